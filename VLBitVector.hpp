@@ -0,0 +1,692 @@
+/**
+ * @file VLBitVector.hpp
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ *
+ * @brief A virtual length vector of packed bits, and a rank and select directory over it.
+ *
+ * @section DESCRIPTION VLBitVector<StaticBits> packs its bits into 64 bit words, which are kept in a VLVector: up to
+ * StaticBits bits are in static storage, more spill to the heap. Bits past the size in the last word are always zero,
+ * so whole words can be counted and compared. The word level operations are:
+ * - AND, OR, XOR and AND NOT with another bit vector, by the runtime dispatched kernels of VLVectorSimd.hpp.
+ * - count(), by POPCNT, or by the AVX2 nibble table popcount (Mula's) when the CPU has AVX2.
+ * - find_first() and find_next(), a word and a bit scan at a time.
+ * rank() and select() of the vector itself scan the words. VLRankSelect is a directory built over a VLBitVector, like
+ * the search indexes of VLVectorSearchIndex.hpp over a VLVector, which answers them with one lookup of the rank before
+ * every RANK_BLOCK_BITS bits and a scan of at most one block.
+ */
+#ifndef CPP_EXAM_VLBITVECTOR_HPP
+#define CPP_EXAM_VLBITVECTOR_HPP
+
+#include "VLVector.hpp"
+#include "VLVectorSimd.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+
+#ifdef VLV_SIMD_X86
+
+#include <immintrin.h>
+
+#endif
+
+#define WORD_BITS 64
+
+#define BYTE_BITS 8
+
+#define BYTE_MASK 0xFF
+
+#define RANK_BLOCK_WORDS 8
+
+#define RANK_BLOCK_BITS (RANK_BLOCK_WORDS * WORD_BITS)
+
+#define BITS_OUT_OF_RANGE_MSG "VLBitVector: the bit index is out of range"
+
+namespace vlvsimd
+{
+    /**
+     * The word level operations of VLBitVector.
+     */
+    enum class BitOp
+    {
+        And, Or, Xor, AndNot
+    };
+
+    /**
+     * @brief lhs = lhs Op rhs, of words or of vectors of words alike.
+     */
+    template<BitOp Op, class W>
+    VLV_ALWAYS_INLINE void applyBits(W &lhs, W const &rhs) noexcept
+    {
+        if constexpr (Op == BitOp::And)
+        {
+            lhs &= rhs;
+        }
+        else if constexpr (Op == BitOp::Or)
+        {
+            lhs |= rhs;
+        }
+        else if constexpr (Op == BitOp::Xor)
+        {
+            lhs ^= rhs;
+        }
+        else
+        {
+            lhs &= ~rhs;
+        }
+    }
+
+    /**
+     * @brief dst[i] = dst[i] Op src[i] for the first n words.
+     */
+    template<BitOp Op, class T, size_t Bytes>
+    VLV_ALWAYS_INLINE void bitwiseBody(T *dst, const T *src, size_t n) noexcept
+    {
+        size_t i = 0;
+        if constexpr (Bytes != SCALAR_BYTES)
+        {
+            typedef typename Vec<T, Bytes>::type V;
+            constexpr size_t lanes = Vec<T, Bytes>::lanes;
+            for (; i + lanes <= n; i += lanes)
+            {
+                V a, b;
+                load(a, dst + i), load(b, src + i);
+                applyBits<Op>(a, b);
+                storeLanes(dst + i, a);
+            }
+        }
+        for (; i < n; ++i)
+        {
+            applyBits<Op>(dst[i], src[i]);
+        }
+    }
+
+    template<class T, size_t Bytes>
+    VLV_ALWAYS_INLINE void andWordsBody(T *dst, const T *src, size_t n) noexcept
+    {
+        bitwiseBody<BitOp::And, T, Bytes>(dst, src, n);
+    }
+
+    template<class T, size_t Bytes>
+    VLV_ALWAYS_INLINE void orWordsBody(T *dst, const T *src, size_t n) noexcept
+    {
+        bitwiseBody<BitOp::Or, T, Bytes>(dst, src, n);
+    }
+
+    template<class T, size_t Bytes>
+    VLV_ALWAYS_INLINE void xorWordsBody(T *dst, const T *src, size_t n) noexcept
+    {
+        bitwiseBody<BitOp::Xor, T, Bytes>(dst, src, n);
+    }
+
+    template<class T, size_t Bytes>
+    VLV_ALWAYS_INLINE void andNotWordsBody(T *dst, const T *src, size_t n) noexcept
+    {
+        bitwiseBody<BitOp::AndNot, T, Bytes>(dst, src, n);
+    }
+
+    VLV_SIMD_KERNEL(void, andWords, (T *dst, const T *src, size_t n), (dst, src, n))
+
+    VLV_SIMD_KERNEL(void, orWords, (T *dst, const T *src, size_t n), (dst, src, n))
+
+    VLV_SIMD_KERNEL(void, xorWords, (T *dst, const T *src, size_t n), (dst, src, n))
+
+    VLV_SIMD_KERNEL(void, andNotWords, (T *dst, const T *src, size_t n), (dst, src, n))
+}
+
+namespace vlvbits
+{
+    /**
+     * @return The amount of words holding n bits.
+     */
+    constexpr size_t wordsFor(size_t n)
+    {
+        return (n + WORD_BITS - 1) / WORD_BITS;
+    }
+
+    /**
+     * @return The amount of set bits of the n words, with the baseline instruction set.
+     */
+    inline size_t countScalar(const uint64_t *words, size_t n) noexcept
+    {
+        size_t total = 0;
+        for (size_t i = FIRST_IDX; i < n; ++i)
+        {
+            total += (size_t) __builtin_popcountll(words[i]);
+        }
+        return total;
+    }
+
+#ifdef VLV_SIMD_X86
+
+    /**
+     * @return The amount of set bits of the n words. Every byte is split into nibbles, whose counts are looked up in a
+     * 16 entry table by a byte shuffle, and the byte counts are summed per 64 bit lane by the sum of absolute
+     * differences. The tail uses POPCNT.
+     */
+    VLV_TARGET_AVX2 inline size_t countAvx2(const uint64_t *words, size_t n) noexcept
+    {
+        constexpr size_t lanes = AVX2_BYTES / sizeof(uint64_t);
+        const __m256i table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                               0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+        const __m256i nibbles = _mm256_set1_epi8(0x0F);
+        __m256i sums = _mm256_setzero_si256();
+        size_t i = FIRST_IDX;
+        for (; i + lanes <= n; i += lanes)
+        {
+            __m256i block = _mm256_loadu_si256((const __m256i *) (words + i));
+            __m256i low = _mm256_shuffle_epi8(table, _mm256_and_si256(block, nibbles));
+            __m256i high = _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(block, 4), nibbles));
+            sums = _mm256_add_epi64(sums, _mm256_sad_epu8(_mm256_add_epi8(low, high), _mm256_setzero_si256()));
+        }
+        uint64_t laneSums[lanes];
+        _mm256_storeu_si256((__m256i *) laneSums, sums);
+        size_t total = (size_t) (laneSums[0] + laneSums[1] + laneSums[2] + laneSums[3]);
+        for (; i < n; ++i)
+        {
+            total += (size_t) __builtin_popcountll(words[i]);
+        }
+        return total;
+    }
+
+#endif
+
+    /**
+     * @return The amount of set bits of the n words, by the widest way the CPU supports.
+     */
+    inline size_t count(const uint64_t *words, size_t n) noexcept
+    {
+#ifdef VLV_SIMD_X86
+        if (vlvsimd::simdLevel() >= vlvsimd::SIMD_AVX2)
+        {
+            return countAvx2(words, n);
+        }
+#endif
+        return countScalar(words, n);
+    }
+
+    /**
+     * @return The index of the k-th (from 0) set bit of word, which has more than k set bits. Skips whole bytes by
+     * their counts, then clears the lower set bits of the byte.
+     */
+    inline size_t selectInWord(uint64_t word, size_t k) noexcept
+    {
+        size_t shift = FIRST_IDX;
+        for (size_t ones = (size_t) __builtin_popcountll(word & BYTE_MASK); k >= ones;
+             ones = (size_t) __builtin_popcountll((word >> shift) & BYTE_MASK))
+        {
+            k -= ones;
+            shift += BYTE_BITS;
+        }
+        uint64_t byte = (word >> shift) & BYTE_MASK;
+        for (; k; --k)
+        {
+            byte &= byte - 1;
+        }
+        return shift + (size_t) __builtin_ctzll(byte);
+    }
+}
+
+/**
+ * A Virtual length vector of packed bits.
+ * @tparam StaticBits The amount of bits held in static storage, rounded up to whole words.
+ */
+template<size_t StaticBits = DEFAULT_STATIC_CAPACITY * WORD_BITS>
+class VLBitVector
+{
+public:
+    /**
+     * The amount of words in static storage.
+     */
+    static constexpr size_t STATIC_WORDS = vlvbits::wordsFor(StaticBits);
+
+private:
+    VLVector<uint64_t, STATIC_WORDS> _words;
+    size_t _size = STARTING_SIZE;
+
+    static uint64_t _bit(size_t idx) noexcept
+    {
+        return (uint64_t) 1 << (idx % WORD_BITS);
+    }
+
+    /**
+     * @brief Clears the bits past the size in the last word.
+     */
+    void _clearTail() noexcept
+    {
+        if (_size % WORD_BITS)
+        {
+            _words.back() &= ~(uint64_t) 0 >> (WORD_BITS - _size % WORD_BITS);
+        }
+    }
+
+    void _checkIdx(size_t idx) const
+    {
+        if (idx >= _size)
+        {
+            throw std::out_of_range(BITS_OUT_OF_RANGE_MSG);
+        }
+    }
+
+public:
+    typedef bool value_type;
+    typedef size_t size_type;
+
+    /**
+     * @brief A regular c'tor.
+     */
+    VLBitVector() = default;
+
+    /**
+     * @brief A c'tor of size bits, all set to value.
+     */
+    explicit VLBitVector(size_t size, bool value = false)
+    {
+        resize(size, value);
+    }
+
+    VLBitVector(VLBitVector const &toCopy) = default;
+
+    /**
+     * @brief A move ctor. Leaves toMove empty.
+     */
+    VLBitVector(VLBitVector &&toMove) noexcept : _words(std::move(toMove._words)), _size(toMove._size)
+    {
+        toMove._size = STARTING_SIZE;
+    }
+
+    VLBitVector &operator=(VLBitVector const &rhs) = default;
+
+    /**
+     * @brief Moves the bits of rhs to the bit vector, leaving rhs empty.
+     * @return The assigned bit vector by ref.
+     */
+    VLBitVector &operator=(VLBitVector &&rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            _words = std::move(rhs._words);
+            _size = rhs._size;
+            rhs._size = STARTING_SIZE;
+        }
+        return *this;
+    }
+
+    size_t size() const noexcept
+    {
+        return _size;
+    }
+
+    bool empty() const noexcept
+    {
+        return _size == STARTING_SIZE;
+    }
+
+    /**
+     * @return The amount of bits the allocated words can hold.
+     */
+    size_t capacity() const noexcept
+    {
+        return _words.capacity() * WORD_BITS;
+    }
+
+    /**
+     * @return The amount of words holding the bits.
+     */
+    size_t word_count() const noexcept
+    {
+        return _words.size();
+    }
+
+    /**
+     * @return The words, the bit idx being bit idx % 64 of word idx / 64.
+     */
+    const uint64_t *data() const noexcept
+    {
+        return _words.data();
+    }
+
+    /**
+     * @brief Adds value as the last bit.
+     */
+    void push_back(bool value)
+    {
+        if (_size % WORD_BITS == FIRST_IDX)
+        {
+            _words.push_back((uint64_t) value);
+        }
+        else
+        {
+            _words.back() |= (uint64_t) value << (_size % WORD_BITS);
+        }
+        ++_size;
+    }
+
+    /**
+     * @brief Removes the last bit.
+     */
+    void pop_back()
+    {
+        --_size;
+        if (_size % WORD_BITS == FIRST_IDX)
+        {
+            _words.pop_back();
+        }
+        else
+        {
+            _words.back() &= ~_bit(_size);
+        }
+    }
+
+    /**
+     * @brief Changes the size to newSize. New bits are value.
+     */
+    void resize(size_t newSize, bool value = false)
+    {
+        if (value && newSize > _size && _size % WORD_BITS)
+        {
+            _words.back() |= ~(uint64_t) 0 << (_size % WORD_BITS);
+        }
+        _words.resize(vlvbits::wordsFor(newSize), value ? ~(uint64_t) 0 : 0);
+        _size = newSize;
+        _clearTail();
+    }
+
+    /**
+     * @brief Sets all of the bits to value.
+     */
+    void fill(bool value) noexcept
+    {
+        std::fill(_words.begin(), _words.end(), value ? ~(uint64_t) 0 : 0);
+        _clearTail();
+    }
+
+    /**
+     * @brief Deletes all of the bits. Frees the words if dynamically allocated.
+     */
+    void clear() noexcept
+    {
+        _words.clear();
+        _size = STARTING_SIZE;
+    }
+
+    bool operator[](size_t idx) const noexcept
+    {
+        return (_words[idx / WORD_BITS] >> (idx % WORD_BITS)) & 1;
+    }
+
+    /**
+     * @return The bit at idx. @throws std::out_of_range if the idx is illegal.
+     */
+    bool test(size_t idx) const
+    {
+        _checkIdx(idx);
+        return (*this)[idx];
+    }
+
+    /**
+     * @brief Sets the bit at idx to value. @throws std::out_of_range if the idx is illegal.
+     */
+    void set(size_t idx, bool value = true)
+    {
+        _checkIdx(idx);
+        uint64_t &word = _words[idx / WORD_BITS];
+        word = (word & ~_bit(idx)) | ((uint64_t) value << (idx % WORD_BITS));
+    }
+
+    /**
+     * @brief Clears the bit at idx. @throws std::out_of_range if the idx is illegal.
+     */
+    void reset(size_t idx)
+    {
+        set(idx, false);
+    }
+
+    /**
+     * @brief Flips the bit at idx. @throws std::out_of_range if the idx is illegal.
+     */
+    void flip(size_t idx)
+    {
+        _checkIdx(idx);
+        _words[idx / WORD_BITS] ^= _bit(idx);
+    }
+
+    /**
+     * @return The amount of set bits.
+     */
+    size_t count() const noexcept
+    {
+        return vlvbits::count(_words.data(), _words.size());
+    }
+
+    bool any() const noexcept
+    {
+        return find_first() != _size;
+    }
+
+    bool none() const noexcept
+    {
+        return !any();
+    }
+
+    /**
+     * @return The index of the first set bit, or size().
+     */
+    size_t find_first() const noexcept
+    {
+        for (size_t word = FIRST_IDX; word < _words.size(); ++word)
+        {
+            if (_words[word])
+            {
+                return word * WORD_BITS + (size_t) __builtin_ctzll(_words[word]);
+            }
+        }
+        return _size;
+    }
+
+    /**
+     * @return The index of the first set bit after idx, or size().
+     */
+    size_t find_next(size_t idx) const noexcept
+    {
+        size_t next = idx + NEXT_ELEM;
+        if (next >= _size)
+        {
+            return _size;
+        }
+        size_t word = next / WORD_BITS;
+        uint64_t bits = _words[word] & (~(uint64_t) 0 << (next % WORD_BITS));
+        while (!bits)
+        {
+            if (++word == _words.size())
+            {
+                return _size;
+            }
+            bits = _words[word];
+        }
+        return word * WORD_BITS + (size_t) __builtin_ctzll(bits);
+    }
+
+    /**
+     * @return The amount of set bits before idx, which is at most size(). Scans the words, see VLRankSelect.
+     */
+    size_t rank(size_t idx) const noexcept
+    {
+        size_t total = vlvbits::count(_words.data(), idx / WORD_BITS);
+        if (idx % WORD_BITS)
+        {
+            total += (size_t) __builtin_popcountll(_words[idx / WORD_BITS] << (WORD_BITS - idx % WORD_BITS));
+        }
+        return total;
+    }
+
+    /**
+     * @return The index of the k-th (from 0) set bit, or size() if there are not that many. Scans the words, see
+     * VLRankSelect.
+     */
+    size_t select(size_t k) const noexcept
+    {
+        for (size_t word = FIRST_IDX; word < _words.size(); ++word)
+        {
+            size_t ones = (size_t) __builtin_popcountll(_words[word]);
+            if (k < ones)
+            {
+                return word * WORD_BITS + vlvbits::selectInWord(_words[word], k);
+            }
+            k -= ones;
+        }
+        return _size;
+    }
+
+    /**
+     * @brief Keeps the bits which are set in rhs too. Bits past the size of rhs are cleared.
+     */
+    VLBitVector &operator&=(VLBitVector const &rhs) noexcept
+    {
+        size_t common = std::min(_words.size(), rhs._words.size());
+        vlvsimd::andWords(_words.data(), rhs._words.data(), common);
+        std::fill(_words.begin() + common, _words.end(), 0);
+        return *this;
+    }
+
+    /**
+     * @brief Sets the bits which are set in rhs. Bits of rhs past the size are ignored.
+     */
+    VLBitVector &operator|=(VLBitVector const &rhs) noexcept
+    {
+        vlvsimd::orWords(_words.data(), rhs._words.data(), std::min(_words.size(), rhs._words.size()));
+        _clearTail();
+        return *this;
+    }
+
+    /**
+     * @brief Flips the bits which are set in rhs. Bits of rhs past the size are ignored.
+     */
+    VLBitVector &operator^=(VLBitVector const &rhs) noexcept
+    {
+        vlvsimd::xorWords(_words.data(), rhs._words.data(), std::min(_words.size(), rhs._words.size()));
+        _clearTail();
+        return *this;
+    }
+
+    /**
+     * @brief Clears the bits which are set in rhs.
+     */
+    VLBitVector &and_not(VLBitVector const &rhs) noexcept
+    {
+        vlvsimd::andNotWords(_words.data(), rhs._words.data(), std::min(_words.size(), rhs._words.size()));
+        return *this;
+    }
+
+    /**
+     * @return true if both of the vectors hold the same bits.
+     */
+    bool operator==(VLBitVector const &toComp) const
+    {
+        return _size == toComp._size && _words == toComp._words;
+    }
+
+    bool operator!=(VLBitVector const &toComp) const
+    {
+        return !(*this == toComp);
+    }
+};
+
+/**
+ * A rank and select directory over a VLBitVector: the rank before every block of RANK_BLOCK_BITS bits, which is a
+ * cache line of words. Like the search indexes, it is a companion which must be rebuilt after the bits change.
+ */
+class VLRankSelect
+{
+private:
+    VLVector<uint64_t> _blockRanks; //the amount of set bits before every block, and the total at the end.
+    const uint64_t *_words = nullptr;
+    size_t _wordCount = STARTING_SIZE;
+    size_t _size = STARTING_SIZE;
+
+public:
+    VLRankSelect() = default;
+
+    /**
+     * @brief Builds the directory of bits, which it refers to until it is rebuilt.
+     */
+    template<size_t StaticBits>
+    explicit VLRankSelect(VLBitVector<StaticBits> const &bits)
+    {
+        rebuild(bits);
+    }
+
+    /**
+     * @brief Builds the directory of bits from scratch.
+     */
+    template<size_t StaticBits>
+    void rebuild(VLBitVector<StaticBits> const &bits)
+    {
+        _words = bits.data();
+        _wordCount = bits.word_count();
+        _size = bits.size();
+        _blockRanks.clear();
+        _blockRanks.reserve(_wordCount / RANK_BLOCK_WORDS + NEXT_ELEM);
+        size_t total = 0;
+        for (size_t word = FIRST_IDX; word < _wordCount; word += RANK_BLOCK_WORDS)
+        {
+            _blockRanks.push_back(total);
+            total += vlvbits::countScalar(_words + word, std::min((size_t) RANK_BLOCK_WORDS, _wordCount - word));
+        }
+        _blockRanks.push_back(total);
+    }
+
+    /**
+     * @return The amount of set bits before idx, which is at most the size.
+     */
+    size_t rank(size_t idx) const noexcept
+    {
+        size_t word = idx / WORD_BITS;
+        size_t total = _blockRanks[idx / RANK_BLOCK_BITS];
+        for (size_t prev = word / RANK_BLOCK_WORDS * RANK_BLOCK_WORDS; prev < word; ++prev)
+        {
+            total += (size_t) __builtin_popcountll(_words[prev]);
+        }
+        if (idx % WORD_BITS)
+        {
+            total += (size_t) __builtin_popcountll(_words[word] << (WORD_BITS - idx % WORD_BITS));
+        }
+        return total;
+    }
+
+    /**
+     * @return The index of the k-th (from 0) set bit, or the size if there are not that many. Binary searches the
+     * block ranks, then scans the block.
+     */
+    size_t select(size_t k) const noexcept
+    {
+        if (k >= _blockRanks.back())
+        {
+            return _size;
+        }
+        size_t block = (size_t) (std::upper_bound(_blockRanks.begin(), _blockRanks.end(), k) - _blockRanks.begin()) -
+                       NEXT_ELEM;
+        k -= _blockRanks[block];
+        for (size_t word = block * RANK_BLOCK_WORDS;; ++word)
+        {
+            size_t ones = (size_t) __builtin_popcountll(_words[word]);
+            if (k < ones)
+            {
+                return word * WORD_BITS + vlvbits::selectInWord(_words[word], k);
+            }
+            k -= ones;
+        }
+    }
+
+    /**
+     * @return The amount of set bits.
+     */
+    size_t count() const noexcept
+    {
+        return _blockRanks.back();
+    }
+};
+
+
+#endif //CPP_EXAM_VLBITVECTOR_HPP
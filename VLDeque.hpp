@@ -0,0 +1,406 @@
+/**
+ * @file VLDeque.hpp
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ *
+ * @brief A virtual length double ended queue.
+ *
+ * @section DESCRIPTION VLDeque<T, StaticCapacity> is a ring buffer with the storage strategy of VLVector: its elements
+ * are in a static array until they do not fit, then in a dynamically allocated one, and back in the static array once
+ * they fit again and fill at most a DEQUE_SHRINK_RATIO-th of the dynamic one, if SHRINK_TO_STATIC is set. The slack
+ * keeps a queue whose size hovers around the static capacity from copying its elements on every push and pop. Adding
+ * and removing at either end is O(1). The capacity is always a power of two, so the place of element idx is
+ * (head + idx) & (capacity - 1). Growing doubles the capacity and copies the elements to the start of the new array in
+ * order, so the ring is linear again after growth.
+ */
+#ifndef CPP_EXAM_VLDEQUE_HPP
+#define CPP_EXAM_VLDEQUE_HPP
+
+#include "VLIndexIterator.hpp"
+#include "VLVector.hpp"
+
+#include <stdexcept>
+
+#define DEQUE_GROWTH 2
+
+#define DEQUE_SHRINK_RATIO 4
+
+namespace vlvdeque
+{
+    /**
+     * @return The smallest power of two which is at least n, and at least 1.
+     */
+    constexpr size_t ceilPow2(size_t n)
+    {
+        size_t pow = 1;
+        while (pow < n)
+        {
+            pow *= 2;
+        }
+        return pow;
+    }
+}
+
+/**
+ * A Virtual length double ended queue. Holds up to StaticCapacity, rounded up to a power of two, elements in its
+ * static storage.
+ * @tparam T The type of the elements.
+ */
+template<class T, size_t StaticCapacity = DEFAULT_STATIC_CAPACITY>
+class VLDeque
+{
+public:
+    /**
+     * The capacity of the static storage.
+     */
+    static constexpr size_t STATIC_CAPACITY = vlvdeque::ceilPow2(StaticCapacity);
+
+private:
+    T _statData[STATIC_CAPACITY];
+    T *_curData = _statData;
+    size_t _head = FIRST_IDX;
+    size_t _size = STARTING_SIZE;
+    size_t _mask = STATIC_CAPACITY - 1;
+
+    bool _dynamic() const noexcept
+    {
+        return _curData != _statData;
+    }
+
+    /**
+     * @return The place in the storage of element idx.
+     */
+    size_t _place(size_t idx) const noexcept
+    {
+        return (_head + idx) & _mask;
+    }
+
+    /**
+     * @brief Copies the elements, in order, to the start of to, which holds newCapacity elements, and makes it the
+     * storage. Frees the old storage if dynamically allocated.
+     */
+    void _moveTo(T *to, size_t newCapacity)
+    {
+        for (size_t idx = FIRST_IDX; idx < _size; ++idx)
+        {
+            to[idx] = _curData[_place(idx)];
+        }
+        if (_dynamic())
+        {
+            delete[] _curData;
+        }
+        _curData = to;
+        _head = FIRST_IDX;
+        _mask = newCapacity - 1;
+    }
+
+    /**
+     * @brief Doubles the capacity, moving the elements to a new dynamic array.
+     */
+    void _grow()
+    {
+        size_t newCapacity = capacity() * DEQUE_GROWTH;
+        _moveTo(new T[newCapacity](), newCapacity);
+    }
+
+    /**
+     * @brief Moves the elements back to the static storage if they fit there and fill at most a DEQUE_SHRINK_RATIO-th
+     * of the dynamic array, see SHRINK_TO_STATIC.
+     */
+    void _shrink()
+    {
+        if (SHRINK_TO_STATIC && _size <= STATIC_CAPACITY && _size <= capacity() / DEQUE_SHRINK_RATIO && _dynamic())
+        {
+            _moveTo(_statData, STATIC_CAPACITY);
+        }
+    }
+
+    /**
+     * @brief Replaces the content by a copy of rhs, in the static storage if it fits, see SHRINK_TO_STATIC, else in
+     * the current array if it fits or in one of the smallest power of two capacity which holds it. The new array is
+     * allocated before the old one is freed, so a bad_alloc leaves the VLDeque as it was.
+     */
+    void _assign(VLDeque const &rhs)
+    {
+        if (rhs._size > capacity())
+        {
+            size_t newCapacity = vlvdeque::ceilPow2(rhs._size);
+            T *temp = new T[newCapacity]();
+            if (_dynamic())
+            {
+                delete[] _curData;
+            }
+            _curData = temp;
+            _mask = newCapacity - 1;
+        }
+        else if (SHRINK_TO_STATIC && rhs._size <= STATIC_CAPACITY && _dynamic())
+        {
+            delete[] _curData;
+            _curData = _statData;
+            _mask = STATIC_CAPACITY - 1;
+        }
+        _head = FIRST_IDX;
+        _size = STARTING_SIZE;
+        for (size_t idx = FIRST_IDX; idx < rhs._size; ++idx)
+        {
+            _curData[idx] = rhs[idx];
+        }
+        _size = rhs._size;
+    }
+
+public:
+    typedef T value_type;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    typedef T &reference;
+    typedef T const &const_reference;
+    typedef VLIndexIterator<VLDeque, T, false> iterator;
+    typedef VLIndexIterator<VLDeque, T, true> const_iterator;
+
+    /**
+     * @brief A regular c'tor.
+     */
+    VLDeque() = default;
+
+    /**
+     * @brief A copy ctor.
+     */
+    VLDeque(VLDeque const &toCopy)
+    {
+        _assign(toCopy);
+    }
+
+    /**
+     * @brief A c'tor from a set of items.
+     * @tparam InputIterator The iterator that is given by the user.
+     */
+    template<class InputIterator>
+    VLDeque(InputIterator first, InputIterator last)
+    {
+        while (first != last)
+        {
+            push_back(*(first++));
+        }
+    }
+
+    /**
+     * @brief Destructor. Frees data if dynamically allocated.
+     */
+    ~VLDeque()
+    {
+        if (_dynamic())
+        {
+            delete[] _curData;
+        }
+    }
+
+    /**
+     * @brief Assigns values equal to the values of rhs to the VLDeque.
+     */
+    VLDeque &operator=(VLDeque const &rhs)
+    {
+        if (this != &rhs)
+        {
+            _assign(rhs);
+        }
+        return *this;
+    }
+
+    size_t size() const noexcept
+    {
+        return _size;
+    }
+
+    /**
+     * @return The current capacity the container can hold before it will have to grow, a power of two.
+     */
+    size_t capacity() const noexcept
+    {
+        return _mask + 1;
+    }
+
+    bool empty() const noexcept
+    {
+        return _size == STARTING_SIZE;
+    }
+
+    /**
+     * @brief Adds toAdd to the back of the VLDeque.
+     */
+    void push_back(const T &toAdd)
+    {
+        if (_size == capacity())
+        {
+            T value = toAdd; //toAdd may be an element of the deque.
+            _grow();
+            _curData[_place(_size++)] = value;
+            return;
+        }
+        _curData[_place(_size++)] = toAdd;
+    }
+
+    /**
+     * @brief Adds toAdd to the front of the VLDeque.
+     */
+    void push_front(const T &toAdd)
+    {
+        if (_size == capacity())
+        {
+            T value = toAdd;
+            _grow();
+            _head = (_head - NEXT_ELEM) & _mask;
+            _curData[_head] = value;
+        }
+        else
+        {
+            _head = (_head - NEXT_ELEM) & _mask;
+            _curData[_head] = toAdd;
+        }
+        ++_size;
+    }
+
+    /**
+     * @brief Removes the last element. Like VLVector::pop_back, the element is not destroyed but left to be overwritten.
+     */
+    void pop_back()
+    {
+        --_size;
+        _shrink();
+    }
+
+    /**
+     * @brief Removes the first element. See pop_back.
+     */
+    void pop_front()
+    {
+        _head = (_head + NEXT_ELEM) & _mask;
+        --_size;
+        _shrink();
+    }
+
+    /**
+     * @brief Deletes all of the elements. Frees the array if dynamically allocated.
+     */
+    void clear() noexcept
+    {
+        if (_dynamic())
+        {
+            delete[] _curData;
+            _curData = _statData;
+            _mask = STATIC_CAPACITY - 1;
+        }
+        _head = FIRST_IDX;
+        _size = STARTING_SIZE;
+    }
+
+    const T &operator[](size_t idx) const noexcept
+    {
+        return _curData[_place(idx)];
+    }
+
+    T &operator[](size_t idx) noexcept
+    {
+        return _curData[_place(idx)];
+    }
+
+    /**
+     * @brief returns the element at place idx. @throws std::out_of_range if the idx is illegal. const version.
+     */
+    const T &at(size_t idx) const
+    {
+        if (idx >= _size)
+        {
+            throw std::out_of_range(OUT_OF_RANGE_MSG);
+        }
+        return (*this)[idx];
+    }
+
+    /**
+     * @brief returns the element at place idx. @throws std::out_of_range if the idx is illegal.
+     */
+    T &at(size_t idx)
+    {
+        if (idx >= _size)
+        {
+            throw std::out_of_range(OUT_OF_RANGE_MSG);
+        }
+        return (*this)[idx];
+    }
+
+    T &front() noexcept
+    {
+        return _curData[_head];
+    }
+
+    const T &front() const noexcept
+    {
+        return _curData[_head];
+    }
+
+    T &back() noexcept
+    {
+        return (*this)[_size - NEXT_ELEM];
+    }
+
+    const T &back() const noexcept
+    {
+        return (*this)[_size - NEXT_ELEM];
+    }
+
+    /**
+     * @return true if all of the elements in both of the containers are equal, in order.
+     */
+    bool operator==(VLDeque const &toComp) const
+    {
+        if (_size != toComp._size)
+        {
+            return false;
+        }
+        for (size_t idx = FIRST_IDX; idx < _size; ++idx)
+        {
+            if (!((*this)[idx] == toComp[idx]))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool operator!=(VLDeque const &toComp) const
+    {
+        return !(*this == toComp);
+    }
+
+    iterator begin() noexcept
+    {
+        return iterator(this, FIRST_IDX);
+    }
+
+    iterator end() noexcept
+    {
+        return iterator(this, _size);
+    }
+
+    const_iterator begin() const noexcept
+    {
+        return const_iterator(this, FIRST_IDX);
+    }
+
+    const_iterator end() const noexcept
+    {
+        return const_iterator(this, _size);
+    }
+
+    const_iterator cbegin() const noexcept
+    {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept
+    {
+        return end();
+    }
+};
+
+
+#endif //CPP_EXAM_VLDEQUE_HPP
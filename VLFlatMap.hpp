@@ -0,0 +1,785 @@
+/**
+ * @file VLFlatMap.hpp
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ *
+ * @brief Sorted associative containers in VLVectors: VLFlatMap and VLFlatSet.
+ *
+ * @section DESCRIPTION VLFlatMap<K, V, StaticCapacity, Compare> keeps its keys sorted in one VLVector and its values
+ * in another, in the same order, so searches only touch the contiguous keys. VLFlatSet<K, StaticCapacity, Compare> is
+ * the keys alone. Up to StaticCapacity entries never allocate, where a node based std::map allocates per entry.
+ * Searching arithmetic keys in the default order by a linear SIMD count of the smaller keys when they take up to
+ * FLAT_SCAN_BYTES, and by a branch free binary search otherwise. Inserting or erasing a single entry shifts the ones
+ * after it, like VLVector::insert. insert_range sorts the new entries, drops the duplicate keys and merges them in from
+ * the back in a single pass, so a batch costs O(m log m + n) instead of m shifts.
+ */
+#ifndef CPP_EXAM_VLFLATMAP_HPP
+#define CPP_EXAM_VLFLATMAP_HPP
+
+#include "VLVector.hpp"
+#include "VLVectorSimd.hpp"
+#include "VLVectorSort.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#ifdef __SSE2__
+
+#include <emmintrin.h>
+
+#endif
+
+#define FLAT_SCAN_BYTES 256
+
+#define MISSING_KEY_MSG "VLFlatMap: the key is missing"
+
+namespace vlvflat
+{
+    /**
+     * true if Compare is the default ascending order of K, which SIMD comparisons compute.
+     */
+    template<class K, class Compare>
+    struct IsDefaultOrder : std::integral_constant<bool, vlvsimd::IsSimdElement<K>::value &&
+                                                         (std::is_same<Compare, std::less<K>>::value ||
+                                                          std::is_same<Compare, std::less<>>::value)>
+    {
+    };
+
+    /**
+     * @return The amount of keys less than key, which is the lower bound of key in the sorted keys. SSE2 compares 16
+     * bytes of keys at once, and every lane of the count subtracts its all ones comparison results. A lane counts at
+     * most FLAT_SCAN_BYTES / 16 keys, so even byte lanes do not overflow.
+     */
+    template<class K>
+    inline size_t countLess(const K *keys, size_t n, K const &key) noexcept
+    {
+        size_t i = FIRST_IDX;
+        size_t less = 0;
+#ifdef __SSE2__
+        typedef typename vlvsimd::Vec<K, SSE2_BYTES>::type V;
+        typedef vlvsimd::MaskLane<K> Lane;
+        typedef typename vlvsimd::Vec<Lane, SSE2_BYTES>::type Counts;
+        constexpr size_t lanes = vlvsimd::Vec<K, SSE2_BYTES>::lanes;
+        V needle = V{} + key;
+        Counts counts = {};
+        for (; i + lanes <= n; i += lanes)
+        {
+            V chunk;
+            vlvsimd::load(chunk, keys + i);
+            counts -= (Counts) (chunk < needle);
+        }
+        Lane laneCounts[lanes];
+        vlvsimd::storeLanes(laneCounts, counts);
+        for (Lane count : laneCounts)
+        {
+            less += (size_t) count;
+        }
+#endif
+        for (; i < n; ++i)
+        {
+            less += keys[i] < key;
+        }
+        return less;
+    }
+
+    /**
+     * @return The index of the first of the n sorted keys which is not before key by comp, or n.
+     */
+    template<class K, class Compare>
+    inline size_t lowerBound(const K *keys, size_t n, K const &key, Compare const &comp) noexcept
+    {
+        if constexpr (IsDefaultOrder<K, Compare>::value)
+        {
+            if (n * sizeof(K) <= FLAT_SCAN_BYTES)
+            {
+                return countLess(keys, n, key);
+            }
+        }
+        if (n == STARTING_SIZE)
+        {
+            return n;
+        }
+        const K *base = keys;
+        while (n > NEXT_ELEM)
+        {
+            size_t half = n / 2;
+            base = comp(base[half], key) ? base + half : base; //a conditional move, not a branch.
+            n -= half;
+        }
+        return (size_t) (base - keys) + comp(*base, key);
+    }
+}
+
+/**
+ * A sorted map of unique keys.
+ * @tparam K The type of the keys.
+ * @tparam V The type of the values.
+ * @tparam StaticCapacity The amount of entries held without allocating.
+ * @tparam Compare The order of the keys.
+ */
+template<class K, class V, size_t StaticCapacity = DEFAULT_STATIC_CAPACITY, class Compare = std::less<K>>
+class VLFlatMap
+{
+private:
+    VLVector<K, StaticCapacity> _keys;
+    VLVector<V, StaticCapacity> _values;
+    Compare _comp;
+
+    size_t _lowerBound(K const &key) const noexcept
+    {
+        return vlvflat::lowerBound(_keys.data(), _keys.size(), key, _comp);
+    }
+
+    /**
+     * @return The index of key, or size().
+     */
+    size_t _find(K const &key) const noexcept
+    {
+        size_t idx = _lowerBound(key);
+        return idx < size() && !_comp(key, _keys[idx]) ? idx : size();
+    }
+
+    /**
+     * @brief Inserts key and value before the entry at idx.
+     */
+    void _insertAt(size_t idx, K const &key, V const &value)
+    {
+        _keys.insert(_keys.cbegin() + idx, key);
+        _values.insert(_values.cbegin() + idx, value);
+    }
+
+public:
+    typedef K key_type;
+    typedef V mapped_type;
+    typedef std::pair<K, V> value_type;
+    typedef size_t size_type;
+
+    /**
+     * @brief An iterator over the entries, in key order. The arrays are separate, so it yields a pair of references
+     * to the key and to the value instead of a reference to a stored pair.
+     * @tparam Const Indicator for const_iterator.
+     */
+    template<bool Const>
+    class Iterator
+    {
+    private:
+        typedef std::conditional_t<Const, VLFlatMap const, VLFlatMap> Owner;
+
+        Owner *_owner = nullptr;
+        size_t _idx = FIRST_IDX;
+
+        template<bool> friend
+        class Iterator;
+
+    public:
+        typedef std::pair<K, V> value_type;
+        typedef ptrdiff_t difference_type;
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef std::pair<K const &, std::conditional_t<Const, V const &, V &>> reference;
+
+        /**
+         * Holds the pair of references, for operator->.
+         */
+        struct pointer
+        {
+            reference ref;
+
+            reference const *operator->() const noexcept
+            {
+                return &ref;
+            }
+        };
+
+        Iterator() noexcept = default;
+
+        Iterator(Owner *owner, size_t idx) noexcept : _owner(owner), _idx(idx)
+        {
+        }
+
+        /**
+         * @brief Converts an iterator to a const_iterator.
+         */
+        template<bool IsConst = Const, class = std::enable_if_t<IsConst>>
+        Iterator(Iterator<false> const &other) noexcept : _owner(other._owner), _idx(other._idx)
+        {
+        }
+
+        K const &key() const noexcept
+        {
+            return _owner->_keys[_idx];
+        }
+
+        std::conditional_t<Const, V const &, V &> value() const noexcept
+        {
+            return _owner->_values[_idx];
+        }
+
+        /**
+         * @return The index of the entry in key order.
+         */
+        size_t index() const noexcept
+        {
+            return _idx;
+        }
+
+        reference operator*() const noexcept
+        {
+            return reference(key(), value());
+        }
+
+        pointer operator->() const noexcept
+        {
+            return pointer{**this};
+        }
+
+        Iterator &operator++() noexcept
+        {
+            ++_idx;
+            return *this;
+        }
+
+        Iterator operator++(int) noexcept
+        {
+            Iterator temp = *this;
+            ++_idx;
+            return temp;
+        }
+
+        Iterator &operator--() noexcept
+        {
+            --_idx;
+            return *this;
+        }
+
+        Iterator operator--(int) noexcept
+        {
+            Iterator temp = *this;
+            --_idx;
+            return temp;
+        }
+
+        friend bool operator==(Iterator const &lhs, Iterator const &rhs) noexcept
+        {
+            return lhs._idx == rhs._idx;
+        }
+
+        friend bool operator!=(Iterator const &lhs, Iterator const &rhs) noexcept
+        {
+            return lhs._idx != rhs._idx;
+        }
+    };
+
+    typedef Iterator<false> iterator;
+    typedef Iterator<true> const_iterator;
+
+    /**
+     * @brief A regular c'tor.
+     */
+    explicit VLFlatMap(Compare const &comp = Compare()) : _comp(comp)
+    {
+    }
+
+    /**
+     * @brief A c'tor from a set of key and value pairs. The first of equal keys is kept.
+     * @tparam InputIterator The iterator that is given by the user.
+     */
+    template<class InputIterator>
+    VLFlatMap(InputIterator first, InputIterator last, Compare const &comp = Compare()) : _comp(comp)
+    {
+        insert_range(first, last);
+    }
+
+    size_t size() const noexcept
+    {
+        return _keys.size();
+    }
+
+    bool empty() const noexcept
+    {
+        return _keys.empty();
+    }
+
+    /**
+     * @brief Deletes all of the entries.
+     */
+    void clear() noexcept
+    {
+        _keys.clear();
+        _values.clear();
+    }
+
+    /**
+     * @return The keys, sorted.
+     */
+    VLVector<K, StaticCapacity> const &keys() const noexcept
+    {
+        return _keys;
+    }
+
+    /**
+     * @return The values, in the order of their keys.
+     */
+    VLVector<V, StaticCapacity> const &values() const noexcept
+    {
+        return _values;
+    }
+
+    iterator find(K const &key) noexcept
+    {
+        return iterator(this, _find(key));
+    }
+
+    const_iterator find(K const &key) const noexcept
+    {
+        return const_iterator(this, _find(key));
+    }
+
+    /**
+     * @return An iterator to the first entry whose key is not before key.
+     */
+    iterator lower_bound(K const &key) noexcept
+    {
+        return iterator(this, _lowerBound(key));
+    }
+
+    const_iterator lower_bound(K const &key) const noexcept
+    {
+        return const_iterator(this, _lowerBound(key));
+    }
+
+    bool contains(K const &key) const noexcept
+    {
+        return _find(key) != size();
+    }
+
+    size_t count(K const &key) const noexcept
+    {
+        return contains(key);
+    }
+
+    /**
+     * @return The value of key. @throws std::out_of_range if key is missing.
+     */
+    V &at(K const &key)
+    {
+        size_t idx = _find(key);
+        if (idx == size())
+        {
+            throw std::out_of_range(MISSING_KEY_MSG);
+        }
+        return _values[idx];
+    }
+
+    /**
+     * @return The value of key. @throws std::out_of_range if key is missing. const version.
+     */
+    V const &at(K const &key) const
+    {
+        size_t idx = _find(key);
+        if (idx == size())
+        {
+            throw std::out_of_range(MISSING_KEY_MSG);
+        }
+        return _values[idx];
+    }
+
+    /**
+     * @return The value of key, inserting a default one first if key is missing.
+     */
+    V &operator[](K const &key)
+    {
+        size_t idx = _lowerBound(key);
+        if (idx == size() || _comp(key, _keys[idx]))
+        {
+            _insertAt(idx, key, V());
+        }
+        return _values[idx];
+    }
+
+    /**
+     * @brief Inserts key with value, unless key is already there.
+     * @return An iterator to the entry of key, and true if it was inserted.
+     */
+    std::pair<iterator, bool> insert(K const &key, V const &value)
+    {
+        size_t idx = _lowerBound(key);
+        bool missing = idx == size() || _comp(key, _keys[idx]);
+        if (missing)
+        {
+            _insertAt(idx, key, value);
+        }
+        return {iterator(this, idx), missing};
+    }
+
+    /**
+     * @brief Inserts the key and value of entry, unless the key is already there.
+     */
+    std::pair<iterator, bool> insert(value_type const &entry)
+    {
+        return insert(entry.first, entry.second);
+    }
+
+    /**
+     * @brief Inserts key with value, or assigns value to key if it is already there.
+     * @return An iterator to the entry of key, and true if it was inserted.
+     */
+    std::pair<iterator, bool> insert_or_assign(K const &key, V const &value)
+    {
+        std::pair<iterator, bool> result = insert(key, value);
+        if (!result.second)
+        {
+            result.first.value() = value;
+        }
+        return result;
+    }
+
+    /**
+     * @brief Inserts all of the key and value pairs between first and last whose keys are not there yet, the first
+     * of equal keys among them. The pairs are stably sorted, and merged from the back into the arrays grown once.
+     */
+    template<class InputIterator>
+    void insert_range(InputIterator first, InputIterator last)
+    {
+        VLVector<value_type, StaticCapacity> added(first, last);
+        Compare const &comp = _comp;
+        stable_sort(added, [&comp](value_type const &lhs, value_type const &rhs)
+        {
+            return comp(lhs.first, rhs.first);
+        });
+        size_t unique = FIRST_IDX;
+        for (size_t idx = FIRST_IDX; idx < added.size(); ++idx)
+        {
+            if (unique == FIRST_IDX || _comp(added[unique - NEXT_ELEM].first, added[idx].first))
+            {
+                added[unique++] = added[idx];
+            }
+        }
+        size_t oldSize = size();
+        _keys.resize(oldSize + unique);
+        _values.resize(oldSize + unique);
+        size_t out = oldSize + unique;
+        size_t old = oldSize;
+        while (unique != FIRST_IDX)
+        {
+            value_type const &next = added[unique - NEXT_ELEM];
+            if (old != FIRST_IDX && _comp(next.first, _keys[old - NEXT_ELEM]))
+            {
+                --old, --out;
+                _keys[out] = _keys[old];
+                _values[out] = _values[old];
+            }
+            else if (old != FIRST_IDX && !_comp(_keys[old - NEXT_ELEM], next.first))
+            {
+                --unique; //the key is there already.
+            }
+            else
+            {
+                --unique, --out;
+                _keys[out] = next.first;
+                _values[out] = next.second;
+            }
+        }
+        size_t dropped = out - old; //the keys which were there already left a gap before the merged entries.
+        std::copy(_keys.begin() + out, _keys.end(), _keys.begin() + old);
+        std::copy(_values.begin() + out, _values.end(), _values.begin() + old);
+        _keys.resize(_keys.size() - dropped);
+        _values.resize(_values.size() - dropped);
+    }
+
+    /**
+     * @brief Erases the entry of key, if it is there.
+     * @return The amount of erased entries.
+     */
+    size_t erase(K const &key)
+    {
+        size_t idx = _find(key);
+        if (idx == size())
+        {
+            return STARTING_SIZE;
+        }
+        erase(const_iterator(this, idx));
+        return NEXT_ELEM;
+    }
+
+    /**
+     * @brief Erases The entry that iter points to.
+     * @return An iterator pointing to the next entry.
+     */
+    iterator erase(const_iterator iter)
+    {
+        size_t idx = iter.index();
+        _keys.erase(_keys.cbegin() + idx);
+        _values.erase(_values.cbegin() + idx);
+        return iterator(this, idx);
+    }
+
+    /**
+     * @return true if both of the maps hold equal keys with equal values.
+     */
+    bool operator==(VLFlatMap const &toComp) const
+    {
+        return _keys == toComp._keys && _values == toComp._values;
+    }
+
+    bool operator!=(VLFlatMap const &toComp) const
+    {
+        return !(*this == toComp);
+    }
+
+    iterator begin() noexcept
+    {
+        return iterator(this, FIRST_IDX);
+    }
+
+    iterator end() noexcept
+    {
+        return iterator(this, size());
+    }
+
+    const_iterator begin() const noexcept
+    {
+        return const_iterator(this, FIRST_IDX);
+    }
+
+    const_iterator end() const noexcept
+    {
+        return const_iterator(this, size());
+    }
+
+    const_iterator cbegin() const noexcept
+    {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept
+    {
+        return end();
+    }
+};
+
+/**
+ * A sorted set of unique keys, iterated as the contiguous array of the keys.
+ * @tparam K The type of the keys.
+ * @tparam StaticCapacity The amount of keys held without allocating.
+ * @tparam Compare The order of the keys.
+ */
+template<class K, size_t StaticCapacity = DEFAULT_STATIC_CAPACITY, class Compare = std::less<K>>
+class VLFlatSet
+{
+private:
+    VLVector<K, StaticCapacity> _keys;
+    Compare _comp;
+
+    size_t _lowerBound(K const &key) const noexcept
+    {
+        return vlvflat::lowerBound(_keys.data(), _keys.size(), key, _comp);
+    }
+
+    size_t _find(K const &key) const noexcept
+    {
+        size_t idx = _lowerBound(key);
+        return idx < size() && !_comp(key, _keys[idx]) ? idx : size();
+    }
+
+public:
+    typedef K key_type;
+    typedef K value_type;
+    typedef size_t size_type;
+    typedef K const *iterator;
+    typedef K const *const_iterator;
+
+    /**
+     * @brief A regular c'tor.
+     */
+    explicit VLFlatSet(Compare const &comp = Compare()) : _comp(comp)
+    {
+    }
+
+    /**
+     * @brief A c'tor from a set of keys.
+     * @tparam InputIterator The iterator that is given by the user.
+     */
+    template<class InputIterator>
+    VLFlatSet(InputIterator first, InputIterator last, Compare const &comp = Compare()) : _comp(comp)
+    {
+        insert_range(first, last);
+    }
+
+    size_t size() const noexcept
+    {
+        return _keys.size();
+    }
+
+    bool empty() const noexcept
+    {
+        return _keys.empty();
+    }
+
+    void clear() noexcept
+    {
+        _keys.clear();
+    }
+
+    /**
+     * @return The keys, sorted.
+     */
+    VLVector<K, StaticCapacity> const &keys() const noexcept
+    {
+        return _keys;
+    }
+
+    const_iterator find(K const &key) const noexcept
+    {
+        return begin() + _find(key);
+    }
+
+    /**
+     * @return An iterator to the first key which is not before key.
+     */
+    const_iterator lower_bound(K const &key) const noexcept
+    {
+        return begin() + _lowerBound(key);
+    }
+
+    bool contains(K const &key) const noexcept
+    {
+        return _find(key) != size();
+    }
+
+    size_t count(K const &key) const noexcept
+    {
+        return contains(key);
+    }
+
+    /**
+     * @brief Inserts key, unless it is already there.
+     * @return An iterator to key, and true if it was inserted.
+     */
+    std::pair<const_iterator, bool> insert(K const &key)
+    {
+        size_t idx = _lowerBound(key);
+        bool missing = idx == size() || _comp(key, _keys[idx]);
+        if (missing)
+        {
+            _keys.insert(_keys.cbegin() + idx, key);
+        }
+        return {begin() + idx, missing};
+    }
+
+    /**
+     * @brief Inserts all of the keys between first and last which are not there yet. The keys are sorted, by the
+     * sorting networks and radix sort of VLVectorSort.hpp in the default order, and merged from the back into the
+     * array grown once.
+     */
+    template<class InputIterator>
+    void insert_range(InputIterator first, InputIterator last)
+    {
+        VLVector<K, StaticCapacity> added(first, last);
+        if constexpr (vlvflat::IsDefaultOrder<K, Compare>::value)
+        {
+            sort(added);
+        }
+        else
+        {
+            sort(added, _comp);
+        }
+        size_t unique = FIRST_IDX;
+        for (size_t idx = FIRST_IDX; idx < added.size(); ++idx)
+        {
+            if (unique == FIRST_IDX || _comp(added[unique - NEXT_ELEM], added[idx]))
+            {
+                added[unique++] = added[idx];
+            }
+        }
+        size_t oldSize = size();
+        _keys.resize(oldSize + unique);
+        size_t out = oldSize + unique;
+        size_t old = oldSize;
+        while (unique != FIRST_IDX)
+        {
+            K const &next = added[unique - NEXT_ELEM];
+            if (old != FIRST_IDX && _comp(next, _keys[old - NEXT_ELEM]))
+            {
+                _keys[--out] = _keys[--old];
+            }
+            else if (old != FIRST_IDX && !_comp(_keys[old - NEXT_ELEM], next))
+            {
+                --unique; //the key is there already.
+            }
+            else
+            {
+                _keys[--out] = next;
+                --unique;
+            }
+        }
+        size_t dropped = out - old; //the keys which were there already left a gap before the merged keys.
+        std::copy(_keys.begin() + out, _keys.end(), _keys.begin() + old);
+        _keys.resize(_keys.size() - dropped);
+    }
+
+    /**
+     * @brief Erases key, if it is there.
+     * @return The amount of erased keys.
+     */
+    size_t erase(K const &key)
+    {
+        size_t idx = _find(key);
+        if (idx == size())
+        {
+            return STARTING_SIZE;
+        }
+        _keys.erase(_keys.cbegin() + idx);
+        return NEXT_ELEM;
+    }
+
+    /**
+     * @brief Erases The key that iter points to.
+     * @return An iterator pointing to the next key.
+     */
+    const_iterator erase(const_iterator iter)
+    {
+        size_t idx = (size_t) (iter - begin());
+        _keys.erase(_keys.cbegin() + idx);
+        return begin() + idx;
+    }
+
+    /**
+     * @return true if both of the sets hold equal keys.
+     */
+    bool operator==(VLFlatSet const &toComp) const
+    {
+        return _keys == toComp._keys;
+    }
+
+    bool operator!=(VLFlatSet const &toComp) const
+    {
+        return !(*this == toComp);
+    }
+
+    const_iterator begin() const noexcept
+    {
+        return _keys.cbegin();
+    }
+
+    const_iterator end() const noexcept
+    {
+        return _keys.cend();
+    }
+
+    const_iterator cbegin() const noexcept
+    {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept
+    {
+        return end();
+    }
+};
+
+
+#endif //CPP_EXAM_VLFLATMAP_HPP
@@ -0,0 +1,465 @@
+/**
+ * @file VLGapVector.hpp
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ *
+ * @brief A virtual length gap buffer, for edits clustered around a moving position.
+ *
+ * @section DESCRIPTION VLGapVector<T, StaticCapacity> keeps its free capacity as a gap inside the elements rather than
+ * after them, and the gap stays where the last edit was. Inserting or erasing at the gap costs only the edited
+ * elements; an edit elsewhere first moves the gap there, copying just the elements between the two places. A run of
+ * inserts at a moving cursor, or a run of erases before or after it, is then O(1) amortized per element, where
+ * VLVector::insert shifts the whole tail every time. The storage strategy is that of VLVector, static until the
+ * elements do not fit. data() and span() close the gap by moving it to the end, so the elements are contiguous again.
+ */
+#ifndef CPP_EXAM_VLGAPVECTOR_HPP
+#define CPP_EXAM_VLGAPVECTOR_HPP
+
+#include "VLIndexIterator.hpp"
+#include "VLVector.hpp"
+#include "VLVectorView.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+
+/**
+ * A Virtual length gap buffer. Holds up to StaticCapacity elements in its static storage.
+ * @tparam T The type of the elements.
+ */
+template<class T, size_t StaticCapacity = DEFAULT_STATIC_CAPACITY>
+class VLGapVector
+{
+private:
+    T _statData[StaticCapacity];
+    T *_curData = _statData;
+    size_t _size = STARTING_SIZE;
+    size_t _capacity = StaticCapacity;
+    size_t _gapStart = FIRST_IDX; //the place of the gap, which is also the index of the element after it.
+
+    bool _dynamic() const noexcept
+    {
+        return _curData != _statData;
+    }
+
+    /**
+     * @return The place in the storage after the gap.
+     */
+    size_t _gapEnd() const noexcept
+    {
+        return _gapStart + _capacity - _size;
+    }
+
+    /**
+     * @return The place in the storage of element idx.
+     */
+    size_t _place(size_t idx) const noexcept
+    {
+        return idx < _gapStart ? idx : idx + _capacity - _size;
+    }
+
+    /**
+     * @brief Moves the gap to before element idx, copying the elements between the old place and the new one across.
+     */
+    void _moveGap(size_t idx)
+    {
+        if (idx < _gapStart)
+        {
+            std::copy_backward(_curData + idx, _curData + _gapStart, _curData + _gapEnd());
+        }
+        else
+        {
+            std::copy(_curData + _gapEnd(), _curData + _gapEnd() + (idx - _gapStart), _curData + _gapStart);
+        }
+        _gapStart = idx;
+    }
+
+    /**
+     * @brief Copies the elements to to, which holds newCapacity elements, with the gap before element gapAt, and makes
+     * it the storage. Frees the old storage if dynamically allocated.
+     */
+    void _moveTo(T *to, size_t newCapacity, size_t gapAt)
+    {
+        size_t newGapLength = newCapacity - _size;
+        for (size_t idx = FIRST_IDX; idx < _size; ++idx)
+        {
+            to[idx < gapAt ? idx : idx + newGapLength] = _curData[_place(idx)];
+        }
+        if (_dynamic())
+        {
+            delete[] _curData;
+        }
+        _curData = to;
+        _capacity = newCapacity;
+        _gapStart = gapAt;
+    }
+
+    /**
+     * @brief Makes room for added elements before element idx: moves the gap there, or grows by the formula of
+     * VLVector with the gap placed there.
+     */
+    void _openGap(size_t idx, size_t added)
+    {
+        if (added > _capacity - _size)
+        {
+            size_t newCapacity = (_size + added + INCREASE_INC) * INCREASE_FACTOR;
+            _moveTo(new T[newCapacity](), newCapacity, idx);
+        }
+        else
+        {
+            _moveGap(idx);
+        }
+    }
+
+    /**
+     * @brief Moves the elements back to the static storage if they fit there, see SHRINK_TO_STATIC. The gap stays
+     * where it is.
+     */
+    void _shrink()
+    {
+        if (SHRINK_TO_STATIC && _size <= StaticCapacity && _dynamic())
+        {
+            _moveTo(_statData, StaticCapacity, _gapStart);
+        }
+    }
+
+    /**
+     * @brief Replaces the content by a copy of rhs, with the gap at the end, sized like the copy of VLVector. The new
+     * array is allocated before the old one is freed, so a bad_alloc leaves the VLGapVector as it was.
+     */
+    void _assign(VLGapVector const &rhs)
+    {
+        if (rhs._size > _capacity)
+        {
+            T *temp = new T[rhs._size]();
+            if (_dynamic())
+            {
+                delete[] _curData;
+            }
+            _curData = temp;
+            _capacity = rhs._size;
+        }
+        else if (SHRINK_TO_STATIC && rhs._size <= StaticCapacity && _dynamic())
+        {
+            delete[] _curData;
+            _curData = _statData;
+            _capacity = StaticCapacity;
+        }
+        for (size_t idx = FIRST_IDX; idx < rhs._size; ++idx)
+        {
+            _curData[idx] = rhs[idx];
+        }
+        _size = rhs._size;
+        _gapStart = _size;
+    }
+
+public:
+    typedef T value_type;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    typedef T &reference;
+    typedef T const &const_reference;
+    typedef VLIndexIterator<VLGapVector, T, false> iterator;
+    typedef VLIndexIterator<VLGapVector, T, true> const_iterator;
+
+    /**
+     * @brief A regular c'tor.
+     */
+    VLGapVector() = default;
+
+    /**
+     * @brief A copy ctor.
+     */
+    VLGapVector(VLGapVector const &toCopy)
+    {
+        _assign(toCopy);
+    }
+
+    /**
+     * @brief A c'tor from a set of items.
+     * @tparam InputIterator The iterator that is given by the user.
+     */
+    template<class InputIterator>
+    VLGapVector(InputIterator first, InputIterator last)
+    {
+        while (first != last)
+        {
+            push_back(*(first++));
+        }
+    }
+
+    /**
+     * @brief Destructor. Frees data if dynamically allocated.
+     */
+    ~VLGapVector()
+    {
+        if (_dynamic())
+        {
+            delete[] _curData;
+        }
+    }
+
+    /**
+     * @brief Assigns values equal to the values of rhs to the VLGapVector.
+     */
+    VLGapVector &operator=(VLGapVector const &rhs)
+    {
+        if (this != &rhs)
+        {
+            _assign(rhs);
+        }
+        return *this;
+    }
+
+    size_t size() const noexcept
+    {
+        return _size;
+    }
+
+    /**
+     * @return The current capacity the container can hold before it will have to grow.
+     */
+    size_t capacity() const noexcept
+    {
+        return _capacity;
+    }
+
+    bool empty() const noexcept
+    {
+        return _size == STARTING_SIZE;
+    }
+
+    /**
+     * @return The index of the element after the gap, where the next edit is cheapest.
+     */
+    size_t gap() const noexcept
+    {
+        return _gapStart;
+    }
+
+    /**
+     * @brief Adds toAdd to the end of the container, moving the gap there.
+     */
+    void push_back(const T &toAdd)
+    {
+        insert(cend(), toAdd);
+    }
+
+    /**
+     * @brief Removes the last element of the container.
+     * Doesn't call item destructor, like VLVector::pop_back.
+     */
+    void pop_back()
+    {
+        erase(cend() - NEXT_ELEM);
+    }
+
+    /**
+     * @brief Inserts toAdd before iter, leaving the gap after it.
+     * @return An iterator pointing to the new element.
+     */
+    iterator insert(const_iterator iter, const T &toAdd)
+    {
+        size_t idx = (size_t) (iter - cbegin());
+        T value = toAdd; //toAdd may be an element which is about to move.
+        _openGap(idx, NEXT_ELEM);
+        _curData[_gapStart++] = value;
+        ++_size;
+        return iterator(this, idx);
+    }
+
+    /**
+     * @brief Adds all of the elements between first and last before iter, leaving the gap after them. Single pass
+     * iterators can only be counted by reading them, so their elements are inserted at the gap one by one as they are
+     * read, which is O(1) amortized each.
+     * @return An iterator pointing to the first element of the new ones.
+     */
+    template<class InputIterator>
+    iterator insert(const_iterator iter, InputIterator first, InputIterator const last)
+    {
+        size_t idx = (size_t) (iter - cbegin());
+        if constexpr (!std::is_base_of<std::forward_iterator_tag,
+                                       typename std::iterator_traits<InputIterator>::iterator_category>::value)
+        {
+            for (size_t at = idx; first != last; ++first, ++at)
+            {
+                insert(cbegin() + at, *first);
+            }
+            return iterator(this, idx);
+        }
+        size_t added = (size_t) std::distance(first, last);
+        _openGap(idx, added);
+        std::copy(first, last, _curData + _gapStart);
+        _gapStart += added;
+        _size += added;
+        return iterator(this, idx);
+    }
+
+    /**
+     * @brief Erases The element that iter points to.
+     * @return An iterator pointing to the next element.
+     */
+    iterator erase(const_iterator iter)
+    {
+        return erase(iter, iter + NEXT_ELEM);
+    }
+
+    /**
+     * @brief Erases all of the elements between first and last by joining them to the gap. The gap moves to whichever
+     * end of the range is closer to it.
+     * @return An iterator pointing to the next element.
+     * Doesn't call item destructor, like VLVector::erase.
+     */
+    iterator erase(const_iterator first, const_iterator last)
+    {
+        size_t begin = (size_t) (first - cbegin());
+        size_t end = (size_t) (last - cbegin());
+        if (end <= _gapStart)
+        {
+            _moveGap(end);
+            _gapStart = begin;
+        }
+        else
+        {
+            _moveGap(begin);
+        }
+        _size -= end - begin;
+        _shrink();
+        return iterator(this, begin);
+    }
+
+    /**
+     * @brief Deletes all of the elements. Frees the array if dynamically allocated.
+     */
+    void clear() noexcept
+    {
+        if (_dynamic())
+        {
+            delete[] _curData;
+            _curData = _statData;
+            _capacity = StaticCapacity;
+        }
+        _size = STARTING_SIZE;
+        _gapStart = FIRST_IDX;
+    }
+
+    /**
+     * @brief Closes the gap by moving it to the end.
+     * @return A pointer to the elements, which are contiguous until the next edit.
+     */
+    T *data()
+    {
+        _moveGap(_size);
+        return _curData;
+    }
+
+    /**
+     * @brief Closes the gap, see data().
+     * @return A span of the elements.
+     */
+    VLSpan<T> span()
+    {
+        return VLSpan<T>(data(), _size);
+    }
+
+    const T &operator[](size_t idx) const noexcept
+    {
+        return _curData[_place(idx)];
+    }
+
+    T &operator[](size_t idx) noexcept
+    {
+        return _curData[_place(idx)];
+    }
+
+    /**
+     * @brief returns the element at place idx. @throws std::out_of_range if the idx is illegal. const version.
+     */
+    const T &at(size_t idx) const
+    {
+        if (idx >= _size)
+        {
+            throw std::out_of_range(OUT_OF_RANGE_MSG);
+        }
+        return (*this)[idx];
+    }
+
+    /**
+     * @brief returns the element at place idx. @throws std::out_of_range if the idx is illegal.
+     */
+    T &at(size_t idx)
+    {
+        if (idx >= _size)
+        {
+            throw std::out_of_range(OUT_OF_RANGE_MSG);
+        }
+        return (*this)[idx];
+    }
+
+    T &front() noexcept
+    {
+        return (*this)[FIRST_IDX];
+    }
+
+    const T &front() const noexcept
+    {
+        return (*this)[FIRST_IDX];
+    }
+
+    T &back() noexcept
+    {
+        return (*this)[_size - NEXT_ELEM];
+    }
+
+    const T &back() const noexcept
+    {
+        return (*this)[_size - NEXT_ELEM];
+    }
+
+    /**
+     * @return true if all of the elements in both of the containers are equal, in order, wherever their gaps are.
+     */
+    bool operator==(VLGapVector const &toComp) const
+    {
+        return _size == toComp._size && std::equal(begin(), end(), toComp.begin());
+    }
+
+    bool operator!=(VLGapVector const &toComp) const
+    {
+        return !(*this == toComp);
+    }
+
+    iterator begin() noexcept
+    {
+        return iterator(this, FIRST_IDX);
+    }
+
+    iterator end() noexcept
+    {
+        return iterator(this, _size);
+    }
+
+    const_iterator begin() const noexcept
+    {
+        return const_iterator(this, FIRST_IDX);
+    }
+
+    const_iterator end() const noexcept
+    {
+        return const_iterator(this, _size);
+    }
+
+    const_iterator cbegin() const noexcept
+    {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept
+    {
+        return end();
+    }
+};
+
+
+#endif //CPP_EXAM_VLGAPVECTOR_HPP
@@ -0,0 +1,868 @@
+/**
+ * @file VLHashMap.hpp
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ *
+ * @brief Open addressing hash containers with inline slots: VLHashMap and VLHashSet.
+ *
+ * @section DESCRIPTION The table follows the SwissTable design. Every slot has a control byte: empty, deleted, or
+ * the low HASH_TAG_BITS bits of the hash of its key while it is full. The slots are probed in groups of
+ * HASH_GROUP_WIDTH, and a single SSE2 comparison of the control bytes of a group finds the slots whose tag matches, so
+ * keys are compared only for those. Groups are probed triangularly: 0, 1, 3, 6... groups away from the home group of
+ * the rest of the hash, which visits every group of a power of two table.
+ * The control bytes and the slots are kept in static storage for StaticCapacity slots, rounded up to a power of two
+ * which is at least a group, like the elements of a VLVector, and move to the heap when the table is rehashed to a
+ * larger capacity. Up to HASH_LINEAR_MAX entries are kept densely at the start of the table and searched by a plain
+ * linear scan, without hashing; the table switches to hashing once it holds more. Erasing in a group which is full
+ * leaves a tombstone, and the table is rehashed once the entries and the tombstones reach the maximal load: in place
+ * when at most half of that is entries, to double the capacity otherwise.
+ */
+#ifndef CPP_EXAM_VLHASHMAP_HPP
+#define CPP_EXAM_VLHASHMAP_HPP
+
+#include "VLVector.hpp"
+#include "VLVectorSimd.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#ifdef __SSE2__
+
+#include <emmintrin.h>
+
+#endif
+
+#define HASH_GROUP_WIDTH 16
+
+#define HASH_TAG_BITS 7
+
+#define HASH_TAG_MASK 0x7F
+
+#define HASH_CTRL_EMPTY ((int8_t) -128)
+
+#define HASH_CTRL_DELETED ((int8_t) -2)
+
+#define HASH_LINEAR_MAX 8
+
+#define HASH_LOAD_NUMERATOR 7
+
+#define HASH_LOAD_DENOMINATOR 8
+
+#define HASH_MULTIPLIER 0x9e3779b97f4a7c15ull
+
+#define HASH_MIX_SHIFT 32
+
+#define HASH_MISSING_KEY_MSG "VLHashMap: the key is missing"
+
+namespace vlvhash
+{
+    /**
+     * @return The amount of slots of a table: the smallest power of two which is at least n and at least a group.
+     */
+    constexpr size_t slotsFor(size_t n)
+    {
+        size_t slots = HASH_GROUP_WIDTH;
+        while (slots < n)
+        {
+            slots *= 2;
+        }
+        return slots;
+    }
+
+    /**
+     * @return The amount of entries and tombstones at which a table of capacity slots is rehashed: 7/8 of it. The
+     * capacity is a multiple of a group, so the division is exact.
+     */
+    constexpr size_t maxLoad(size_t capacity) noexcept
+    {
+        return capacity / HASH_LOAD_DENOMINATOR * HASH_LOAD_NUMERATOR;
+    }
+
+    /**
+     * @return A bit mask of the control bytes of the group which are equal to ctrl.
+     */
+    inline unsigned matchGroup(const int8_t *group, int8_t ctrl) noexcept
+    {
+#ifdef __SSE2__
+        typedef typename vlvsimd::Vec<int8_t, HASH_GROUP_WIDTH>::type V;
+        V bytes;
+        vlvsimd::load(bytes, group);
+        return (unsigned) _mm_movemask_epi8((__m128i) (bytes == (V{} + ctrl)));
+#else
+        unsigned mask = 0;
+        for (size_t i = FIRST_IDX; i < HASH_GROUP_WIDTH; ++i)
+        {
+            mask |= (unsigned) (group[i] == ctrl) << i;
+        }
+        return mask;
+#endif
+    }
+
+    /**
+     * @return A bit mask of the slots of the group which are empty or deleted: the control bytes with the sign bit.
+     */
+    inline unsigned matchFree(const int8_t *group) noexcept
+    {
+#ifdef __SSE2__
+        __m128i bytes;
+        std::memcpy(&bytes, group, sizeof(bytes));
+        return (unsigned) _mm_movemask_epi8(bytes);
+#else
+        unsigned mask = 0;
+        for (size_t i = FIRST_IDX; i < HASH_GROUP_WIDTH; ++i)
+        {
+            mask |= (unsigned) (group[i] < 0) << i;
+        }
+        return mask;
+#endif
+    }
+
+    /**
+     * The key of a slot of a map.
+     */
+    struct MapKey
+    {
+        template<class K, class V>
+        static K const &of(std::pair<K, V> const &slot) noexcept
+        {
+            return slot.first;
+        }
+    };
+
+    /**
+     * The key of a slot of a set, which is the slot itself.
+     */
+    struct SetKey
+    {
+        template<class K>
+        static K const &of(K const &slot) noexcept
+        {
+            return slot;
+        }
+    };
+}
+
+/**
+ * The table of VLHashMap and VLHashSet.
+ * @tparam K The type of the keys.
+ * @tparam Slot The type of the slots, which hold the keys.
+ * @tparam KeyOf Gets the key of a slot.
+ * @tparam StaticCapacity The amount of slots held without allocating, before rounding.
+ * @tparam Hash The hash of the keys.
+ * @tparam KeyEqual The equality of the keys.
+ */
+template<class K, class Slot, class KeyOf, size_t StaticCapacity, class Hash, class KeyEqual>
+class VLHashTable
+{
+public:
+    /**
+     * The amount of slots in static storage.
+     */
+    static constexpr size_t STATIC_SLOTS = vlvhash::slotsFor(StaticCapacity);
+
+private:
+    int8_t _statCtrl[STATIC_SLOTS];
+    Slot _statSlots[STATIC_SLOTS];
+    int8_t *_ctrl = _statCtrl;
+    Slot *_slots = _statSlots;
+    size_t _capacity = STATIC_SLOTS;
+    size_t _size = STARTING_SIZE;
+    size_t _tombstones = STARTING_SIZE;
+    bool _linear = true;
+    Hash _hasher;
+    KeyEqual _equal;
+
+    bool _dynamic() const noexcept
+    {
+        return _slots != _statSlots;
+    }
+
+    /**
+     * @return The hash of key, mixed so that both the tag and the group bits depend on all of its bits.
+     */
+    size_t _hash(K const &key) const
+    {
+        uint64_t hash = (uint64_t) _hasher(key) * HASH_MULTIPLIER;
+        return (size_t) (hash ^ (hash >> HASH_MIX_SHIFT));
+    }
+
+    size_t _groupMask() const noexcept
+    {
+        return _capacity / HASH_GROUP_WIDTH - NEXT_ELEM;
+    }
+
+    /**
+     * @return The slot of key, or capacity().
+     */
+    size_t _find(K const &key) const
+    {
+        if (_linear)
+        {
+            for (size_t idx = FIRST_IDX; idx < _size; ++idx)
+            {
+                if (_equal(KeyOf::of(_slots[idx]), key))
+                {
+                    return idx;
+                }
+            }
+            return _capacity;
+        }
+        size_t hash = _hash(key);
+        int8_t tag = (int8_t) (hash & HASH_TAG_MASK);
+        size_t groupMask = _groupMask();
+        size_t group = (hash >> HASH_TAG_BITS) & groupMask;
+        for (size_t step = NEXT_ELEM;; group = (group + step++) & groupMask)
+        {
+            const int8_t *ctrl = _ctrl + group * HASH_GROUP_WIDTH;
+            for (unsigned match = vlvhash::matchGroup(ctrl, tag); match; match &= match - 1)
+            {
+                size_t idx = group * HASH_GROUP_WIDTH + (size_t) __builtin_ctz(match);
+                if (_equal(KeyOf::of(_slots[idx]), key))
+                {
+                    return idx;
+                }
+            }
+            if (vlvhash::matchGroup(ctrl, HASH_CTRL_EMPTY))
+            {
+                return _capacity;
+            }
+        }
+    }
+
+    /**
+     * @return The first empty or deleted slot in the probe sequence of hash.
+     */
+    size_t _firstFree(size_t hash) const noexcept
+    {
+        size_t groupMask = _groupMask();
+        size_t group = (hash >> HASH_TAG_BITS) & groupMask;
+        unsigned free = vlvhash::matchFree(_ctrl + group * HASH_GROUP_WIDTH);
+        for (size_t step = NEXT_ELEM; !free; ++step)
+        {
+            group = (group + step) & groupMask;
+            free = vlvhash::matchFree(_ctrl + group * HASH_GROUP_WIDTH);
+        }
+        return group * HASH_GROUP_WIDTH + (size_t) __builtin_ctz(free);
+    }
+
+    /**
+     * @brief Marks the first free slot in the probe sequence of key full. key must be missing.
+     * @return The slot.
+     */
+    size_t _claim(K const &key)
+    {
+        size_t hash = _hash(key);
+        size_t idx = _firstFree(hash);
+        _tombstones -= _ctrl[idx] == HASH_CTRL_DELETED;
+        _ctrl[idx] = (int8_t) (hash & HASH_TAG_MASK);
+        ++_size;
+        return idx;
+    }
+
+    /**
+     * @brief Hashes the entries again within the current slots, dropping the tombstones. Every entry is marked
+     * deleted, then placed in turn: kept if its probe sequence reaches its own group first, moved if it reaches an
+     * empty slot, and swapped with the entry there if it reaches another one not placed yet, which is then placed.
+     */
+    void _rehashInPlace()
+    {
+        for (size_t idx = FIRST_IDX; idx < _capacity; ++idx)
+        {
+            _ctrl[idx] = _ctrl[idx] >= 0 ? HASH_CTRL_DELETED : HASH_CTRL_EMPTY;
+        }
+        _tombstones = STARTING_SIZE;
+        _linear = false;
+        for (size_t idx = FIRST_IDX; idx < _capacity; ++idx)
+        {
+            while (_ctrl[idx] == HASH_CTRL_DELETED)
+            {
+                size_t hash = _hash(KeyOf::of(_slots[idx]));
+                int8_t tag = (int8_t) (hash & HASH_TAG_MASK);
+                size_t to = _firstFree(hash);
+                if (to / HASH_GROUP_WIDTH == idx / HASH_GROUP_WIDTH)
+                {
+                    _ctrl[idx] = tag;
+                }
+                else if (_ctrl[to] == HASH_CTRL_EMPTY)
+                {
+                    _slots[to] = std::move(_slots[idx]);
+                    _ctrl[to] = tag;
+                    _ctrl[idx] = HASH_CTRL_EMPTY;
+                }
+                else
+                {
+                    std::swap(_slots[to], _slots[idx]);
+                    _ctrl[to] = tag;
+                }
+            }
+        }
+    }
+
+    /**
+     * @return The control bytes and the slots of a table of capacity slots: the static ones if it fits there, else new
+     * arrays. Both are allocated before either is returned, so a bad_alloc leaks neither and changes nothing.
+     */
+    std::pair<int8_t *, Slot *> _storage(size_t capacity)
+    {
+        if (capacity <= STATIC_SLOTS)
+        {
+            return {_statCtrl, _statSlots};
+        }
+        std::unique_ptr<int8_t[]> ctrl(new int8_t[capacity]);
+        Slot *slots = new Slot[capacity]();
+        return {ctrl.release(), slots};
+    }
+
+    /**
+     * @brief Moves the entries to a hashed table of newCapacity slots, in static storage if it fits there, dropping
+     * the tombstones. The entries are moved from the old slots to the new ones directly.
+     */
+    void _rehash(size_t newCapacity)
+    {
+        if (newCapacity == _capacity)
+        {
+            _rehashInPlace();
+            return;
+        }
+        std::pair<int8_t *, Slot *> storage = _storage(newCapacity);
+        int8_t *oldCtrl = _ctrl;
+        Slot *oldSlots = _slots;
+        size_t oldCapacity = _capacity;
+        bool wasDynamic = _dynamic();
+        _ctrl = storage.first;
+        _slots = storage.second;
+        _capacity = newCapacity;
+        std::memset(_ctrl, HASH_CTRL_EMPTY, _capacity);
+        _size = STARTING_SIZE;
+        _tombstones = STARTING_SIZE;
+        _linear = false;
+        for (size_t idx = FIRST_IDX; idx < oldCapacity; ++idx)
+        {
+            if (oldCtrl[idx] >= 0)
+            {
+                _slots[_claim(KeyOf::of(oldSlots[idx]))] = std::move(oldSlots[idx]);
+            }
+        }
+        if (wasDynamic)
+        {
+            delete[] oldCtrl;
+            delete[] oldSlots;
+        }
+    }
+
+    /**
+     * @brief Replaces the content by a copy of rhs, with the same capacity and slots. The new arrays are allocated
+     * before the old ones are freed, so a bad_alloc leaves the table as it was.
+     */
+    void _assign(VLHashTable const &rhs)
+    {
+        std::pair<int8_t *, Slot *> storage = _storage(rhs._capacity);
+        if (_dynamic())
+        {
+            delete[] _ctrl;
+            delete[] _slots;
+        }
+        _ctrl = storage.first;
+        _slots = storage.second;
+        _capacity = rhs._capacity;
+        std::memcpy(_ctrl, rhs._ctrl, _capacity);
+        std::copy(rhs._slots, rhs._slots + _capacity, _slots);
+        _size = rhs._size;
+        _tombstones = rhs._tombstones;
+        _linear = rhs._linear;
+        _hasher = rhs._hasher;
+        _equal = rhs._equal;
+    }
+
+protected:
+    /**
+     * @brief Finds the slot of key, claiming one for it if it is missing. Growing or rehashing happens here.
+     * @return The slot, and true if it was claimed for key, in which case the caller writes the slot.
+     */
+    std::pair<size_t, bool> _findOrClaim(K const &key)
+    {
+        size_t idx = _find(key);
+        if (idx != _capacity)
+        {
+            return {idx, false};
+        }
+        if (_linear)
+        {
+            if (_size < HASH_LINEAR_MAX)
+            {
+                _ctrl[_size] = FIRST_IDX; //any tag marks the slot full.
+                return {_size++, true};
+            }
+            _rehash(_capacity);
+        }
+        size_t load = vlvhash::maxLoad(_capacity);
+        if (_size + _tombstones >= load)
+        {
+            _rehash(2 * _size >= load ? 2 * _capacity : _capacity);
+        }
+        return {_claim(key), true};
+    }
+
+    Slot &_slot(size_t idx) noexcept
+    {
+        return _slots[idx];
+    }
+
+public:
+    typedef K key_type;
+    typedef Slot value_type;
+    typedef size_t size_type;
+
+    /**
+     * @brief A forward iterator over the full slots.
+     * @tparam Const Indicator for const_iterator.
+     */
+    template<bool Const>
+    class Iterator
+    {
+    private:
+        typedef std::conditional_t<Const, VLHashTable const, VLHashTable> Owner;
+
+        Owner *_owner = nullptr;
+        size_t _idx = FIRST_IDX;
+
+        template<bool> friend
+        class Iterator;
+
+        friend class VLHashTable;
+
+        /**
+         * @brief Moves on to the first full slot from the current one on.
+         */
+        void _skipFree() noexcept
+        {
+            while (_idx < _owner->_capacity && _owner->_ctrl[_idx] < 0)
+            {
+                ++_idx;
+            }
+        }
+
+    public:
+        typedef Slot value_type;
+        typedef ptrdiff_t difference_type;
+        typedef std::forward_iterator_tag iterator_category;
+        typedef std::conditional_t<Const, Slot const &, Slot &> reference;
+        typedef std::conditional_t<Const, Slot const *, Slot *> pointer;
+
+        Iterator() noexcept = default;
+
+        Iterator(Owner *owner, size_t idx) noexcept : _owner(owner), _idx(idx)
+        {
+            _skipFree();
+        }
+
+        /**
+         * @brief Converts an iterator to a const_iterator.
+         */
+        template<bool IsConst = Const, class = std::enable_if_t<IsConst>>
+        Iterator(Iterator<false> const &other) noexcept : _owner(other._owner), _idx(other._idx)
+        {
+        }
+
+        reference operator*() const noexcept
+        {
+            return _owner->_slots[_idx];
+        }
+
+        pointer operator->() const noexcept
+        {
+            return _owner->_slots + _idx;
+        }
+
+        Iterator &operator++() noexcept
+        {
+            ++_idx;
+            _skipFree();
+            return *this;
+        }
+
+        Iterator operator++(int) noexcept
+        {
+            Iterator temp = *this;
+            ++*this;
+            return temp;
+        }
+
+        friend bool operator==(Iterator const &lhs, Iterator const &rhs) noexcept
+        {
+            return lhs._idx == rhs._idx;
+        }
+
+        friend bool operator!=(Iterator const &lhs, Iterator const &rhs) noexcept
+        {
+            return lhs._idx != rhs._idx;
+        }
+    };
+
+    typedef Iterator<false> iterator;
+    typedef Iterator<true> const_iterator;
+
+    /**
+     * @brief A regular c'tor.
+     */
+    VLHashTable()
+    {
+        std::memset(_statCtrl, HASH_CTRL_EMPTY, STATIC_SLOTS);
+    }
+
+    /**
+     * @brief A copy ctor.
+     */
+    VLHashTable(VLHashTable const &toCopy)
+    {
+        _assign(toCopy);
+    }
+
+    /**
+     * @brief Destructor. Frees the slots if dynamically allocated.
+     */
+    ~VLHashTable()
+    {
+        if (_dynamic())
+        {
+            delete[] _ctrl;
+            delete[] _slots;
+        }
+    }
+
+    VLHashTable &operator=(VLHashTable const &rhs)
+    {
+        if (this != &rhs)
+        {
+            _assign(rhs);
+        }
+        return *this;
+    }
+
+    size_t size() const noexcept
+    {
+        return _size;
+    }
+
+    bool empty() const noexcept
+    {
+        return _size == STARTING_SIZE;
+    }
+
+    /**
+     * @return The amount of slots.
+     */
+    size_t capacity() const noexcept
+    {
+        return _capacity;
+    }
+
+    /**
+     * @brief Rehashes to a capacity which holds n entries below the maximal load, if the current one does not.
+     */
+    void reserve(size_t n)
+    {
+        size_t newCapacity = _capacity;
+        while (n >= vlvhash::maxLoad(newCapacity))
+        {
+            newCapacity *= 2;
+        }
+        if (newCapacity != _capacity)
+        {
+            _rehash(newCapacity);
+        }
+    }
+
+    /**
+     * @brief Deletes all of the entries. Frees the slots if dynamically allocated.
+     */
+    void clear() noexcept
+    {
+        if (_dynamic())
+        {
+            delete[] _ctrl;
+            delete[] _slots;
+            _ctrl = _statCtrl;
+            _slots = _statSlots;
+            _capacity = STATIC_SLOTS;
+        }
+        std::memset(_ctrl, HASH_CTRL_EMPTY, _capacity);
+        _size = STARTING_SIZE;
+        _tombstones = STARTING_SIZE;
+        _linear = true;
+    }
+
+    iterator find(K const &key)
+    {
+        return iterator(this, _find(key));
+    }
+
+    const_iterator find(K const &key) const
+    {
+        return const_iterator(this, _find(key));
+    }
+
+    bool contains(K const &key) const
+    {
+        return _find(key) != _capacity;
+    }
+
+    size_t count(K const &key) const
+    {
+        return contains(key);
+    }
+
+    /**
+     * @brief Erases The entry that iter points to. Linear tables move their last entry to its slot; hashed ones mark
+     * it empty if its group has an empty slot, since no probe passes such a group, and deleted otherwise.
+     * @return An iterator pointing to the next entry.
+     */
+    iterator erase(const_iterator iter)
+    {
+        size_t idx = iter._idx;
+        --_size;
+        if (_linear)
+        {
+            _slots[idx] = _slots[_size];
+            _ctrl[_size] = HASH_CTRL_EMPTY;
+            return iterator(this, idx);
+        }
+        const int8_t *group = _ctrl + idx / HASH_GROUP_WIDTH * HASH_GROUP_WIDTH;
+        bool open = vlvhash::matchGroup(group, HASH_CTRL_EMPTY);
+        _ctrl[idx] = open ? HASH_CTRL_EMPTY : HASH_CTRL_DELETED;
+        _tombstones += !open;
+        return iterator(this, idx + NEXT_ELEM);
+    }
+
+    /**
+     * @brief Erases the entry of key, if it is there.
+     * @return The amount of erased entries.
+     */
+    size_t erase(K const &key)
+    {
+        size_t idx = _find(key);
+        if (idx == _capacity)
+        {
+            return STARTING_SIZE;
+        }
+        erase(const_iterator(this, idx));
+        return NEXT_ELEM;
+    }
+
+    /**
+     * @return true if both of the tables hold equal entries, wherever their slots are.
+     */
+    bool operator==(VLHashTable const &toComp) const
+    {
+        if (_size != toComp._size)
+        {
+            return false;
+        }
+        for (Slot const &entry : *this)
+        {
+            size_t idx = toComp._find(KeyOf::of(entry));
+            if (idx == toComp._capacity || !(toComp._slots[idx] == entry))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool operator!=(VLHashTable const &toComp) const
+    {
+        return !(*this == toComp);
+    }
+
+    iterator begin() noexcept
+    {
+        return iterator(this, FIRST_IDX);
+    }
+
+    iterator end() noexcept
+    {
+        return iterator(this, _capacity);
+    }
+
+    const_iterator begin() const noexcept
+    {
+        return const_iterator(this, FIRST_IDX);
+    }
+
+    const_iterator end() const noexcept
+    {
+        return const_iterator(this, _capacity);
+    }
+
+    const_iterator cbegin() const noexcept
+    {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept
+    {
+        return end();
+    }
+};
+
+/**
+ * An unordered map of unique keys. The entries are std::pair<K, V>, whose key must not be changed through iterators.
+ * @tparam K The type of the keys.
+ * @tparam V The type of the values.
+ * @tparam StaticCapacity The amount of slots held without allocating, see VLHashTable::STATIC_SLOTS.
+ */
+template<class K, class V, size_t StaticCapacity = DEFAULT_STATIC_CAPACITY, class Hash = std::hash<K>,
+        class KeyEqual = std::equal_to<K>>
+class VLHashMap : public VLHashTable<K, std::pair<K, V>, vlvhash::MapKey, StaticCapacity, Hash, KeyEqual>
+{
+private:
+    typedef VLHashTable<K, std::pair<K, V>, vlvhash::MapKey, StaticCapacity, Hash, KeyEqual> Table;
+
+public:
+    typedef V mapped_type;
+    typedef typename Table::iterator iterator;
+    typedef typename Table::const_iterator const_iterator;
+
+    VLHashMap() = default;
+
+    /**
+     * @brief A c'tor from a set of key and value pairs. The first of equal keys is kept.
+     * @tparam InputIterator The iterator that is given by the user.
+     */
+    template<class InputIterator>
+    VLHashMap(InputIterator first, InputIterator last)
+    {
+        for (; first != last; ++first)
+        {
+            insert(first->first, first->second);
+        }
+    }
+
+    /**
+     * @brief Inserts key with value, unless key is already there.
+     * @return An iterator to the entry of key, and true if it was inserted.
+     */
+    std::pair<iterator, bool> insert(K const &key, V const &value)
+    {
+        std::pair<size_t, bool> found = this->_findOrClaim(key);
+        if (found.second)
+        {
+            this->_slot(found.first) = std::pair<K, V>(key, value);
+        }
+        return {iterator(this, found.first), found.second};
+    }
+
+    /**
+     * @brief Inserts the key and value of entry, unless the key is already there.
+     */
+    std::pair<iterator, bool> insert(std::pair<K, V> const &entry)
+    {
+        return insert(entry.first, entry.second);
+    }
+
+    /**
+     * @brief Inserts key with value, or assigns value to key if it is already there.
+     * @return An iterator to the entry of key, and true if it was inserted.
+     */
+    std::pair<iterator, bool> insert_or_assign(K const &key, V const &value)
+    {
+        std::pair<size_t, bool> found = this->_findOrClaim(key);
+        this->_slot(found.first) = std::pair<K, V>(key, value);
+        return {iterator(this, found.first), found.second};
+    }
+
+    /**
+     * @return The value of key, inserting a default one first if key is missing.
+     */
+    V &operator[](K const &key)
+    {
+        std::pair<size_t, bool> found = this->_findOrClaim(key);
+        std::pair<K, V> &slot = this->_slot(found.first);
+        if (found.second)
+        {
+            slot = std::pair<K, V>(key, V());
+        }
+        return slot.second;
+    }
+
+    /**
+     * @return The value of key. @throws std::out_of_range if key is missing.
+     */
+    V &at(K const &key)
+    {
+        iterator found = this->find(key);
+        if (found == this->end())
+        {
+            throw std::out_of_range(HASH_MISSING_KEY_MSG);
+        }
+        return found->second;
+    }
+
+    /**
+     * @return The value of key. @throws std::out_of_range if key is missing. const version.
+     */
+    V const &at(K const &key) const
+    {
+        const_iterator found = this->find(key);
+        if (found == this->end())
+        {
+            throw std::out_of_range(HASH_MISSING_KEY_MSG);
+        }
+        return found->second;
+    }
+};
+
+/**
+ * An unordered set of unique keys. The keys must not be changed through iterators.
+ * @tparam K The type of the keys.
+ * @tparam StaticCapacity The amount of slots held without allocating, see VLHashTable::STATIC_SLOTS.
+ */
+template<class K, size_t StaticCapacity = DEFAULT_STATIC_CAPACITY, class Hash = std::hash<K>,
+        class KeyEqual = std::equal_to<K>>
+class VLHashSet : public VLHashTable<K, K, vlvhash::SetKey, StaticCapacity, Hash, KeyEqual>
+{
+private:
+    typedef VLHashTable<K, K, vlvhash::SetKey, StaticCapacity, Hash, KeyEqual> Table;
+
+public:
+    typedef typename Table::iterator iterator;
+    typedef typename Table::const_iterator const_iterator;
+
+    VLHashSet() = default;
+
+    /**
+     * @brief A c'tor from a set of keys.
+     * @tparam InputIterator The iterator that is given by the user.
+     */
+    template<class InputIterator>
+    VLHashSet(InputIterator first, InputIterator last)
+    {
+        for (; first != last; ++first)
+        {
+            insert(*first);
+        }
+    }
+
+    /**
+     * @brief Inserts key, unless it is already there.
+     * @return An iterator to key, and true if it was inserted.
+     */
+    std::pair<iterator, bool> insert(K const &key)
+    {
+        std::pair<size_t, bool> found = this->_findOrClaim(key);
+        if (found.second)
+        {
+            this->_slot(found.first) = key;
+        }
+        return {iterator(this, found.first), found.second};
+    }
+};
+
+
+#endif //CPP_EXAM_VLHASHMAP_HPP
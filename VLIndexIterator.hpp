@@ -0,0 +1,163 @@
+/**
+ * @file VLIndexIterator.hpp
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ *
+ * @brief A random access iterator for containers whose elements are not contiguous.
+ *
+ * @section DESCRIPTION VLVector iterates with plain pointers, but the elements of a ring buffer or of a gap buffer are
+ * not in one contiguous run. VLIndexIterator keeps the container and the index of its element instead, and reads the
+ * element through the operator[] of the container, so it stays valid as long as the index does.
+ */
+#ifndef CPP_EXAM_VLINDEXITERATOR_HPP
+#define CPP_EXAM_VLINDEXITERATOR_HPP
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+/**
+ * @brief A random access iterator which keeps the index of its element in Owner.
+ * @tparam Owner The container, with an operator[] by index.
+ * @tparam T The type of the elements.
+ * @tparam Const Indicator for const_iterator.
+ */
+template<class Owner, class T, bool Const>
+class VLIndexIterator
+{
+private:
+    typedef std::conditional_t<Const, Owner const, Owner> Container;
+
+    Container *_owner = nullptr;
+    ptrdiff_t _idx = 0;
+
+    template<class, class, bool> friend
+    class VLIndexIterator;
+
+public:
+    typedef T value_type;
+    typedef ptrdiff_t difference_type;
+    typedef std::random_access_iterator_tag iterator_category;
+    typedef std::conditional_t<Const, T const &, T &> reference;
+    typedef std::conditional_t<Const, T const *, T *> pointer;
+
+    VLIndexIterator() noexcept = default;
+
+    VLIndexIterator(Container *owner, size_t idx) noexcept : _owner(owner), _idx((ptrdiff_t) idx)
+    {
+    }
+
+    /**
+     * @brief Converts an iterator to a const_iterator.
+     */
+    template<bool IsConst = Const, class = std::enable_if_t<IsConst>>
+    VLIndexIterator(VLIndexIterator<Owner, T, false> const &other) noexcept : _owner(other._owner), _idx(other._idx)
+    {
+    }
+
+    reference operator*() const noexcept
+    {
+        return (*_owner)[(size_t) _idx];
+    }
+
+    pointer operator->() const noexcept
+    {
+        return &**this;
+    }
+
+    reference operator[](ptrdiff_t steps) const noexcept
+    {
+        return (*_owner)[(size_t) (_idx + steps)];
+    }
+
+    VLIndexIterator &operator++() noexcept
+    {
+        ++_idx;
+        return *this;
+    }
+
+    VLIndexIterator operator++(int) noexcept
+    {
+        VLIndexIterator temp = *this;
+        ++_idx;
+        return temp;
+    }
+
+    VLIndexIterator &operator--() noexcept
+    {
+        --_idx;
+        return *this;
+    }
+
+    VLIndexIterator operator--(int) noexcept
+    {
+        VLIndexIterator temp = *this;
+        --_idx;
+        return temp;
+    }
+
+    VLIndexIterator &operator+=(ptrdiff_t steps) noexcept
+    {
+        _idx += steps;
+        return *this;
+    }
+
+    VLIndexIterator &operator-=(ptrdiff_t steps) noexcept
+    {
+        _idx -= steps;
+        return *this;
+    }
+
+    friend VLIndexIterator operator+(VLIndexIterator it, ptrdiff_t steps) noexcept
+    {
+        return it += steps;
+    }
+
+    friend VLIndexIterator operator+(ptrdiff_t steps, VLIndexIterator it) noexcept
+    {
+        return it += steps;
+    }
+
+    friend VLIndexIterator operator-(VLIndexIterator it, ptrdiff_t steps) noexcept
+    {
+        return it -= steps;
+    }
+
+    friend ptrdiff_t operator-(VLIndexIterator const &lhs, VLIndexIterator const &rhs) noexcept
+    {
+        return lhs._idx - rhs._idx;
+    }
+
+    friend bool operator==(VLIndexIterator const &lhs, VLIndexIterator const &rhs) noexcept
+    {
+        return lhs._idx == rhs._idx;
+    }
+
+    friend bool operator!=(VLIndexIterator const &lhs, VLIndexIterator const &rhs) noexcept
+    {
+        return lhs._idx != rhs._idx;
+    }
+
+    friend bool operator<(VLIndexIterator const &lhs, VLIndexIterator const &rhs) noexcept
+    {
+        return lhs._idx < rhs._idx;
+    }
+
+    friend bool operator>(VLIndexIterator const &lhs, VLIndexIterator const &rhs) noexcept
+    {
+        return lhs._idx > rhs._idx;
+    }
+
+    friend bool operator<=(VLIndexIterator const &lhs, VLIndexIterator const &rhs) noexcept
+    {
+        return lhs._idx <= rhs._idx;
+    }
+
+    friend bool operator>=(VLIndexIterator const &lhs, VLIndexIterator const &rhs) noexcept
+    {
+        return lhs._idx >= rhs._idx;
+    }
+};
+
+
+#endif //CPP_EXAM_VLINDEXITERATOR_HPP
@@ -0,0 +1,612 @@
+/**
+ * @file VLJaggedVector.hpp
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ *
+ * @brief Containers of many variable length rows, stored in shared arrays instead of a container per row.
+ *
+ * @section DESCRIPTION A VLVector<VLVector<T, N>> costs every row the members of a VLVector and N slots, used or not,
+ * and every row longer than N allocates on its own. The containers here keep the rows in shared arrays:
+ * - VLJaggedVector<T> is compressed sparse row (CSR) storage: the elements of all of the rows in one contiguous
+ *   array, in row order, and the offset of every row in another, so a row costs one offset. It is built append only,
+ *   a row after the other, or rebuilt at once from (row, value) pairs by a counting sort.
+ * - VLHybridJaggedVector<T, InlineSlots> lets every row grow at any time. A row holds up to InlineSlots elements in
+ *   its own slots; a longer one moves to a region of a shared overflow arena, whose blocks never move, and grows
+ *   there in place while the free part of the arena follows it, or moves to a new region by the VLVector formula.
+ *   The regions rows move out of are garbage until compact() rewrites the arena as one block, which also moves the
+ *   rows that fit back into their slots.
+ * Either way, a row is contiguous, and operator[] returns a VLSpan of it. Adding a row invalidates the spans of the
+ * hybrid rows, and adding elements to a row invalidates its own; any addition invalidates the spans of CSR rows.
+ */
+#ifndef CPP_EXAM_VLJAGGEDVECTOR_HPP
+#define CPP_EXAM_VLJAGGEDVECTOR_HPP
+
+#include "VLVector.hpp"
+#include "VLVectorView.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+#define ROW_SIZE_LIMIT UINT32_MAX
+
+#define ARENA_BLOCK_MIN 64
+
+#define ARENA_TABLE_CAPACITY 8
+
+/**
+ * Rows of elements which grow in place: up to InlineSlots elements in the row itself, more in a shared overflow arena.
+ * A row holds up to ROW_SIZE_LIMIT elements.
+ * @tparam T The type of the elements.
+ * @tparam InlineSlots The amount of elements every row holds without the overflow arena.
+ * @tparam StaticCapacity The amount of rows held without allocating.
+ */
+template<class T, size_t InlineSlots = 4, size_t StaticCapacity = DEFAULT_STATIC_CAPACITY>
+class VLHybridJaggedVector
+{
+    static_assert(InlineSlots > 0, "a hybrid row has inline slots, see VLJaggedVector for rows without");
+
+private:
+    VLVector<T, StaticCapacity * InlineSlots> _slots; //InlineSlots slots of every row, in row order.
+    VLVector<uint32_t, StaticCapacity> _sizes;
+    VLVector<uint32_t, StaticCapacity> _capacities; //the capacity of every row in the arena, 0 if in its slots.
+    VLVector<T *, StaticCapacity> _regions; //the elements of every row in the arena, if they are there.
+    VLVector<T *, ARENA_TABLE_CAPACITY> _blocks; //the blocks of the arena, the last one partly free.
+    T *_free = nullptr; //the free elements of the last block.
+    size_t _freeCount = STARTING_SIZE;
+    size_t _arenaSize = STARTING_SIZE;
+    size_t _valueCount = STARTING_SIZE;
+    size_t _garbage = STARTING_SIZE;
+
+    T *_elems(size_t row) noexcept
+    {
+        return _capacities[row] ? _regions[row] : _slots.data() + row * InlineSlots;
+    }
+
+    const T *_elems(size_t row) const noexcept
+    {
+        return _capacities[row] ? _regions[row] : _slots.data() + row * InlineSlots;
+    }
+
+    /**
+     * @brief Adds a block of count elements to the arena, the free elements of the last one becoming garbage.
+     */
+    void _addBlock(size_t count)
+    {
+        _blocks.push_back(new T[count]());
+        _garbage += _freeCount;
+        _free = _blocks.back();
+        _freeCount = count;
+        _arenaSize += count;
+    }
+
+    /**
+     * @return count free elements of the arena. A new block is at least as large as all of the previous ones, so
+     * there are O(log) blocks, like the segments of VLSegmentedVector.
+     */
+    T *_allocate(size_t count)
+    {
+        if (count > _freeCount)
+        {
+            _addBlock(std::max({count, _arenaSize, (size_t) ARENA_BLOCK_MIN}));
+        }
+        T *region = _free;
+        _free += count;
+        _freeCount -= count;
+        return region;
+    }
+
+    /**
+     * @brief Makes room for one more element in a full row: extends its region if the free elements of the arena
+     * follow it, and moves it to a new region otherwise. The capacity is set by the VLVector formula.
+     */
+    void _grow(size_t row)
+    {
+        size_t newCapacity = std::min((size_t) (_sizes[row] + INCREASE_INC) * INCREASE_FACTOR, (size_t) ROW_SIZE_LIMIT);
+        size_t added = newCapacity - _capacities[row];
+        if (_capacities[row] && _regions[row] + _capacities[row] == _free && added <= _freeCount)
+        {
+            _free += added;
+            _freeCount -= added;
+        }
+        else
+        {
+            T *region = _allocate(newCapacity);
+            const T *from = _elems(row);
+            std::copy(from, from + _sizes[row], region);
+            _garbage += _capacities[row];
+            _regions[row] = region;
+        }
+        _capacities[row] = (uint32_t) newCapacity;
+    }
+
+    /**
+     * @brief Frees the blocks of the arena.
+     */
+    void _freeArena() noexcept
+    {
+        for (T *block : _blocks)
+        {
+            delete[] block;
+        }
+        _blocks.clear();
+        _free = nullptr;
+        _freeCount = _arenaSize = _garbage = STARTING_SIZE;
+    }
+
+public:
+    typedef T value_type;
+    typedef size_t size_type;
+
+    /**
+     * @brief A regular c'tor, of no rows.
+     */
+    VLHybridJaggedVector() = default;
+
+    /**
+     * @brief A c'tor of rows empty rows.
+     */
+    explicit VLHybridJaggedVector(size_t rows)
+    {
+        resize(rows);
+    }
+
+    /**
+     * @brief A copy ctor. The copy is compact, see compact.
+     */
+    VLHybridJaggedVector(VLHybridJaggedVector const &toCopy)
+    {
+        *this = toCopy;
+    }
+
+    /**
+     * @brief Destructor. Frees the arena.
+     */
+    ~VLHybridJaggedVector()
+    {
+        _freeArena();
+    }
+
+    /**
+     * @brief Assigns rows equal to the rows of rhs, compactly, see compact.
+     */
+    VLHybridJaggedVector &operator=(VLHybridJaggedVector const &rhs)
+    {
+        if (this != &rhs)
+        {
+            _freeArena();
+            _slots = rhs._slots;
+            _sizes = rhs._sizes;
+            _capacities = rhs._capacities;
+            _regions = rhs._regions;
+            _valueCount = rhs._valueCount;
+            compact(); //moves the rows out of the arena of rhs.
+        }
+        return *this;
+    }
+
+    /**
+     * @return The amount of rows.
+     */
+    size_t size() const noexcept
+    {
+        return _sizes.size();
+    }
+
+    bool empty() const noexcept
+    {
+        return _sizes.empty();
+    }
+
+    /**
+     * @return The amount of elements in all of the rows.
+     */
+    size_t value_count() const noexcept
+    {
+        return _valueCount;
+    }
+
+    /**
+     * @return The amount of elements of the arena: the rows out of their slots, their unused capacity, the garbage
+     * and the free elements.
+     */
+    size_t overflow_size() const noexcept
+    {
+        return _arenaSize;
+    }
+
+    /**
+     * @return The amount of elements of the arena which no row uses any more, see compact.
+     */
+    size_t garbage() const noexcept
+    {
+        return _garbage;
+    }
+
+    /**
+     * @brief Makes room for rows rows without reallocating, and for overflow elements in the arena without adding a
+     * block.
+     */
+    void reserve(size_t rows, size_t overflow)
+    {
+        _slots.reserve(rows * InlineSlots);
+        _sizes.reserve(rows);
+        _capacities.reserve(rows);
+        _regions.reserve(rows);
+        if (overflow > _freeCount)
+        {
+            _addBlock(overflow);
+        }
+    }
+
+    /**
+     * @brief Adds an empty row.
+     * @return The index of the row.
+     */
+    size_t push_row()
+    {
+        resize(size() + NEXT_ELEM);
+        return size() - NEXT_ELEM;
+    }
+
+    /**
+     * @brief Changes the amount of rows to rows. New rows are empty, the regions of removed ones become garbage.
+     */
+    void resize(size_t rows)
+    {
+        for (size_t row = rows; row < size(); ++row)
+        {
+            _valueCount -= _sizes[row];
+            _garbage += _capacities[row];
+        }
+        _slots.resize(rows * InlineSlots);
+        _sizes.resize(rows, STARTING_SIZE);
+        _capacities.resize(rows, STARTING_SIZE);
+        _regions.resize(rows, nullptr);
+    }
+
+    /**
+     * @return The amount of elements of row.
+     */
+    size_t row_size(size_t row) const noexcept
+    {
+        return _sizes[row];
+    }
+
+    /**
+     * @brief Adds toAdd to the end of row. Only the spans of row are invalidated.
+     */
+    void push_back(size_t row, const T &toAdd)
+    {
+        if (_sizes[row] == (_capacities[row] ? _capacities[row] : InlineSlots))
+        {
+            _grow(row); //the old region stays in the arena, so toAdd stays valid.
+        }
+        _elems(row)[_sizes[row]++] = toAdd;
+        ++_valueCount;
+    }
+
+    /**
+     * @brief Removes the last element of row. The row keeps its capacity.
+     */
+    void pop_back(size_t row) noexcept
+    {
+        --_sizes[row];
+        --_valueCount;
+    }
+
+    /**
+     * @brief Removes the elements of row. The row keeps its capacity.
+     */
+    void clear_row(size_t row) noexcept
+    {
+        _valueCount -= _sizes[row];
+        _sizes[row] = STARTING_SIZE;
+    }
+
+    /**
+     * @return A span of the elements of row.
+     */
+    VLSpan<T> operator[](size_t row) noexcept
+    {
+        return VLSpan<T>(_elems(row), _sizes[row]);
+    }
+
+    /**
+     * @return A span of the elements of row. const version.
+     */
+    VLSpan<const T> operator[](size_t row) const noexcept
+    {
+        return VLSpan<const T>(_elems(row), _sizes[row]);
+    }
+
+    /**
+     * @brief Moves the rows out of their slots to one block of exactly their size, in row order, and frees the rest of
+     * the arena. Rows which fit their slots move back to them. O(size() + value_count()).
+     */
+    void compact()
+    {
+        size_t spilled = STARTING_SIZE;
+        for (size_t row = FIRST_IDX; row < size(); ++row)
+        {
+            spilled += _sizes[row] > InlineSlots ? _sizes[row] : STARTING_SIZE;
+        }
+        T *block = spilled ? new T[spilled]() : nullptr;
+        T *next = block;
+        for (size_t row = FIRST_IDX; row < size(); ++row)
+        {
+            if (!_capacities[row])
+            {
+                continue;
+            }
+            const T *from = _regions[row];
+            if (_sizes[row] <= InlineSlots)
+            {
+                std::copy(from, from + _sizes[row], _slots.data() + row * InlineSlots);
+                _capacities[row] = STARTING_SIZE;
+            }
+            else
+            {
+                _regions[row] = std::copy(from, from + _sizes[row], next) - _sizes[row];
+                _capacities[row] = _sizes[row];
+                next += _sizes[row];
+            }
+        }
+        _freeArena();
+        if (block)
+        {
+            _blocks.push_back(block);
+            _arenaSize = spilled;
+        }
+    }
+
+    /**
+     * @brief Deletes all of the rows. Frees the arena.
+     */
+    void clear() noexcept
+    {
+        _slots.clear();
+        _sizes.clear();
+        _capacities.clear();
+        _regions.clear();
+        _freeArena();
+        _valueCount = STARTING_SIZE;
+    }
+};
+
+/**
+ * Rows of elements in compressed sparse row storage: the elements of all of the rows in one array, and the offset of
+ * every row. Rows are added at the end only.
+ * @tparam T The type of the elements.
+ * @tparam StaticCapacity The amount of rows, and of elements, held without allocating.
+ * @tparam Offset The type of the offsets: uint32_t halves the cost of a row when there are less than 2^32 elements.
+ */
+template<class T, size_t StaticCapacity = DEFAULT_STATIC_CAPACITY, class Offset = size_t>
+class VLJaggedVector
+{
+private:
+    VLVector<T, StaticCapacity> _values;
+    VLVector<Offset, StaticCapacity + NEXT_ELEM> _offsets; //the first element of every row, and the end of the last.
+
+public:
+    typedef T value_type;
+    typedef size_t size_type;
+
+    /**
+     * @brief A regular c'tor, of no rows.
+     */
+    VLJaggedVector()
+    {
+        _offsets.push_back(FIRST_IDX);
+    }
+
+    /**
+     * @brief A c'tor of the rows of a VLHybridJaggedVector, in one array.
+     */
+    template<size_t InlineSlots, size_t OtherCapacity>
+    explicit VLJaggedVector(VLHybridJaggedVector<T, InlineSlots, OtherCapacity> const &rows) : VLJaggedVector()
+    {
+        reserve(rows.size(), rows.value_count());
+        for (size_t row = FIRST_IDX; row < rows.size(); ++row)
+        {
+            push_row(rows[row].begin(), rows[row].end());
+        }
+    }
+
+    VLJaggedVector(VLJaggedVector const &toCopy) = default;
+
+    /**
+     * @brief A move ctor. Leaves toMove with no rows.
+     */
+    VLJaggedVector(VLJaggedVector &&toMove) noexcept : _values(std::move(toMove._values)),
+                                                       _offsets(std::move(toMove._offsets))
+    {
+        toMove._offsets.push_back(FIRST_IDX);
+    }
+
+    VLJaggedVector &operator=(VLJaggedVector const &rhs) = default;
+
+    /**
+     * @brief Moves the rows of rhs to the jagged vector, leaving rhs with no rows.
+     * @return The assigned jagged vector by ref.
+     */
+    VLJaggedVector &operator=(VLJaggedVector &&rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            _values = std::move(rhs._values);
+            _offsets = std::move(rhs._offsets);
+            rhs._offsets.push_back(FIRST_IDX);
+        }
+        return *this;
+    }
+
+    /**
+     * @return The amount of rows.
+     */
+    size_t size() const noexcept
+    {
+        return _offsets.size() - NEXT_ELEM;
+    }
+
+    bool empty() const noexcept
+    {
+        return size() == STARTING_SIZE;
+    }
+
+    /**
+     * @return The amount of elements in all of the rows.
+     */
+    size_t value_count() const noexcept
+    {
+        return _values.size();
+    }
+
+    /**
+     * @brief Makes room for rows rows of values elements in all without reallocating.
+     */
+    void reserve(size_t rows, size_t values)
+    {
+        _offsets.reserve(rows + NEXT_ELEM);
+        _values.reserve(values);
+    }
+
+    /**
+     * @brief Adds an empty row at the end, see push_back.
+     * @return The index of the row.
+     */
+    size_t push_row()
+    {
+        _offsets.push_back((Offset) _values.size());
+        return size() - NEXT_ELEM;
+    }
+
+    /**
+     * @brief Adds a row of the elements between first and last at the end.
+     * @tparam InputIterator The iterator that is given by the user.
+     * @return The index of the row.
+     */
+    template<class InputIterator>
+    size_t push_row(InputIterator first, InputIterator last)
+    {
+        _values.insert(_values.cend(), first, last);
+        return push_row();
+    }
+
+    /**
+     * @brief Adds toAdd to the end of the last row. There must be a row.
+     */
+    void push_back(const T &toAdd)
+    {
+        _values.push_back(toAdd);
+        ++_offsets.back();
+    }
+
+    /**
+     * @brief Removes the last row.
+     */
+    void pop_row()
+    {
+        _offsets.pop_back();
+        _values.resize(_offsets.back());
+    }
+
+    /**
+     * @return The amount of elements of row.
+     */
+    size_t row_size(size_t row) const noexcept
+    {
+        return (size_t) (_offsets[row + NEXT_ELEM] - _offsets[row]);
+    }
+
+    /**
+     * @return A span of the elements of row.
+     */
+    VLSpan<T> operator[](size_t row) noexcept
+    {
+        return VLSpan<T>(_values.data() + _offsets[row], row_size(row));
+    }
+
+    /**
+     * @return A span of the elements of row. const version.
+     */
+    VLSpan<const T> operator[](size_t row) const noexcept
+    {
+        return VLSpan<const T>(_values.data() + _offsets[row], row_size(row));
+    }
+
+    /**
+     * @return A span of the elements of all of the rows, in row order.
+     */
+    VLSpan<const T> values() const noexcept
+    {
+        return VLSpan<const T>(_values.data(), _values.size());
+    }
+
+    /**
+     * @return A span of the offsets: row is between offsets()[row] and offsets()[row + 1] in values().
+     */
+    VLSpan<const Offset> offsets() const noexcept
+    {
+        return VLSpan<const Offset>(_offsets.data(), _offsets.size());
+    }
+
+    /**
+     * @brief Replaces the rows by rows rows of the pairs (*rowFirst, *valueFirst) ... , in which every element is
+     * added to the row before it. A counting sort: counts the elements of every row, turns the counts into offsets and
+     * places the elements. Elements of the same row keep their order. O(rows + pairs).
+     * @tparam RowIterator A forward iterator of row indices, each smaller than rows.
+     * @tparam ValueIterator A forward iterator of the elements, as many as the row indices.
+     */
+    template<class RowIterator, class ValueIterator>
+    void rebuild(size_t rows, RowIterator rowFirst, RowIterator rowLast, ValueIterator valueFirst)
+    {
+        _offsets.clear();
+        _offsets.resize(rows + NEXT_ELEM, FIRST_IDX);
+        size_t pairs = STARTING_SIZE;
+        for (RowIterator row = rowFirst; row != rowLast; ++row, ++pairs)
+        {
+            ++_offsets[(size_t) *row + NEXT_ELEM];
+        }
+        for (size_t row = FIRST_IDX; row < rows; ++row)
+        {
+            _offsets[row + NEXT_ELEM] += _offsets[row];
+        }
+        _values.clear();
+        _values.resize(pairs);
+        for (; rowFirst != rowLast; ++rowFirst, ++valueFirst)
+        {
+            _values[_offsets[*rowFirst]++] = *valueFirst; //offsets[row] is the next place of row meanwhile.
+        }
+        for (size_t row = rows; row > FIRST_IDX; --row) //every offset went up to the next one, back down.
+        {
+            _offsets[row] = _offsets[row - NEXT_ELEM];
+        }
+        _offsets[FIRST_IDX] = FIRST_IDX;
+    }
+
+    /**
+     * @brief Deletes all of the rows.
+     */
+    void clear() noexcept
+    {
+        _values.clear();
+        _offsets.clear();
+        _offsets.push_back(FIRST_IDX);
+    }
+
+    /**
+     * @return true if both of the containers hold equal rows.
+     */
+    bool operator==(VLJaggedVector const &toComp) const
+    {
+        return _offsets == toComp._offsets && _values == toComp._values;
+    }
+
+    bool operator!=(VLJaggedVector const &toComp) const
+    {
+        return !(*this == toComp);
+    }
+};
+
+
+#endif //CPP_EXAM_VLJAGGEDVECTOR_HPP
@@ -0,0 +1,299 @@
+/**
+ * @file VLPriorityQueue.hpp
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ *
+ * @brief A priority queue kept in a VLVector, and a top-k selection which does not allocate for small k.
+ *
+ * @section DESCRIPTION VLPriorityQueue<T, StaticCapacity, Compare, Arity> is an implicit d-ary heap in a VLVector, so
+ * up to StaticCapacity elements never touch the allocator. The children of the element at idx are at
+ * idx * Arity + 1 on. A binary heap does the fewest comparisons per level; a 4-ary one is half as deep and a node's
+ * children usually share a cache line, which wins once the heap is larger than the cache. Elements are moved into a
+ * hole instead of swapped while sifting. Building from a range heapifies bottom up in O(n). top_k keeps a bounded
+ * heap of the k best elements of a range, which stays in static storage when k <= StaticCapacity. A binary one over a
+ * range which can be counted is the heap of std::partial_sort_copy, kept in the result itself.
+ */
+#ifndef CPP_EXAM_VLPRIORITYQUEUE_HPP
+#define CPP_EXAM_VLPRIORITYQUEUE_HPP
+
+#include "VLVector.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#define BINARY_HEAP 2
+
+#define QUATERNARY_HEAP 4
+
+#define ROOT_IDX 0
+
+namespace vlvheap
+{
+    /**
+     * A comparator which orders the other way around than Compare does.
+     */
+    template<class Compare>
+    struct Reversed
+    {
+        Compare comp;
+
+        template<class T>
+        bool operator()(T const &lhs, T const &rhs) const
+        {
+            return comp(rhs, lhs);
+        }
+    };
+}
+
+/**
+ * A priority queue. top() is an element which no other element is better than: with the default std::less, the
+ * largest one.
+ * @tparam T The type of the elements.
+ * @tparam StaticCapacity The amount of elements held without allocating.
+ * @tparam Compare Orders the elements, top() being the last in its order.
+ * @tparam Arity The amount of children of every node of the heap, BINARY_HEAP or QUATERNARY_HEAP typically.
+ */
+template<class T, size_t StaticCapacity = DEFAULT_STATIC_CAPACITY, class Compare = std::less<T>,
+        size_t Arity = BINARY_HEAP>
+class VLPriorityQueue
+{
+    static_assert(Arity >= BINARY_HEAP, "a heap node has at least two children");
+
+private:
+    VLVector<T, StaticCapacity> _heap;
+    Compare _comp;
+
+    /**
+     * @brief Moves value up from the hole at idx to its place.
+     */
+    void _siftUp(size_t idx, T const &value)
+    {
+        T *heap = _heap.data();
+        while (idx > ROOT_IDX)
+        {
+            size_t parent = (idx - NEXT_ELEM) / Arity;
+            if (!_comp(heap[parent], value))
+            {
+                break;
+            }
+            heap[idx] = std::move(heap[parent]);
+            idx = parent;
+        }
+        heap[idx] = value;
+    }
+
+    /**
+     * @brief Moves value down from the hole at idx to its place, moving the best child up to the hole on every level.
+     * Works on the raw elements, and full child groups (all but the last) are compared with a fixed trip count.
+     */
+    void _siftDown(size_t idx, T value)
+    {
+        T *heap = _heap.data();
+        size_t size = _heap.size();
+        for (size_t first = idx * Arity + NEXT_ELEM; first < size; first = idx * Arity + NEXT_ELEM)
+        {
+            size_t best = first;
+            if (first + Arity <= size)
+            {
+                for (size_t child = first + NEXT_ELEM; child < first + Arity; ++child)
+                {
+                    best = _comp(heap[best], heap[child]) ? child : best;
+                }
+            }
+            else
+            {
+                for (size_t child = first + NEXT_ELEM; child < size; ++child)
+                {
+                    best = _comp(heap[best], heap[child]) ? child : best;
+                }
+            }
+            if (!_comp(value, heap[best]))
+            {
+                break;
+            }
+            heap[idx] = std::move(heap[best]);
+            idx = best;
+        }
+        heap[idx] = std::move(value);
+    }
+
+public:
+    typedef T value_type;
+    typedef size_t size_type;
+    typedef T const &const_reference;
+
+    /**
+     * @brief A regular c'tor.
+     */
+    explicit VLPriorityQueue(Compare const &comp = Compare()) : _comp(comp)
+    {
+    }
+
+    /**
+     * @brief Builds a queue of the elements between first and last, see heapify.
+     * @tparam InputIterator The iterator that is given by the user.
+     */
+    template<class InputIterator>
+    VLPriorityQueue(InputIterator first, InputIterator last, Compare const &comp = Compare()) : _heap(first, last),
+                                                                                                  _comp(comp)
+    {
+        heapify();
+    }
+
+    size_t size() const noexcept
+    {
+        return _heap.size();
+    }
+
+    bool empty() const noexcept
+    {
+        return _heap.empty();
+    }
+
+    /**
+     * @return The best element. The queue must not be empty.
+     */
+    const T &top() const noexcept
+    {
+        return _heap.front();
+    }
+
+    /**
+     * @brief Adds toAdd to the queue. O(log n).
+     */
+    void push(const T &toAdd)
+    {
+        T value = toAdd; //toAdd may be an element of the queue.
+        _heap.push_back(value);
+        _siftUp(_heap.size() - NEXT_ELEM, value);
+    }
+
+    /**
+     * @brief Removes the best element. O(log n).
+     */
+    void pop()
+    {
+        T value = std::move(_heap.back());
+        _heap.pop_back();
+        if (!_heap.empty())
+        {
+            _siftDown(ROOT_IDX, std::move(value));
+        }
+    }
+
+    /**
+     * @brief Replaces the best element by toAdd. Sifts once, where pop and push would sift twice.
+     */
+    void replace_top(const T &toAdd)
+    {
+        _siftDown(ROOT_IDX, toAdd);
+    }
+
+    /**
+     * @brief Restores the heap order of all of the elements, bottom up. O(n).
+     */
+    void heapify()
+    {
+        if (_heap.size() <= NEXT_ELEM)
+        {
+            return;
+        }
+        for (size_t idx = (_heap.size() - BINARY_HEAP) / Arity + NEXT_ELEM; idx-- > ROOT_IDX;) //from the last parent.
+        {
+            _siftDown(idx, std::move(_heap[idx]));
+        }
+    }
+
+    /**
+     * @brief Replaces the elements by the ones between first and last, in O(n).
+     */
+    template<class InputIterator>
+    void assign(InputIterator first, InputIterator last)
+    {
+        _heap.clear();
+        while (first != last)
+        {
+            _heap.push_back(*(first++));
+        }
+        heapify();
+    }
+
+    /**
+     * @brief Deletes all of the elements.
+     */
+    void clear() noexcept
+    {
+        _heap.clear();
+    }
+
+    /**
+     * @return The elements, in heap order.
+     */
+    VLVector<T, StaticCapacity> const &container() const noexcept
+    {
+        return _heap;
+    }
+};
+
+/**
+ * @brief Selects the k best elements between first and last, keeping a heap of the k best seen so far. With a binary
+ * heap and forward iterators, that is std::partial_sort_copy into the result, which does the same work without the
+ * copy of the heap to the result at the end.
+ * @tparam StaticCapacity The static capacity of the heap and the result. Nothing is allocated when k <= StaticCapacity.
+ * @tparam Arity The arity of the heap.
+ * @return The min(k, distance(first, last)) best elements, best first.
+ */
+template<size_t StaticCapacity = DEFAULT_STATIC_CAPACITY, size_t Arity = BINARY_HEAP, class InputIterator,
+        class Compare = std::less<typename std::iterator_traits<InputIterator>::value_type>>
+VLVector<typename std::iterator_traits<InputIterator>::value_type, StaticCapacity>
+top_k(InputIterator first, InputIterator last, size_t k, Compare comp = Compare())
+{
+    typedef typename std::iterator_traits<InputIterator>::value_type T;
+    typedef typename std::iterator_traits<InputIterator>::iterator_category Category;
+    if constexpr (Arity == BINARY_HEAP && std::is_base_of<std::forward_iterator_tag, Category>::value)
+    {
+        VLVector<T, StaticCapacity> best;
+        best.resize(std::min(k, (size_t) std::distance(first, last)));
+        std::partial_sort_copy(first, last, best.begin(), best.end(), vlvheap::Reversed<Compare>{comp});
+        return best;
+    }
+    VLPriorityQueue<T, StaticCapacity, vlvheap::Reversed<Compare>, Arity> worst({comp}); //top() is the worst kept.
+    for (; first != last && worst.size() < k; ++first)
+    {
+        worst.push(*first);
+    }
+    if (!worst.empty())
+    {
+        const T &top = worst.top(); //the heap is full, so its storage stays where it is.
+        for (; first != last; ++first)
+        {
+            if (comp(top, *first))
+            {
+                worst.replace_top(*first);
+            }
+        }
+    }
+    VLVector<T, StaticCapacity> best;
+    best.resize(worst.size());
+    for (size_t idx = worst.size(); idx-- > FIRST_IDX; worst.pop())
+    {
+        best[idx] = worst.top();
+    }
+    return best;
+}
+
+/**
+ * @brief Selects the k best elements of vec. See top_k.
+ */
+template<size_t StaticCapacity = DEFAULT_STATIC_CAPACITY, size_t Arity = BINARY_HEAP, class T,
+        class Compare = std::less<T>>
+VLVector<T, StaticCapacity> top_k(VLVectorBase<T> const &vec, size_t k, Compare comp = Compare())
+{
+    return top_k<StaticCapacity, Arity>(vec.begin(), vec.end(), k, comp);
+}
+
+
+#endif //CPP_EXAM_VLPRIORITYQUEUE_HPP
@@ -0,0 +1,348 @@
+/**
+ * @file VLSegmentedVector.hpp
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ *
+ * @brief A virtual length vector whose elements never move.
+ *
+ * @section DESCRIPTION VLSegmentedVector<T, StaticCapacity> keeps its first StaticCapacity elements in static storage,
+ * like VLVector, but spills into segments which double in size instead of into one contiguous array: segment 0 is the
+ * static storage, and segment k > 0 holds the StaticCapacity * 2^(k-1) elements from index StaticCapacity * 2^(k-1)
+ * on. Growing allocates a new segment and copies nothing, so pointers and references to elements stay valid across
+ * push_back. The segment of an index is the bit width of index / StaticCapacity, found with a bit scan, so indexing
+ * is O(1). Traversal is fastest segment by segment, each being contiguous, see segment().
+ */
+#ifndef CPP_EXAM_VLSEGMENTEDVECTOR_HPP
+#define CPP_EXAM_VLSEGMENTEDVECTOR_HPP
+
+#include "VLIndexIterator.hpp"
+#include "VLVector.hpp"
+#include "VLVectorView.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#define SEGMENT_TABLE_CAPACITY 8
+
+#define HIGHEST_BIT 63
+
+/**
+ * A Virtual length vector of stable elements. Holds up to StaticCapacity elements in its static storage.
+ * @tparam T The type of the elements.
+ */
+template<class T, size_t StaticCapacity = DEFAULT_STATIC_CAPACITY>
+class VLSegmentedVector
+{
+    static_assert(StaticCapacity > 0, "VLSegmentedVector needs a static storage to size its segments by");
+
+private:
+    T _statData[StaticCapacity];
+    VLVector<T *, SEGMENT_TABLE_CAPACITY> _segments; //the start of every segment, the static storage first.
+    size_t _size = STARTING_SIZE;
+
+    /**
+     * @return The segment holding element idx.
+     */
+    static size_t _segmentOf(size_t idx) noexcept
+    {
+        size_t quotient = idx / StaticCapacity;
+        return (size_t) (HIGHEST_BIT - __builtin_clzll((quotient << 1) | 1)); //the bit width of quotient.
+    }
+
+    /**
+     * @return The index of the first element of segment k.
+     */
+    static size_t _segmentStart(size_t k) noexcept
+    {
+        return StaticCapacity * (((size_t) 1 << k) >> 1);
+    }
+
+    /**
+     * @brief Frees the dynamically allocated segments.
+     */
+    void _freeSegments() noexcept
+    {
+        while (_segments.size() > NEXT_ELEM)
+        {
+            delete[] _segments.back();
+            _segments.pop_back();
+        }
+    }
+
+public:
+    typedef T value_type;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    typedef T &reference;
+    typedef T const &const_reference;
+    typedef VLIndexIterator<VLSegmentedVector, T, false> iterator;
+    typedef VLIndexIterator<VLSegmentedVector, T, true> const_iterator;
+
+    /**
+     * @brief A regular c'tor.
+     */
+    VLSegmentedVector()
+    {
+        _segments.push_back(_statData);
+    }
+
+    /**
+     * @brief A copy ctor.
+     */
+    VLSegmentedVector(VLSegmentedVector const &toCopy) : VLSegmentedVector(toCopy.begin(), toCopy.end())
+    {
+    }
+
+    /**
+     * @brief A c'tor from a set of items.
+     * @tparam InputIterator The iterator that is given by the user.
+     */
+    template<class InputIterator>
+    VLSegmentedVector(InputIterator first, InputIterator last) : VLSegmentedVector()
+    {
+        while (first != last)
+        {
+            push_back(*(first++));
+        }
+    }
+
+    /**
+     * @brief Destructor. Frees the segments.
+     */
+    ~VLSegmentedVector()
+    {
+        _freeSegments();
+    }
+
+    /**
+     * @brief Assigns values equal to the values of rhs to the VLSegmentedVector, keeping the segments it has.
+     */
+    VLSegmentedVector &operator=(VLSegmentedVector const &rhs)
+    {
+        if (this != &rhs)
+        {
+            _size = STARTING_SIZE;
+            for (T const &elem : rhs)
+            {
+                push_back(elem);
+            }
+        }
+        return *this;
+    }
+
+    size_t size() const noexcept
+    {
+        return _size;
+    }
+
+    /**
+     * @return The amount of elements the allocated segments can hold.
+     */
+    size_t capacity() const noexcept
+    {
+        return _segmentStart(_segments.size());
+    }
+
+    bool empty() const noexcept
+    {
+        return _size == STARTING_SIZE;
+    }
+
+    /**
+     * @brief Adds toAdd to the end, allocating a new segment if the last one is full. No element moves.
+     */
+    void push_back(const T &toAdd)
+    {
+        if (_size == capacity())
+        {
+            _segments.push_back(new T[_segmentStart(_segments.size())]());
+        }
+        (*this)[_size++] = toAdd;
+    }
+
+    /**
+     * @brief Removes the last element of the container. Frees the last segment once the segment before it is empty
+     * too, see SHRINK_TO_STATIC, so one empty segment is kept spare and a size going back and forth across the start
+     * of a segment does not allocate and free it every time. No element moves.
+     * Doesn't call item destructor, like VLVector::pop_back.
+     */
+    void pop_back()
+    {
+        --_size;
+        size_t last = _segments.size() - NEXT_ELEM;
+        if (SHRINK_TO_STATIC && last > FIRST_IDX && _size <= _segmentStart(last - NEXT_ELEM))
+        {
+            delete[] _segments.back();
+            _segments.pop_back();
+        }
+    }
+
+    /**
+     * @brief Deletes all of the elements. Frees the segments.
+     */
+    void clear() noexcept
+    {
+        _freeSegments();
+        _size = STARTING_SIZE;
+    }
+
+    /**
+     * @return The amount of segments which hold elements.
+     */
+    size_t segment_count() const noexcept
+    {
+        return empty() ? STARTING_SIZE : _segmentOf(_size - NEXT_ELEM) + NEXT_ELEM;
+    }
+
+    /**
+     * @return A span of the elements of segment k, which are contiguous.
+     */
+    VLSpan<T> segment(size_t k) noexcept
+    {
+        size_t start = _segmentStart(k);
+        size_t end = std::min(_segmentStart(k + NEXT_ELEM), _size);
+        return VLSpan<T>(_segments[k], end > start ? end - start : STARTING_SIZE);
+    }
+
+    /**
+     * @return A span of the elements of segment k. const version.
+     */
+    VLSpan<const T> segment(size_t k) const noexcept
+    {
+        size_t start = _segmentStart(k);
+        size_t end = std::min(_segmentStart(k + NEXT_ELEM), _size);
+        return VLSpan<const T>(_segments[k], end > start ? end - start : STARTING_SIZE);
+    }
+
+    const T &operator[](size_t idx) const noexcept
+    {
+        size_t k = _segmentOf(idx);
+        return _segments[k][idx - _segmentStart(k)];
+    }
+
+    T &operator[](size_t idx) noexcept
+    {
+        size_t k = _segmentOf(idx);
+        return _segments[k][idx - _segmentStart(k)];
+    }
+
+    /**
+     * @brief returns the element at place idx. @throws std::out_of_range if the idx is illegal. const version.
+     */
+    const T &at(size_t idx) const
+    {
+        if (idx >= _size)
+        {
+            throw std::out_of_range(OUT_OF_RANGE_MSG);
+        }
+        return (*this)[idx];
+    }
+
+    /**
+     * @brief returns the element at place idx. @throws std::out_of_range if the idx is illegal.
+     */
+    T &at(size_t idx)
+    {
+        if (idx >= _size)
+        {
+            throw std::out_of_range(OUT_OF_RANGE_MSG);
+        }
+        return (*this)[idx];
+    }
+
+    T &front() noexcept
+    {
+        return _statData[FIRST_IDX];
+    }
+
+    const T &front() const noexcept
+    {
+        return _statData[FIRST_IDX];
+    }
+
+    T &back() noexcept
+    {
+        return (*this)[_size - NEXT_ELEM];
+    }
+
+    const T &back() const noexcept
+    {
+        return (*this)[_size - NEXT_ELEM];
+    }
+
+    /**
+     * @return true if all of the elements in both of the containers are equal, in order.
+     */
+    bool operator==(VLSegmentedVector const &toComp) const
+    {
+        return _size == toComp._size && std::equal(begin(), end(), toComp.begin());
+    }
+
+    bool operator!=(VLSegmentedVector const &toComp) const
+    {
+        return !(*this == toComp);
+    }
+
+    iterator begin() noexcept
+    {
+        return iterator(this, FIRST_IDX);
+    }
+
+    iterator end() noexcept
+    {
+        return iterator(this, _size);
+    }
+
+    const_iterator begin() const noexcept
+    {
+        return const_iterator(this, FIRST_IDX);
+    }
+
+    const_iterator end() const noexcept
+    {
+        return const_iterator(this, _size);
+    }
+
+    const_iterator cbegin() const noexcept
+    {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept
+    {
+        return end();
+    }
+};
+
+/**
+ * @brief Calls func on every element of vec, in order, one contiguous segment at a time.
+ */
+template<class T, size_t StaticCapacity, class Func>
+void for_each_segmented(VLSegmentedVector<T, StaticCapacity> &vec, Func func)
+{
+    for (size_t k = FIRST_IDX; k < vec.segment_count(); ++k)
+    {
+        for (T &elem : vec.segment(k))
+        {
+            func(elem);
+        }
+    }
+}
+
+/**
+ * @brief Calls func on every element of vec, in order, one contiguous segment at a time. const version.
+ */
+template<class T, size_t StaticCapacity, class Func>
+void for_each_segmented(VLSegmentedVector<T, StaticCapacity> const &vec, Func func)
+{
+    for (size_t k = FIRST_IDX; k < vec.segment_count(); ++k)
+    {
+        for (T const &elem : vec.segment(k))
+        {
+            func(elem);
+        }
+    }
+}
+
+
+#endif //CPP_EXAM_VLSEGMENTEDVECTOR_HPP
@@ -0,0 +1,459 @@
+/**
+ * @file VLStaticVector.hpp
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ *
+ * @brief A fixed capacity vector which never allocates.
+ *
+ * @section DESCRIPTION VLStaticVector<T, Capacity, Overflow> has the element API of VLVector, but its elements are
+ * only ever in its Capacity long static storage: nothing in it calls the heap, so it is safe where allocation is
+ * forbidden. What an operation which would hold more than Capacity elements does is chosen per instantiation by
+ * Overflow. try_push_back never overflows whatever the policy, it returns false instead. A VLStaticVector of a
+ * trivially copyable T is trivially copyable itself.
+ */
+#ifndef CPP_EXAM_VLSTATICVECTOR_HPP
+#define CPP_EXAM_VLSTATICVECTOR_HPP
+
+#include "VLVector.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+
+#define STATIC_OVERFLOW_MSG "VLStaticVector: the capacity is exceeded"
+
+/**
+ * What a VLStaticVector does on an operation which would exceed its capacity.
+ */
+enum class VLOverflow
+{
+    Throw, //throws std::length_error, leaving the vector unchanged.
+    Terminate, //calls std::terminate, so the operations are noexcept for elements which copy without throwing.
+    Refuse //leaves the vector unchanged: push_back and resize return false, insert returns end().
+};
+
+/**
+ * A vector of at most Capacity elements, kept in static storage.
+ * @tparam T The type of the elements.
+ * @tparam Capacity The amount of elements the vector can hold.
+ * @tparam Overflow What operations which would hold more than Capacity elements do.
+ */
+template<class T, size_t Capacity = DEFAULT_STATIC_CAPACITY, VLOverflow Overflow = VLOverflow::Throw>
+class VLStaticVector
+{
+private:
+    /**
+     * true if the growing operations do not throw.
+     */
+    static constexpr bool _nothrowGrowth = Overflow != VLOverflow::Throw && std::is_nothrow_copy_assignable<T>::value;
+
+    T _statData[Capacity];
+    size_t _size = STARTING_SIZE;
+
+    /**
+     * @brief Handles an operation which would need more than Capacity elements, by the Overflow policy.
+     * @return false, if the policy is to refuse it.
+     */
+    static bool _overflow()
+    {
+        if constexpr (Overflow == VLOverflow::Throw)
+        {
+            throw std::length_error(STATIC_OVERFLOW_MSG);
+        }
+        else if constexpr (Overflow == VLOverflow::Terminate)
+        {
+            std::terminate();
+        }
+        return false;
+    }
+
+public:
+    typedef T value_type;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    typedef T &reference;
+    typedef T const &const_reference;
+    typedef T *pointer;
+    typedef T const *const_pointer;
+    typedef T *iterator;
+    typedef T const *const_iterator;
+    typedef std::reverse_iterator<iterator> reverse_iterator;
+    typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    VLStaticVector() = default;
+
+    /**
+     * @brief A c'tor from a set of items. Items past the capacity overflow, and are dropped if Overflow refuses them.
+     * @tparam InputIterator The iterator that is given by the user.
+     */
+    template<class InputIterator>
+    VLStaticVector(InputIterator first, InputIterator last)
+    {
+        while (first != last && push_back(*(first++)))
+        {
+        }
+    }
+
+    /**
+     * @return The current amount of elements in the container.
+     */
+    size_t size() const noexcept
+    {
+        return _size;
+    }
+
+    /**
+     * @return The amount of elements the container can hold, which never changes.
+     */
+    static constexpr size_t capacity() noexcept
+    {
+        return Capacity;
+    }
+
+    bool empty() const noexcept
+    {
+        return _size == STARTING_SIZE;
+    }
+
+    /**
+     * @return true if no more elements can be added.
+     */
+    bool full() const noexcept
+    {
+        return _size == Capacity;
+    }
+
+    /**
+     * @brief returns the element at place idx. @throws std::out_of_range if the idx is illegal. const version.
+     */
+    const T &at(size_t idx) const
+    {
+        if (idx >= _size)
+        {
+            throw std::out_of_range(OUT_OF_RANGE_MSG);
+        }
+        return _statData[idx];
+    }
+
+    /**
+     * @brief returns the element at place idx. @throws std::out_of_range if the idx is illegal.
+     */
+    T &at(size_t idx)
+    {
+        if (idx >= _size)
+        {
+            throw std::out_of_range(OUT_OF_RANGE_MSG);
+        }
+        return _statData[idx];
+    }
+
+    /**
+     * @brief Adds toAdd to the back of the container, if there is room for it.
+     * @return false if there was no room, in which case nothing else happens whatever Overflow is.
+     */
+    bool try_push_back(const T &toAdd) noexcept(std::is_nothrow_copy_assignable<T>::value)
+    {
+        if (_size == Capacity)
+        {
+            return false;
+        }
+        _statData[_size++] = toAdd;
+        return true;
+    }
+
+    /**
+     * @brief Adds toAdd to the back of the container, overflowing if it is full.
+     * @return false if the overflow was refused.
+     */
+    bool push_back(const T &toAdd) noexcept(_nothrowGrowth)
+    {
+        if (_size == Capacity)
+        {
+            return _overflow();
+        }
+        _statData[_size++] = toAdd;
+        return true;
+    }
+
+    /**
+     * @brief Inserts toAdd before iter, overflowing if the container is full.
+     * @return An iter pointing to the new element, or end() if the overflow was refused.
+     */
+    iterator insert(const_iterator iter, const T &toAdd) noexcept(_nothrowGrowth)
+    {
+        if (_size == Capacity)
+        {
+            _overflow();
+            return end();
+        }
+        T value = toAdd; //toAdd may be an element which is about to move.
+        iterator toIns = begin() + (iter - cbegin());
+        std::copy_backward(toIns, end(), end() + NEXT_ELEM);
+        *toIns = value;
+        ++_size;
+        return toIns;
+    }
+
+    /**
+     * @brief Adds all of the elements between first and last before iter, overflowing if they do not all fit. Single
+     * pass iterators can only be counted by reading them, so their elements are added at the end as they are read and
+     * rotated into place.
+     * @return An iter pointing to the first element of the new ones, or end() if the overflow was refused.
+     */
+    template<class InputIterator>
+    iterator insert(const_iterator iter, InputIterator first, InputIterator const last)
+    {
+        size_t inPlc = iter - cbegin();
+        if constexpr (!std::is_base_of<std::forward_iterator_tag,
+                                       typename std::iterator_traits<InputIterator>::iterator_category>::value)
+        {
+            size_t oldSize = _size;
+            for (; first != last; ++first)
+            {
+                if (_size == Capacity)
+                {
+                    _size = oldSize;
+                    _overflow();
+                    return end();
+                }
+                _statData[_size++] = *first;
+            }
+            std::rotate(begin() + inPlc, begin() + oldSize, end());
+            return begin() + inPlc;
+        }
+        size_t added = (size_t) std::distance(first, last);
+        if (added > Capacity - _size)
+        {
+            _overflow();
+            return end();
+        }
+        iterator toIns = begin() + inPlc;
+        std::copy_backward(toIns, end(), end() + added);
+        std::copy(first, last, toIns);
+        _size += added;
+        return toIns;
+    }
+
+    /**
+     * @brief Removes the last element of the container.
+     */
+    void pop_back() noexcept
+    {
+        --_size;
+    }
+
+    /**
+     * @brief Erases The element that iter points to.
+     * @return An iterator pointing to the next element.
+     */
+    iterator erase(const_iterator iter)
+    {
+        return erase(iter, iter + NEXT_ELEM);
+    }
+
+    /**
+     * @brief Erases all of the elements between first and last.
+     * @return An iterator pointing to the next element.
+     */
+    iterator erase(const_iterator first, const_iterator last)
+    {
+        iterator copyTo = begin() + (first - cbegin());
+        std::copy(last, cend(), copyTo);
+        _size -= last - first;
+        return copyTo;
+    }
+
+    /**
+     * @brief Removes all of the elements.
+     */
+    void clear() noexcept
+    {
+        _size = STARTING_SIZE;
+    }
+
+    /**
+     * @brief Changes the size to newSize, overflowing if it is above the capacity. New elements are copies of value.
+     * @return false if the overflow was refused.
+     */
+    bool resize(size_t newSize, T const &value = T()) noexcept(_nothrowGrowth)
+    {
+        if (newSize > Capacity)
+        {
+            return _overflow();
+        }
+        if (newSize > _size)
+        {
+            std::fill(end(), begin() + newSize, value);
+        }
+        _size = newSize;
+        return true;
+    }
+
+    /**
+     * @brief Lets op write the elements directly, like VLVector::resize_and_overwrite, overflowing if maxSize is
+     * above the capacity.
+     * @return false if the overflow was refused.
+     */
+    template<class Operation>
+    bool resize_and_overwrite(size_t maxSize, Operation op)
+    {
+        if (maxSize > Capacity)
+        {
+            return _overflow();
+        }
+        _size = (size_t) op(data(), maxSize);
+        return true;
+    }
+
+    T *data() noexcept
+    {
+        return _statData;
+    }
+
+    const T *data() const noexcept
+    {
+        return _statData;
+    }
+
+    const T &operator[](size_t idx) const noexcept
+    {
+        return _statData[idx];
+    }
+
+    T &operator[](size_t idx) noexcept
+    {
+        return _statData[idx];
+    }
+
+    T &front() noexcept
+    {
+        return _statData[FIRST_IDX];
+    }
+
+    const T &front() const noexcept
+    {
+        return _statData[FIRST_IDX];
+    }
+
+    T &back() noexcept
+    {
+        return _statData[_size - NEXT_ELEM];
+    }
+
+    const T &back() const noexcept
+    {
+        return _statData[_size - NEXT_ELEM];
+    }
+
+    /**
+     * @return true if all of the elements in both of the containers are equal. Compared like VLVector elements.
+     */
+    bool operator==(VLStaticVector const &toComp) const
+    {
+        return _size == toComp._size && vlvcompare::equalElements(data(), toComp.data(), _size);
+    }
+
+    bool operator!=(VLStaticVector const &toComp) const
+    {
+        return !(*this == toComp);
+    }
+
+#ifdef VLV_THREE_WAY_COMPARISON
+
+    /**
+     * @return The lexicographic order of the containers. See VLVector::operator<=>.
+     */
+    auto operator<=>(VLStaticVector const &toComp) const
+    {
+        return vlvcompare::compareElements(data(), _size, toComp.data(), toComp._size);
+    }
+
+#else
+
+    bool operator<(VLStaticVector const &toComp) const
+    {
+        return vlvcompare::lessElements(data(), _size, toComp.data(), toComp._size);
+    }
+
+    bool operator>(VLStaticVector const &toComp) const
+    {
+        return toComp < *this;
+    }
+
+    bool operator<=(VLStaticVector const &toComp) const
+    {
+        return !(toComp < *this);
+    }
+
+    bool operator>=(VLStaticVector const &toComp) const
+    {
+        return !(*this < toComp);
+    }
+
+#endif
+
+    iterator begin() noexcept
+    {
+        return _statData;
+    }
+
+    iterator end() noexcept
+    {
+        return _statData + _size;
+    }
+
+    const_iterator begin() const noexcept
+    {
+        return _statData;
+    }
+
+    const_iterator end() const noexcept
+    {
+        return _statData + _size;
+    }
+
+    const_iterator cbegin() const noexcept
+    {
+        return _statData;
+    }
+
+    const_iterator cend() const noexcept
+    {
+        return _statData + _size;
+    }
+
+    reverse_iterator rbegin() noexcept
+    {
+        return reverse_iterator(end());
+    }
+
+    reverse_iterator rend() noexcept
+    {
+        return reverse_iterator(begin());
+    }
+
+    const_reverse_iterator rbegin() const noexcept
+    {
+        return const_reverse_iterator(end());
+    }
+
+    const_reverse_iterator rend() const noexcept
+    {
+        return const_reverse_iterator(begin());
+    }
+
+    const_reverse_iterator crbegin() const noexcept
+    {
+        return rbegin();
+    }
+
+    const_reverse_iterator crend() const noexcept
+    {
+        return rend();
+    }
+};
+
+
+#endif //CPP_EXAM_VLSTATICVECTOR_HPP
@@ -0,0 +1,628 @@
+/**
+ * @file VLString.hpp
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ *
+ * @brief A string with a configurable small string buffer, on the storage of VLVector.
+ *
+ * @section DESCRIPTION VLString<StaticCapacity> keeps its characters and a terminating NUL in a
+ * VLVector<char, StaticCapacity + 1>, so strings of up to StaticCapacity characters never touch the allocator. The
+ * small string buffer of libstdc++'s std::string holds 15 characters, and every longer string allocates; a
+ * VLString<48> holds the typical identifier inline. c_str() is always NUL terminated, and a VLString converts to a
+ * std::string_view. Appending grows by the VLVector formula, so it is amortized O(1) per character, and
+ * resize_and_overwrite lets a producer write into the buffer directly. find() of a character is the vectorized
+ * vlvsimd::findEq; find() of a substring compares the first and the last character of the needle against a vector of
+ * positions at a time, and checks the rest only where both match. std::hash hashes the characters with the bulk hash
+ * of VLVectorHash.hpp.
+ */
+#ifndef CPP_EXAM_VLSTRING_HPP
+#define CPP_EXAM_VLSTRING_HPP
+
+#include "VLVector.hpp"
+#include "VLVectorHash.hpp"
+#include "VLVectorSimd.hpp"
+
+#include <climits>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <string_view>
+
+#define STRING_TERMINATOR '\0'
+
+#define TERMINATOR_SPACE 1
+
+namespace vlvsimd
+{
+    /**
+     * @return The first lane set in the comparison mask hits at which the m elements of needle appear, src being the
+     * place of lane 0, or the amount of lanes. Goes over the set lanes only, a 64 bit word of the mask at a time.
+     */
+    template<class T, size_t Bytes, class M>
+    VLV_ALWAYS_INLINE size_t matchLanes(M const &hits, const T *src, const T *needle, size_t m) noexcept
+    {
+        constexpr size_t laneBits = sizeof(T) * CHAR_BIT;
+        constexpr uint64_t laneMask = ((uint64_t) 2 << (laneBits - 1)) - 1; //a lane of ones, at bit 0.
+        constexpr size_t words = Bytes / sizeof(uint64_t);
+        uint64_t maskWords[words];
+        storeLanes(maskWords, hits);
+        for (size_t word = FIRST_IDX; word < words; ++word)
+        {
+            for (uint64_t bits = maskWords[word]; bits;)
+            {
+                size_t bit = (size_t) __builtin_ctzll(bits);
+                size_t lane = (word * sizeof(uint64_t) * CHAR_BIT + bit) / laneBits;
+                if (std::memcmp(src + lane, needle, m * sizeof(T)) == 0)
+                {
+                    return lane;
+                }
+                bits &= ~(laneMask << bit);
+            }
+        }
+        return Vec<T, Bytes>::lanes;
+    }
+
+    /**
+     * @return The index of the first place at which the m elements of needle appear in the n elements of src, or n.
+     * needle has at least two elements. Every vector of positions is matched against the first and the last element of
+     * needle, and only the positions matching both are compared in full.
+     */
+    template<class T, size_t Bytes>
+    VLV_ALWAYS_INLINE size_t findRangeBody(const T *src, size_t n, const T *needle, size_t m) noexcept
+    {
+        if (m > n)
+        {
+            return n;
+        }
+        size_t last = n - m + NEXT_ELEM; //the amount of places needle may start at.
+        size_t i = 0;
+        if constexpr (Bytes != SCALAR_BYTES)
+        {
+            typedef typename Vec<T, Bytes>::type V;
+            typedef decltype(V{} == V{}) M;
+            constexpr size_t lanes = Vec<T, Bytes>::lanes;
+            V firstNeedle = V{} + needle[FIRST_IDX];
+            V lastNeedle = V{} + needle[m - NEXT_ELEM];
+            for (; i + SIMD_UNROLL * lanes <= last; i += SIMD_UNROLL * lanes)
+            {
+                M hits[SIMD_UNROLL];
+                for (size_t part = FIRST_IDX; part < SIMD_UNROLL; ++part)
+                {
+                    V firsts, lasts;
+                    load(firsts, src + i + part * lanes), load(lasts, src + i + part * lanes + m - NEXT_ELEM);
+                    hits[part] = (firsts == firstNeedle) & (lasts == lastNeedle);
+                }
+                M candidates = hits[FIRST_IDX];
+                for (size_t part = NEXT_ELEM; part < SIMD_UNROLL; ++part)
+                {
+                    candidates |= hits[part];
+                }
+                if (!anyLane<Bytes>(candidates)) //skips runs without candidates.
+                {
+                    continue;
+                }
+                for (size_t part = FIRST_IDX; part < SIMD_UNROLL; ++part)
+                {
+                    size_t lane = matchLanes<T, Bytes>(hits[part], src + i + part * lanes, needle, m);
+                    if (lane != lanes)
+                    {
+                        return i + part * lanes + lane;
+                    }
+                }
+            }
+            for (; i + lanes <= last; i += lanes)
+            {
+                V firsts, lasts;
+                load(firsts, src + i), load(lasts, src + i + m - NEXT_ELEM);
+                M hits = (firsts == firstNeedle) & (lasts == lastNeedle);
+                size_t lane = anyLane<Bytes>(hits) ? matchLanes<T, Bytes>(hits, src + i, needle, m) : lanes;
+                if (lane != lanes)
+                {
+                    return i + lane;
+                }
+            }
+        }
+        for (; i < last; ++i)
+        {
+            if (src[i] == needle[FIRST_IDX] && std::memcmp(src + i, needle, m * sizeof(T)) == 0)
+            {
+                return i;
+            }
+        }
+        return n;
+    }
+
+    VLV_SIMD_KERNEL(size_t, findRange, (const T *src, size_t n, const T *needle, size_t m), (src, n, needle, m))
+}
+
+/**
+ * A string of chars. Holds up to StaticCapacity characters in its static storage.
+ * @tparam StaticCapacity The amount of characters held without allocating, not counting the terminating NUL.
+ */
+template<size_t StaticCapacity = DEFAULT_STATIC_CAPACITY>
+class VLString
+{
+private:
+    VLVector<char, StaticCapacity + TERMINATOR_SPACE> _chars; //the characters, then STRING_TERMINATOR.
+
+    /**
+     * @return true if src points into the characters, which move if the string grows.
+     */
+    bool _aliases(const char *src) const noexcept
+    {
+        return std::less_equal<const char *>()(data(), src) && std::less<const char *>()(src, data() + size());
+    }
+
+public:
+    typedef char value_type;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    typedef char &reference;
+    typedef char const &const_reference;
+    typedef char *iterator;
+    typedef const char *const_iterator;
+
+    /**
+     * The value find returns if nothing is found.
+     */
+    static constexpr size_t npos = std::string_view::npos;
+
+    /**
+     * @brief A regular c'tor, of the empty string.
+     */
+    VLString()
+    {
+        _chars.push_back(STRING_TERMINATOR);
+    }
+
+    /**
+     * @brief A c'tor from the count characters at src.
+     */
+    VLString(const char *src, size_t count) : VLString()
+    {
+        append(src, count);
+    }
+
+    /**
+     * @brief A c'tor from a NUL terminated string.
+     */
+    VLString(const char *src) : VLString(src, std::strlen(src))
+    {
+    }
+
+    /**
+     * @brief A c'tor from the characters of view.
+     */
+    explicit VLString(std::string_view view) : VLString(view.data(), view.size())
+    {
+    }
+
+    /**
+     * @brief A c'tor of count copies of ch.
+     */
+    VLString(size_t count, char ch) : VLString()
+    {
+        resize(count, ch);
+    }
+
+    VLString(VLString const &toCopy) = default;
+
+    /**
+     * @brief A move ctor. Leaves toMove the empty string.
+     */
+    VLString(VLString &&toMove) noexcept : _chars(std::move(toMove._chars))
+    {
+        toMove._chars.push_back(STRING_TERMINATOR);
+    }
+
+    VLString &operator=(VLString const &rhs) = default;
+
+    /**
+     * @brief Moves the characters of rhs to the string, leaving rhs the empty string.
+     * @return The assigned string by ref.
+     */
+    VLString &operator=(VLString &&rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            _chars = std::move(rhs._chars);
+            rhs._chars.push_back(STRING_TERMINATOR);
+        }
+        return *this;
+    }
+
+    size_t size() const noexcept
+    {
+        return _chars.size() - TERMINATOR_SPACE;
+    }
+
+    size_t length() const noexcept
+    {
+        return size();
+    }
+
+    bool empty() const noexcept
+    {
+        return size() == STARTING_SIZE;
+    }
+
+    /**
+     * @return The amount of characters the string can hold without allocating.
+     */
+    size_t capacity() const noexcept
+    {
+        return _chars.capacity() - TERMINATOR_SPACE;
+    }
+
+    char *data() noexcept
+    {
+        return _chars.data();
+    }
+
+    const char *data() const noexcept
+    {
+        return _chars.data();
+    }
+
+    /**
+     * @return The characters, followed by STRING_TERMINATOR.
+     */
+    const char *c_str() const noexcept
+    {
+        return _chars.data();
+    }
+
+    operator std::string_view() const noexcept
+    {
+        return std::string_view(data(), size());
+    }
+
+    char &operator[](size_t idx) noexcept
+    {
+        return _chars[idx];
+    }
+
+    const char &operator[](size_t idx) const noexcept
+    {
+        return _chars[idx];
+    }
+
+    /**
+     * @brief returns the character at place idx. @throws std::out_of_range if the idx is illegal.
+     */
+    char &at(size_t idx)
+    {
+        if (idx >= size())
+        {
+            throw std::out_of_range(OUT_OF_RANGE_MSG);
+        }
+        return _chars[idx];
+    }
+
+    /**
+     * @brief returns the character at place idx. @throws std::out_of_range if the idx is illegal. const version.
+     */
+    const char &at(size_t idx) const
+    {
+        if (idx >= size())
+        {
+            throw std::out_of_range(OUT_OF_RANGE_MSG);
+        }
+        return _chars[idx];
+    }
+
+    char &front() noexcept
+    {
+        return _chars.front();
+    }
+
+    const char &front() const noexcept
+    {
+        return _chars.front();
+    }
+
+    char &back() noexcept
+    {
+        return _chars[size() - NEXT_ELEM];
+    }
+
+    const char &back() const noexcept
+    {
+        return _chars[size() - NEXT_ELEM];
+    }
+
+    /**
+     * @brief Makes the capacity at least newCapacity characters.
+     */
+    void reserve(size_t newCapacity)
+    {
+        _chars.reserve(newCapacity + TERMINATOR_SPACE);
+    }
+
+    /**
+     * @brief Makes the capacity at least maxSize and lets op write the characters directly, as std::string does in
+     * C++23: op(data(), maxSize) may write up to maxSize characters and returns the new size. The terminator is added
+     * after them.
+     */
+    template<class Operation>
+    void resize_and_overwrite(size_t maxSize, Operation op)
+    {
+        _chars.resize_and_overwrite(maxSize + TERMINATOR_SPACE, [&op, maxSize](char *buffer, size_t)
+        {
+            size_t newSize = (size_t) op(buffer, maxSize);
+            buffer[newSize] = STRING_TERMINATOR;
+            return newSize + TERMINATOR_SPACE;
+        });
+    }
+
+    /**
+     * @brief Changes the size to newSize. New characters are ch.
+     */
+    void resize(size_t newSize, char ch = STRING_TERMINATOR)
+    {
+        size_t oldSize = size();
+        resize_and_overwrite(newSize, [oldSize, ch](char *buffer, size_t newSize)
+        {
+            if (newSize > oldSize)
+            {
+                std::memset(buffer + oldSize, ch, newSize - oldSize);
+            }
+            return newSize;
+        });
+    }
+
+    /**
+     * @brief Adds the count characters at src to the end. src may point into the string.
+     */
+    VLString &append(const char *src, size_t count)
+    {
+        size_t oldSize = size();
+        if (_aliases(src))
+        {
+            size_t offset = (size_t) (src - data());
+            reserve(oldSize + count);
+            src = data() + offset;
+        }
+        resize_and_overwrite(oldSize + count, [oldSize, src, count](char *buffer, size_t newSize)
+        {
+            std::memcpy(buffer + oldSize, src, count);
+            return newSize;
+        });
+        return *this;
+    }
+
+    /**
+     * @brief Adds the characters of view to the end.
+     */
+    VLString &append(std::string_view view)
+    {
+        return append(view.data(), view.size());
+    }
+
+    VLString &operator+=(std::string_view view)
+    {
+        return append(view.data(), view.size());
+    }
+
+    VLString &operator+=(char ch)
+    {
+        push_back(ch);
+        return *this;
+    }
+
+    /**
+     * @brief Adds ch to the end.
+     */
+    void push_back(char ch)
+    {
+        _chars.back() = ch;
+        _chars.push_back(STRING_TERMINATOR);
+    }
+
+    /**
+     * @brief Removes the last character.
+     */
+    void pop_back()
+    {
+        _chars.pop_back();
+        _chars.back() = STRING_TERMINATOR;
+    }
+
+    /**
+     * @brief Deletes all of the characters. Frees the buffer if dynamically allocated.
+     */
+    void clear() noexcept
+    {
+        _chars.clear();
+        _chars.push_back(STRING_TERMINATOR);
+    }
+
+    /**
+     * @return The index of the first ch from pos on, or npos.
+     */
+    size_t find(char ch, size_t pos = FIRST_IDX) const noexcept
+    {
+        if (pos >= size())
+        {
+            return npos;
+        }
+        size_t idx = pos + vlvsimd::findEq(data() + pos, size() - pos, ch);
+        return idx == size() ? npos : idx;
+    }
+
+    /**
+     * @return The index of the first appearance of needle from pos on, or npos.
+     */
+    size_t find(std::string_view needle, size_t pos = FIRST_IDX) const noexcept
+    {
+        if (needle.size() <= NEXT_ELEM)
+        {
+            return needle.empty() ? (pos <= size() ? pos : npos) : find(needle.front(), pos);
+        }
+        if (pos >= size())
+        {
+            return npos;
+        }
+        size_t idx = pos + vlvsimd::findRange(data() + pos, size() - pos, needle.data(), needle.size());
+        return idx == size() ? npos : idx;
+    }
+
+    /**
+     * @return true if needle appears in the string.
+     */
+    bool contains(std::string_view needle) const noexcept
+    {
+        return find(needle) != npos;
+    }
+
+    bool starts_with(std::string_view prefix) const noexcept
+    {
+        return std::string_view(*this).substr(FIRST_IDX, prefix.size()) == prefix;
+    }
+
+    bool ends_with(std::string_view suffix) const noexcept
+    {
+        return size() >= suffix.size() && std::string_view(*this).substr(size() - suffix.size()) == suffix;
+    }
+
+    iterator begin() noexcept
+    {
+        return data();
+    }
+
+    iterator end() noexcept
+    {
+        return data() + size();
+    }
+
+    const_iterator begin() const noexcept
+    {
+        return data();
+    }
+
+    const_iterator end() const noexcept
+    {
+        return data() + size();
+    }
+
+    const_iterator cbegin() const noexcept
+    {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept
+    {
+        return end();
+    }
+};
+
+/**
+ * @return true if both of the strings hold the same characters.
+ */
+template<size_t StaticCapacity, size_t OtherCapacity>
+bool operator==(VLString<StaticCapacity> const &lhs, VLString<OtherCapacity> const &rhs) noexcept
+{
+    return std::string_view(lhs) == std::string_view(rhs);
+}
+
+template<size_t StaticCapacity, size_t OtherCapacity>
+bool operator!=(VLString<StaticCapacity> const &lhs, VLString<OtherCapacity> const &rhs) noexcept
+{
+    return !(lhs == rhs);
+}
+
+#ifdef VLV_THREE_WAY_COMPARISON
+
+/**
+ * @return The lexicographical order of the strings, by their characters as unsigned char like std::string.
+ */
+template<size_t StaticCapacity, size_t OtherCapacity>
+std::strong_ordering operator<=>(VLString<StaticCapacity> const &lhs, VLString<OtherCapacity> const &rhs) noexcept
+{
+    return std::string_view(lhs) <=> std::string_view(rhs);
+}
+
+#else
+
+/**
+ * @return true if lhs is before rhs in lexicographical order.
+ */
+template<size_t StaticCapacity, size_t OtherCapacity>
+bool operator<(VLString<StaticCapacity> const &lhs, VLString<OtherCapacity> const &rhs) noexcept
+{
+    return std::string_view(lhs) < std::string_view(rhs);
+}
+
+/**
+ * @return true if lhs is after rhs in lexicographical order.
+ */
+template<size_t StaticCapacity, size_t OtherCapacity>
+bool operator>(VLString<StaticCapacity> const &lhs, VLString<OtherCapacity> const &rhs) noexcept
+{
+    return rhs < lhs;
+}
+
+/**
+ * @return true if lhs is not after rhs in lexicographical order.
+ */
+template<size_t StaticCapacity, size_t OtherCapacity>
+bool operator<=(VLString<StaticCapacity> const &lhs, VLString<OtherCapacity> const &rhs) noexcept
+{
+    return !(rhs < lhs);
+}
+
+/**
+ * @return true if lhs is not before rhs in lexicographical order.
+ */
+template<size_t StaticCapacity, size_t OtherCapacity>
+bool operator>=(VLString<StaticCapacity> const &lhs, VLString<OtherCapacity> const &rhs) noexcept
+{
+    return !(lhs < rhs);
+}
+
+#endif
+
+/**
+ * @return true if the string holds the characters of view.
+ */
+template<size_t StaticCapacity>
+bool operator==(VLString<StaticCapacity> const &lhs, std::string_view rhs) noexcept
+{
+    return std::string_view(lhs) == rhs;
+}
+
+template<size_t StaticCapacity>
+bool operator==(std::string_view lhs, VLString<StaticCapacity> const &rhs) noexcept
+{
+    return rhs == lhs;
+}
+
+template<size_t StaticCapacity>
+bool operator!=(VLString<StaticCapacity> const &lhs, std::string_view rhs) noexcept
+{
+    return !(lhs == rhs);
+}
+
+template<size_t StaticCapacity>
+bool operator!=(std::string_view lhs, VLString<StaticCapacity> const &rhs) noexcept
+{
+    return !(rhs == lhs);
+}
+
+namespace std
+{
+    /**
+     * Hash of a VLString, consistent with its operator==, by the bulk hash of its characters.
+     */
+    template<size_t StaticCapacity>
+    struct hash<VLString<StaticCapacity>>
+    {
+        size_t operator()(VLString<StaticCapacity> const &str) const noexcept
+        {
+            return (size_t) vlvhash::bytes(str.data(), str.size());
+        }
+    };
+}
+
+
+#endif //CPP_EXAM_VLSTRING_HPP
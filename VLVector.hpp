@@ -11,7 +11,28 @@
 #ifndef CPP_EXAM_VLVECTOR_HPP
 #define CPP_EXAM_VLVECTOR_HPP
 
+#include "VLVectorSimd.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#if __has_include(<version>)
+
+#include <version>
+
+#endif
+
+#if defined(__cpp_impl_three_way_comparison) && defined(__cpp_lib_three_way_comparison)
+
+#include <compare>
+
+#define VLV_THREE_WAY_COMPARISON
+
+#endif
 
 #define DEFAULT_STATIC_CAPACITY 16
 
@@ -23,333 +44,365 @@
 
 #define NEXT_ELEM 1
 
+#ifndef INCREASE_FACTOR
 #define INCREASE_FACTOR 3 / 2
+#endif
+
+#ifndef SHRINK_TO_STATIC
+#define SHRINK_TO_STATIC true
+#endif
 
 #define OUT_OF_RANGE_MSG "VLVector::_M_range_check: __n >= this->size()"
 
-template<class T, size_t StaticCapacity = DEFAULT_STATIC_CAPACITY>
+#ifdef VLVECTOR_TRACE
+
+#include "VLVectorTrace.hpp"
+
+#define VLV_TRACE(...) VLVectorTrace::record(__VA_ARGS__)
+
+#else
+
+#define VLV_TRACE(...)
+
+#endif
 
 /**
- * A Virtual length vector. Has a static capacity of StaticCapacity, when exceeded the elements are moved to dynamically
- * allocate space.
- * @tparam T The type of the elements.
+ * Marks the lazy element-wise expressions of VLVectorExpr.hpp, which a VLVector can be assigned from.
  */
-class VLVector
+template<class Expr>
+struct IsVLVectorExpr : std::false_type
 {
-private:
+};
 
+template<class T, size_t StaticCapacity>
+class VLVector;
 
-    T _statData[StaticCapacity];
-    bool _dynamic = false;
-    size_t _size;
-    size_t _capacity;
-    T *_curData;
+/**
+ * Comparisons of two arrays of elements, shared by the containers of the library.
+ */
+namespace vlvcompare
+{
+    /**
+     * @brief true if every element of type T is equal to itself, so arrays which share their elements are equal
+     * without comparing them. A floating element may be a NaN, and other types may hold one or define operator== as
+     * they please: only elements whose equality is equality of their bytes are known to be.
+     */
+    template<class T>
+    constexpr bool reflexive = std::has_unique_object_representations<T>::value;
 
     /**
-     * @brief Updates the capacity, allocates dynamic memory for a new array, copies all of the elements to it, deletes
-     * the previous array if it was dynamically allocated and changes to pointer to point on the new array.
+     * @return true if the first n elements of lhs and rhs are equal. Elements whose equality is equality of their
+     * bytes are compared by memcmp, other arithmetic elements by the SIMD mismatch kernel.
      */
-    void _increaseCapacity()
+    template<class T>
+    bool equalElements(const T *lhs, const T *rhs, size_t n)
     {
-        _capacity = (_size + INCREASE_INC) * INCREASE_FACTOR;
-        T *temp = new T[(size_t) (sizeof(T) * _capacity)](); //creates an array of the size specified by the formula.
-        for (size_t i = FIRST_IDX; i < _size; ++i)
+        if constexpr (std::has_unique_object_representations<T>::value)
         {
-            temp[i] = data()[i];
+            return !n || !std::memcmp(lhs, rhs, n * sizeof(T));
         }
-        if (_dynamic)
+        else if constexpr (vlvsimd::IsSimdElement<T>::value)
         {
-            delete[] _curData;
+            return vlvsimd::mismatch(lhs, rhs, n) == n;
+        }
+        else
+        {
+            return std::equal(lhs, lhs + n, rhs);
         }
-        _curData = temp, _dynamic = true;
     }
 
+#ifdef VLV_THREE_WAY_COMPARISON
+
     /**
-     * Copies all of the elements to the static array, deletes the previous array, updates the stats accordingly
+     * @brief operator<=> of two elements, synthesized from operator< for element types which have no operator<=>.
      */
-    void _decreaseCapacity() //being called to only if dynamic == true.
+    template<class T>
+    constexpr auto compareElement(T const &lhs, T const &rhs)
     {
-        for (size_t idx = FIRST_IDX; idx < _size; ++idx)
+        if constexpr (std::three_way_comparable<T>)
         {
-            _statData[idx] = _curData[idx];
+            return lhs <=> rhs;
+        }
+        else
+        {
+            return lhs < rhs ? std::weak_ordering::less
+                             : rhs < lhs ? std::weak_ordering::greater : std::weak_ordering::equivalent;
         }
-        delete[] _curData;
-        _curData = &(_statData[FIRST_IDX]);
-        _capacity = StaticCapacity;
-        _dynamic = false;
     }
 
-public:
+    /**
+     * The ordering compareElement returns for elements of type T.
+     */
+    template<class T>
+    using Ordering = decltype(compareElement(std::declval<T const &>(), std::declval<T const &>()));
 
-    template<bool Const = false>
     /**
-     * @brief A template class for VLV iterator/const_iterator.
-     * @tparam Const Indicator for const_iterator.
+     * @brief Lexicographic three way comparison. Byte sized unsigned elements are ordered by memcmp, other arithmetic
+     * elements by comparing the first mismatch found by the SIMD kernel.
      */
-    class Iterator
+    template<class T>
+    Ordering<T> compareElements(const T *lhs, size_t lhsSize, const T *rhs, size_t rhsSize)
     {
-    public:
-        typedef T value_type;
-        typedef ptrdiff_t difference_type;
-        typedef std::random_access_iterator_tag iterator_category;
-        typedef typename std::conditional_t<Const, T const &, T &> reference;
-        typedef typename std::conditional_t<Const, T const *, T *> pointer;
-    private:
-        pointer _cur;
-    public:
-        /**
-         * @brief C'tor for iterator
-         * @param cur A pointer to a place in a VLV. casted to const if Const == true.
-         */
-        Iterator(pointer cur) : _cur{reinterpret_cast<pointer>(cur)} //casting not const to const if needed.
+        size_t common = std::min(lhsSize, rhsSize);
+        if constexpr (std::is_unsigned<T>::value && sizeof(T) == 1)
         {
+            int order = common ? std::memcmp(lhs, rhs, common) : 0;
+            return order ? (order < 0 ? Ordering<T>::less : Ordering<T>::greater) : Ordering<T>(lhsSize <=> rhsSize);
         }
-
-        /**
-         * @brief A copy c'tor. For copying iterator to const_iterator, and iterator to itself.
-         * @param toCopy The iterator to copy.
-         */
-        Iterator(const Iterator<false> &toCopy) : _cur(&(*toCopy)) //const iterator has a default copy c'tor for itself
+        else if constexpr (vlvsimd::IsSimdElement<T>::value)
         {
+            size_t idx = vlvsimd::mismatch(lhs, rhs, common);
+            return idx < common ? compareElement(lhs[idx], rhs[idx]) : Ordering<T>(lhsSize <=> rhsSize);
         }
-
-        /**
-         * @brief Dereference for a const_iterator.
-         * @tparam IsConst The type of the iterator.
-         * @return The value of the item referenced by the iterator.
-         */
-        template<bool IsConst = Const> //so that will appear only in const iterator class.
-        std::enable_if_t<IsConst, reference>
-        operator*() const noexcept
+        else
         {
-            return *_cur;
+            return std::lexicographical_compare_three_way(lhs, lhs + lhsSize, rhs, rhs + rhsSize,
+                                                          compareElement<T>);
         }
+    }
 
+#else
 
-        /**
-         * @brief Dereference for iterator.
-         * @tparam IsConst The type of the iterator.
-         * @return A reference to the value of the item referenced by the iterator.
-         */
-        template<bool IsConst = Const> //so that will appear only in non-const iterator class.
-        std::enable_if_t<!IsConst, reference>
-        operator*() const noexcept
+    /**
+     * @return true if lhs is lexicographically smaller than rhs. Integral elements are ordered by comparing the first
+     * mismatch found by the SIMD kernel.
+     */
+    template<class T>
+    bool lessElements(const T *lhs, size_t lhsSize, const T *rhs, size_t rhsSize)
+    {
+        if constexpr (std::is_integral<T>::value && vlvsimd::IsSimdElement<T>::value)
         {
-            return *_cur;
+            size_t common = std::min(lhsSize, rhsSize);
+            size_t idx = vlvsimd::mismatch(lhs, rhs, common);
+            return idx < common ? lhs[idx] < rhs[idx] : lhsSize < rhsSize;
         }
-
-        /**
-         * @brief Assignment operator. works the same as the c'tor.
-         * @param ptr A pointer to a place in a VLV. casted to const if Const == true.
-         * @return A ref to the current iterator.
-         */
-        Iterator &operator=(pointer ptr) const
+        else
         {
-            _cur = ptr;
-            return *this;
+            return std::lexicographical_compare(lhs, lhs + lhsSize, rhs, rhs + rhsSize);
         }
+    }
 
-        /**
-         * @brief Same as the copy c'tor. Can copy iterator of the same type or iterator to const_iterator.
-         * @param toCopy The iterator to copy.
-         * @return A ref to the current iterator.
-         */
-        Iterator &operator=(Iterator const &toCopy)
-        {
-            (*this)(toCopy);
-            return *this;
-        }
+#endif
+}
 
-        /**
-         * Equality check
-         */
-        friend bool
-        operator==(Iterator const &lhs, Iterator const &rhs) //friend - for working on all iterator type combinations
-        {
-            return lhs._cur == rhs._cur;
-        }
+/**
+ * The part of VLVector<T, StaticCapacity> which does not depend on StaticCapacity: every operation but construction,
+ * so it is compiled once per element type however many static capacities are used, and code can take a VLVectorBase<T>
+ * reference to accept a VLVector of any static capacity without being a template on it. The VLVector hands the base a
+ * pointer to its static storage, which is how the base tells the storage from a dynamic array.
+ * @tparam T The type of the elements.
+ */
+template<class T>
+class VLVectorBase
+{
+private:
+    template<class, size_t> friend
+    class VLVector;
 
-        /**
-         * Inequality check
-         */
-        friend bool operator!=(Iterator const &lhs, Iterator const &rhs)
-        {
-            return lhs._cur != rhs._cur;
-        }
+    T *_curData;
+    T *_staticData; //the static storage of the VLVector this is the base of.
+    size_t _size;
+    size_t _capacity;
+    size_t _staticCapacity;
+#ifdef VLVECTOR_TRACE
+    uint64_t _traceId = VLVectorTrace::newId();
+#endif
 
-        /**
-         * Bigger check
-         */
-        friend bool operator>(Iterator const &lhs, Iterator const &rhs)
-        {
-            return lhs._cur > rhs._cur;
-        }
+    /**
+     * @return true if the elements are in a dynamically allocated array.
+     */
+    bool _dynamic() const noexcept
+    {
+        return _curData != _staticData;
+    }
 
-        /**
-         * Bigger/equal check
-         */
-        friend bool operator>=(Iterator const &lhs, Iterator const &rhs)
-        {
-            return lhs._cur >= rhs._cur;
-        }
+protected:
+    /**
+     * @brief An empty container in statData, the static storage of the VLVector, which holds staticCapacity
+     * elements. Only VLVector creates it.
+     */
+    VLVectorBase(size_t staticCapacity, T *statData) noexcept : _curData(statData), _staticData(statData),
+                                                                _size(STARTING_SIZE), _capacity(staticCapacity),
+                                                                _staticCapacity(staticCapacity)
+    {
+    }
 
-        /**
-         * Smaller check
-         */
-        friend bool operator<(Iterator const &lhs, Iterator const &rhs)
+    /**
+     * @brief Frees data if dynamically allocated. Protected, so a VLVector is never deleted through its base.
+     */
+    ~VLVectorBase()
+    {
+        VLV_TRACE(TRACE_DESTROY, _traceId);
+        if (_dynamic())
         {
-            return lhs._cur < rhs._cur;
+            delete[] _curData;
         }
+    }
 
-        /**
-         * Small/equal check
-         */
-        friend bool operator<=(Iterator const &lhs, Iterator const &rhs)
-        {
-            return lhs._cur <= rhs._cur;
-        }
+private:
+
+    /**
+     * @brief Updates the capacity, allocates dynamic memory for a new array, copies all of the elements to it, deletes
+     * the previous array if it was dynamically allocated and changes to pointer to point on the new array.
+     * @param toHold The amount of elements the new capacity is computed from.
+     */
+    void _increaseCapacity(size_t toHold)
+    {
+        _reallocate((toHold + INCREASE_INC) * INCREASE_FACTOR); //the size specified by the formula.
+    }
 
-        /**
-         * @brief Iterator subtraction.
-         * @param lhs An iterator.
-         * @param rhs Another iterator.
-         * @return The distance between the iterators' pointers.
-         */
-        friend difference_type operator-(Iterator const &lhs, Iterator const &rhs) noexcept
+    /**
+     * @brief Moves the elements to a new dynamic array of exactly newCapacity elements. See _increaseCapacity.
+     */
+    void _reallocate(size_t newCapacity)
+    {
+        T *temp = new T[newCapacity](); //allocated first, so a throw leaves the VLVector as it was.
+        _capacity = newCapacity;
+        for (size_t i = FIRST_IDX; i < _size; ++i)
         {
-            difference_type temp(lhs._cur - rhs._cur);
-            return temp;
+            temp[i] = data()[i];
         }
-
-        /**
-         * @brief Add rhs to the iterator.
-         * @return The iterator after being moved rhs items forward.
-         */
-        Iterator &operator+=(difference_type const &rhs) noexcept
+        if (_dynamic())
         {
-            _cur += rhs;
-            return *this;
+            delete[] _curData;
         }
+        _curData = temp;
+    }
 
-        /**
-         * @brief Add rhs and the iterator. Doesn't change the iterator's pointer value.
-         * @return The iterator after being moved rhs items forward.
-         */
-        Iterator operator+(difference_type const &rhs) noexcept
+    /**
+     * Copies all of the elements to the static array, deletes the previous array, updates the stats accordingly
+     */
+    void _decreaseCapacity() //being called to only if dynamic == true.
+    {
+        for (size_t idx = FIRST_IDX; idx < _size; ++idx)
         {
-            Iterator temp(_cur + rhs);
-            return temp;
+            _staticData[idx] = _curData[idx];
         }
+        delete[] _curData;
+        _curData = _staticData;
+        _capacity = _staticCapacity;
+    }
 
-        /**
-         * @brief Subtracts rhs from the iterator.
-         * @return The iterator after being moved rhs items backwards.
-         */
-        Iterator &operator-=(difference_type const &rhs) noexcept
+    /**
+     * @brief Replaces the content of the VLVector by a copy of rhs. Keeps the current storage if it can hold the
+     * elements of rhs, otherwise allocates exactly as many, whatever the capacity of rhs. Shrinks back to the static
+     * storage like erase does. Not traced, shared by the copy c'tors and operator=.
+     */
+    void _assign(VLVectorBase const &rhs)
+    {
+        if (rhs.size() > _capacity)
         {
-            _cur -= rhs;
-            return *this;
+            _size = STARTING_SIZE; //nothing to keep.
+            _reallocate(rhs.size());
         }
-
-        /**
-         * @brief Subtracts rhs from the iterator. Doesn't change the iterator's pointer value.
-         * @return The iterator after being moved rhs items backwards.
-         */
-        Iterator operator-(difference_type const &rhs) noexcept
+        else if (SHRINK_TO_STATIC && rhs.size() <= _staticCapacity && _dynamic())
         {
-            Iterator temp(_cur - rhs);
-            return temp;
+            delete[] _curData;
+            _curData = _staticData;
+            _capacity = _staticCapacity;
         }
+        std::copy(rhs.data(), rhs.data() + rhs.size(), _curData);
+        _size = rhs.size();
+    }
 
-        /**
-         * @brief A prefix single place addition.
-         * @return The iterator after being moved one step forward.
-         */
-        Iterator &operator++() noexcept
+    /**
+     * @brief Replaces the content of the VLVector by the elements of rhs and empties rhs. A dynamic array of rhs
+     * whose elements the static storage can not hold is taken over, other elements are moved one by one. Not traced,
+     * shared by the move c'tor and the move operator=.
+     */
+    void _take(VLVectorBase &rhs)
+    {
+        if (rhs._dynamic() && rhs._size > _staticCapacity)
         {
-            ++_cur;
-            return *this;
+            if (_dynamic())
+            {
+                delete[] _curData;
+            }
+            _curData = rhs._curData;
+            _capacity = rhs._capacity;
+            _size = rhs._size;
+            rhs._curData = rhs._staticData;
+            rhs._capacity = rhs._staticCapacity;
+            rhs._size = STARTING_SIZE;
+            return;
         }
-
-        /**
-         * @brief A postfix single place addition.
-         * @return The iterator before being moved one step forward.
-         */
-        Iterator operator++(int) noexcept
+        if (rhs._size > _capacity)
         {
-            Iterator temp = *this;
-            ++_cur;
-            return temp;
+            _size = STARTING_SIZE;
+            _reallocate(rhs._size);
         }
-
-        /**
-         * @brief A prefix single place subtraction.
-         * @return The iterator after being moved one step backwards.
-         */
-        Iterator &operator--() noexcept
+        else if (SHRINK_TO_STATIC && rhs._size <= _staticCapacity && _dynamic())
         {
-            --_cur;
-            return *this;
+            delete[] _curData;
+            _curData = _staticData;
+            _capacity = _staticCapacity;
         }
-
-        /**
-         * @brief A postfix single place subtraction.
-         * @return The iterator before being moved one step backwards.
-         */
-        Iterator operator--(int) noexcept
+        std::move(rhs.data(), rhs.data() + rhs._size, _curData);
+        _size = rhs._size;
+        rhs._size = STARTING_SIZE;
+        if (rhs._dynamic())
         {
-            Iterator temp = *this;
-            --_cur;
-            return temp;
+            delete[] rhs._curData;
+            rhs._curData = rhs._staticData;
+            rhs._capacity = rhs._staticCapacity;
         }
-    };
-
-    typedef Iterator<false> iterator;
-    typedef Iterator<true> const_iterator;
-
-    /**
-     * @brief A regular c'tor.
-     */
-    VLVector() : _size(STARTING_SIZE), _capacity(StaticCapacity)
-    {
-        _curData = &(_statData[FIRST_IDX]);
     }
 
     /**
-     * @brief A copy ctor.
-     * @param toCopy The VLVector to copy.
+     * @brief Sets the size of the elements already in place, traced as an insert or an erase at the end. Shrinks back
+     * to the static storage like erase does.
      */
-    VLVector(VLVector const &toCopy)
-            : VLVector()
+    void _setSize(size_t newSize)
     {
-        this->operator=(toCopy);
+        if (newSize > _size)
+        {
+            VLV_TRACE(TRACE_INSERT, _traceId, _size, newSize - _size);
+        }
+        else if (newSize < _size)
+        {
+            VLV_TRACE(TRACE_ERASE, _traceId, newSize, _size - newSize);
+        }
+        _size = newSize;
+        if (SHRINK_TO_STATIC && _size <= _staticCapacity && _dynamic())
+        {
+            _decreaseCapacity();
+        }
     }
 
     /**
-     * @brief A c'tor from a set of items.
-     * @tparam InputIterator The iterator that is given by the user.
-     * @param first The first item to copy.
-     * @param last The first item after the items to copy.
+     * @brief Discards the elements and makes the size n, keeping the current storage if it can hold n elements.
      */
-    template<class InputIterator>
-    VLVector(InputIterator first, InputIterator last) : VLVector()
+    void _overwriteSize(size_t n)
     {
-        while (first != last)
+        if (n > _capacity)
         {
-            push_back(*(first++));
+            _size = STARTING_SIZE;
+            _increaseCapacity(n);
         }
+        _size = n;
     }
 
+public:
+
+    typedef T value_type;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    typedef T &reference;
+    typedef T const &const_reference;
+    typedef T *pointer;
+    typedef T const *const_pointer;
+
     /**
-     * @brief Destructor. Frees data if dynamically allocated.
+     * The iterators are plain pointers into the contiguous elements, so they are contiguous iterators (and a VLVector
+     * a contiguous, sized range), and the standard algorithms take their pointer paths: std::copy memmoves trivially
+     * copyable elements, and std::span views a VLVector without copying it.
      */
-    ~VLVector()
-    {
-        if (_dynamic)
-        {
-            delete[] _curData;
-        }
-    }
+    typedef T *iterator;
+    typedef T const *const_iterator;
+    typedef std::reverse_iterator<iterator> reverse_iterator;
+    typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    VLVectorBase(VLVectorBase const &) = delete;
 
     /**
      * @return The current amount of elements in the container.
@@ -400,27 +453,78 @@ public:
     }
 
     /**
-     * @brief Adds toAdd to the back of the VLVector.
+     * @brief Makes the capacity at least newCapacity, allocating exactly newCapacity elements if it is not.
+     */
+    void reserve(size_t newCapacity)
+    {
+        if (newCapacity > _capacity)
+        {
+            _reallocate(newCapacity);
+        }
+    }
+
+    /**
+     * @brief Changes the size to newSize. New elements are copies of value, removed ones are left like pop_back does.
+     * value may be an element of the VLVector: it is copied before the elements move.
+     */
+    void resize(size_t newSize, T const &value = T())
+    {
+        if (newSize > _capacity)
+        {
+            T fill(value);
+            _increaseCapacity(newSize);
+            std::fill(data() + _size, data() + newSize, fill);
+        }
+        else if (newSize > _size)
+        {
+            std::fill(data() + _size, data() + newSize, value);
+        }
+        _setSize(newSize);
+    }
+
+    /**
+     * @brief Makes the capacity at least maxSize and lets op write the elements directly, as std::string does in
+     * C++23: op(data(), maxSize) gets the buffer with the current elements in place, may write up to maxSize elements
+     * and returns the new size, which must not exceed maxSize. Saves filling elements which are overwritten anyway.
+     */
+    template<class Operation>
+    void resize_and_overwrite(size_t maxSize, Operation op)
+    {
+        if (maxSize > _capacity)
+        {
+            _increaseCapacity(maxSize);
+        }
+        _setSize((size_t) op(data(), maxSize));
+    }
+
+    /**
+     * @brief Adds toAdd, which may be an element of the VLVector, to the back of the VLVector.
      */
     void push_back(const T &toAdd)
     {
+        VLV_TRACE(TRACE_PUSH_BACK, _traceId);
         if (_size == _capacity)
         {
-            _increaseCapacity();
+            T copy(toAdd); //the growth frees the array toAdd may be in.
+            _increaseCapacity(_size);
+            data()[_size++] = copy;
+            return;
         }
         data()[_size++] = toAdd;
     }
 
     /**
-     * @brief Inserts toAdd before iter.
+     * @brief Inserts toAdd, which may be an element of the VLVector, before iter.
      * @return An iter pointing to the new element.
      */
     iterator insert(const_iterator iter, const T &toAdd)
     {
         size_t inPlc = iter - cbegin();
+        VLV_TRACE(TRACE_INSERT, _traceId, inPlc, INCREASE_INC);
+        T copy(toAdd); //the elements move and may be reallocated.
         if (_size == _capacity)
         {
-            _increaseCapacity();
+            _increaseCapacity(_size);
         }
         const_iterator toCopy = cend();
         iterator copyTo = end();
@@ -428,7 +532,7 @@ public:
         {
             *(copyTo--) = *toCopy;
         }
-        *copyTo = toAdd;
+        *copyTo = copy;
         _size++;
         return copyTo;
     }
@@ -443,19 +547,16 @@ public:
     insert(const_iterator iter, InputIterator const first, InputIterator const last)
     {
         size_t inPlc = iter - cbegin();
-        const_iterator curPlc = iter;
-        VLVector<T, StaticCapacity> after; //saves all of the objects to the right of the place to insert to.
-        while (curPlc != cend())
-        {
-            after.push_back(*(curPlc++));
-        }
-        if ((_size += (last - first)) > _capacity)
+        VLV_TRACE(TRACE_INSERT, _traceId, inPlc, last - first);
+        size_t newSize = _size + (last - first);
+        if (newSize > _capacity)
         {
-            _increaseCapacity();
+            _increaseCapacity(newSize);
         }
         iterator toIns = begin() + inPlc; //finds the place to start the insertion to.
+        std::copy_backward(toIns, end(), begin() + newSize); //old items to the right of the insertion place.
+        _size = newSize;
         std::copy(first, last, toIns); //new items
-        std::copy(after.begin(), after.end(), toIns + (last - first)); //old items to the right of the insertion place.
         return toIns;
     }
 
@@ -465,8 +566,9 @@ public:
      */
     void pop_back()
     {
+        VLV_TRACE(TRACE_POP_BACK, _traceId);
         --_size;
-        if (_size <= StaticCapacity && _dynamic)
+        if (SHRINK_TO_STATIC && _size <= _staticCapacity && _dynamic())
         {
             _decreaseCapacity();
         }
@@ -479,15 +581,12 @@ public:
      */
     iterator erase(const_iterator iter)
     {
-        iterator insTo = begin(); //gets a non-const iterator to the same place as iter.
-        while (insTo != iter)
-        {
-            ++insTo;
-        }
+        iterator insTo = begin() + (iter - cbegin()); //gets a non-const iterator to the same place as iter.
+        VLV_TRACE(TRACE_ERASE, _traceId, insTo - begin(), NEXT_ELEM);
         iterator first = insTo + NEXT_ELEM;
         std::copy(first, end(), insTo); //copies everything one space to the left.
         --_size;
-        if (_size <= StaticCapacity && _dynamic)
+        if (SHRINK_TO_STATIC && _size <= _staticCapacity && _dynamic())
         {
             _decreaseCapacity();
         }
@@ -502,9 +601,10 @@ public:
     iterator erase(const_iterator first, const_iterator last)
     {
         iterator copyTo = begin() + (first - cbegin()); //gets a non-const iterator to the same place as iter.
+        VLV_TRACE(TRACE_ERASE, _traceId, first - cbegin(), last - first);
         std::copy(last, cend(), copyTo); //copies everything the desired amount of spaces to the left.
         _size -= last - first;
-        if (_size <= StaticCapacity && _dynamic)
+        if (SHRINK_TO_STATIC && _size <= _staticCapacity && _dynamic())
         {
             _decreaseCapacity();
         }
@@ -516,11 +616,12 @@ public:
      */
     void clear() noexcept
     {
-        if (_dynamic)
+        VLV_TRACE(TRACE_CLEAR, _traceId);
+        if (_dynamic())
         {
             delete[] _curData;
-            _curData = &(_statData[FIRST_IDX]);
-            _dynamic = false;
+            _curData = _staticData;
+            _capacity = _staticCapacity;
         }
         _size = STARTING_SIZE;
     }
@@ -557,41 +658,156 @@ public:
         return data()[idx];
     }
 
+    /**
+     * @return The first element. The container must not be empty.
+     */
+    T &front() noexcept
+    {
+        return data()[FIRST_IDX];
+    }
+
+    /**
+     * @return The first element. Const version.
+     */
+    const T &front() const noexcept
+    {
+        return data()[FIRST_IDX];
+    }
+
+    /**
+     * @return The last element. The container must not be empty.
+     */
+    T &back() noexcept
+    {
+        return data()[_size - NEXT_ELEM];
+    }
+
+    /**
+     * @return The last element. Const version.
+     */
+    const T &back() const noexcept
+    {
+        return data()[_size - NEXT_ELEM];
+    }
+
     /**
      * @return true if all of the elements in both of the containers are equal. false otherwise.
      */
-    bool operator==(VLVector const &toComp) const
+    bool operator==(VLVectorBase const &toComp) const
     {
-        return (size() == toComp.size() && std::equal(cbegin(), cend(), toComp.cbegin()));
+        if (size() != toComp.size())
+        {
+            return false;
+        }
+        return (vlvcompare::reflexive<T> && data() == toComp.data()) ||
+               vlvcompare::equalElements(data(), toComp.data(), size());
     }
 
     /**
      * @return false if all of the elements in both of the containers are equal. true otherwise.
      */
-    bool operator!=(VLVector const &toComp) const
+    bool operator!=(VLVectorBase const &toComp) const
     {
         return !((*this).operator==(toComp));
     }
 
+#ifdef VLV_THREE_WAY_COMPARISON
+
     /**
-     * @brief Assigns values equal to the values of rhs to the VLVector.
+     * @return The lexicographic order of the containers, by the elements' operator<=> (or operator< if they have none).
+     */
+    auto operator<=>(VLVectorBase const &toComp) const
+    {
+        if (vlvcompare::reflexive<T> && data() == toComp.data())
+        {
+            return vlvcompare::Ordering<T>(size() <=> toComp.size());
+        }
+        return vlvcompare::compareElements(data(), size(), toComp.data(), toComp.size());
+    }
+
+#else
+
+    /**
+     * @return true if the container is lexicographically smaller than toComp.
+     */
+    bool operator<(VLVectorBase const &toComp) const
+    {
+        return data() != toComp.data() && vlvcompare::lessElements(data(), size(), toComp.data(), toComp.size());
+    }
+
+    /**
+     * @return true if the container is lexicographically bigger than toComp.
+     */
+    bool operator>(VLVectorBase const &toComp) const
+    {
+        return toComp < *this;
+    }
+
+    /**
+     * @return true if the container is not lexicographically bigger than toComp.
+     */
+    bool operator<=(VLVectorBase const &toComp) const
+    {
+        return !(toComp < *this);
+    }
+
+    /**
+     * @return true if the container is not lexicographically smaller than toComp.
+     */
+    bool operator>=(VLVectorBase const &toComp) const
+    {
+        return !(*this < toComp);
+    }
+
+#endif
+
+    /**
+     * @brief Assigns values equal to the values of rhs, a VLVector of any static capacity, to the VLVector.
      * @return The assigned vector by ref.
      */
-    VLVector<T, StaticCapacity> &operator=(VLVector const &rhs)
+    VLVectorBase &operator=(VLVectorBase const &rhs)
     {
         if (this != &rhs)
         {
-            if (_dynamic)
-            {
-                delete[] _curData;
-            }
-            _capacity = rhs.capacity();
-            if (_capacity > StaticCapacity)
-            {
-                _curData = new T[_capacity * sizeof(T)]();
-                _dynamic = true;
-            }
-            insert(begin(), rhs.cbegin(), rhs.cend());
+            VLV_TRACE(TRACE_ASSIGN, _traceId, rhs._traceId);
+            _assign(rhs);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Moves the elements of rhs, a VLVector of any static capacity, to the VLVector, leaving rhs empty. Takes
+     * over the dynamic array of rhs rather than copying, unless the static storage can hold its elements.
+     * @return The assigned vector by ref.
+     */
+    VLVectorBase &operator=(VLVectorBase &&rhs)
+    {
+        if (this != &rhs)
+        {
+            VLV_TRACE(TRACE_MOVE_ASSIGN, _traceId, rhs._traceId);
+            _take(rhs);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Evaluates a lazy element-wise expression of VLVectorExpr.hpp in a single loop, into the storage the
+     * VLVector already has if it is large enough. The VLVector may be an operand of the expression: element i is only
+     * computed from elements i of the operands.
+     * @return The assigned vector by ref.
+     */
+    template<class Expr, class = std::enable_if_t<IsVLVectorExpr<Expr>::value>>
+    VLVectorBase &operator=(Expr const &expr)
+    {
+        size_t n = expr.size();
+        VLV_TRACE(TRACE_CLEAR, _traceId); // replayed as a clear and a fill of n elements.
+        VLV_TRACE(TRACE_INSERT, _traceId, FIRST_IDX, n);
+        _overwriteSize(n);
+        T *dst = data();
+#pragma GCC ivdep
+        for (size_t i = FIRST_IDX; i < n; ++i)
+        {
+            dst[i] = (T) expr[i];
         }
         return *this;
     }
@@ -643,6 +859,176 @@ public:
     {
         return const_iterator(&(data()[_size]));
     }
+
+    /**
+     * @return A reverse_iterator pointing to the last element of the container.
+     */
+    reverse_iterator rbegin() noexcept
+    {
+        return reverse_iterator(end());
+    }
+
+    /**
+     * @return A reverse_iterator pointing before the first element of the container.
+     */
+    reverse_iterator rend() noexcept
+    {
+        return reverse_iterator(begin());
+    }
+
+    /**
+     * @return A const_reverse_iterator pointing to the last element of the container.
+     */
+    const_reverse_iterator rbegin() const noexcept
+    {
+        return const_reverse_iterator(end());
+    }
+
+    /**
+     * @return A const_reverse_iterator pointing before the first element of the container.
+     */
+    const_reverse_iterator rend() const noexcept
+    {
+        return const_reverse_iterator(begin());
+    }
+
+    /**
+     * @return A const_reverse_iterator pointing to the last element of the container.
+     */
+    const_reverse_iterator crbegin() const noexcept
+    {
+        return rbegin();
+    }
+
+    /**
+     * @return A const_reverse_iterator pointing before the first element of the container.
+     */
+    const_reverse_iterator crend() const noexcept
+    {
+        return rend();
+    }
+};
+
+
+/**
+ * A Virtual length vector. Has a static capacity of StaticCapacity, when exceeded the elements are moved to dynamically
+ * allocate space. All of the operations are those of VLVectorBase<T>: the VLVector only adds the static storage.
+ * @tparam T The type of the elements.
+ */
+template<class T, size_t StaticCapacity = DEFAULT_STATIC_CAPACITY>
+class VLVector : public VLVectorBase<T>
+{
+private:
+    T _statData[StaticCapacity];
+
+public:
+    /**
+     * @brief A regular c'tor.
+     */
+    VLVector() : VLVectorBase<T>(StaticCapacity, _statData)
+    {
+        VLV_TRACE(TRACE_CREATE, this->_traceId, sizeof(T), StaticCapacity);
+    }
+
+    /**
+     * @brief A copy ctor.
+     * @param toCopy The VLVector to copy.
+     */
+    VLVector(VLVector const &toCopy) : VLVectorBase<T>(StaticCapacity, _statData)
+    {
+        VLV_TRACE(TRACE_COPY, this->_traceId, toCopy._traceId, sizeof(T), StaticCapacity);
+        this->_assign(toCopy);
+    }
+
+    /**
+     * @brief A move ctor. Takes over the dynamic array of toMove, or moves its elements out of its static storage,
+     * leaving toMove empty either way.
+     * @param toMove The VLVector to move.
+     */
+    VLVector(VLVector &&toMove) noexcept(std::is_nothrow_move_assignable<T>::value)
+            : VLVectorBase<T>(StaticCapacity, _statData)
+    {
+        VLV_TRACE(TRACE_MOVE, this->_traceId, toMove._traceId, sizeof(T), StaticCapacity);
+        this->_take(toMove);
+    }
+
+    /**
+     * @brief A copy ctor from a VLVector of another static capacity.
+     * @param toCopy The VLVector to copy.
+     */
+    explicit VLVector(VLVectorBase<T> const &toCopy) : VLVectorBase<T>(StaticCapacity, _statData)
+    {
+        VLV_TRACE(TRACE_COPY, this->_traceId, toCopy._traceId, sizeof(T), StaticCapacity);
+        this->_assign(toCopy);
+    }
+
+    /**
+     * @brief A move ctor from a VLVector of another static capacity, leaving toMove empty. Not noexcept: elements in
+     * a static storage larger than StaticCapacity are moved to a new dynamic array.
+     * @param toMove The VLVector to move.
+     */
+    explicit VLVector(VLVectorBase<T> &&toMove) : VLVectorBase<T>(StaticCapacity, _statData)
+    {
+        VLV_TRACE(TRACE_MOVE, this->_traceId, toMove._traceId, sizeof(T), StaticCapacity);
+        this->_take(toMove);
+    }
+
+    /**
+     * @brief A c'tor from a set of items.
+     * @tparam InputIterator The iterator that is given by the user.
+     * @param first The first item to copy.
+     * @param last The first item after the items to copy.
+     */
+    template<class InputIterator>
+    VLVector(InputIterator first, InputIterator last) : VLVector()
+    {
+        while (first != last)
+        {
+            this->push_back(*(first++));
+        }
+    }
+
+    /**
+     * @brief A c'tor from a lazy element-wise expression of VLVectorExpr.hpp. See operator=.
+     */
+    template<class Expr, class = std::enable_if_t<IsVLVectorExpr<Expr>::value>>
+    VLVector(Expr const &expr) : VLVector()
+    {
+        *this = expr;
+    }
+
+    using VLVectorBase<T>::operator=;
+
+    /**
+     * @brief Assigns values equal to the values of rhs to the VLVector.
+     * @return The assigned vector by ref.
+     */
+    VLVector &operator=(VLVector const &rhs)
+    {
+        VLVectorBase<T>::operator=(rhs);
+        return *this;
+    }
+
+    /**
+     * @brief Moves the elements of rhs to the VLVector, leaving rhs empty. See VLVectorBase::operator=.
+     * @return The assigned vector by ref.
+     */
+    VLVector &operator=(VLVector &&rhs) noexcept(std::is_nothrow_move_assignable<T>::value)
+    {
+        VLVectorBase<T>::operator=(std::move(rhs));
+        return *this;
+    }
+
+    /**
+     * @brief Evaluates a lazy element-wise expression of VLVectorExpr.hpp. See VLVectorBase::operator=.
+     * @return The assigned vector by ref.
+     */
+    template<class Expr, class = std::enable_if_t<IsVLVectorExpr<Expr>::value>>
+    VLVector &operator=(Expr const &expr)
+    {
+        VLVectorBase<T>::operator=(expr);
+        return *this;
+    }
 };
 
 
@@ -0,0 +1,356 @@
+/**
+ * @file VLVectorExpr.hpp
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ *
+ * @brief Lazy element-wise arithmetic on VLVectors of arithmetic elements.
+ *
+ * @section DESCRIPTION +, -, * and / of VLVectors, of scalars and of other expressions build expression templates
+ * instead of vectors. Nothing is computed until an expression is assigned to a VLVector: a = b * 2 + c - d runs a
+ * single loop over the elements, with no temporary vectors, and writes into the storage a already has. Expressions
+ * hold pointers to the elements of their operand vectors, so they must be assigned before any operand changes size.
+ * The operand vectors must all be of the same size.
+ */
+#ifndef CPP_EXAM_VLVECTOREXPR_HPP
+#define CPP_EXAM_VLVECTOREXPR_HPP
+
+#include "VLVector.hpp"
+#include "VLVectorSimd.hpp"
+
+#include <stdexcept>
+#include <type_traits>
+
+#define NO_SIZE ((size_t) -1)
+
+#define EXPR_SIZE_MSG "VLVector expression: the operand sizes differ"
+
+namespace vlvexpr
+{
+    /**
+     * The elements of an operand vector.
+     */
+    template<class T>
+    struct Leaf
+    {
+        typedef T value_type;
+
+        const T *elems;
+        size_t n;
+
+        size_t size() const noexcept
+        {
+            return n;
+        }
+
+        T operator[](size_t idx) const noexcept
+        {
+            return elems[idx];
+        }
+    };
+
+    /**
+     * A scalar operand, the same at every place. Has no size of its own.
+     */
+    template<class T>
+    struct Scalar
+    {
+        typedef T value_type;
+
+        T value;
+
+        size_t size() const noexcept
+        {
+            return NO_SIZE;
+        }
+
+        T operator[](size_t) const noexcept
+        {
+            return value;
+        }
+    };
+
+    /**
+     * An element-wise operation of two operands. Operands are held by value: leaves and scalars are small, and a
+     * stored expression never refers to a destroyed temporary node.
+     */
+    template<class Op, class L, class R>
+    struct Binary
+    {
+        typedef decltype(Op::apply(std::declval<typename L::value_type>(),
+                                   std::declval<typename R::value_type>())) value_type;
+
+        L lhs;
+        R rhs;
+        size_t n;
+
+        /**
+         * @throws std::invalid_argument if both operands have a size and the sizes differ.
+         */
+        Binary(L const &lhs, R const &rhs) : lhs(lhs), rhs(rhs), n(lhs.size() == NO_SIZE ? rhs.size() : lhs.size())
+        {
+            if (lhs.size() != NO_SIZE && rhs.size() != NO_SIZE && lhs.size() != rhs.size())
+            {
+                throw std::invalid_argument(EXPR_SIZE_MSG);
+            }
+        }
+
+        size_t size() const noexcept
+        {
+            return n;
+        }
+
+        value_type operator[](size_t idx) const noexcept
+        {
+            return Op::apply(lhs[idx], rhs[idx]);
+        }
+    };
+
+    /**
+     * The element-wise negation of an operand.
+     */
+    template<class E>
+    struct Negate
+    {
+        typedef decltype(-std::declval<typename E::value_type>()) value_type;
+
+        E operand;
+
+        size_t size() const noexcept
+        {
+            return operand.size();
+        }
+
+        value_type operator[](size_t idx) const noexcept
+        {
+            return -operand[idx];
+        }
+    };
+
+    struct Add
+    {
+        template<class A, class B>
+        static auto apply(A lhs, B rhs) noexcept
+        {
+            return lhs + rhs;
+        }
+    };
+
+    struct Sub
+    {
+        template<class A, class B>
+        static auto apply(A lhs, B rhs) noexcept
+        {
+            return lhs - rhs;
+        }
+    };
+
+    struct Mul
+    {
+        template<class A, class B>
+        static auto apply(A lhs, B rhs) noexcept
+        {
+            return lhs * rhs;
+        }
+    };
+
+    struct Div
+    {
+        template<class A, class B>
+        static auto apply(A lhs, B rhs) noexcept
+        {
+            return lhs / rhs;
+        }
+    };
+
+    /**
+     * @brief Tells the operands expressions are built of: VLVectors of arithmetic elements and expressions.
+     */
+    template<class X>
+    struct IsOperand : IsVLVectorExpr<X>
+    {
+    };
+
+    template<class T, size_t StaticCapacity>
+    struct IsOperand<VLVector<T, StaticCapacity>> : vlvsimd::IsSimdElement<T>
+    {
+    };
+
+    /**
+     * @brief The node an operand is held as.
+     */
+    template<class X>
+    struct NodeOf
+    {
+        typedef X type;
+
+        static X const &of(X const &expr) noexcept
+        {
+            return expr;
+        }
+    };
+
+    template<class T, size_t StaticCapacity>
+    struct NodeOf<VLVector<T, StaticCapacity>>
+    {
+        typedef Leaf<T> type;
+
+        static Leaf<T> of(VLVector<T, StaticCapacity> const &vec) noexcept
+        {
+            return Leaf<T>{vec.data(), vec.size()};
+        }
+    };
+
+    /**
+     * @brief The node of a scalar S combined with the operand Other: a Scalar of the common type of S and the element
+     * type of Other, so an int vector times 0.5 is computed in double and only converted back when it is stored, while
+     * a float vector times 2.0f stays float arithmetic.
+     */
+    template<class Other, class S>
+    struct ScalarOf
+    {
+        typedef Scalar<std::common_type_t<typename NodeOf<Other>::type::value_type, S>> type;
+
+        static type of(S value) noexcept
+        {
+            return type{(typename type::value_type) value};
+        }
+    };
+
+    /**
+     * @brief Holds the operand or the scalar lhs or rhs, whichever X is, given the other operand Other.
+     */
+    template<class X, class Other, bool IsScalar = std::is_arithmetic<X>::value>
+    struct Wrap
+    {
+        typedef typename NodeOf<X>::type type;
+
+        static type of(X const &value)
+        {
+            return NodeOf<X>::of(value);
+        }
+    };
+
+    template<class X, class Other>
+    struct Wrap<X, Other, true>
+    {
+        typedef typename ScalarOf<Other, X>::type type;
+
+        static type of(X const &value)
+        {
+            return ScalarOf<Other, X>::of(value);
+        }
+    };
+
+    /**
+     * @brief Enables the operators for an operand and an operand or a scalar, in any order.
+     */
+    template<class L, class R>
+    using EnableIfOperands = std::enable_if_t<(IsOperand<L>::value && (IsOperand<R>::value ||
+                                                                        std::is_arithmetic<R>::value)) ||
+                                              (std::is_arithmetic<L>::value && IsOperand<R>::value)>;
+
+    /**
+     * @return The Op node of lhs and rhs.
+     */
+    template<class Op, class L, class R>
+    Binary<Op, typename Wrap<L, R>::type, typename Wrap<R, L>::type> make(L const &lhs, R const &rhs)
+    {
+        return Binary<Op, typename Wrap<L, R>::type, typename Wrap<R, L>::type>(Wrap<L, R>::of(lhs),
+                                                                                Wrap<R, L>::of(rhs));
+    }
+}
+
+template<class Op, class L, class R>
+struct IsVLVectorExpr<vlvexpr::Binary<Op, L, R>> : std::true_type
+{
+};
+
+template<class E>
+struct IsVLVectorExpr<vlvexpr::Negate<E>> : std::true_type
+{
+};
+
+/**
+ * @return The lazy element-wise sum of lhs and rhs.
+ */
+template<class L, class R, class = vlvexpr::EnableIfOperands<L, R>>
+auto operator+(L const &lhs, R const &rhs)
+{
+    return vlvexpr::make<vlvexpr::Add>(lhs, rhs);
+}
+
+/**
+ * @return The lazy element-wise difference of lhs and rhs.
+ */
+template<class L, class R, class = vlvexpr::EnableIfOperands<L, R>>
+auto operator-(L const &lhs, R const &rhs)
+{
+    return vlvexpr::make<vlvexpr::Sub>(lhs, rhs);
+}
+
+/**
+ * @return The lazy element-wise product of lhs and rhs.
+ */
+template<class L, class R, class = vlvexpr::EnableIfOperands<L, R>>
+auto operator*(L const &lhs, R const &rhs)
+{
+    return vlvexpr::make<vlvexpr::Mul>(lhs, rhs);
+}
+
+/**
+ * @return The lazy element-wise quotient of lhs and rhs.
+ */
+template<class L, class R, class = vlvexpr::EnableIfOperands<L, R>>
+auto operator/(L const &lhs, R const &rhs)
+{
+    return vlvexpr::make<vlvexpr::Div>(lhs, rhs);
+}
+
+/**
+ * @return The lazy element-wise negation of operand.
+ */
+template<class X, class = std::enable_if_t<vlvexpr::IsOperand<X>::value>>
+auto operator-(X const &operand)
+{
+    typedef typename vlvexpr::NodeOf<X>::type Node;
+    return vlvexpr::Negate<Node>{vlvexpr::NodeOf<X>::of(operand)};
+}
+
+/**
+ * @brief Adds rhs, a vector, an expression or a scalar, to every element of vec, in a single pass.
+ */
+template<class T, size_t StaticCapacity, class R, class = vlvexpr::EnableIfOperands<VLVector<T, StaticCapacity>, R>>
+VLVector<T, StaticCapacity> &operator+=(VLVector<T, StaticCapacity> &vec, R const &rhs)
+{
+    return vec = vec + rhs;
+}
+
+/**
+ * @brief Subtracts rhs from every element of vec. See operator+=.
+ */
+template<class T, size_t StaticCapacity, class R, class = vlvexpr::EnableIfOperands<VLVector<T, StaticCapacity>, R>>
+VLVector<T, StaticCapacity> &operator-=(VLVector<T, StaticCapacity> &vec, R const &rhs)
+{
+    return vec = vec - rhs;
+}
+
+/**
+ * @brief Multiplies every element of vec by rhs. See operator+=.
+ */
+template<class T, size_t StaticCapacity, class R, class = vlvexpr::EnableIfOperands<VLVector<T, StaticCapacity>, R>>
+VLVector<T, StaticCapacity> &operator*=(VLVector<T, StaticCapacity> &vec, R const &rhs)
+{
+    return vec = vec * rhs;
+}
+
+/**
+ * @brief Divides every element of vec by rhs. See operator+=.
+ */
+template<class T, size_t StaticCapacity, class R, class = vlvexpr::EnableIfOperands<VLVector<T, StaticCapacity>, R>>
+VLVector<T, StaticCapacity> &operator/=(VLVector<T, StaticCapacity> &vec, R const &rhs)
+{
+    return vec = vec / rhs;
+}
+
+
+#endif //CPP_EXAM_VLVECTOREXPR_HPP
@@ -0,0 +1,499 @@
+/**
+ * @file VLVectorFilter.hpp
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ *
+ * @brief Filtering of arrays of arithmetic elements into VLVectors, by compaction kernels.
+ *
+ * @section DESCRIPTION filter_into appends the elements of an array which satisfy a predicate to a VLVector, and
+ * retain keeps only those elements of a VLVector. The comparison predicates of vlvfilter (Less, Equal, Between,
+ * AnyBits...) are tested on whole vectors of elements, and the survivors are compacted without branches: by the
+ * AVX-512 compress instructions (VBMI2 for 1 and 2 byte elements), or by a permutation table with AVX2 for 4 and 8
+ * byte elements. Any other predicate, and CPUs without those, run a branch free scalar loop.
+ */
+#ifndef CPP_EXAM_VLVECTORFILTER_HPP
+#define CPP_EXAM_VLVECTORFILTER_HPP
+
+#include "VLVector.hpp"
+#include "VLVectorSimd.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+
+#ifdef VLV_SIMD_X86
+
+#include <immintrin.h>
+
+#endif
+
+#define FILTER_CHUNK 256
+
+#define PERMUTE_LANES 8
+
+namespace vlvfilter
+{
+    /**
+     * Base of the predicates the kernels test on whole vectors. Derived::test(x, pass) sets pass to the result for an
+     * element, or to the lane mask for a GCC vector of elements, which keeps vectors out of return values.
+     */
+    template<class Derived, class T>
+    struct SimdPredicate
+    {
+        typedef T simd_element;
+
+        VLV_ALWAYS_INLINE bool operator()(T x) const noexcept
+        {
+            bool pass;
+            static_cast<Derived const *>(this)->test(x, pass);
+            return pass;
+        }
+    };
+
+    /**
+     * x < value.
+     */
+    template<class T>
+    struct Less : SimdPredicate<Less<T>, T>
+    {
+        T value;
+
+        explicit Less(T value) : value(value)
+        {
+        }
+
+        template<class X, class M>
+        VLV_ALWAYS_INLINE void test(X const &x, M &pass) const noexcept
+        {
+            pass = x < value;
+        }
+    };
+
+    /**
+     * x <= value.
+     */
+    template<class T>
+    struct LessEqual : SimdPredicate<LessEqual<T>, T>
+    {
+        T value;
+
+        explicit LessEqual(T value) : value(value)
+        {
+        }
+
+        template<class X, class M>
+        VLV_ALWAYS_INLINE void test(X const &x, M &pass) const noexcept
+        {
+            pass = x <= value;
+        }
+    };
+
+    /**
+     * x > value.
+     */
+    template<class T>
+    struct Greater : SimdPredicate<Greater<T>, T>
+    {
+        T value;
+
+        explicit Greater(T value) : value(value)
+        {
+        }
+
+        template<class X, class M>
+        VLV_ALWAYS_INLINE void test(X const &x, M &pass) const noexcept
+        {
+            pass = x > value;
+        }
+    };
+
+    /**
+     * x >= value.
+     */
+    template<class T>
+    struct GreaterEqual : SimdPredicate<GreaterEqual<T>, T>
+    {
+        T value;
+
+        explicit GreaterEqual(T value) : value(value)
+        {
+        }
+
+        template<class X, class M>
+        VLV_ALWAYS_INLINE void test(X const &x, M &pass) const noexcept
+        {
+            pass = x >= value;
+        }
+    };
+
+    /**
+     * x == value.
+     */
+    template<class T>
+    struct Equal : SimdPredicate<Equal<T>, T>
+    {
+        T value;
+
+        explicit Equal(T value) : value(value)
+        {
+        }
+
+        template<class X, class M>
+        VLV_ALWAYS_INLINE void test(X const &x, M &pass) const noexcept
+        {
+            pass = x == value;
+        }
+    };
+
+    /**
+     * x != value.
+     */
+    template<class T>
+    struct NotEqual : SimdPredicate<NotEqual<T>, T>
+    {
+        T value;
+
+        explicit NotEqual(T value) : value(value)
+        {
+        }
+
+        template<class X, class M>
+        VLV_ALWAYS_INLINE void test(X const &x, M &pass) const noexcept
+        {
+            pass = x != value;
+        }
+    };
+
+    /**
+     * lo <= x <= hi.
+     */
+    template<class T>
+    struct Between : SimdPredicate<Between<T>, T>
+    {
+        T lo;
+        T hi;
+
+        Between(T lo, T hi) : lo(lo), hi(hi)
+        {
+        }
+
+        template<class X, class M>
+        VLV_ALWAYS_INLINE void test(X const &x, M &pass) const noexcept
+        {
+            pass = (x >= lo) & (x <= hi);
+        }
+    };
+
+    /**
+     * Any of the bits of mask is set in x. Integral elements only.
+     */
+    template<class T>
+    struct AnyBits : SimdPredicate<AnyBits<T>, T>
+    {
+        static_assert(std::is_integral<T>::value, "AnyBits needs integral elements");
+
+        T mask;
+
+        explicit AnyBits(T mask) : mask(mask)
+        {
+        }
+
+        template<class X, class M>
+        VLV_ALWAYS_INLINE void test(X const &x, M &pass) const noexcept
+        {
+            pass = (x & mask) != 0;
+        }
+    };
+
+    /**
+     * All of the bits of mask are set in x. Integral elements only.
+     */
+    template<class T>
+    struct AllBits : SimdPredicate<AllBits<T>, T>
+    {
+        static_assert(std::is_integral<T>::value, "AllBits needs integral elements");
+
+        T mask;
+
+        explicit AllBits(T mask) : mask(mask)
+        {
+        }
+
+        template<class X, class M>
+        VLV_ALWAYS_INLINE void test(X const &x, M &pass) const noexcept
+        {
+            pass = (x & mask) == mask;
+        }
+    };
+
+    /**
+     * @brief Tells the predicates the kernels can test on whole vectors of T, see SimdPredicate.
+     */
+    template<class Pred, class T, class = void>
+    struct IsSimdPredicate : std::false_type
+    {
+    };
+
+    template<class Pred, class T>
+    struct IsSimdPredicate<Pred, T, std::void_t<typename Pred::simd_element>>
+            : std::is_same<typename Pred::simd_element, T>
+    {
+    };
+
+    /**
+     * @brief The branch free scalar compaction: every element is written, and the write position only advances past
+     * the survivors. dst may be src, the writes never pass the reads.
+     * @return The amount of survivors written to dst.
+     */
+    template<class T, class Pred>
+    inline size_t compressScalar(const T *src, size_t n, Pred const &pred, T *dst)
+    {
+        size_t kept = 0;
+        for (size_t i = FIRST_IDX; i < n; ++i)
+        {
+            T elem = src[i];
+            dst[kept] = elem;
+            kept += pred(elem) ? 1 : 0;
+        }
+        return kept;
+    }
+
+#ifdef VLV_SIMD_X86
+
+    /**
+     * The _mm256_permutevar8x32_epi32 indices which move the 32 bit lanes set in a mask of 8 lanes to the front,
+     * and the same for the 64 bit lanes (as pairs of 32 bit lanes) of a mask of 4 lanes.
+     */
+    struct PermuteTable
+    {
+        alignas(AVX2_BYTES) uint32_t lanes32[1 << PERMUTE_LANES][PERMUTE_LANES];
+        alignas(AVX2_BYTES) uint32_t lanes64[1 << (PERMUTE_LANES / 2)][PERMUTE_LANES];
+    };
+
+    constexpr PermuteTable buildPermuteTable()
+    {
+        PermuteTable table = {};
+        for (uint32_t mask = 0; mask < (1 << PERMUTE_LANES); ++mask)
+        {
+            uint32_t at = 0;
+            for (uint32_t lane = 0; lane < PERMUTE_LANES; ++lane)
+            {
+                if (mask & (1u << lane))
+                {
+                    table.lanes32[mask][at++] = lane;
+                }
+            }
+        }
+        for (uint32_t mask = 0; mask < (1 << (PERMUTE_LANES / 2)); ++mask)
+        {
+            uint32_t at = 0;
+            for (uint32_t lane = 0; lane < PERMUTE_LANES / 2; ++lane)
+            {
+                if (mask & (1u << lane))
+                {
+                    table.lanes64[mask][at++] = 2 * lane;
+                    table.lanes64[mask][at++] = 2 * lane + 1;
+                }
+            }
+        }
+        return table;
+    }
+
+    inline constexpr PermuteTable PERMUTE_TABLE = buildPermuteTable();
+
+    /**
+     * @brief AVX2 compaction of 4 and 8 byte elements: the lanes which pass are moved to the front by a table lookup
+     * and a single permute, and the whole vector is stored. The bytes past the survivors are overwritten by the next
+     * store, and never reach past src + n relative to dst, so dst needs room for n elements only.
+     */
+    template<class T, class Pred>
+    VLV_TARGET_AVX2 size_t compressAvx2(const T *src, size_t n, Pred const &pred, T *dst)
+    {
+        typedef typename vlvsimd::Vec<T, AVX2_BYTES>::type V;
+        constexpr size_t lanes = vlvsimd::Vec<T, AVX2_BYTES>::lanes;
+        size_t kept = 0, i = FIRST_IDX;
+        for (; i + lanes <= n; i += lanes)
+        {
+            V elems;
+            vlvsimd::load(elems, src + i);
+            typename vlvsimd::Vec<vlvsimd::MaskLane<T>, AVX2_BYTES>::type pass;
+            pred.test(elems, pass);
+            unsigned mask;
+            const uint32_t *permute;
+            if constexpr (sizeof(T) == sizeof(uint32_t))
+            {
+                mask = (unsigned) _mm256_movemask_ps((__m256) pass);
+                permute = PERMUTE_TABLE.lanes32[mask];
+            }
+            else
+            {
+                mask = (unsigned) _mm256_movemask_pd((__m256d) pass);
+                permute = PERMUTE_TABLE.lanes64[mask];
+            }
+            __m256i packed = _mm256_permutevar8x32_epi32((__m256i) elems,
+                                                         _mm256_load_si256((const __m256i *) permute));
+            _mm256_storeu_si256((__m256i *) (dst + kept), packed);
+            kept += (size_t) __builtin_popcount(mask);
+        }
+        return kept + compressScalar(src + i, n - i, pred, dst + kept);
+    }
+
+    /**
+     * @brief AVX-512 compaction of 4 and 8 byte elements: the predicate is tested on 32 byte vectors (see
+     * GENERIC_AVX512_BYTES), its lanes are turned to a mask register and vpcompress packs the survivors. Same bounds as
+     * compressAvx2. Compiled for the AVX-512 level only, so it runs on every CPU the dispatch picks that level on.
+     */
+    template<class T, class Pred>
+    VLV_TARGET_AVX512 size_t compressAvx512(const T *src, size_t n, Pred const &pred, T *dst)
+    {
+        typedef typename vlvsimd::Vec<T, AVX2_BYTES>::type V;
+        constexpr size_t lanes = vlvsimd::Vec<T, AVX2_BYTES>::lanes;
+        size_t kept = 0, i = FIRST_IDX;
+        for (; i + lanes <= n; i += lanes)
+        {
+            V elems;
+            vlvsimd::load(elems, src + i);
+            typename vlvsimd::Vec<vlvsimd::MaskLane<T>, AVX2_BYTES>::type pass;
+            pred.test(elems, pass);
+            __m256i packed;
+            unsigned mask;
+            if constexpr (sizeof(T) == sizeof(uint32_t))
+            {
+                mask = (unsigned) _mm256_movepi32_mask((__m256i) pass);
+                packed = _mm256_maskz_compress_epi32((__mmask8) mask, (__m256i) elems);
+            }
+            else
+            {
+                mask = (unsigned) _mm256_movepi64_mask((__m256i) pass);
+                packed = _mm256_maskz_compress_epi64((__mmask8) mask, (__m256i) elems);
+            }
+            _mm256_storeu_si256((__m256i *) (dst + kept), packed);
+            kept += (size_t) __builtin_popcount(mask);
+        }
+        return kept + compressScalar(src + i, n - i, pred, dst + kept);
+    }
+
+    /**
+     * @brief AVX-512 compaction of 1 and 2 byte elements, whose vpcompress needs AVX512_VBMI2 on top of the AVX-512
+     * level. Only called on CPUs which have it. See compressAvx512.
+     */
+    template<class T, class Pred>
+    __attribute__((target("avx512f,avx512bw,avx512dq,avx512vl,avx512vbmi2,avx2,bmi,bmi2,popcnt")))
+    size_t compressAvx512Vbmi2(const T *src, size_t n, Pred const &pred, T *dst)
+    {
+        typedef typename vlvsimd::Vec<T, AVX2_BYTES>::type V;
+        constexpr size_t lanes = vlvsimd::Vec<T, AVX2_BYTES>::lanes;
+        size_t kept = 0, i = FIRST_IDX;
+        for (; i + lanes <= n; i += lanes)
+        {
+            V elems;
+            vlvsimd::load(elems, src + i);
+            typename vlvsimd::Vec<vlvsimd::MaskLane<T>, AVX2_BYTES>::type pass;
+            pred.test(elems, pass);
+            __m256i packed;
+            unsigned mask;
+            if constexpr (sizeof(T) == sizeof(uint8_t))
+            {
+                mask = (unsigned) _mm256_movepi8_mask((__m256i) pass);
+                packed = _mm256_maskz_compress_epi8(mask, (__m256i) elems);
+            }
+            else
+            {
+                mask = (unsigned) _mm256_movepi16_mask((__m256i) pass);
+                packed = _mm256_maskz_compress_epi16((__mmask16) mask, (__m256i) elems);
+            }
+            _mm256_storeu_si256((__m256i *) (dst + kept), packed);
+            kept += (size_t) __builtin_popcount(mask);
+        }
+        return kept + compressScalar(src + i, n - i, pred, dst + kept);
+    }
+
+#endif
+
+    /**
+     * @brief Writes the elements of src which satisfy pred to dst, in order, with the widest kernel the CPU and the
+     * element size allow. dst needs room for n elements, and may be src.
+     * @return The amount of survivors.
+     */
+    template<class T, class Pred>
+    size_t compress(const T *src, size_t n, Pred const &pred, T *dst)
+    {
+#ifdef VLV_SIMD_X86
+        if constexpr (IsSimdPredicate<Pred, T>::value && vlvsimd::IsSimdElement<T>::value)
+        {
+            vlvsimd::SimdLevel level = vlvsimd::simdLevel();
+            if constexpr (sizeof(T) >= sizeof(uint32_t))
+            {
+                if (level >= vlvsimd::SIMD_AVX512)
+                {
+                    return compressAvx512(src, n, pred, dst);
+                }
+                if (level >= vlvsimd::SIMD_AVX2)
+                {
+                    return compressAvx2(src, n, pred, dst);
+                }
+            }
+            else
+            {
+                static const bool vbmi2 = __builtin_cpu_supports("avx512vbmi2");
+                if (level >= vlvsimd::SIMD_AVX512 && vbmi2)
+                {
+                    return compressAvx512Vbmi2(src, n, pred, dst);
+                }
+            }
+        }
+#endif
+        return compressScalar(src, n, pred, dst);
+    }
+}
+
+/**
+ * @brief Appends the elements of src which satisfy pred to out, in order. If out has room for all n elements they
+ * are compacted straight into it, else through a stack buffer of FILTER_CHUNK elements, so out grows only by what
+ * survives and a small result may stay in the static storage.
+ * @return The amount of elements appended.
+ */
+template<class T, class Pred>
+size_t filter_into(const T *src, size_t n, Pred pred, VLVectorBase<T> &out)
+{
+    size_t before = out.size();
+    if (out.capacity() - before >= n)
+    {
+        out.resize_and_overwrite(before + n, [&](T *elems, size_t)
+        {
+            return before + vlvfilter::compress(src, n, pred, elems + before);
+        });
+        return out.size() - before;
+    }
+    T chunk[FILTER_CHUNK];
+    for (size_t done = 0; done < n; done += FILTER_CHUNK)
+    {
+        size_t amount = n - done < FILTER_CHUNK ? n - done : FILTER_CHUNK;
+        size_t kept = vlvfilter::compress(src + done, amount, pred, chunk);
+        size_t size = out.size();
+        out.resize_and_overwrite(size + kept, [&](T *elems, size_t)
+        {
+            std::copy(chunk, chunk + kept, elems + size);
+            return size + kept;
+        });
+    }
+    return out.size() - before;
+}
+
+/**
+ * @brief Removes the elements of vec which do not satisfy pred, keeping the order of the rest, in place.
+ * @return The amount of elements removed.
+ */
+template<class T, class Pred>
+size_t retain(VLVectorBase<T> &vec, Pred pred)
+{
+    size_t before = vec.size();
+    vec.resize_and_overwrite(before, [&](T *elems, size_t n)
+    {
+        return vlvfilter::compress(elems, n, pred, elems);
+    });
+    return before - vec.size();
+}
+
+
+#endif //CPP_EXAM_VLVECTORFILTER_HPP
@@ -0,0 +1,313 @@
+/**
+ * @file VLVectorHash.hpp
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ *
+ * @brief Hashing and checksums for VLVector.
+ *
+ * @section DESCRIPTION std::hash specializations for VLVector and VLVectorBase. Vectors of elements with unique object
+ * representations (integers, byte arrays, padding free structs) are hashed in one pass over their bytes, with a fast
+ * non cryptographic hash after wyhash by Wang Yi (public domain); the same bytes always hash the same on a given
+ * platform, but the values are not meant to match other wyhash implementations. Other element types are hashed with
+ * std::hash per element, combined by the same mixing function. crc32c() computes the Castagnoli CRC with the SSE4.2
+ * or ARMv8 CRC instructions when present, for integrity checks of stored vectors.
+ */
+#ifndef CPP_EXAM_VLVECTORHASH_HPP
+#define CPP_EXAM_VLVECTORHASH_HPP
+
+#include "VLVector.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <type_traits>
+
+#if defined(__ARM_FEATURE_CRC32)
+
+#include <arm_acle.h>
+
+#endif
+
+#define CRC32C_POLY 0x82F63B78u
+
+#define CRC32C_TABLE_SIZE 256
+
+#define BULK_BLOCK_BYTES 48
+
+#define SMALL_INPUT_BYTES 16
+
+namespace vlvhash
+{
+    /**
+     * The default secret of the hash. Odd, with balanced bits in every byte.
+     */
+    static constexpr uint64_t SECRET[4] = {0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull, 0x4b33a62ed433d4a3ull,
+                                           0x4d5a2da51de1aa47ull};
+
+    /**
+     * @brief Multiplies lhs by rhs into 128 bits, leaving the low half in lhs and the high half in rhs.
+     */
+    inline void multiply128(uint64_t &lhs, uint64_t &rhs) noexcept
+    {
+#if defined(__SIZEOF_INT128__)
+        __uint128_t product = (__uint128_t) lhs * rhs;
+        lhs = (uint64_t) product;
+        rhs = (uint64_t) (product >> 64);
+#else
+        uint64_t lhsHigh = lhs >> 32, lhsLow = (uint32_t) lhs, rhsHigh = rhs >> 32, rhsLow = (uint32_t) rhs;
+        uint64_t highHigh = lhsHigh * rhsHigh, highLow = lhsHigh * rhsLow, lowHigh = lhsLow * rhsHigh;
+        uint64_t lowLow = lhsLow * rhsLow;
+        uint64_t middle = (lowLow >> 32) + (uint32_t) highLow + (uint32_t) lowHigh;
+        lhs = (middle << 32) | (uint32_t) lowLow;
+        rhs = highHigh + (highLow >> 32) + (lowHigh >> 32) + (middle >> 32);
+#endif
+    }
+
+    /**
+     * @return The xor of the two halves of the 128 bit product of lhs and rhs.
+     */
+    inline uint64_t mix(uint64_t lhs, uint64_t rhs) noexcept
+    {
+        multiply128(lhs, rhs);
+        return lhs ^ rhs;
+    }
+
+    inline uint64_t read64(const unsigned char *src) noexcept
+    {
+        uint64_t value;
+        std::memcpy(&value, src, sizeof(value));
+        return value;
+    }
+
+    inline uint64_t read32(const unsigned char *src) noexcept
+    {
+        uint32_t value;
+        std::memcpy(&value, src, sizeof(value));
+        return value;
+    }
+
+    /**
+     * @return The hash of len bytes from src.
+     */
+    inline uint64_t bytes(const void *src, size_t len, uint64_t seed = 0) noexcept
+    {
+        const unsigned char *cur = static_cast<const unsigned char *>(src);
+        seed ^= mix(seed ^ SECRET[0], SECRET[1]);
+        uint64_t first, second;
+        if (len <= SMALL_INPUT_BYTES)
+        {
+            if (len >= sizeof(uint32_t))
+            {
+                size_t shift = (len >> 3) << 2; // 4 if len >= 8, else 0: two overlapping pairs of 4 bytes.
+                first = (read32(cur) << 32) | read32(cur + shift);
+                second = (read32(cur + len - 4) << 32) | read32(cur + len - 4 - shift);
+            }
+            else if (len)
+            {
+                first = ((uint64_t) cur[0] << 16) | ((uint64_t) cur[len >> 1] << 8) | cur[len - 1];
+                second = 0;
+            }
+            else
+            {
+                first = second = 0;
+            }
+        }
+        else
+        {
+            size_t left = len;
+            if (left > BULK_BLOCK_BYTES)
+            {
+                uint64_t seed1 = seed, seed2 = seed; // three independent lanes hide the multiply latency.
+                do
+                {
+                    seed = mix(read64(cur) ^ SECRET[1], read64(cur + 8) ^ seed);
+                    seed1 = mix(read64(cur + 16) ^ SECRET[2], read64(cur + 24) ^ seed1);
+                    seed2 = mix(read64(cur + 32) ^ SECRET[3], read64(cur + 40) ^ seed2);
+                    cur += BULK_BLOCK_BYTES;
+                    left -= BULK_BLOCK_BYTES;
+                } while (left > BULK_BLOCK_BYTES);
+                seed ^= seed1 ^ seed2;
+            }
+            while (left > SMALL_INPUT_BYTES)
+            {
+                seed = mix(read64(cur) ^ SECRET[1], read64(cur + 8) ^ seed);
+                cur += SMALL_INPUT_BYTES;
+                left -= SMALL_INPUT_BYTES;
+            }
+            first = read64(cur + left - 16);
+            second = read64(cur + left - 8);
+        }
+        first ^= SECRET[1];
+        second ^= seed;
+        multiply128(first, second);
+        return mix(first ^ SECRET[0] ^ len, second ^ SECRET[1]);
+    }
+
+    /**
+     * @return seed combined with the hash of another value.
+     */
+    inline uint64_t combine(uint64_t seed, uint64_t value) noexcept
+    {
+        return mix(seed ^ SECRET[0], value ^ SECRET[1]);
+    }
+
+    /**
+     * @return The hash of n elements from src. Bulk hash of the bytes if T has unique object representations, combined
+     * std::hash of every element otherwise. Equal ranges hash equally either way.
+     */
+    template<class T>
+    inline uint64_t range(const T *src, size_t n, uint64_t seed = 0)
+    {
+        if constexpr (std::has_unique_object_representations<T>::value)
+        {
+            return bytes(src, n * sizeof(T), seed);
+        }
+        else
+        {
+            uint64_t hash = combine(seed, n);
+            std::hash<T> hasher;
+            for (size_t i = FIRST_IDX; i < n; ++i)
+            {
+                hash = combine(hash, (uint64_t) hasher(src[i]));
+            }
+            return hash;
+        }
+    }
+
+    /**
+     * @return The table of the bytewise software CRC32C.
+     */
+    inline const uint32_t *crc32cTable() noexcept
+    {
+        static const struct Table
+        {
+            uint32_t entries[CRC32C_TABLE_SIZE];
+
+            Table() noexcept
+            {
+                for (uint32_t byte = 0; byte < CRC32C_TABLE_SIZE; ++byte)
+                {
+                    uint32_t crc = byte;
+                    for (int bit = 0; bit < 8; ++bit)
+                    {
+                        crc = (crc >> 1) ^ (CRC32C_POLY & (0u - (crc & 1)));
+                    }
+                    entries[byte] = crc;
+                }
+            }
+        } table;
+        return table.entries;
+    }
+
+    /**
+     * @brief The software CRC32C, on the raw (not inverted) crc state.
+     */
+    inline uint32_t crc32cSoftware(uint32_t crc, const unsigned char *src, size_t len) noexcept
+    {
+        const uint32_t *table = crc32cTable();
+        for (size_t i = 0; i < len; ++i)
+        {
+            crc = table[(crc ^ src[i]) & 0xff] ^ (crc >> 8);
+        }
+        return crc;
+    }
+
+#ifdef VLV_SIMD_X86
+
+    /**
+     * @brief The SSE4.2 CRC32C, on the raw crc state.
+     */
+    __attribute__((target("sse4.2"))) inline uint32_t crc32cHardware(uint32_t crc, const unsigned char *src,
+                                                                      size_t len) noexcept
+    {
+#ifdef __x86_64__
+        uint64_t wide = crc;
+        for (; len >= sizeof(uint64_t); len -= sizeof(uint64_t), src += sizeof(uint64_t))
+        {
+            wide = __builtin_ia32_crc32di(wide, read64(src));
+        }
+        crc = (uint32_t) wide;
+#endif
+        for (; len; --len, ++src)
+        {
+            crc = __builtin_ia32_crc32qi(crc, *src);
+        }
+        return crc;
+    }
+
+#elif defined(__ARM_FEATURE_CRC32)
+
+    /**
+     * @brief The ARMv8 CRC32C, on the raw crc state.
+     */
+    inline uint32_t crc32cHardware(uint32_t crc, const unsigned char *src, size_t len) noexcept
+    {
+        for (; len >= sizeof(uint64_t); len -= sizeof(uint64_t), src += sizeof(uint64_t))
+        {
+            crc = __crc32cd(crc, read64(src));
+        }
+        for (; len; --len, ++src)
+        {
+            crc = __crc32cb(crc, *src);
+        }
+        return crc;
+    }
+
+#endif
+
+    /**
+     * @return The CRC32C (Castagnoli) of len bytes from src. crc is the result over the preceding bytes, if any, so
+     * checksums can be computed piecewise.
+     */
+    inline uint32_t crc32c(const void *src, size_t len, uint32_t crc = 0) noexcept
+    {
+        const unsigned char *cur = static_cast<const unsigned char *>(src);
+        crc = ~crc;
+#ifdef VLV_SIMD_X86
+        static const bool hardware = __builtin_cpu_supports("sse4.2");
+        crc = hardware ? crc32cHardware(crc, cur, len) : crc32cSoftware(crc, cur, len);
+#elif defined(__ARM_FEATURE_CRC32)
+        crc = crc32cHardware(crc, cur, len);
+#else
+        crc = crc32cSoftware(crc, cur, len);
+#endif
+        return ~crc;
+    }
+}
+
+/**
+ * @return The CRC32C of the bytes of the elements of vec.
+ */
+template<class T>
+std::enable_if_t<std::is_trivially_copyable<T>::value, uint32_t>
+crc32c(VLVectorBase<T> const &vec, uint32_t crc = 0) noexcept
+{
+    return vlvhash::crc32c(vec.data(), vec.size() * sizeof(T), crc);
+}
+
+namespace std
+{
+    /**
+     * Hash of a VLVector of any static capacity through its base, consistent with its operator==, which compares
+     * vectors of different static capacities too. See vlvhash::range.
+     */
+    template<class T>
+    struct hash<VLVectorBase<T>>
+    {
+        size_t operator()(VLVectorBase<T> const &vec) const
+        {
+            return (size_t) vlvhash::range(vec.data(), vec.size());
+        }
+    };
+
+    /**
+     * Hash of a VLVector, the same as the hash of its base.
+     */
+    template<class T, size_t StaticCapacity>
+    struct hash<VLVector<T, StaticCapacity>> : hash<VLVectorBase<T>>
+    {
+    };
+}
+
+
+#endif //CPP_EXAM_VLVECTORHASH_HPP
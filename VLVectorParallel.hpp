@@ -0,0 +1,526 @@
+/**
+ * @file VLVectorParallel.hpp
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ *
+ * @brief Multi threaded algorithms over large VLVectors.
+ *
+ * @section DESCRIPTION parallel_for_each, parallel_transform, parallel_reduce, parallel_inclusive_scan and
+ * parallel_sort split data() into chunks and run them on VLThreadPool, a work stealing pool shipped with the library,
+ * so no std::execution support is needed. Vectors of fewer than PARALLEL_MIN_SIZE elements, and vectors which fit
+ * in their static storage, are always processed sequentially on the calling thread. The amount of threads is
+ * std::thread::hardware_concurrency(), or the value of the VLVECTOR_THREADS environment variable.
+ */
+#ifndef CPP_EXAM_VLVECTORPARALLEL_HPP
+#define CPP_EXAM_VLVECTORPARALLEL_HPP
+
+#include "VLVector.hpp"
+#include "VLVectorSort.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#define PARALLEL_MIN_SIZE (1 << 15)
+
+#define CHUNKS_PER_THREAD 4
+
+#define THREADS_ENV_VAR "VLVECTOR_THREADS"
+
+#define NO_WORKER ((size_t) -1)
+
+#define TRANSFORM_SIZE_MSG "parallel_transform: the source and destination sizes differ"
+
+/**
+ * A work stealing thread pool. Every worker owns a queue: it runs the newest task of its own queue first and, when
+ * it is empty, steals the oldest task of another queue. Threads which wait for their tasks run queued tasks meanwhile,
+ * so nested parallel calls can not deadlock.
+ */
+class VLThreadPool
+{
+public:
+    typedef std::function<void()> Task;
+
+    /**
+     * @brief Starts a pool of the given amount of threads. A pool of one thread starts no workers: its tasks are run
+     * by the threads waiting for them.
+     */
+    explicit VLThreadPool(size_t threads) : _threads(threads ? threads : 1), _pending(0), _stopping(false)
+    {
+        for (size_t i = 0; i < _threads; ++i)
+        {
+            _queues.emplace_back(new Queue);
+        }
+        for (size_t i = 0; _threads > 1 && i < _threads; ++i)
+        {
+            _workers.emplace_back(&VLThreadPool::_work, this, i);
+        }
+    }
+
+    VLThreadPool(VLThreadPool const &) = delete;
+
+    VLThreadPool &operator=(VLThreadPool const &) = delete;
+
+    /**
+     * @brief Stops the workers once every queued task has run.
+     */
+    ~VLThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> guard(_sleepLock);
+            _stopping = true;
+        }
+        _wake.notify_all();
+        for (std::thread &worker : _workers)
+        {
+            worker.join();
+        }
+    }
+
+    /**
+     * @return The pool shared by the parallel algorithms. Never destroyed, so it may be used during static
+     * destruction.
+     */
+    static VLThreadPool &instance()
+    {
+        static VLThreadPool *pool = new VLThreadPool(_defaultThreads());
+        return *pool;
+    }
+
+    /**
+     * @return The amount of threads tasks run on.
+     */
+    size_t threads() const noexcept
+    {
+        return _threads;
+    }
+
+    /**
+     * @brief Queues a task. A worker queues on its own queue, other threads spread their tasks over all queues.
+     */
+    void submit(Task task)
+    {
+        size_t idx = _current == this ? _currentIdx : _nextQueue++ % _threads;
+        {
+            std::lock_guard<std::mutex> guard(_sleepLock); // counted first, so _pending never drops below zero.
+            ++_pending;
+        }
+        {
+            std::lock_guard<std::mutex> guard(_queues[idx]->lock);
+            _queues[idx]->tasks.push_back(std::move(task));
+        }
+        _wake.notify_one();
+    }
+
+    /**
+     * @brief Runs one queued task on the calling thread, if there is one.
+     * @return true if a task was run.
+     */
+    bool runOne()
+    {
+        Task task;
+        if (!_take(_current == this ? _currentIdx : FIRST_IDX, task))
+        {
+            return false;
+        }
+        task();
+        return true;
+    }
+
+private:
+    struct Queue
+    {
+        std::mutex lock;
+        std::deque<Task> tasks;
+    };
+
+    size_t _threads;
+    std::vector<std::unique_ptr<Queue>> _queues;
+    std::vector<std::thread> _workers;
+    std::mutex _sleepLock;
+    std::condition_variable _wake;
+    size_t _pending;
+    bool _stopping;
+    std::atomic<size_t> _nextQueue{0};
+    static inline thread_local VLThreadPool *_current = nullptr;
+    static inline thread_local size_t _currentIdx = NO_WORKER;
+
+    /**
+     * @return The amount of threads of the shared pool.
+     */
+    static size_t _defaultThreads()
+    {
+        const char *env = std::getenv(THREADS_ENV_VAR);
+        if (env && std::atoi(env) > 0)
+        {
+            return (size_t) std::atoi(env);
+        }
+        size_t hardware = std::thread::hardware_concurrency();
+        return hardware ? hardware : 1;
+    }
+
+    /**
+     * @brief Takes the newest task of queue idx, or else steals the oldest task of another queue.
+     * @return true if a task was taken.
+     */
+    bool _take(size_t idx, Task &task)
+    {
+        for (size_t i = 0; i < _threads; ++i)
+        {
+            size_t victim = (idx + i) % _threads;
+            std::lock_guard<std::mutex> guard(_queues[victim]->lock);
+            std::deque<Task> &tasks = _queues[victim]->tasks;
+            if (tasks.empty())
+            {
+                continue;
+            }
+            if (!i)
+            {
+                task = std::move(tasks.back());
+                tasks.pop_back();
+            }
+            else
+            {
+                task = std::move(tasks.front());
+                tasks.pop_front();
+            }
+            std::lock_guard<std::mutex> sleepGuard(_sleepLock);
+            --_pending;
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief The loop of worker idx: runs tasks, sleeps while there are none.
+     */
+    void _work(size_t idx)
+    {
+        _current = this;
+        _currentIdx = idx;
+        Task task;
+        while (true)
+        {
+            if (_take(idx, task))
+            {
+                task();
+                task = nullptr;
+                continue;
+            }
+            std::unique_lock<std::mutex> guard(_sleepLock);
+            _wake.wait(guard, [this] { return _pending || _stopping; });
+            if (!_pending && _stopping)
+            {
+                return;
+            }
+        }
+    }
+};
+
+namespace vlvparallel
+{
+    /**
+     * @return true if a vector of this size is worth splitting between threads.
+     */
+    template<size_t StaticCapacity>
+    inline bool parallelizes(size_t size)
+    {
+        return size > StaticCapacity && size >= PARALLEL_MIN_SIZE && VLThreadPool::instance().threads() > 1;
+    }
+
+    /**
+     * @return The amount of chunks n elements are split to.
+     */
+    inline size_t chunksOf(size_t n)
+    {
+        size_t chunks = VLThreadPool::instance().threads() * CHUNKS_PER_THREAD;
+        return chunks < n ? chunks : n;
+    }
+
+    /**
+     * @brief Runs body(chunk, begin, end) for every chunk of [0, n) split to the given amount of chunks, on the pool,
+     * and waits for all of them. The calling thread runs the first chunk, then helps with queued tasks.
+     * @throws The first exception a chunk threw, after all of the chunks are done.
+     */
+    template<class Body>
+    void forChunks(size_t n, size_t chunks, Body const &body)
+    {
+        VLThreadPool &pool = VLThreadPool::instance();
+        std::atomic<size_t> left(chunks);
+        std::exception_ptr error;
+        std::mutex errorLock;
+        auto run = [&](size_t chunk)
+        {
+            try
+            {
+                body(chunk, n * chunk / chunks, n * (chunk + 1) / chunks);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> guard(errorLock);
+                if (!error)
+                {
+                    error = std::current_exception();
+                }
+            }
+            left.fetch_sub(1, std::memory_order_acq_rel);
+        };
+        for (size_t chunk = 1; chunk < chunks; ++chunk)
+        {
+            pool.submit([&run, chunk] { run(chunk); });
+        }
+        run(FIRST_IDX);
+        while (left.load(std::memory_order_acquire))
+        {
+            if (!pool.runOne())
+            {
+                std::this_thread::yield();
+            }
+        }
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+
+    /**
+     * @brief Sorts n elements: chunkSort(first, last) sorts a power of two amount of chunks, at least one per thread,
+     * in parallel, then rounds of parallel std::inplace_merge by comp join them pairwise.
+     */
+    template<class T, class ChunkSort, class Compare>
+    void sortAndMerge(T *elems, size_t n, ChunkSort const &chunkSort, Compare const &comp)
+    {
+        size_t chunks = 1;
+        while (chunks < VLThreadPool::instance().threads())
+        {
+            chunks <<= 1;
+        }
+        forChunks(n, chunks, [elems, &chunkSort](size_t, size_t begin, size_t end)
+        {
+            chunkSort(elems + begin, elems + end);
+        });
+        for (size_t width = 1; width < chunks; width <<= 1)
+        {
+            size_t pairs = chunks / (width * 2);
+            forChunks(pairs, pairs, [elems, n, chunks, width, &comp](size_t pair, size_t, size_t)
+            {
+                size_t first = pair * width * 2;
+                std::inplace_merge(elems + n * first / chunks, elems + n * (first + width) / chunks,
+                                   elems + n * (first + width * 2) / chunks, comp);
+            });
+        }
+    }
+}
+
+/**
+ * @brief Calls f on every element. The order of the calls is unspecified when the vector is large.
+ */
+template<class T, size_t StaticCapacity, class Function>
+void parallel_for_each(VLVector<T, StaticCapacity> &vec, Function f)
+{
+    T *elems = vec.data();
+    size_t n = vec.size();
+    if (!vlvparallel::parallelizes<StaticCapacity>(n))
+    {
+        std::for_each(elems, elems + n, f);
+        return;
+    }
+    vlvparallel::forChunks(n, vlvparallel::chunksOf(n), [elems, &f](size_t, size_t begin, size_t end)
+    {
+        std::for_each(elems + begin, elems + end, f);
+    });
+}
+
+/**
+ * @brief Writes f of every element of src to the element of dst at the same place.
+ * @throws std::invalid_argument if the vectors are not of the same size.
+ */
+template<class T, size_t StaticCapacity, class U, size_t OtherCapacity, class Function>
+void parallel_transform(VLVector<T, StaticCapacity> const &src, VLVector<U, OtherCapacity> &dst, Function f)
+{
+    if (src.size() != dst.size())
+    {
+        throw std::invalid_argument(TRANSFORM_SIZE_MSG);
+    }
+    const T *from = src.data();
+    U *to = dst.data();
+    size_t n = src.size();
+    if (!vlvparallel::parallelizes<StaticCapacity>(n))
+    {
+        std::transform(from, from + n, to, f);
+        return;
+    }
+    vlvparallel::forChunks(n, vlvparallel::chunksOf(n), [from, to, &f](size_t, size_t begin, size_t end)
+    {
+        std::transform(from + begin, from + end, to + begin, f);
+    });
+}
+
+/**
+ * @brief Replaces every element with f of it.
+ */
+template<class T, size_t StaticCapacity, class Function>
+void parallel_transform(VLVector<T, StaticCapacity> &vec, Function f)
+{
+    parallel_for_each(vec, [&f](T &elem) { elem = f(elem); });
+}
+
+/**
+ * @return op over init and all of the elements, folded from the left like std::accumulate, where every chunk is folded
+ * from a value initialized Result and combine joins init and the results of the chunks in order. op must be associative
+ * with combine, and Result() must be an identity of combine: combine(r, op(Result(), x)) == op(r, x). For example, a
+ * count of the odd elements is parallel_reduce(vec, (size_t) 0, countOdd, std::plus<>()).
+ */
+template<class T, size_t StaticCapacity, class Result, class BinaryOp, class Combine>
+Result parallel_reduce(VLVector<T, StaticCapacity> const &vec, Result init, BinaryOp op, Combine combine)
+{
+    const T *elems = vec.data();
+    size_t n = vec.size();
+    if (!vlvparallel::parallelizes<StaticCapacity>(n))
+    {
+        return std::accumulate(elems, elems + n, init, op);
+    }
+    size_t chunks = vlvparallel::chunksOf(n);
+    std::vector<Result> partial(chunks);
+    vlvparallel::forChunks(n, chunks, [elems, &op, &partial](size_t chunk, size_t begin, size_t end)
+    {
+        partial[chunk] = std::accumulate(elems + begin, elems + end, Result(), op);
+    });
+    for (Result const &acc : partial)
+    {
+        init = combine(init, acc);
+    }
+    return init;
+}
+
+/**
+ * @return op over init and all of the elements, like std::reduce: op must be associative and commutative, and accept
+ * any mix of elements and Results, since every chunk is folded from its first element and op joins init and the
+ * results of the chunks. An op which only accepts a Result on its left, as a count does, needs the overload which
+ * takes a combine.
+ */
+template<class T, size_t StaticCapacity, class Result, class BinaryOp = std::plus<>>
+Result parallel_reduce(VLVector<T, StaticCapacity> const &vec, Result init, BinaryOp op = BinaryOp())
+{
+    static_assert(std::is_convertible<T const &, Result>::value, "parallel_reduce: an element is not a Result");
+    const T *elems = vec.data();
+    size_t n = vec.size();
+    if (!vlvparallel::parallelizes<StaticCapacity>(n))
+    {
+        return std::accumulate(elems, elems + n, init, op);
+    }
+    size_t chunks = vlvparallel::chunksOf(n);
+    std::vector<Result> partial(chunks, init);
+    vlvparallel::forChunks(n, chunks, [elems, &op, &partial](size_t chunk, size_t begin, size_t end)
+    {
+        partial[chunk] = std::accumulate(elems + begin + NEXT_ELEM, elems + end, (Result) elems[begin], op);
+    });
+    for (Result const &acc : partial)
+    {
+        init = op(init, acc);
+    }
+    return init;
+}
+
+/**
+ * @brief Replaces every element with op over it and all of the elements before it. op must be associative. The
+ * chunks are scanned in two passes: their totals first, then the scan itself, carrying the totals of the chunks
+ * before.
+ */
+template<class T, size_t StaticCapacity, class BinaryOp = std::plus<>>
+void parallel_inclusive_scan(VLVector<T, StaticCapacity> &vec, BinaryOp op = BinaryOp())
+{
+    T *elems = vec.data();
+    size_t n = vec.size();
+    if (!vlvparallel::parallelizes<StaticCapacity>(n))
+    {
+        for (size_t i = NEXT_ELEM; i < n; ++i)
+        {
+            elems[i] = op(elems[i - NEXT_ELEM], elems[i]);
+        }
+        return;
+    }
+    size_t chunks = vlvparallel::chunksOf(n);
+    std::vector<T> totals(chunks);
+    vlvparallel::forChunks(n, chunks, [elems, &op, &totals](size_t chunk, size_t begin, size_t end)
+    {
+        T acc = elems[begin];
+        for (size_t i = begin + NEXT_ELEM; i < end; ++i)
+        {
+            acc = op(acc, elems[i]);
+        }
+        totals[chunk] = acc;
+    });
+    for (size_t chunk = NEXT_ELEM; chunk < chunks; ++chunk)
+    {
+        totals[chunk] = op(totals[chunk - NEXT_ELEM], totals[chunk]);
+    }
+    vlvparallel::forChunks(n, chunks, [elems, &op, &totals](size_t chunk, size_t begin, size_t end)
+    {
+        if (chunk)
+        {
+            elems[begin] = op(totals[chunk - NEXT_ELEM], elems[begin]);
+        }
+        for (size_t i = begin + NEXT_ELEM; i < end; ++i)
+        {
+            elems[i] = op(elems[i - NEXT_ELEM], elems[i]);
+        }
+    });
+}
+
+/**
+ * @brief Sorts the elements by comp: the chunks are sorted in parallel, then merged pairwise, every round of merges in
+ * parallel too.
+ */
+template<class T, size_t StaticCapacity, class Compare>
+void parallel_sort(VLVector<T, StaticCapacity> &vec, Compare comp)
+{
+    if (!vlvparallel::parallelizes<StaticCapacity>(vec.size()))
+    {
+        std::sort(vec.data(), vec.data() + vec.size(), comp);
+        return;
+    }
+    vlvparallel::sortAndMerge(vec.data(), vec.size(), [&comp](T *first, T *last) { std::sort(first, last, comp); },
+                              comp);
+}
+
+/**
+ * @brief Sorts the elements in ascending order. Small vectors go to sort() of VLVectorSort.hpp, and the chunks of
+ * large vectors of arithmetic elements are radix sorted.
+ */
+template<class T, size_t StaticCapacity>
+void parallel_sort(VLVector<T, StaticCapacity> &vec)
+{
+    if (!vlvparallel::parallelizes<StaticCapacity>(vec.size()))
+    {
+        sort(vec);
+        return;
+    }
+    vlvparallel::sortAndMerge(vec.data(), vec.size(), [](T *first, T *last)
+    {
+        size_t n = (size_t) (last - first);
+        if constexpr (vlvsimd::IsSimdElement<T>::value)
+        {
+            if (n >= RADIX_MIN_SIZE)
+            {
+                std::unique_ptr<T[]> scratch(new T[n]);
+                vlvsort::radixSort(first, n, scratch.get());
+                return;
+            }
+        }
+        std::sort(first, last);
+    }, std::less<>());
+}
+
+#endif //CPP_EXAM_VLVECTORPARALLEL_HPP
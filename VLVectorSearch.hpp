@@ -0,0 +1,326 @@
+/**
+ * @file VLVectorSearch.hpp
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ *
+ * @brief Search and reduction functions over VLVectors of arithmetic elements.
+ *
+ * @section DESCRIPTION find, find_if_eq, count, contains, min_element, max_element, minmax and sum for VLVectors of
+ * integral and floating elements. find, contains and count of vectors no larger than a small static storage are fully
+ * unrolled over StaticCapacity places and use the SSE2 baseline directly. All others use the runtime dispatched kernels
+ * of VLVectorSimd.hpp. The helpers are in namespace vlvsearch; only the algorithms are next to VLVector, where argument
+ * dependent lookup finds them.
+ */
+#ifndef CPP_EXAM_VLVECTORSEARCH_HPP
+#define CPP_EXAM_VLVECTORSEARCH_HPP
+
+#include "VLVector.hpp"
+#include "VLVectorSimd.hpp"
+
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#ifdef __SSE2__
+
+#include <emmintrin.h>
+
+#endif
+
+#define INLINE_UNROLL_BYTES 256
+
+#define EMPTY_MINMAX_MSG "minmax: the VLVector is empty"
+
+namespace vlvsearch
+{
+    /**
+     * @brief Keeps the type of value parameters from being deduced, so find(vec, 5) works for any integral vector.
+     */
+    template<class T>
+    struct NonDeducedImpl
+    {
+        typedef T type;
+    };
+
+    template<class T>
+    using NonDeduced = typename NonDeducedImpl<T>::type;
+
+    /**
+     * @brief Enables a search function only for element types the kernels support.
+     */
+    template<class T, class Ret>
+    using EnableIfSimd = std::enable_if_t<vlvsimd::IsSimdElement<T>::value, Ret>;
+
+    /**
+     * @return true if a vector of this size is searched by the unrolled static storage loop.
+     */
+    template<class T, size_t StaticCapacity>
+    constexpr bool unrollsInline(size_t size)
+    {
+        return StaticCapacity * sizeof(T) <= INLINE_UNROLL_BYTES && size <= StaticCapacity;
+    }
+
+    /**
+     * @brief The branch free scalar find of the first places of a small vector: every one of the first Places places is
+     * visited, the ones past the size read the first element instead and never match.
+     * @return The index of the first element equal to value, or size.
+     */
+    template<size_t Places, class T>
+    inline size_t findUnrolled(const T *src, size_t size, T value) noexcept
+    {
+        size_t found = size;
+#pragma GCC unroll 64
+        for (size_t i = FIRST_IDX; i < Places; ++i)
+        {
+            bool hit = (i < size) & (src[i < size ? i : FIRST_IDX] == value) & (found == size);
+            found = hit ? i : found;
+        }
+        return found;
+    }
+
+    /**
+     * @brief The branch free scalar count of the first places of a small vector. See findUnrolled.
+     */
+    template<size_t Places, class T>
+    inline size_t countUnrolled(const T *src, size_t size, T value) noexcept
+    {
+        size_t total = 0;
+#pragma GCC unroll 64
+        for (size_t i = FIRST_IDX; i < Places; ++i)
+        {
+            total += (i < size) & (src[i < size ? i : FIRST_IDX] == value);
+        }
+        return total;
+    }
+
+    /**
+     * @brief The find of a vector of at most StaticCapacity elements, fully unrolled over StaticCapacity. SSE2 is part
+     * of the x86-64 baseline, so no dispatch is needed: each 16 byte window is compared at once, and windows past the
+     * size are slid back to end at the size. The only branches are on the size being below a single window.
+     * @return The index of the first element equal to value, or size.
+     */
+    template<size_t StaticCapacity, class T>
+    inline size_t findInline(const T *src, size_t size, T value) noexcept
+    {
+        if (!size)
+        {
+            return size;
+        }
+#ifdef __SSE2__
+        typedef typename vlvsimd::Vec<T, SSE2_BYTES>::type V;
+        constexpr size_t lanes = vlvsimd::Vec<T, SSE2_BYTES>::lanes;
+        if (size >= lanes)
+        {
+            V needle = V{} + value;
+            size_t found = size;
+#pragma GCC unroll 64
+            for (size_t i = FIRST_IDX; i < StaticCapacity; i += lanes)
+            {
+                size_t at = i + lanes <= size ? i : size - lanes;
+                V window;
+                vlvsimd::load(window, src + at);
+                unsigned mask = (unsigned) _mm_movemask_epi8((__m128i) (window == needle));
+                size_t hit = mask ? at + (size_t) __builtin_ctz(mask) / sizeof(T) : size;
+                found = hit < found ? hit : found;
+            }
+            return found;
+        }
+        return findUnrolled<(StaticCapacity < lanes ? StaticCapacity : lanes)>(src, size, value);
+#else
+        return findUnrolled<StaticCapacity>(src, size, value);
+#endif
+    }
+
+    /**
+     * @brief The count of a vector of at most StaticCapacity elements. See findInline. Lanes of a slid back window
+     * which the previous window already counted are masked out.
+     */
+    template<size_t StaticCapacity, class T>
+    inline size_t countInline(const T *src, size_t size, T value) noexcept
+    {
+        if (!size)
+        {
+            return size;
+        }
+#ifdef __SSE2__
+        typedef typename vlvsimd::Vec<T, SSE2_BYTES>::type V;
+        constexpr size_t lanes = vlvsimd::Vec<T, SSE2_BYTES>::lanes;
+        if (size >= lanes)
+        {
+            V needle = V{} + value;
+            size_t total = 0;
+#pragma GCC unroll 64
+            for (size_t i = FIRST_IDX; i < StaticCapacity; i += lanes)
+            {
+                size_t at = i + lanes <= size ? i : size - lanes;
+                size_t counted = i - at < lanes ? i - at : lanes;
+                V window;
+                vlvsimd::load(window, src + at);
+                uint32_t mask = (uint32_t) _mm_movemask_epi8((__m128i) (window == needle));
+                total += (size_t) __builtin_popcount((mask >> (counted * sizeof(T))) << (counted * sizeof(T)));
+            }
+            return total / sizeof(T);
+        }
+        return countUnrolled<(StaticCapacity < lanes ? StaticCapacity : lanes)>(src, size, value);
+#else
+        return countUnrolled<StaticCapacity>(src, size, value);
+#endif
+    }
+
+    /**
+     * @return The index of the first element equal to value, or vec.size().
+     */
+    template<class T, size_t StaticCapacity>
+    inline size_t findIndex(VLVector<T, StaticCapacity> const &vec, NonDeduced<T> const &value) noexcept
+    {
+        if (unrollsInline<T, StaticCapacity>(vec.size()))
+        {
+            return findInline<StaticCapacity>(vec.data(), vec.size(), value);
+        }
+        return vlvsimd::findEq(vec.data(), vec.size(), value);
+    }
+
+    /**
+     * @return The index of the first smallest (or, if Max, the first largest) of the size > 0 elements, with the
+     * semantics of std::min_element and std::max_element. The extreme is reduced by the SIMD kernels and then found;
+     * -0 and +0 are equal to both, like they are to operator<. If there is a NaN, the kernels return one, and the
+     * elements are scanned like std does instead: the running extreme is only replaced by an element which operator<
+     * orders past it, so a NaN is never moved to and a leading NaN is the result.
+     */
+    template<bool Max, class T>
+    inline size_t extremeIndex(const T *src, size_t size) noexcept
+    {
+        T extreme = Max ? vlvsimd::maxValue(src, size) : vlvsimd::minValue(src, size);
+        if (extreme == extreme)
+        {
+            return vlvsimd::findEq(src, size, extreme);
+        }
+        size_t best = FIRST_IDX;
+        for (size_t i = NEXT_ELEM; i < size; ++i)
+        {
+            best = (Max ? src[best] < src[i] : src[i] < src[best]) ? i : best;
+        }
+        return best;
+    }
+}
+
+/**
+ * @return A const_iterator to the first element equal to value, or cend().
+ */
+template<class T, size_t StaticCapacity>
+vlvsearch::EnableIfSimd<T, typename VLVector<T, StaticCapacity>::const_iterator>
+find(VLVector<T, StaticCapacity> const &vec, vlvsearch::NonDeduced<T> const &value) noexcept
+{
+    return vec.cbegin() + vlvsearch::findIndex(vec, value);
+}
+
+/**
+ * @return An iterator to the first element equal to value, or end().
+ */
+template<class T, size_t StaticCapacity>
+vlvsearch::EnableIfSimd<T, typename VLVector<T, StaticCapacity>::iterator>
+find(VLVector<T, StaticCapacity> &vec, vlvsearch::NonDeduced<T> const &value) noexcept
+{
+    return vec.begin() + vlvsearch::findIndex(vec, value);
+}
+
+/**
+ * @return An iterator to the first element of lhs which is equal to the element of rhs at the same place, or
+ * lhs.cend(). Only the first min(lhs.size(), rhs.size()) places are compared.
+ */
+template<class T, size_t StaticCapacity, size_t OtherCapacity>
+vlvsearch::EnableIfSimd<T, typename VLVector<T, StaticCapacity>::const_iterator>
+find_if_eq(VLVector<T, StaticCapacity> const &lhs, VLVector<T, OtherCapacity> const &rhs) noexcept
+{
+    size_t common = lhs.size() < rhs.size() ? lhs.size() : rhs.size();
+    size_t idx = vlvsimd::findEqualPair(lhs.data(), rhs.data(), common);
+    return idx == common ? lhs.cend() : lhs.cbegin() + idx;
+}
+
+/**
+ * @return The amount of elements equal to value.
+ */
+template<class T, size_t StaticCapacity>
+vlvsearch::EnableIfSimd<T, size_t>
+count(VLVector<T, StaticCapacity> const &vec, vlvsearch::NonDeduced<T> const &value) noexcept
+{
+    if (vlvsearch::unrollsInline<T, StaticCapacity>(vec.size()))
+    {
+        return vlvsearch::countInline<StaticCapacity>(vec.data(), vec.size(), value);
+    }
+    return vlvsimd::countEq(vec.data(), vec.size(), value);
+}
+
+/**
+ * @return true if an element equal to value is in the vector.
+ */
+template<class T, size_t StaticCapacity>
+vlvsearch::EnableIfSimd<T, bool>
+contains(VLVector<T, StaticCapacity> const &vec, vlvsearch::NonDeduced<T> const &value) noexcept
+{
+    return vlvsearch::findIndex(vec, value) != vec.size();
+}
+
+/**
+ * @return A const_iterator to the first smallest element, or cend() if the vector is empty. See extremeIndex.
+ */
+template<class T>
+vlvsearch::EnableIfSimd<T, const T *>
+min_element(VLVectorBase<T> const &vec) noexcept
+{
+    if (vec.empty())
+    {
+        return vec.cend();
+    }
+    return vec.cbegin() + vlvsearch::extremeIndex<false>(vec.data(), vec.size());
+}
+
+/**
+ * @return A const_iterator to the first largest element, or cend() if the vector is empty. See extremeIndex.
+ */
+template<class T>
+vlvsearch::EnableIfSimd<T, const T *>
+max_element(VLVectorBase<T> const &vec) noexcept
+{
+    if (vec.empty())
+    {
+        return vec.cend();
+    }
+    return vec.cbegin() + vlvsearch::extremeIndex<true>(vec.data(), vec.size());
+}
+
+/**
+ * @return The smallest and the largest elements: the elements min_element and max_element point to, so a NaN is
+ * neither unless it leads. @throws std::out_of_range if the vector is empty.
+ */
+template<class T>
+vlvsearch::EnableIfSimd<T, std::pair<T, T>> minmax(VLVectorBase<T> const &vec)
+{
+    if (vec.empty())
+    {
+        throw std::out_of_range(EMPTY_MINMAX_MSG);
+    }
+    const T *src = vec.data();
+    if constexpr (std::is_integral<T>::value)
+    {
+        return std::pair<T, T>(vlvsimd::minValue(src, vec.size()), vlvsimd::maxValue(src, vec.size()));
+    }
+    else
+    {
+        return std::pair<T, T>(src[vlvsearch::extremeIndex<false>(src, vec.size())],
+                               src[vlvsearch::extremeIndex<true>(src, vec.size())]);
+    }
+}
+
+/**
+ * @return The sum of the elements. Integral elements are summed in 64 bits. Floating elements are summed in T, in an
+ * unspecified order, so the result may differ from a left to right sum by rounding.
+ */
+template<class T>
+vlvsearch::EnableIfSimd<T, vlvsimd::SumType<T>> sum(VLVectorBase<T> const &vec) noexcept
+{
+    return vlvsimd::sum(vec.data(), vec.size());
+}
+
+
+#endif //CPP_EXAM_VLVECTORSEARCH_HPP
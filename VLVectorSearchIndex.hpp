@@ -0,0 +1,370 @@
+/**
+ * @file VLVectorSearchIndex.hpp
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ *
+ * @brief Static search indexes over sorted VLVectors, in cache friendly layouts.
+ *
+ * @section DESCRIPTION A binary search over a large sorted array misses the cache on almost every level, since the
+ * keys it visits are far apart. VLEytzingerIndex and VLSTreeIndex copy the keys of a sorted VLVector of arithmetic
+ * elements into layouts where the next keys of a search are close together:
+ * - VLEytzingerIndex stores the keys in BFS order of the implicit binary search tree (the Eytzinger layout). A search
+ *   is branch free, and prefetches the cache line holding the descendants a few levels down while it compares.
+ * - VLSTreeIndex stores them as an implicit static B-tree whose nodes are single cache lines of CACHE_LINE_BYTES. The
+ *   rank of the key in a node is computed with SIMD comparisons of the whole node.
+ * lower_bound returns the position in the indexed VLVector, so the index is a companion of the vector, which is kept
+ * as it is. After a batch of updates, update() rewrites only the changed positions when the size did not change, and
+ * rebuilds otherwise. Up to UINT32_MAX keys are supported.
+ */
+#ifndef CPP_EXAM_VLVECTORSEARCHINDEX_HPP
+#define CPP_EXAM_VLVECTORSEARCHINDEX_HPP
+
+#include "VLVector.hpp"
+#include "VLVectorSimd.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+
+#ifdef __SSE2__
+
+#include <emmintrin.h>
+
+#endif
+
+#define CACHE_LINE_BYTES 64
+
+#define MAX_INDEX_KEYS UINT32_MAX
+
+#define NO_SLOT ((size_t) -1)
+
+#define INDEX_SIZE_MSG "VLVector search index: too many keys"
+
+namespace vlvindex
+{
+    /**
+     * Deletes arrays made by allocateAligned.
+     */
+    struct AlignedDelete
+    {
+        void operator()(void *ptr) const noexcept
+        {
+            ::operator delete(ptr, std::align_val_t(CACHE_LINE_BYTES));
+        }
+    };
+
+    /**
+     * An array of trivial elements which starts on a cache line.
+     */
+    template<class T>
+    using AlignedArray = std::unique_ptr<T[], AlignedDelete>;
+
+    template<class T>
+    AlignedArray<T> allocateAligned(size_t n)
+    {
+        static_assert(std::is_trivial<T>::value, "aligned arrays hold trivial elements only");
+        return AlignedArray<T>(static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t(CACHE_LINE_BYTES))));
+    }
+
+    /**
+     * @return The key which pads the index past the real keys: larger than or equal to all of them.
+     */
+    template<class K>
+    constexpr K paddingKey()
+    {
+        typedef std::numeric_limits<K> Limits;
+        return Limits::has_infinity ? Limits::infinity() : Limits::max();
+    }
+
+    /**
+     * @throws std::length_error if n keys do not fit an index.
+     */
+    inline void checkSize(size_t n)
+    {
+        if (n >= MAX_INDEX_KEYS)
+        {
+            throw std::length_error(INDEX_SIZE_MSG);
+        }
+    }
+}
+
+/**
+ * An Eytzinger layout index over a sorted VLVector of arithmetic keys. The keys are kept 1-based, so the children of
+ * slot k are 2k and 2k + 1, and the 2^d descendants d levels down are contiguous.
+ * @tparam K The type of the keys.
+ */
+template<class K>
+class VLEytzingerIndex
+{
+    static_assert(vlvsimd::IsSimdElement<K>::value, "VLEytzingerIndex needs arithmetic keys");
+
+private:
+    size_t _size = STARTING_SIZE;
+    vlvindex::AlignedArray<K> _keys;
+    std::unique_ptr<uint32_t[]> _positions; //the position in the vector of the key of every slot.
+    std::unique_ptr<uint32_t[]> _slots; //the slot of every position in the vector.
+
+    /**
+     * @brief Fills the subtree of slot k with the keys from position next on, in order.
+     * @return The position after the last key of the subtree.
+     */
+    size_t _fill(const K *sorted, size_t next, size_t k)
+    {
+        if (k <= _size)
+        {
+            next = _fill(sorted, next, 2 * k);
+            _keys[k] = sorted[next];
+            _positions[k] = (uint32_t) next;
+            _slots[next] = (uint32_t) k;
+            next = _fill(sorted, next + NEXT_ELEM, 2 * k + 1);
+        }
+        return next;
+    }
+
+public:
+    /**
+     * The amount of slots a search prefetches ahead: the descendants of this many levels down fill a cache line.
+     */
+    static constexpr size_t PREFETCH_SLOTS = CACHE_LINE_BYTES / sizeof(K);
+
+    VLEytzingerIndex() = default;
+
+    /**
+     * @brief Indexes sorted, which must be sorted in ascending order.
+     */
+    explicit VLEytzingerIndex(VLVectorBase<K> const &sorted)
+    {
+        rebuild(sorted);
+    }
+
+    /**
+     * @brief Indexes sorted from scratch.
+     */
+    void rebuild(VLVectorBase<K> const &sorted)
+    {
+        vlvindex::checkSize(sorted.size());
+        _size = sorted.size();
+        _keys = vlvindex::allocateAligned<K>(_size + NEXT_ELEM);
+        _positions.reset(new uint32_t[_size + NEXT_ELEM]);
+        _slots.reset(new uint32_t[_size + NEXT_ELEM]);
+        _fill(sorted.data(), FIRST_IDX, NEXT_ELEM);
+    }
+
+    /**
+     * @brief Brings the index up to date after a batch of updates of sorted, which changed only the keys at positions
+     * [first, last). Those are rewritten in place if the size is the same, else the index is rebuilt.
+     */
+    void update(VLVectorBase<K> const &sorted, size_t first, size_t last)
+    {
+        if (sorted.size() != _size || !_keys)
+        {
+            rebuild(sorted);
+            return;
+        }
+        for (size_t position = first; position < last && position < _size; ++position)
+        {
+            _keys[_slots[position]] = sorted[position];
+        }
+    }
+
+    /**
+     * @return The amount of indexed keys.
+     */
+    size_t size() const noexcept
+    {
+        return _size;
+    }
+
+    /**
+     * @return The position of the first key which is not less than key in the indexed vector, or size().
+     */
+    size_t lower_bound(K const &key) const noexcept
+    {
+        const K *keys = _keys.get();
+        size_t k = NEXT_ELEM;
+        while (k <= _size)
+        {
+            __builtin_prefetch(keys + k * PREFETCH_SLOTS);
+            k = 2 * k + (keys[k] < key);
+        }
+        k >>= __builtin_ffsll((long long) ~k); //climbs back over the right turns after the last left one.
+        return k ? _positions[k] : _size;
+    }
+
+    /**
+     * @return true if key is in the indexed vector.
+     */
+    bool contains(K const &key) const noexcept
+    {
+        size_t position = lower_bound(key);
+        return position < _size && _keys[_slots[position]] == key;
+    }
+};
+
+/**
+ * A static B-tree (S-tree) index over a sorted VLVector of arithmetic keys. Every node is one cache line of NODE_KEYS
+ * keys, node k has the NODE_KEYS + 1 children k * (NODE_KEYS + 1) + 1 on, and the last node is padded with a key no
+ * smaller than any other.
+ * @tparam K The type of the keys.
+ */
+template<class K>
+class VLSTreeIndex
+{
+    static_assert(vlvsimd::IsSimdElement<K>::value, "VLSTreeIndex needs arithmetic keys");
+
+public:
+    /**
+     * The amount of keys in a node.
+     */
+    static constexpr size_t NODE_KEYS = CACHE_LINE_BYTES / sizeof(K);
+
+private:
+    size_t _size = STARTING_SIZE;
+    size_t _nodes = 0;
+    vlvindex::AlignedArray<K> _keys;
+    std::unique_ptr<uint32_t[]> _positions; //the position in the vector of the key of every slot, size() if padding.
+    std::unique_ptr<uint32_t[]> _slots; //the slot of every position in the vector.
+
+    static size_t _child(size_t node, size_t idx) noexcept
+    {
+        return node * (NODE_KEYS + 1) + idx + 1;
+    }
+
+    /**
+     * @brief Fills the subtree of node with the keys from position next on, in order.
+     * @return The position after the last key of the subtree.
+     */
+    size_t _fill(const K *sorted, size_t next, size_t node)
+    {
+        if (node >= _nodes)
+        {
+            return next;
+        }
+        for (size_t idx = FIRST_IDX; idx < NODE_KEYS; ++idx)
+        {
+            next = _fill(sorted, next, _child(node, idx));
+            size_t slot = node * NODE_KEYS + idx;
+            if (next < _size)
+            {
+                _keys[slot] = sorted[next];
+                _positions[slot] = (uint32_t) next;
+                _slots[next++] = (uint32_t) slot;
+            }
+            else
+            {
+                _keys[slot] = vlvindex::paddingKey<K>();
+                _positions[slot] = (uint32_t) _size;
+            }
+        }
+        return _fill(sorted, next, _child(node, NODE_KEYS));
+    }
+
+    /**
+     * @return The amount of keys of the node which are less than key. SSE2 compares 16 bytes of keys at once, and the
+     * count is the population count of the comparison masks.
+     */
+    static size_t _rankInNode(const K *node, K const &key) noexcept
+    {
+#ifdef __SSE2__
+        typedef typename vlvsimd::Vec<K, SSE2_BYTES>::type V;
+        constexpr size_t lanes = vlvsimd::Vec<K, SSE2_BYTES>::lanes;
+        V needle = V{} + key;
+        size_t less = 0;
+#pragma GCC unroll 4
+        for (size_t i = FIRST_IDX; i < NODE_KEYS; i += lanes)
+        {
+            V chunk;
+            vlvsimd::load(chunk, node + i);
+            less += (size_t) __builtin_popcount((unsigned) _mm_movemask_epi8((__m128i) (chunk < needle)));
+        }
+        return less / sizeof(K);
+#else
+        size_t less = 0;
+        for (size_t i = FIRST_IDX; i < NODE_KEYS; ++i)
+        {
+            less += node[i] < key;
+        }
+        return less;
+#endif
+    }
+
+public:
+    VLSTreeIndex() = default;
+
+    /**
+     * @brief Indexes sorted, which must be sorted in ascending order.
+     */
+    explicit VLSTreeIndex(VLVectorBase<K> const &sorted)
+    {
+        rebuild(sorted);
+    }
+
+    /**
+     * @brief Indexes sorted from scratch.
+     */
+    void rebuild(VLVectorBase<K> const &sorted)
+    {
+        vlvindex::checkSize(sorted.size());
+        _size = sorted.size();
+        _nodes = (_size + NODE_KEYS - 1) / NODE_KEYS;
+        _keys = vlvindex::allocateAligned<K>(_nodes * NODE_KEYS + NEXT_ELEM);
+        _positions.reset(new uint32_t[_nodes * NODE_KEYS + NEXT_ELEM]);
+        _slots.reset(new uint32_t[_size + NEXT_ELEM]);
+        _fill(sorted.data(), FIRST_IDX, FIRST_IDX);
+    }
+
+    /**
+     * @brief Brings the index up to date after a batch of updates of sorted. See VLEytzingerIndex::update.
+     */
+    void update(VLVectorBase<K> const &sorted, size_t first, size_t last)
+    {
+        if (sorted.size() != _size || !_keys)
+        {
+            rebuild(sorted);
+            return;
+        }
+        for (size_t position = first; position < last && position < _size; ++position)
+        {
+            _keys[_slots[position]] = sorted[position];
+        }
+    }
+
+    /**
+     * @return The amount of indexed keys.
+     */
+    size_t size() const noexcept
+    {
+        return _size;
+    }
+
+    /**
+     * @return The position of the first key which is not less than key in the indexed vector, or size(). Descends one
+     * node per level, remembering the slot of the last key not less than key it saw, and reads its position only once.
+     */
+    size_t lower_bound(K const &key) const noexcept
+    {
+        size_t found = NO_SLOT;
+        for (size_t node = FIRST_IDX; node < _nodes;)
+        {
+            size_t idx = _rankInNode(_keys.get() + node * NODE_KEYS, key);
+            found = idx < NODE_KEYS ? node * NODE_KEYS + idx : found;
+            node = _child(node, idx);
+        }
+        return found == NO_SLOT ? _size : _positions[found];
+    }
+
+    /**
+     * @return true if key is in the indexed vector.
+     */
+    bool contains(K const &key) const noexcept
+    {
+        size_t position = lower_bound(key);
+        return position < _size && _keys[_slots[position]] == key;
+    }
+};
+
+
+#endif //CPP_EXAM_VLVECTORSEARCHINDEX_HPP
@@ -0,0 +1,327 @@
+/**
+ * @file VLVectorSetOps.hpp
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ *
+ * @brief Operations on sorted VLVectors: intersection, union, difference and merge.
+ *
+ * @section DESCRIPTION set_intersection, set_union and set_difference take VLVectors sorted in ascending order without
+ * repeated elements (sets, like posting lists) and write the result, also sorted, to an output VLVector, replacing its
+ * content; merge takes any sorted VLVectors and keeps every element. The output capacity is reserved once, from the
+ * largest size the result can have. Intersections of 4 and 8 byte integers compare blocks of 8x8 or 4x4 elements at
+ * once with AVX2 when the CPU has it. When one input is much larger than the other, intersections and differences
+ * gallop over the large one instead. Unions, differences and merges otherwise run branch free scalar merges. The
+ * output must not be one of the inputs.
+ */
+#ifndef CPP_EXAM_VLVECTORSETOPS_HPP
+#define CPP_EXAM_VLVECTORSETOPS_HPP
+
+#include "VLVector.hpp"
+#include "VLVectorFilter.hpp"
+#include "VLVectorSimd.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+
+#ifdef VLV_SIMD_X86
+
+#include <immintrin.h>
+
+#endif
+
+#define GALLOP_RATIO 32
+
+namespace vlvsetops
+{
+    /**
+     * @return The index of the first element of large, from start on, which is not less than value: found by doubling
+     * steps from start, then a binary search of the last step. Cheap when the answer is close to start.
+     */
+    template<class T>
+    inline size_t gallop(const T *large, size_t start, size_t n, T const &value)
+    {
+        size_t bound = 1;
+        while (start + bound < n && large[start + bound] < value)
+        {
+            bound <<= 1;
+        }
+        size_t hi = start + bound + 1 < n ? start + bound + 1 : n;
+        return (size_t) (std::lower_bound(large + start + bound / 2, large + hi, value) - large);
+    }
+
+    /**
+     * @brief The scalar intersection: the smaller head advances, both advance on a match. Branches here beat a branch
+     * free loop, whose every step waits for the loads of the previous one.
+     * @return The amount of elements written to out.
+     */
+    template<class T>
+    inline size_t intersectScalar(const T *lhs, size_t lhsSize, const T *rhs, size_t rhsSize, T *out) noexcept
+    {
+        size_t i = FIRST_IDX, j = FIRST_IDX, kept = 0;
+        while (i < lhsSize && j < rhsSize)
+        {
+            if (lhs[i] < rhs[j])
+            {
+                ++i;
+            }
+            else if (rhs[j] < lhs[i])
+            {
+                ++j;
+            }
+            else
+            {
+                out[kept++] = lhs[i];
+                ++i, ++j;
+            }
+        }
+        return kept;
+    }
+
+    /**
+     * @brief Intersection of a small set with a much larger one, galloping over the large one.
+     */
+    template<class T>
+    inline size_t intersectGallop(const T *small, size_t smallSize, const T *large, size_t largeSize, T *out)
+    {
+        size_t j = FIRST_IDX, kept = 0;
+        for (size_t i = FIRST_IDX; i < smallSize && j < largeSize; ++i)
+        {
+            j = gallop(large, j, largeSize, small[i]);
+            if (j < largeSize)
+            {
+                out[kept] = small[i];
+                kept += large[j] == small[i];
+            }
+        }
+        return kept;
+    }
+
+#ifdef VLV_SIMD_X86
+
+    /**
+     * @brief The AVX2 block intersection of 4 and 8 byte integers: a block of lhs is compared to every rotation of a
+     * block of rhs, the lanes of lhs which matched are packed by the permutation table of VLVectorFilter.hpp, and the
+     * block with the smaller last element advances. Every store is of a whole block, so the blocks stop while a store
+     * could still pass min(lhsSize, rhsSize) elements of out, and the scalar loop finishes.
+     */
+    template<class T>
+    VLV_TARGET_AVX2 size_t intersectAvx2(const T *lhs, size_t lhsSize, const T *rhs, size_t rhsSize, T *out)
+    {
+        constexpr size_t lanes = AVX2_BYTES / sizeof(T);
+        size_t room = lhsSize < rhsSize ? lhsSize : rhsSize;
+        size_t i = FIRST_IDX, j = FIRST_IDX, kept = 0;
+        while (i + lanes <= lhsSize && j + lanes <= rhsSize && kept + lanes <= room)
+        {
+            __m256i blockL = _mm256_loadu_si256((const __m256i *) (lhs + i));
+            __m256i blockR = _mm256_loadu_si256((const __m256i *) (rhs + j));
+            unsigned mask;
+            const uint32_t *permute;
+            if constexpr (sizeof(T) == sizeof(uint32_t))
+            {
+                // The 8 rotations as 4 rotations within the 128 bit halves, of blockR and of blockR with its halves
+                // swapped: all of them depend on blockR only, so they run in parallel.
+                __m256i swapped = _mm256_permute2x128_si256(blockR, blockR, 0x01);
+                __m256i match = _mm256_or_si256(_mm256_cmpeq_epi32(blockL, blockR),
+                                                _mm256_cmpeq_epi32(blockL, swapped));
+                match = _mm256_or_si256(match, _mm256_cmpeq_epi32(blockL, _mm256_shuffle_epi32(blockR, 0x39)));
+                match = _mm256_or_si256(match, _mm256_cmpeq_epi32(blockL, _mm256_shuffle_epi32(blockR, 0x4e)));
+                match = _mm256_or_si256(match, _mm256_cmpeq_epi32(blockL, _mm256_shuffle_epi32(blockR, 0x93)));
+                match = _mm256_or_si256(match, _mm256_cmpeq_epi32(blockL, _mm256_shuffle_epi32(swapped, 0x39)));
+                match = _mm256_or_si256(match, _mm256_cmpeq_epi32(blockL, _mm256_shuffle_epi32(swapped, 0x4e)));
+                match = _mm256_or_si256(match, _mm256_cmpeq_epi32(blockL, _mm256_shuffle_epi32(swapped, 0x93)));
+                mask = (unsigned) _mm256_movemask_ps(_mm256_castsi256_ps(match));
+                permute = vlvfilter::PERMUTE_TABLE.lanes32[mask];
+            }
+            else
+            {
+                __m256i match = _mm256_cmpeq_epi64(blockL, blockR);
+                match = _mm256_or_si256(match, _mm256_cmpeq_epi64(blockL, _mm256_permute4x64_epi64(blockR, 0x39)));
+                match = _mm256_or_si256(match, _mm256_cmpeq_epi64(blockL, _mm256_permute4x64_epi64(blockR, 0x4e)));
+                match = _mm256_or_si256(match, _mm256_cmpeq_epi64(blockL, _mm256_permute4x64_epi64(blockR, 0x93)));
+                mask = (unsigned) _mm256_movemask_pd(_mm256_castsi256_pd(match));
+                permute = vlvfilter::PERMUTE_TABLE.lanes64[mask];
+            }
+            __m256i packed = _mm256_permutevar8x32_epi32(blockL, _mm256_load_si256((const __m256i *) permute));
+            _mm256_storeu_si256((__m256i *) (out + kept), packed);
+            kept += (size_t) __builtin_popcount(mask);
+            T lastL = lhs[i + lanes - 1], lastR = rhs[j + lanes - 1];
+            i += lastL <= lastR ? lanes : 0;
+            j += lastR <= lastL ? lanes : 0;
+        }
+        return kept + intersectScalar(lhs + i, lhsSize - i, rhs + j, rhsSize - j, out + kept);
+    }
+
+#endif
+
+    /**
+     * @brief Intersection of two sets into out, which needs room for min(lhsSize, rhsSize) elements.
+     * @return The size of the intersection.
+     */
+    template<class T>
+    size_t intersect(const T *lhs, size_t lhsSize, const T *rhs, size_t rhsSize, T *out)
+    {
+        if (lhsSize > rhsSize * GALLOP_RATIO)
+        {
+            return intersectGallop(rhs, rhsSize, lhs, lhsSize, out);
+        }
+        if (rhsSize > lhsSize * GALLOP_RATIO)
+        {
+            return intersectGallop(lhs, lhsSize, rhs, rhsSize, out);
+        }
+#ifdef VLV_SIMD_X86
+        if constexpr (std::is_integral<T>::value && (sizeof(T) == sizeof(uint32_t) || sizeof(T) == sizeof(uint64_t)))
+        {
+            if (vlvsimd::simdLevel() >= vlvsimd::SIMD_AVX2)
+            {
+                return intersectAvx2(lhs, lhsSize, rhs, rhsSize, out);
+            }
+        }
+#endif
+        return intersectScalar(lhs, lhsSize, rhs, rhsSize, out);
+    }
+
+    /**
+     * @brief Union of two sets into out, which needs room for lhsSize + rhsSize elements. The smaller head is written
+     * without a branch, and an element of both is written once.
+     * @return The size of the union.
+     */
+    template<class T>
+    size_t unite(const T *lhs, size_t lhsSize, const T *rhs, size_t rhsSize, T *out) noexcept
+    {
+        size_t i = FIRST_IDX, j = FIRST_IDX, kept = 0;
+        while (i < lhsSize && j < rhsSize)
+        {
+            T x = lhs[i], y = rhs[j];
+            out[kept++] = y < x ? y : x;
+            i += x <= y;
+            j += y <= x;
+        }
+        kept = (size_t) (std::copy(lhs + i, lhs + lhsSize, out + kept) - out);
+        return (size_t) (std::copy(rhs + j, rhs + rhsSize, out + kept) - out);
+    }
+
+    /**
+     * @brief The elements of lhs which are not in rhs into out, which needs room for lhsSize elements. Gallops over
+     * rhs when it is much larger.
+     * @return The size of the difference.
+     */
+    template<class T>
+    size_t subtract(const T *lhs, size_t lhsSize, const T *rhs, size_t rhsSize, T *out)
+    {
+        size_t i = FIRST_IDX, j = FIRST_IDX, kept = 0;
+        if (rhsSize > lhsSize * GALLOP_RATIO)
+        {
+            for (; i < lhsSize && j < rhsSize; ++i)
+            {
+                j = gallop(rhs, j, rhsSize, lhs[i]);
+                out[kept] = lhs[i];
+                kept += j == rhsSize || rhs[j] != lhs[i];
+            }
+        }
+        else
+        {
+            while (i < lhsSize && j < rhsSize)
+            {
+                T x = lhs[i], y = rhs[j];
+                out[kept] = x;
+                kept += x < y;
+                i += x <= y;
+                j += y <= x;
+            }
+        }
+        return (size_t) (std::copy(lhs + i, lhs + lhsSize, out + kept) - out);
+    }
+
+    /**
+     * @brief Merge of two sorted ranges into out, which needs room for lhsSize + rhsSize elements. Stable: of equal
+     * elements, the ones of lhs come first.
+     */
+    template<class T>
+    void merge(const T *lhs, size_t lhsSize, const T *rhs, size_t rhsSize, T *out) noexcept
+    {
+        size_t i = FIRST_IDX, j = FIRST_IDX, kept = 0;
+        while (i < lhsSize && j < rhsSize)
+        {
+            bool takeRhs = rhs[j] < lhs[i];
+            out[kept++] = takeRhs ? rhs[j] : lhs[i];
+            j += takeRhs;
+            i += !takeRhs;
+        }
+        kept = (size_t) (std::copy(lhs + i, lhs + lhsSize, out + kept) - out);
+        std::copy(rhs + j, rhs + rhsSize, out + kept);
+    }
+
+    /**
+     * @brief Replaces the content of out by the result op writes, reserving bound elements for it once. The old
+     * elements are dropped first if the storage has to grow, so they are not copied to the new one.
+     */
+    template<class T, class Operation>
+    void overwrite(VLVectorBase<T> &out, size_t bound, Operation op)
+    {
+        if (out.capacity() < bound)
+        {
+            out.clear();
+        }
+        out.resize_and_overwrite(bound, op);
+    }
+}
+
+/**
+ * @brief Replaces the content of out by the elements which are in both lhs and rhs.
+ * @return The size of the intersection.
+ */
+template<class T>
+size_t set_intersection(VLVectorBase<T> const &lhs, VLVectorBase<T> const &rhs, VLVectorBase<T> &out)
+{
+    vlvsetops::overwrite(out, std::min(lhs.size(), rhs.size()), [&](T *elems, size_t)
+    {
+        return vlvsetops::intersect(lhs.data(), lhs.size(), rhs.data(), rhs.size(), elems);
+    });
+    return out.size();
+}
+
+/**
+ * @brief Replaces the content of out by the elements which are in lhs, in rhs or in both.
+ * @return The size of the union.
+ */
+template<class T>
+size_t set_union(VLVectorBase<T> const &lhs, VLVectorBase<T> const &rhs, VLVectorBase<T> &out)
+{
+    vlvsetops::overwrite(out, lhs.size() + rhs.size(), [&](T *elems, size_t)
+    {
+        return vlvsetops::unite(lhs.data(), lhs.size(), rhs.data(), rhs.size(), elems);
+    });
+    return out.size();
+}
+
+/**
+ * @brief Replaces the content of out by the elements of lhs which are not in rhs.
+ * @return The size of the difference.
+ */
+template<class T>
+size_t set_difference(VLVectorBase<T> const &lhs, VLVectorBase<T> const &rhs, VLVectorBase<T> &out)
+{
+    vlvsetops::overwrite(out, lhs.size(), [&](T *elems, size_t)
+    {
+        return vlvsetops::subtract(lhs.data(), lhs.size(), rhs.data(), rhs.size(), elems);
+    });
+    return out.size();
+}
+
+/**
+ * @brief Replaces the content of out by all of the elements of the sorted lhs and rhs, sorted. Of equal elements, the
+ * ones of lhs come first.
+ */
+template<class T>
+void merge(VLVectorBase<T> const &lhs, VLVectorBase<T> const &rhs, VLVectorBase<T> &out)
+{
+    vlvsetops::overwrite(out, lhs.size() + rhs.size(), [&](T *elems, size_t size)
+    {
+        vlvsetops::merge(lhs.data(), lhs.size(), rhs.data(), rhs.size(), elems);
+        return size;
+    });
+}
+
+
+#endif //CPP_EXAM_VLVECTORSETOPS_HPP
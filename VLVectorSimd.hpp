@@ -0,0 +1,486 @@
+/**
+ * @file VLVectorSimd.hpp
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ *
+ * @brief SIMD kernels over contiguous arrays of arithmetic elements, with runtime dispatch.
+ *
+ * @section DESCRIPTION Every kernel is written once, generically over the vector width, with the compiler's vector
+ * extensions. It is then compiled for SSE2, AVX2 and AVX-512 and the widest one the running CPU supports is picked on
+ * the first call. Compilers or targets without vector extensions get the scalar versions only. The VLVECTOR_SIMD
+ * environment variable (scalar, sse2, avx2 or avx512) caps the picked level, which helps when comparing the paths.
+ * All of the kernels take raw pointers, the VLVector level functions are in VLVectorSearch.hpp.
+ */
+#ifndef CPP_EXAM_VLVECTORSIMD_HPP
+#define CPP_EXAM_VLVECTORSIMD_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define VLV_SIMD_X86
+#endif
+
+#define SCALAR_BYTES 0
+
+#define SSE2_BYTES 16
+
+#define AVX2_BYTES 32
+
+#define AVX512_BYTES 64
+
+// GCC lowers comparisons of 64 byte generic vectors to scalar code, so the generic kernels run 32 byte vectors at the
+// AVX-512 level too, and only gain its extra instructions (masked ops, ternary logic). Hand written kernels use 64.
+#define GENERIC_AVX512_BYTES AVX2_BYTES
+
+#define SIMD_UNROLL 4
+
+#define SIMD_ENV_VAR "VLVECTOR_SIMD"
+
+#define VLV_ALWAYS_INLINE __attribute__((always_inline)) inline
+
+#define VLV_TARGET_SSE2 __attribute__((target("sse2")))
+
+#define VLV_TARGET_AVX2 __attribute__((target("avx2,bmi,bmi2,popcnt")))
+
+#define VLV_TARGET_AVX512 __attribute__((target("avx512f,avx512bw,avx512dq,avx512vl,avx2,bmi,bmi2,popcnt")))
+
+#ifdef VLV_SIMD_X86
+
+/**
+ * @brief Defines the SSE2, AVX2 and AVX-512 instances of the generic kernel name##Body, and name itself, which calls
+ * the widest instance the CPU supports. Params is the parenthesized parameter list and Args the matching arguments.
+ */
+#define VLV_SIMD_KERNEL(Ret, name, Params, Args) \
+    template<class T> VLV_TARGET_SSE2 Ret name##Sse2 Params { return name##Body<T, SSE2_BYTES> Args; } \
+    template<class T> VLV_TARGET_AVX2 Ret name##Avx2 Params { return name##Body<T, AVX2_BYTES> Args; } \
+    template<class T> VLV_TARGET_AVX512 Ret name##Avx512 Params { return name##Body<T, GENERIC_AVX512_BYTES> Args; } \
+    template<class T> inline Ret name Params \
+    { \
+        switch (simdLevel()) \
+        { \
+            case SIMD_AVX512: return name##Avx512<T> Args; \
+            case SIMD_AVX2: return name##Avx2<T> Args; \
+            case SIMD_SSE2: return name##Sse2<T> Args; \
+            default: return name##Body<T, SCALAR_BYTES> Args; \
+        } \
+    }
+
+#else
+
+#define VLV_SIMD_KERNEL(Ret, name, Params, Args) \
+    template<class T> inline Ret name Params { return name##Body<T, SCALAR_BYTES> Args; }
+
+#endif
+
+namespace vlvsimd
+{
+    /**
+     * The instruction sets the kernels are compiled for, from the narrowest.
+     */
+    enum SimdLevel
+    {
+        SIMD_SCALAR, SIMD_SSE2, SIMD_AVX2, SIMD_AVX512
+    };
+
+    /**
+     * @return The widest level supported by the CPU, capped by the VLVECTOR_SIMD environment variable.
+     */
+    inline SimdLevel detectSimdLevel()
+    {
+        SimdLevel level = SIMD_SCALAR;
+#ifdef VLV_SIMD_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+            __builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("avx512vl"))
+        {
+            level = SIMD_AVX512;
+        }
+        else if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("bmi2"))
+        {
+            level = SIMD_AVX2;
+        }
+        else if (__builtin_cpu_supports("sse2"))
+        {
+            level = SIMD_SSE2;
+        }
+#endif
+        const char *cap = std::getenv(SIMD_ENV_VAR);
+        if (cap)
+        {
+            static const char *const names[] = {"scalar", "sse2", "avx2", "avx512"};
+            for (int capLevel = SIMD_SCALAR; capLevel <= SIMD_AVX512; ++capLevel)
+            {
+                if (!std::strcmp(cap, names[capLevel]) && capLevel < level)
+                {
+                    level = (SimdLevel) capLevel;
+                }
+            }
+        }
+        return level;
+    }
+
+    /**
+     * @return The level the kernels run at. Detected once.
+     */
+    inline SimdLevel simdLevel()
+    {
+        static const SimdLevel level = detectSimdLevel();
+        return level;
+    }
+
+    /**
+     * The types the kernels accept: every arithmetic type but bool.
+     */
+    template<class T>
+    struct IsSimdElement : std::integral_constant<bool, std::is_arithmetic<T>::value &&
+                                                        !std::is_same<std::remove_cv_t<T>, bool>::value>
+    {
+    };
+
+    /**
+     * @brief The type sum() accumulates and returns: 64 bit integers for integral types, T itself for floating ones.
+     */
+    template<class T>
+    using SumType = std::conditional_t<std::is_floating_point<T>::value, T,
+            std::conditional_t<std::is_signed<T>::value, int64_t, uint64_t>>;
+
+    /**
+     * @brief The signed integer type of the same size as T, which is the lane type of comparison masks.
+     */
+    template<class T>
+    using MaskLane = std::conditional_t<sizeof(T) == 1, int8_t, std::conditional_t<sizeof(T) == 2, int16_t,
+            std::conditional_t<sizeof(T) == 4, int32_t, int64_t>>>;
+
+    /**
+     * A vector of Bytes / sizeof(T) lanes of T.
+     */
+    template<class T, size_t Bytes>
+    struct Vec
+    {
+        typedef T type __attribute__((vector_size(Bytes)));
+        static constexpr size_t lanes = Bytes / sizeof(T);
+    };
+
+    /**
+     * @brief Unaligned load of a vector from src.
+     */
+    template<class V, class T>
+    VLV_ALWAYS_INLINE void load(V &dst, const T *src) noexcept
+    {
+        std::memcpy(&dst, src, sizeof(V));
+    }
+
+    /**
+     * @return true if any bit of the mask is set. Folds the halves down to 16 bytes instead of extracting every lane.
+     */
+    template<size_t Bytes, class M>
+    VLV_ALWAYS_INLINE bool anyLane(M const &mask) noexcept
+    {
+        if constexpr (Bytes > SSE2_BYTES)
+        {
+            typedef uint64_t Half __attribute__((vector_size(Bytes / 2)));
+            Half low, high;
+            std::memcpy(&low, &mask, Bytes / 2);
+            std::memcpy(&high, reinterpret_cast<const char *>(&mask) + Bytes / 2, Bytes / 2);
+            Half folded = low | high;
+            return anyLane<Bytes / 2>(folded);
+        }
+        else
+        {
+            uint64_t words[2];
+            std::memcpy(words, &mask, sizeof(words));
+            return (words[0] | words[1]) != 0;
+        }
+    }
+
+    /**
+     * @brief Spills the lanes of a vector to an array.
+     */
+    template<class T, class V>
+    VLV_ALWAYS_INLINE void storeLanes(T *dst, V const &src) noexcept
+    {
+        std::memcpy(dst, &src, sizeof(V));
+    }
+
+    /**
+     * @return The index of the first element equal to value, or n.
+     */
+    template<class T, size_t Bytes>
+    VLV_ALWAYS_INLINE size_t findEqBody(const T *src, size_t n, T value) noexcept
+    {
+        size_t i = 0;
+        if constexpr (Bytes != SCALAR_BYTES)
+        {
+            typedef typename Vec<T, Bytes>::type V;
+            constexpr size_t lanes = Vec<T, Bytes>::lanes;
+            V needle = V{} + value;
+            for (; i + SIMD_UNROLL * lanes <= n; i += SIMD_UNROLL * lanes)
+            {
+                V a, b, c, d;
+                load(a, src + i), load(b, src + i + lanes), load(c, src + i + 2 * lanes), load(d, src + i + 3 * lanes);
+                auto hits = (a == needle) | (b == needle) | (c == needle) | (d == needle);
+                if (anyLane<Bytes>(hits))
+                {
+                    break; // the scalar loop below finds it within the next SIMD_UNROLL vectors.
+                }
+            }
+            for (; i + lanes <= n; i += lanes)
+            {
+                V a;
+                load(a, src + i);
+                auto hits = a == needle;
+                if (anyLane<Bytes>(hits))
+                {
+                    break;
+                }
+            }
+        }
+        for (; i < n; ++i)
+        {
+            if (src[i] == value)
+            {
+                return i;
+            }
+        }
+        return n;
+    }
+
+    /**
+     * @return The index of the first place in which lhs and rhs hold equal elements, or n.
+     */
+    template<class T, size_t Bytes>
+    VLV_ALWAYS_INLINE size_t findEqualPairBody(const T *lhs, const T *rhs, size_t n) noexcept
+    {
+        size_t i = 0;
+        if constexpr (Bytes != SCALAR_BYTES)
+        {
+            typedef typename Vec<T, Bytes>::type V;
+            constexpr size_t lanes = Vec<T, Bytes>::lanes;
+            for (; i + lanes <= n; i += lanes)
+            {
+                V a, b;
+                load(a, lhs + i), load(b, rhs + i);
+                auto hits = a == b;
+                if (anyLane<Bytes>(hits))
+                {
+                    break;
+                }
+            }
+        }
+        for (; i < n; ++i)
+        {
+            if (lhs[i] == rhs[i])
+            {
+                return i;
+            }
+        }
+        return n;
+    }
+
+    /**
+     * @return The index of the first place in which lhs and rhs hold elements which are not equal (by operator==, so
+     * NaNs never match and signed zeros do), or n.
+     */
+    template<class T, size_t Bytes>
+    VLV_ALWAYS_INLINE size_t mismatchBody(const T *lhs, const T *rhs, size_t n) noexcept
+    {
+        size_t i = 0;
+        if constexpr (Bytes != SCALAR_BYTES)
+        {
+            typedef typename Vec<T, Bytes>::type V;
+            constexpr size_t lanes = Vec<T, Bytes>::lanes;
+            for (; i + 2 * lanes <= n; i += 2 * lanes)
+            {
+                V a, b, c, d;
+                load(a, lhs + i), load(b, rhs + i), load(c, lhs + i + lanes), load(d, rhs + i + lanes);
+                auto misses = (a != b) | (c != d);
+                if (anyLane<Bytes>(misses))
+                {
+                    break;
+                }
+            }
+            for (; i + lanes <= n; i += lanes)
+            {
+                V a, b;
+                load(a, lhs + i), load(b, rhs + i);
+                auto misses = a != b;
+                if (anyLane<Bytes>(misses))
+                {
+                    break;
+                }
+            }
+        }
+        for (; i < n; ++i)
+        {
+            if (!(lhs[i] == rhs[i]))
+            {
+                return i;
+            }
+        }
+        return n;
+    }
+
+    /**
+     * @return The amount of elements equal to value.
+     */
+    template<class T, size_t Bytes>
+    VLV_ALWAYS_INLINE size_t countEqBody(const T *src, size_t n, T value) noexcept
+    {
+        size_t i = 0, total = 0;
+        if constexpr (Bytes != SCALAR_BYTES)
+        {
+            typedef typename Vec<T, Bytes>::type V;
+            typedef MaskLane<T> Lane;
+            typedef typename Vec<Lane, Bytes>::type Counts;
+            constexpr size_t lanes = Vec<T, Bytes>::lanes;
+            // every round adds at most 1 to a lane, so narrow lanes are flushed before they can overflow.
+            constexpr size_t maxRounds = sizeof(Lane) >= sizeof(uint32_t) ? SIZE_MAX
+                                                                            : (size_t) std::numeric_limits<Lane>::max();
+            V needle = V{} + value;
+            while (i + lanes <= n)
+            {
+                Counts counts = {};
+                for (size_t rounds = 0; rounds < maxRounds && i + lanes <= n; ++rounds, i += lanes)
+                {
+                    V a;
+                    load(a, src + i);
+                    counts -= (Counts) (a == needle); // true lanes are all ones, that is -1.
+                }
+                Lane laneCounts[lanes];
+                storeLanes(laneCounts, counts);
+                for (Lane laneCount : laneCounts)
+                {
+                    total += (size_t) (std::make_unsigned_t<Lane>) laneCount;
+                }
+            }
+        }
+        for (; i < n; ++i)
+        {
+            total += src[i] == value;
+        }
+        return total;
+    }
+
+    /**
+     * @return The smallest element if Max is false, the largest otherwise. n must be positive. Lanes are reduced
+     * separately, and a NaN among floating elements is tracked by x != x alongside, so the result is a NaN if any
+     * element is one, whatever the SIMD level.
+     */
+    template<bool Max, class T, size_t Bytes>
+    VLV_ALWAYS_INLINE T extremeBody(const T *src, size_t n) noexcept
+    {
+        size_t i = 0;
+        T best = src[0];
+        bool nan = false;
+        if constexpr (Bytes != SCALAR_BYTES)
+        {
+            typedef typename Vec<T, Bytes>::type V;
+            constexpr size_t lanes = Vec<T, Bytes>::lanes;
+            if (n >= lanes)
+            {
+                V acc;
+                load(acc, src);
+                auto nans = acc != acc;
+                for (i = lanes; i + lanes <= n; i += lanes)
+                {
+                    V a;
+                    load(a, src + i);
+                    acc = Max ? (a > acc ? a : acc) : (a < acc ? a : acc);
+                    if constexpr (std::is_floating_point<T>::value)
+                    {
+                        nans |= a != a;
+                    }
+                }
+                nan = std::is_floating_point<T>::value && anyLane<Bytes>(nans);
+                T laneBests[lanes];
+                storeLanes(laneBests, acc);
+                for (T lane : laneBests)
+                {
+                    best = Max ? (lane > best ? lane : best) : (lane < best ? lane : best);
+                }
+            }
+        }
+        for (; i < n; ++i)
+        {
+            best = Max ? (src[i] > best ? src[i] : best) : (src[i] < best ? src[i] : best);
+            nan |= src[i] != src[i];
+        }
+        return nan ? std::numeric_limits<T>::quiet_NaN() : best;
+    }
+
+    template<class T, size_t Bytes>
+    VLV_ALWAYS_INLINE T minValueBody(const T *src, size_t n) noexcept
+    {
+        return extremeBody<false, T, Bytes>(src, n);
+    }
+
+    template<class T, size_t Bytes>
+    VLV_ALWAYS_INLINE T maxValueBody(const T *src, size_t n) noexcept
+    {
+        return extremeBody<true, T, Bytes>(src, n);
+    }
+
+    /**
+     * @return The sum of the elements, accumulated in SumType<T>. Floating sums are reassociated across the lanes.
+     */
+    template<class T, size_t Bytes>
+    VLV_ALWAYS_INLINE SumType<T> sumBody(const T *src, size_t n) noexcept
+    {
+        typedef SumType<T> S;
+        size_t i = 0;
+        S total = 0;
+        if constexpr (Bytes != SCALAR_BYTES)
+        {
+            typedef typename Vec<T, Bytes>::type V;
+            constexpr size_t lanes = Vec<T, Bytes>::lanes;
+            typedef typename Vec<S, lanes * sizeof(S)>::type Wide;
+            Wide acc = {};
+            for (; i + lanes <= n; i += lanes)
+            {
+                V a;
+                load(a, src + i);
+                if constexpr (std::is_same<S, T>::value)
+                {
+                    acc += a;
+                }
+                else
+                {
+                    acc += __builtin_convertvector(a, Wide);
+                }
+            }
+            S laneSums[lanes];
+            storeLanes(laneSums, acc);
+            for (S lane : laneSums)
+            {
+                total += lane;
+            }
+        }
+        for (; i < n; ++i)
+        {
+            total += (S) src[i];
+        }
+        return total;
+    }
+
+    VLV_SIMD_KERNEL(size_t, findEq, (const T *src, size_t n, T value), (src, n, value))
+
+    VLV_SIMD_KERNEL(size_t, findEqualPair, (const T *lhs, const T *rhs, size_t n), (lhs, rhs, n))
+
+    VLV_SIMD_KERNEL(size_t, mismatch, (const T *lhs, const T *rhs, size_t n), (lhs, rhs, n))
+
+    VLV_SIMD_KERNEL(size_t, countEq, (const T *src, size_t n, T value), (src, n, value))
+
+    VLV_SIMD_KERNEL(T, minValue, (const T *src, size_t n), (src, n))
+
+    VLV_SIMD_KERNEL(T, maxValue, (const T *src, size_t n), (src, n))
+
+    VLV_SIMD_KERNEL(SumType<T>, sum, (const T *src, size_t n), (src, n))
+}
+
+
+#endif //CPP_EXAM_VLVECTORSIMD_HPP
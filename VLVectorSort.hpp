@@ -0,0 +1,362 @@
+/**
+ * @file VLVectorSort.hpp
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ *
+ * @brief Sorting of VLVectors, dispatched on the size and the element type.
+ *
+ * @section DESCRIPTION sort() and stable_sort() of VLVectors of arithmetic elements pick one of:
+ * - A branch free sorting network, when the vector is in its static storage and StaticCapacity is at most
+ *   NETWORK_MAX_SIZE. One Batcher odd-even merge network is built at compile time per power of two, and the vector is
+ *   padded up to it with the largest value of T.
+ * - An LSD radix sort on 8 bit digits, from RADIX_MIN_SIZE elements, which uses the spare capacity of the vector as
+ *   its scratch buffer when there is enough of it.
+ * - std::sort (introsort) or std::stable_sort otherwise, and for any other element type or comparator.
+ * Sorting networks are not stable, so stable_sort uses them for integral elements only, where equal elements can not
+ * be told apart.
+ */
+#ifndef CPP_EXAM_VLVECTORSORT_HPP
+#define CPP_EXAM_VLVECTORSORT_HPP
+
+#include "VLVector.hpp"
+#include "VLVectorSimd.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <type_traits>
+
+#define NETWORK_MAX_SIZE 32
+
+#define RADIX_MIN_SIZE 512
+
+#define RADIX_BITS 8
+
+#define RADIX_BUCKETS (1 << RADIX_BITS)
+
+#define INSERTION_SORT_MAX_SIZE 16
+
+namespace vlvsort
+{
+    /**
+     * A comparator of a sorting network: the smaller element goes to lo, the larger to hi.
+     */
+    struct Comparator
+    {
+        uint8_t lo;
+        uint8_t hi;
+    };
+
+    /**
+     * @brief Walks the Batcher odd-even merge sort network of Size (a power of two) inputs.
+     * @return The amount of comparators. If out is given, the comparators are written to it.
+     */
+    constexpr size_t oddEvenMergeNetwork(size_t size, Comparator *out)
+    {
+        size_t amount = 0;
+        for (size_t p = 1; p < size; p <<= 1)
+        {
+            for (size_t k = p; k >= 1; k >>= 1)
+            {
+                for (size_t j = k % p; j + k < size; j += 2 * k)
+                {
+                    for (size_t i = 0; i < k && i + j + k < size; ++i)
+                    {
+                        if ((i + j) / (2 * p) == (i + j + k) / (2 * p))
+                        {
+                            if (out)
+                            {
+                                out[amount] = Comparator{(uint8_t) (i + j), (uint8_t) (i + j + k)};
+                            }
+                            ++amount;
+                        }
+                    }
+                }
+            }
+        }
+        return amount;
+    }
+
+    /**
+     * The comparators of the Size input network, built at compile time.
+     */
+    template<size_t Size>
+    struct Network
+    {
+        static constexpr size_t amount = oddEvenMergeNetwork(Size, nullptr);
+
+        static constexpr std::array<Comparator, amount> build()
+        {
+            std::array<Comparator, amount> comparators = {};
+            oddEvenMergeNetwork(Size, comparators.data());
+            return comparators;
+        }
+
+        static constexpr std::array<Comparator, amount> comparators = build();
+    };
+
+    /**
+     * @brief Sorts Size elements (a power of two) in place with the network. Fully unrolled, and every comparator is
+     * a min and a max, so there are no branches.
+     */
+    template<size_t Size, class T>
+    inline void runNetwork(T *elems) noexcept
+    {
+#pragma GCC unroll 256
+        for (size_t c = 0; c < Network<Size>::amount; ++c)
+        {
+            Comparator const comparator = Network<Size>::comparators[c];
+            T a = elems[comparator.lo], b = elems[comparator.hi];
+            elems[comparator.lo] = b < a ? b : a;
+            elems[comparator.hi] = b < a ? a : b;
+        }
+    }
+
+    /**
+     * @return The size of the network which sorts n elements: the next power of two, at least 2.
+     */
+    constexpr size_t networkSize(size_t n)
+    {
+        size_t size = 2;
+        while (size < n)
+        {
+            size <<= 1;
+        }
+        return size;
+    }
+
+    /**
+     * @brief Runs the network of the given size, searching up from Size. Networks larger than the one of Max elements
+     * are never instantiated.
+     */
+    template<size_t Size, size_t Max, class T>
+    inline void runNetwork(T *padded, size_t size) noexcept
+    {
+        if constexpr (Size < networkSize(Max))
+        {
+            if (size > Size)
+            {
+                runNetwork<Size * 2, Max>(padded, size);
+                return;
+            }
+        }
+        runNetwork<Size>(padded);
+    }
+
+    /**
+     * @brief Sorts n elements, 2 <= n <= Max, by padding them up to the size of their network with the largest T.
+     */
+    template<size_t Max, class T>
+    inline void networkSort(T *elems, size_t n) noexcept
+    {
+        T padded[networkSize(Max)] = {};
+        size_t size = networkSize(n);
+        std::copy(elems, elems + n, padded);
+        std::fill(padded + n, padded + size, std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity()
+                                                                                  : std::numeric_limits<T>::max());
+        runNetwork<2, Max>(padded, size);
+        std::copy(padded, padded + n, elems);
+    }
+
+    /**
+     * The unsigned radix key of an arithmetic type: the order of the keys is the order of the values.
+     */
+    template<class T>
+    struct RadixKey
+    {
+        typedef std::conditional_t<sizeof(T) == 1, uint8_t, std::conditional_t<sizeof(T) == 2, uint16_t,
+                std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>>> type;
+
+        static constexpr type signBit = (type) ((type) 1 << (sizeof(T) * 8 - 1));
+
+        /**
+         * @return The key of value. Signed integers get their sign bit flipped, negative floats all of their bits and
+         * positive ones their sign bit. Both zeros get the key of +0, so they stay equivalent, as they compare.
+         */
+        static type of(T value) noexcept
+        {
+            type bits;
+            std::memcpy(&bits, &value, sizeof(T));
+            if constexpr (std::is_floating_point<T>::value)
+            {
+                bits = value == 0 ? signBit : (bits & signBit ? (type) ~bits : (type) (bits | signBit));
+            }
+            else if constexpr (std::is_signed<T>::value)
+            {
+                bits ^= signBit;
+            }
+            return bits;
+        }
+    };
+
+    /**
+     * @brief Stable LSD radix sort of n elements, using scratch (room for n elements) as the second buffer.
+     * Digits in which all of the keys agree are skipped.
+     */
+    template<class T>
+    void radixSort(T *elems, size_t n, T *scratch)
+    {
+        typedef RadixKey<T> Key;
+        constexpr size_t digits = sizeof(T) * 8 / RADIX_BITS;
+        size_t counts[digits][RADIX_BUCKETS] = {};
+        for (size_t i = 0; i < n; ++i)
+        {
+            typename Key::type key = Key::of(elems[i]);
+            for (size_t digit = 0; digit < digits; ++digit)
+            {
+                ++counts[digit][(key >> (digit * RADIX_BITS)) & (RADIX_BUCKETS - 1)];
+            }
+        }
+        T *src = elems, *dst = scratch;
+        for (size_t digit = 0; digit < digits; ++digit)
+        {
+            size_t *count = counts[digit];
+            if (count[(Key::of(elems[0]) >> (digit * RADIX_BITS)) & (RADIX_BUCKETS - 1)] == n)
+            {
+                continue;
+            }
+            size_t offset = 0;
+            for (size_t bucket = 0; bucket < RADIX_BUCKETS; ++bucket)
+            {
+                size_t amount = count[bucket];
+                count[bucket] = offset;
+                offset += amount;
+            }
+            for (size_t i = 0; i < n; ++i)
+            {
+                dst[count[(Key::of(src[i]) >> (digit * RADIX_BITS)) & (RADIX_BUCKETS - 1)]++] = src[i];
+            }
+            std::swap(src, dst);
+        }
+        if (src != elems)
+        {
+            std::copy(src, src + n, elems);
+        }
+    }
+
+    /**
+     * @brief Radix sorts the elements of vec, in its spare capacity if there is room for all of the elements there.
+     */
+    template<class T>
+    void radixSort(VLVectorBase<T> &vec)
+    {
+        size_t n = vec.size();
+        if (vec.capacity() - n >= n)
+        {
+            radixSort(vec.data(), n, vec.data() + n);
+            return;
+        }
+        std::unique_ptr<T[]> scratch(new T[n]);
+        radixSort(vec.data(), n, scratch.get());
+    }
+
+    /**
+     * @brief Stable insertion sort, for the small vectors stable_sort can not send to a network.
+     */
+    template<class T>
+    void insertionSort(T *elems, size_t n) noexcept
+    {
+        for (size_t i = 1; i < n; ++i)
+        {
+            T value = elems[i];
+            size_t j = i;
+            for (; j > 0 && value < elems[j - 1]; --j)
+            {
+                elems[j] = elems[j - 1];
+            }
+            elems[j] = value;
+        }
+    }
+
+    /**
+     * @return true if vec is sorted by a network: arithmetic, small static storage and in it.
+     */
+    template<class T, size_t StaticCapacity>
+    constexpr bool usesNetwork(size_t size)
+    {
+        return vlvsimd::IsSimdElement<T>::value && StaticCapacity <= NETWORK_MAX_SIZE && size <= StaticCapacity;
+    }
+}
+
+/**
+ * @brief Sorts the elements of vec in ascending order.
+ */
+template<class T, size_t StaticCapacity>
+void sort(VLVector<T, StaticCapacity> &vec)
+{
+    size_t n = vec.size();
+    if (n < 2)
+    {
+        return;
+    }
+    if constexpr (vlvsimd::IsSimdElement<T>::value)
+    {
+        if (vlvsort::usesNetwork<T, StaticCapacity>(n))
+        {
+            vlvsort::networkSort<StaticCapacity>(vec.data(), n);
+            return;
+        }
+        if (n >= RADIX_MIN_SIZE)
+        {
+            vlvsort::radixSort(vec);
+            return;
+        }
+    }
+    std::sort(vec.data(), vec.data() + n);
+}
+
+/**
+ * @brief Sorts the elements of vec by comp. Custom comparators always go to std::sort.
+ */
+template<class T, class Compare>
+void sort(VLVectorBase<T> &vec, Compare comp)
+{
+    std::sort(vec.data(), vec.data() + vec.size(), comp);
+}
+
+/**
+ * @brief Sorts the elements of vec in ascending order, keeping the order of equivalent elements.
+ */
+template<class T, size_t StaticCapacity>
+void stable_sort(VLVector<T, StaticCapacity> &vec)
+{
+    size_t n = vec.size();
+    if (n < 2)
+    {
+        return;
+    }
+    if constexpr (vlvsimd::IsSimdElement<T>::value)
+    {
+        if (std::is_integral<T>::value && vlvsort::usesNetwork<T, StaticCapacity>(n))
+        {
+            vlvsort::networkSort<StaticCapacity>(vec.data(), n);
+            return;
+        }
+        if (n <= INSERTION_SORT_MAX_SIZE)
+        {
+            vlvsort::insertionSort(vec.data(), n);
+            return;
+        }
+        if (n >= RADIX_MIN_SIZE)
+        {
+            vlvsort::radixSort(vec);
+            return;
+        }
+    }
+    std::stable_sort(vec.data(), vec.data() + n);
+}
+
+/**
+ * @brief Sorts the elements of vec by comp, keeping the order of equivalent elements.
+ */
+template<class T, class Compare>
+void stable_sort(VLVectorBase<T> &vec, Compare comp)
+{
+    std::stable_sort(vec.data(), vec.data() + vec.size(), comp);
+}
+
+
+#endif //CPP_EXAM_VLVECTORSORT_HPP
@@ -0,0 +1,217 @@
+/**
+ * @file VLVectorTrace.hpp
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ *
+ * @brief Operation trace recording for VLVector.
+ *
+ * @section DESCRIPTION When VLVECTOR_TRACE is defined (in every translation unit of the program), every VLVector
+ * records its mutating calls to a compact binary trace: creation, copy, move, assignment, push_back, insert, erase,
+ * pop_back, clear and destruction, with the positions and amounts involved but not the element values. The trace is
+ * written to the file given to VLVectorTrace::open, or to the file named by the VLVECTOR_TRACE_FILE environment
+ * variable. benchmark/TraceReplay.cpp re-executes such traces.
+ *
+ * Format: the 5 bytes "VLVT" TRACE_VERSION, then one record per call - an op byte followed by LEB128 varints: the id
+ * of the vector and the arguments of the op (see VLVTraceOp). Version 2 and older traces record moves as copies and
+ * assignments followed by a clear of the moved-from vector. Version 1 traces lack the element size and the static
+ * capacity of copies.
+ *
+ * Recording never throws: a record which can not be written (the lock or the sink failing) is dropped, so the
+ * noexcept members of VLVector may record too.
+ */
+#ifndef CPP_EXAM_VLVECTORTRACE_HPP
+#define CPP_EXAM_VLVECTORTRACE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+
+#define TRACE_MAGIC "VLVT"
+
+#define TRACE_MAGIC_LEN 4
+
+#define TRACE_VERSION 3
+
+#define TRACE_ENV_VAR "VLVECTOR_TRACE_FILE"
+
+#define TRACE_BUFFER_SIZE (1 << 20)
+
+#define VARINT_MAX_LEN 10
+
+#define TRACE_RECORD_MAX_LEN (1 + 4 * VARINT_MAX_LEN)
+
+/**
+ * The recorded operations, and the varint arguments following the vector id of each.
+ */
+enum VLVTraceOp : unsigned char
+{
+    TRACE_CREATE, // element size, static capacity.
+    TRACE_COPY, // id of the copied vector, element size, static capacity (of the new vector, which a copy of a
+                // VLVectorBase reference need not share with the copied one).
+    TRACE_ASSIGN, // id of the assigned-from vector.
+    TRACE_DESTROY,
+    TRACE_PUSH_BACK,
+    TRACE_POP_BACK,
+    TRACE_INSERT, // position, amount of inserted elements.
+    TRACE_ERASE, // position, amount of erased elements.
+    TRACE_CLEAR,
+    TRACE_MOVE, // id of the moved-from vector, element size, static capacity, as TRACE_COPY.
+    TRACE_MOVE_ASSIGN, // id of the moved-from vector.
+    TRACE_OPS_AMOUNT
+};
+
+/**
+ * The process wide trace sink. All of the members are thread safe.
+ */
+class VLVectorTrace
+{
+private:
+    FILE *_out = nullptr;
+    bool _triedEnv = false;
+    std::mutex _lock;
+
+    /**
+     * @return The single sink of the process. Never destroyed, so vectors with static storage duration can still
+     * record after main returns; the file itself is flushed and closed at exit.
+     */
+    static VLVectorTrace &_instance()
+    {
+        static VLVectorTrace *instance = []()
+        {
+            std::atexit(close);
+            return new VLVectorTrace;
+        }();
+        return *instance;
+    }
+
+    /**
+     * @brief Encodes value as an LEB128 varint at out.
+     * @return The amount of bytes written.
+     */
+    static size_t _putVarint(unsigned char *out, uint64_t value) noexcept
+    {
+        size_t len = 0;
+        while (value >= 0x80)
+        {
+            out[len++] = (unsigned char) (value | 0x80);
+            value >>= 7;
+        }
+        out[len++] = (unsigned char) value;
+        return len;
+    }
+
+    /**
+     * @brief Opens path and writes the header. Expects the lock to be held.
+     */
+    bool _open(const char *path)
+    {
+        _close();
+        _out = std::fopen(path, "wb");
+        if (!_out)
+        {
+            return false;
+        }
+        std::setvbuf(_out, nullptr, _IOFBF, TRACE_BUFFER_SIZE);
+        std::fwrite(TRACE_MAGIC, 1, TRACE_MAGIC_LEN, _out);
+        std::fputc(TRACE_VERSION, _out);
+        return true;
+    }
+
+    /**
+     * @brief Flushes and closes the trace file, if open. Expects the lock to be held.
+     */
+    void _close()
+    {
+        if (_out)
+        {
+            std::fclose(_out);
+            _out = nullptr;
+        }
+    }
+
+public:
+    /**
+     * @brief Starts recording to path, replacing the current trace file if any.
+     * @return false if the file could not be opened.
+     */
+    static bool open(const char *path)
+    {
+        VLVectorTrace &trace = _instance();
+        std::lock_guard<std::mutex> guard(trace._lock);
+        trace._triedEnv = true;
+        return trace._open(path);
+    }
+
+    /**
+     * @brief Stops recording and flushes the trace file.
+     */
+    static void close()
+    {
+        VLVectorTrace &trace = _instance();
+        std::lock_guard<std::mutex> guard(trace._lock);
+        trace._close();
+    }
+
+    /**
+     * @return A new, process unique, vector id. Ids start from 1.
+     */
+    static uint64_t newId()
+    {
+        static std::atomic<uint64_t> lastId(0);
+        return ++lastId;
+    }
+
+    /**
+     * @brief Records a single operation. Does nothing if no trace file is open, and drops the record if the sink
+     * fails rather than throwing.
+     */
+    static void record(VLVTraceOp op, uint64_t id, uint64_t first = 0, uint64_t second = 0,
+                       uint64_t third = 0) noexcept
+    {
+        unsigned char buffer[TRACE_RECORD_MAX_LEN];
+        size_t len = 0;
+        buffer[len++] = op;
+        len += _putVarint(buffer + len, id);
+        if (op == TRACE_CREATE || op == TRACE_INSERT || op == TRACE_ERASE)
+        {
+            len += _putVarint(buffer + len, first);
+            len += _putVarint(buffer + len, second);
+        }
+        else if (op == TRACE_COPY || op == TRACE_MOVE)
+        {
+            len += _putVarint(buffer + len, first);
+            len += _putVarint(buffer + len, second);
+            len += _putVarint(buffer + len, third);
+        }
+        else if (op == TRACE_ASSIGN || op == TRACE_MOVE_ASSIGN)
+        {
+            len += _putVarint(buffer + len, first);
+        }
+        try
+        {
+            VLVectorTrace &trace = _instance();
+            std::lock_guard<std::mutex> guard(trace._lock);
+            if (!trace._triedEnv)
+            {
+                trace._triedEnv = true;
+                const char *path = std::getenv(TRACE_ENV_VAR);
+                if (path)
+                {
+                    trace._open(path);
+                }
+            }
+            if (trace._out)
+            {
+                std::fwrite(buffer, 1, len, trace._out);
+            }
+        }
+        catch (...)
+        {
+        }
+    }
+};
+
+
+#endif //CPP_EXAM_VLVECTORTRACE_HPP
@@ -0,0 +1,537 @@
+/**
+ * @file VLVectorView.hpp
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ *
+ * @brief Non-owning views of the elements of VLVectors.
+ *
+ * @section DESCRIPTION VLSpan, VLStridedView and VLChunks refer to the current storage of a VLVector without copying
+ * it, and are trivially copyable, so they are passed by value. A VLSpan converts implicitly from a VLVector of any
+ * StaticCapacity (through its VLVectorBase), so a function which takes a VLSpan<const T> accepts every VLVector of T
+ * without being a template, and under C++20 it converts to std::span too. Views are invalidated by anything which may
+ * reallocate the vector or move it between its static and dynamic storage, like iterators are.
+ */
+#ifndef CPP_EXAM_VLVECTORVIEW_HPP
+#define CPP_EXAM_VLVECTORVIEW_HPP
+
+#include "VLVector.hpp"
+
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+
+#if __has_include(<version>)
+
+#include <version>
+
+#endif
+
+#if defined(__cpp_lib_span)
+
+#include <span>
+
+#define VLV_STD_SPAN
+
+#endif
+
+#define SLICE_RANGE_MSG "VLVector slice: the slice ends after the elements"
+
+#define ZERO_STRIDE_MSG "VLVector strided view: the stride must be positive"
+
+#define ZERO_CHUNKS_MSG "VLVector chunks: there must be at least one chunk"
+
+/**
+ * A view of size() contiguous elements of type T, T being const for a read only view.
+ * @tparam T The type of the elements.
+ */
+template<class T>
+class VLSpan
+{
+private:
+    T *_elems = nullptr;
+    size_t _size = STARTING_SIZE;
+
+public:
+    typedef std::remove_cv_t<T> value_type;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    typedef T &reference;
+    typedef T *pointer;
+    typedef T *iterator;
+
+    VLSpan() noexcept = default;
+
+    /**
+     * @brief A view of the size elements from elems on.
+     */
+    VLSpan(T *elems, size_t size) noexcept : _elems(elems), _size(size)
+    {
+    }
+
+    /**
+     * @brief A view of all of the elements of vec.
+     */
+    VLSpan(VLVectorBase<value_type> &vec) noexcept : _elems(vec.data()), _size(vec.size())
+    {
+    }
+
+    /**
+     * @brief A read only view of all of the elements of vec.
+     */
+    template<class U = T, class = std::enable_if_t<std::is_const<U>::value>>
+    VLSpan(VLVectorBase<value_type> const &vec) noexcept : _elems(vec.data()), _size(vec.size())
+    {
+    }
+
+    /**
+     * @brief A read only view of the same elements as a mutable view.
+     */
+    template<class U, class = std::enable_if_t<std::is_same<U const, T>::value && !std::is_const<U>::value>>
+    VLSpan(VLSpan<U> const &other) noexcept : _elems(other.data()), _size(other.size())
+    {
+    }
+
+#ifdef VLV_STD_SPAN
+
+    /**
+     * @return A std::span of the same elements.
+     */
+    operator std::span<T>() const noexcept
+    {
+        return std::span<T>(_elems, _size);
+    }
+
+#endif
+
+    T *data() const noexcept
+    {
+        return _elems;
+    }
+
+    size_t size() const noexcept
+    {
+        return _size;
+    }
+
+    bool empty() const noexcept
+    {
+        return !_size;
+    }
+
+    T &operator[](size_t idx) const noexcept
+    {
+        return _elems[idx];
+    }
+
+    T &front() const noexcept
+    {
+        return _elems[FIRST_IDX];
+    }
+
+    T &back() const noexcept
+    {
+        return _elems[_size - NEXT_ELEM];
+    }
+
+    iterator begin() const noexcept
+    {
+        return _elems;
+    }
+
+    iterator end() const noexcept
+    {
+        return _elems + _size;
+    }
+
+    /**
+     * @return A view of the len elements from begin on. @throws std::out_of_range if they end after the elements.
+     */
+    VLSpan slice(size_t begin, size_t len) const
+    {
+        if (begin > _size || len > _size - begin)
+        {
+            throw std::out_of_range(SLICE_RANGE_MSG);
+        }
+        return VLSpan(_elems + begin, len);
+    }
+};
+
+/**
+ * A view of every stride-th element of contiguous elements.
+ * @tparam T The type of the elements, const for a read only view.
+ */
+template<class T>
+class VLStridedView
+{
+private:
+    T *_elems = nullptr;
+    size_t _size = STARTING_SIZE;
+    size_t _stride = NEXT_ELEM;
+
+public:
+    /**
+     * A random access iterator which steps stride elements at a time. It keeps the index of its element instead of a
+     * pointer, so the past the end iterator does not point past the underlying elements.
+     */
+    class Iterator
+    {
+    private:
+        T *_elems = nullptr;
+        size_t _stride = NEXT_ELEM;
+        ptrdiff_t _idx = FIRST_IDX;
+
+    public:
+        typedef std::remove_cv_t<T> value_type;
+        typedef ptrdiff_t difference_type;
+        typedef std::random_access_iterator_tag iterator_category;
+        typedef T &reference;
+        typedef T *pointer;
+
+        Iterator() noexcept = default;
+
+        Iterator(T *elems, size_t stride, size_t idx) noexcept : _elems(elems), _stride(stride), _idx((ptrdiff_t) idx)
+        {
+        }
+
+        T &operator*() const noexcept
+        {
+            return _elems[(size_t) _idx * _stride];
+        }
+
+        T *operator->() const noexcept
+        {
+            return &**this;
+        }
+
+        T &operator[](ptrdiff_t steps) const noexcept
+        {
+            return _elems[(size_t) (_idx + steps) * _stride];
+        }
+
+        Iterator &operator++() noexcept
+        {
+            ++_idx;
+            return *this;
+        }
+
+        Iterator operator++(int) noexcept
+        {
+            Iterator temp = *this;
+            ++_idx;
+            return temp;
+        }
+
+        Iterator &operator--() noexcept
+        {
+            --_idx;
+            return *this;
+        }
+
+        Iterator operator--(int) noexcept
+        {
+            Iterator temp = *this;
+            --_idx;
+            return temp;
+        }
+
+        Iterator &operator+=(ptrdiff_t steps) noexcept
+        {
+            _idx += steps;
+            return *this;
+        }
+
+        Iterator &operator-=(ptrdiff_t steps) noexcept
+        {
+            _idx -= steps;
+            return *this;
+        }
+
+        friend Iterator operator+(Iterator it, ptrdiff_t steps) noexcept
+        {
+            return it += steps;
+        }
+
+        friend Iterator operator+(ptrdiff_t steps, Iterator it) noexcept
+        {
+            return it += steps;
+        }
+
+        friend Iterator operator-(Iterator it, ptrdiff_t steps) noexcept
+        {
+            return it -= steps;
+        }
+
+        friend ptrdiff_t operator-(Iterator const &lhs, Iterator const &rhs) noexcept
+        {
+            return lhs._idx - rhs._idx;
+        }
+
+        friend bool operator==(Iterator const &lhs, Iterator const &rhs) noexcept
+        {
+            return lhs._idx == rhs._idx;
+        }
+
+        friend bool operator!=(Iterator const &lhs, Iterator const &rhs) noexcept
+        {
+            return lhs._idx != rhs._idx;
+        }
+
+        friend bool operator<(Iterator const &lhs, Iterator const &rhs) noexcept
+        {
+            return lhs._idx < rhs._idx;
+        }
+
+        friend bool operator>(Iterator const &lhs, Iterator const &rhs) noexcept
+        {
+            return lhs._idx > rhs._idx;
+        }
+
+        friend bool operator<=(Iterator const &lhs, Iterator const &rhs) noexcept
+        {
+            return lhs._idx <= rhs._idx;
+        }
+
+        friend bool operator>=(Iterator const &lhs, Iterator const &rhs) noexcept
+        {
+            return lhs._idx >= rhs._idx;
+        }
+    };
+
+    typedef Iterator iterator;
+
+    VLStridedView() noexcept = default;
+
+    /**
+     * @brief A view of the elements start, start + stride and so on of the span.
+     * @throws std::invalid_argument if stride is zero.
+     */
+    VLStridedView(VLSpan<T> span, size_t start, size_t stride) : _stride(stride)
+    {
+        if (!stride)
+        {
+            throw std::invalid_argument(ZERO_STRIDE_MSG);
+        }
+        _size = start < span.size() ? (span.size() - start + stride - NEXT_ELEM) / stride : STARTING_SIZE;
+        _elems = span.data() + (_size ? start : FIRST_IDX);
+    }
+
+    size_t size() const noexcept
+    {
+        return _size;
+    }
+
+    size_t stride() const noexcept
+    {
+        return _stride;
+    }
+
+    bool empty() const noexcept
+    {
+        return !_size;
+    }
+
+    T &operator[](size_t idx) const noexcept
+    {
+        return _elems[idx * _stride];
+    }
+
+    iterator begin() const noexcept
+    {
+        return iterator(_elems, _stride, FIRST_IDX);
+    }
+
+    iterator end() const noexcept
+    {
+        return iterator(_elems, _stride, _size);
+    }
+};
+
+/**
+ * A view of n contiguous elements as k consecutive chunks whose sizes differ by at most one: the first n % k chunks
+ * hold n / k + 1 elements and the rest n / k. There are always k chunks, some of them empty if there are fewer than k
+ * elements, so chunk i can be given to worker i.
+ * @tparam T The type of the elements, const for a read only view.
+ */
+template<class T>
+class VLChunks
+{
+private:
+    T *_elems = nullptr;
+    size_t _size = STARTING_SIZE;
+    size_t _chunks = NEXT_ELEM;
+
+    size_t _boundary(size_t chunk) const noexcept
+    {
+        size_t larger = _size % _chunks;
+        return chunk * (_size / _chunks) + (chunk < larger ? chunk : larger);
+    }
+
+public:
+    /**
+     * An iterator over the chunks, which are produced as VLSpans by value.
+     */
+    class Iterator
+    {
+    private:
+        VLChunks const *_owner = nullptr;
+        size_t _chunk = FIRST_IDX;
+
+    public:
+        typedef VLSpan<T> value_type;
+        typedef ptrdiff_t difference_type;
+        typedef std::input_iterator_tag iterator_category;
+        typedef VLSpan<T> reference;
+        typedef void pointer;
+
+        Iterator() noexcept = default;
+
+        Iterator(VLChunks const *owner, size_t chunk) noexcept : _owner(owner), _chunk(chunk)
+        {
+        }
+
+        VLSpan<T> operator*() const noexcept
+        {
+            return (*_owner)[_chunk];
+        }
+
+        Iterator &operator++() noexcept
+        {
+            ++_chunk;
+            return *this;
+        }
+
+        Iterator operator++(int) noexcept
+        {
+            Iterator temp = *this;
+            ++_chunk;
+            return temp;
+        }
+
+        friend bool operator==(Iterator const &lhs, Iterator const &rhs) noexcept
+        {
+            return lhs._chunk == rhs._chunk;
+        }
+
+        friend bool operator!=(Iterator const &lhs, Iterator const &rhs) noexcept
+        {
+            return lhs._chunk != rhs._chunk;
+        }
+    };
+
+    typedef Iterator iterator;
+
+    VLChunks() noexcept = default;
+
+    /**
+     * @brief The span split into chunks chunks. @throws std::invalid_argument if chunks is zero.
+     */
+    VLChunks(VLSpan<T> span, size_t chunks) : _elems(span.data()), _size(span.size()), _chunks(chunks)
+    {
+        if (!chunks)
+        {
+            throw std::invalid_argument(ZERO_CHUNKS_MSG);
+        }
+    }
+
+    /**
+     * @return The amount of chunks.
+     */
+    size_t size() const noexcept
+    {
+        return _chunks;
+    }
+
+    /**
+     * @return The elements of the chunk.
+     */
+    VLSpan<T> operator[](size_t chunk) const noexcept
+    {
+        size_t begin = _boundary(chunk);
+        return VLSpan<T>(_elems + begin, _boundary(chunk + NEXT_ELEM) - begin);
+    }
+
+    iterator begin() const noexcept
+    {
+        return iterator(this, FIRST_IDX);
+    }
+
+    iterator end() const noexcept
+    {
+        return iterator(this, _chunks);
+    }
+};
+
+/**
+ * @return A view of all of the elements of vec.
+ */
+template<class T>
+VLSpan<T> as_span(VLVectorBase<T> &vec) noexcept
+{
+    return VLSpan<T>(vec);
+}
+
+/**
+ * @return A read only view of all of the elements of vec.
+ */
+template<class T>
+VLSpan<const T> as_span(VLVectorBase<T> const &vec) noexcept
+{
+    return VLSpan<const T>(vec);
+}
+
+/**
+ * @return A view of the len elements of vec from begin on. @throws std::out_of_range if they end after the elements.
+ */
+template<class T>
+VLSpan<T> slice(VLVectorBase<T> &vec, size_t begin, size_t len)
+{
+    return as_span(vec).slice(begin, len);
+}
+
+/**
+ * @return A read only view of the len elements of vec from begin on. See slice.
+ */
+template<class T>
+VLSpan<const T> slice(VLVectorBase<T> const &vec, size_t begin, size_t len)
+{
+    return as_span(vec).slice(begin, len);
+}
+
+/**
+ * @return A view of the elements start, start + stride and so on of vec. @throws std::invalid_argument if stride is 0.
+ */
+template<class T>
+VLStridedView<T> strided(VLVectorBase<T> &vec, size_t start, size_t stride)
+{
+    return VLStridedView<T>(as_span(vec), start, stride);
+}
+
+/**
+ * @return A read only view of every stride-th element of vec from start on. See strided.
+ */
+template<class T>
+VLStridedView<const T> strided(VLVectorBase<T> const &vec, size_t start, size_t stride)
+{
+    return VLStridedView<const T>(as_span(vec), start, stride);
+}
+
+/**
+ * @return vec split into k chunks of near equal sizes, for splitting work. @throws std::invalid_argument if k is 0.
+ */
+template<class T>
+VLChunks<T> chunks(VLVectorBase<T> &vec, size_t k)
+{
+    return VLChunks<T>(as_span(vec), k);
+}
+
+/**
+ * @return vec split into k read only chunks of near equal sizes. See chunks.
+ */
+template<class T>
+VLChunks<const T> chunks(VLVectorBase<T> const &vec, size_t k)
+{
+    return VLChunks<const T>(as_span(vec), k);
+}
+
+
+#endif //CPP_EXAM_VLVECTORVIEW_HPP
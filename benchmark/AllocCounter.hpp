@@ -0,0 +1,181 @@
+/**
+ * @file AllocCounter.hpp
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ *
+ * @brief Allocation counting for the VLVector benchmarks.
+ *
+ * @section DESCRIPTION Counts the calls to (and the bytes requested from) the global operator new, the over-aligned
+ * overloads included, from any thread. The replacement operators must be defined exactly once per program, so exactly
+ * one translation unit of every benchmark executable has to define ALLOC_COUNTER_IMPLEMENTATION before including this
+ * header.
+ */
+#ifndef CPP_EXAM_ALLOCCOUNTER_HPP
+#define CPP_EXAM_ALLOCCOUNTER_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * A snapshot of the global allocation counters.
+ */
+struct AllocSample
+{
+    uint64_t allocations = 0;
+    uint64_t bytes = 0;
+};
+
+/**
+ * @return The allocations done by the program so far.
+ */
+AllocSample allocSnapshot() noexcept;
+
+/**
+ * @return The allocations done between two snapshots.
+ */
+inline AllocSample operator-(AllocSample const &lhs, AllocSample const &rhs) noexcept
+{
+    AllocSample diff;
+    diff.allocations = lhs.allocations - rhs.allocations;
+    diff.bytes = lhs.bytes - rhs.bytes;
+    return diff;
+}
+
+#ifdef ALLOC_COUNTER_IMPLEMENTATION
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<uint64_t> gAllocations(0);
+static std::atomic<uint64_t> gAllocatedBytes(0);
+
+AllocSample allocSnapshot() noexcept
+{
+    AllocSample sample;
+    sample.allocations = gAllocations.load(std::memory_order_relaxed);
+    sample.bytes = gAllocatedBytes.load(std::memory_order_relaxed);
+    return sample;
+}
+
+/**
+ * @brief The counting allocation routine behind all of the replaced operator new overloads. Counts from any thread.
+ * @param align The alignment, or 0 for the default one of malloc.
+ */
+static void *countedAlloc(std::size_t bytes, std::size_t align = 0) noexcept
+{
+    gAllocations.fetch_add(1, std::memory_order_relaxed);
+    gAllocatedBytes.fetch_add(bytes, std::memory_order_relaxed);
+    if (!align)
+    {
+        return std::malloc(bytes ? bytes : 1);
+    }
+    return std::aligned_alloc(align, (std::max(bytes, (std::size_t) 1) + align - 1) / align * align);
+}
+
+/**
+ * @brief The release routine behind all of the replaced operator delete overloads. Not inlined into them, so the
+ * compiler does not see free() called on what operator new returned.
+ */
+__attribute__((noinline)) static void countedFree(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+/**
+ * @brief The throwing allocation of the replaced operator new overloads.
+ */
+static void *checkedAlloc(std::size_t bytes, std::size_t align = 0)
+{
+    void *ptr = countedAlloc(bytes, align);
+    if (!ptr)
+    {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void *operator new(std::size_t bytes)
+{
+    return checkedAlloc(bytes);
+}
+
+void *operator new[](std::size_t bytes)
+{
+    return checkedAlloc(bytes);
+}
+
+void *operator new(std::size_t bytes, std::nothrow_t const &) noexcept
+{
+    return countedAlloc(bytes);
+}
+
+void *operator new[](std::size_t bytes, std::nothrow_t const &) noexcept
+{
+    return countedAlloc(bytes);
+}
+
+void *operator new(std::size_t bytes, std::align_val_t align)
+{
+    return checkedAlloc(bytes, (std::size_t) align);
+}
+
+void *operator new[](std::size_t bytes, std::align_val_t align)
+{
+    return checkedAlloc(bytes, (std::size_t) align);
+}
+
+void *operator new(std::size_t bytes, std::align_val_t align, std::nothrow_t const &) noexcept
+{
+    return countedAlloc(bytes, (std::size_t) align);
+}
+
+void *operator new[](std::size_t bytes, std::align_val_t align, std::nothrow_t const &) noexcept
+{
+    return countedAlloc(bytes, (std::size_t) align);
+}
+
+void operator delete(void *ptr) noexcept
+{
+    countedFree(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+    countedFree(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+    countedFree(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t) noexcept
+{
+    countedFree(ptr);
+}
+
+void operator delete(void *ptr, std::align_val_t) noexcept
+{
+    countedFree(ptr);
+}
+
+void operator delete[](void *ptr, std::align_val_t) noexcept
+{
+    countedFree(ptr);
+}
+
+void operator delete(void *ptr, std::size_t, std::align_val_t) noexcept
+{
+    countedFree(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t, std::align_val_t) noexcept
+{
+    countedFree(ptr);
+}
+
+#endif //ALLOC_COUNTER_IMPLEMENTATION
+
+#endif //CPP_EXAM_ALLOCCOUNTER_HPP
@@ -0,0 +1,196 @@
+/**
+ * @file PerfCounters.hpp
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ *
+ * @brief Hardware performance counters for the VLVector benchmarks.
+ *
+ * @section DESCRIPTION Opens a set of perf_event_open counters (cycles, instructions, L1D/LLC misses, branch misses
+ * and dTLB misses) for the calling thread. Every counter is opened on its own, so a kernel or a VM that refuses some of
+ * the events still reports the others, and one that refuses all of them leaves the benchmarks with wall time only.
+ */
+#ifndef CPP_EXAM_PERFCOUNTERS_HPP
+#define CPP_EXAM_PERFCOUNTERS_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+
+#ifdef __linux__
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#endif
+
+#define PERF_EVENTS_AMOUNT 6
+
+#define CLOSED_FD (-1)
+
+#define CACHE_EVENT(cache, op, result) ((cache) | ((op) << 8) | ((result) << 16))
+
+/**
+ * The hardware events collected by PerfCounters, in the order of PerfSample::values.
+ */
+enum PerfEvent
+{
+    CYCLES, INSTRUCTIONS, L1D_MISSES, LLC_MISSES, BRANCH_MISSES, DTLB_MISSES
+};
+
+/**
+ * @brief The column names of the events, in the order of PerfEvent.
+ */
+inline const char *perfEventName(size_t event)
+{
+    static const char *const names[PERF_EVENTS_AMOUNT] = {"cycles", "instructions", "l1d-misses", "llc-misses",
+                                                          "branch-misses", "dtlb-misses"};
+    return names[event];
+}
+
+/**
+ * A single reading of all of the counters. A counter the kernel did not allow is marked as invalid.
+ */
+struct PerfSample
+{
+    uint64_t values[PERF_EVENTS_AMOUNT] = {};
+    bool valid[PERF_EVENTS_AMOUNT] = {};
+};
+
+/**
+ * A set of per-thread hardware counters which are started and stopped around a measured region.
+ */
+class PerfCounters
+{
+private:
+    int _fds[PERF_EVENTS_AMOUNT];
+
+#ifdef __linux__
+
+    /**
+     * @brief Opens a single user-space-only counter for the calling thread, disabled until start() is called.
+     * @return The counter's fd, or CLOSED_FD if the kernel refused it.
+     */
+    static int _open(uint32_t type, uint64_t config)
+    {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        long fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+        return fd < 0 ? CLOSED_FD : (int) fd;
+    }
+
+#endif
+
+public:
+    /**
+     * @brief Opens all of the counters the kernel permits. Never fails - unavailable counters are just skipped.
+     */
+    PerfCounters()
+    {
+        for (int &fd : _fds)
+        {
+            fd = CLOSED_FD;
+        }
+#ifdef __linux__
+        _fds[CYCLES] = _open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+        _fds[INSTRUCTIONS] = _open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+        _fds[L1D_MISSES] = _open(PERF_TYPE_HW_CACHE, CACHE_EVENT(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ,
+                                                                 PERF_COUNT_HW_CACHE_RESULT_MISS));
+        _fds[LLC_MISSES] = _open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+        _fds[BRANCH_MISSES] = _open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+        _fds[DTLB_MISSES] = _open(PERF_TYPE_HW_CACHE, CACHE_EVENT(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_OP_READ,
+                                                                  PERF_COUNT_HW_CACHE_RESULT_MISS));
+#endif
+    }
+
+    PerfCounters(PerfCounters const &) = delete;
+
+    PerfCounters &operator=(PerfCounters const &) = delete;
+
+    /**
+     * @brief Closes all of the opened counters.
+     */
+    ~PerfCounters()
+    {
+#ifdef __linux__
+        for (int fd : _fds)
+        {
+            if (fd != CLOSED_FD)
+            {
+                close(fd);
+            }
+        }
+#endif
+    }
+
+    /**
+     * @return true if at least one hardware counter could be opened, false if only timing is available.
+     */
+    bool available() const noexcept
+    {
+        for (int fd : _fds)
+        {
+            if (fd != CLOSED_FD)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Zeroes and enables all of the opened counters.
+     */
+    void start() noexcept
+    {
+#ifdef __linux__
+        for (int fd : _fds)
+        {
+            if (fd != CLOSED_FD)
+            {
+                ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+#endif
+    }
+
+    /**
+     * @brief Disables the counters and reads them. Values are scaled up if the kernel multiplexed a counter.
+     */
+    PerfSample stop() noexcept
+    {
+        PerfSample sample;
+#ifdef __linux__
+        for (int fd : _fds)
+        {
+            if (fd != CLOSED_FD)
+            {
+                ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            }
+        }
+        for (size_t event = 0; event < PERF_EVENTS_AMOUNT; ++event)
+        {
+            uint64_t raw[3]; // value, time enabled, time running.
+            if (_fds[event] == CLOSED_FD || read(_fds[event], raw, sizeof(raw)) != (ssize_t) sizeof(raw) || !raw[2])
+            {
+                continue;
+            }
+            sample.values[event] = raw[2] < raw[1] ? (uint64_t) ((double) raw[0] * raw[1] / raw[2]) : raw[0];
+            sample.valid[event] = true;
+        }
+#endif
+        return sample;
+    }
+};
+
+
+#endif //CPP_EXAM_PERFCOUNTERS_HPP
@@ -0,0 +1,393 @@
+/**
+ * @file RegressionGate.hpp
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ *
+ * @brief Baseline storage and statistical comparison for the VLVector benchmarks.
+ *
+ * @section DESCRIPTION Saves the repeated samples of every benchmark to a small JSON file and compares a new run
+ * against such a baseline with a one sided Mann-Whitney U test. An operation regresses only if its median slowed down
+ * beyond the threshold ratio and the slowdown is statistically significant, so single noisy runs do not fail the gate.
+ * The samples of a single process are not independent though: they share its code layout, clock frequency and cache
+ * state, so a whole run can be off by more than the threshold while its p-value is tiny. The benchmark therefore
+ * re-measures every failed operation in separate processes, and only fails the operations that regress in all of them
+ * (see compareToBaseline and VLVectorBenchmark.cpp). An operation the baseline has no samples of fails too, unless new operations are explicitly allowed: a benchmark
+ * is added together with its samples in the baseline.
+ */
+#ifndef CPP_EXAM_REGRESSIONGATE_HPP
+#define CPP_EXAM_REGRESSIONGATE_HPP
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#define DEFAULT_THRESHOLD 1.10
+
+#define DEFAULT_ALPHA 0.01
+
+#define PARSE_ERROR_MSG "RegressionGate: malformed baseline file"
+
+/**
+ * The repeated samples of a single benchmark.
+ */
+struct BenchmarkSamples
+{
+    std::vector<double> nanosPerOp;
+    double allocsPerOp = 0;
+};
+
+typedef std::map<std::string, BenchmarkSamples> BenchmarkSet;
+
+/**
+ * @return The median of the samples. Copies since the samples are kept in run order.
+ */
+inline double median(std::vector<double> samples)
+{
+    if (samples.empty())
+    {
+        return 0;
+    }
+    std::sort(samples.begin(), samples.end());
+    size_t mid = samples.size() / 2;
+    return samples.size() % 2 ? samples[mid] : (samples[mid - 1] + samples[mid]) / 2;
+}
+
+/**
+ * @brief One sided Mann-Whitney U test, with tie correction and the normal approximation.
+ * @return The p-value of the hypothesis that values from current tend to be larger than values from baseline.
+ */
+inline double mannWhitneyGreater(std::vector<double> const &current, std::vector<double> const &baseline)
+{
+    size_t n1 = current.size(), n2 = baseline.size();
+    if (!n1 || !n2)
+    {
+        return 1;
+    }
+    std::vector<std::pair<double, bool>> all; // value, belongs to current.
+    for (double value : current)
+    {
+        all.emplace_back(value, true);
+    }
+    for (double value : baseline)
+    {
+        all.emplace_back(value, false);
+    }
+    std::sort(all.begin(), all.end());
+    double rankSum = 0, tieTerm = 0;
+    for (size_t first = 0; first < all.size();)
+    {
+        size_t last = first;
+        while (last < all.size() && all[last].first == all[first].first)
+        {
+            ++last;
+        }
+        double ties = (double) (last - first), rank = (double) (first + last + 1) / 2; // average 1-based rank.
+        for (size_t i = first; i < last; ++i)
+        {
+            rankSum += all[i].second ? rank : 0;
+        }
+        tieTerm += ties * ties * ties - ties;
+        first = last;
+    }
+    double n = (double) (n1 + n2);
+    double u = rankSum - (double) n1 * (double) (n1 + 1) / 2;
+    double mean = (double) n1 * (double) n2 / 2;
+    double variance = (double) n1 * (double) n2 / 12 * ((n + 1) - tieTerm / (n * (n - 1)));
+    if (variance <= 0)
+    {
+        return u > mean ? 0 : 1;
+    }
+    double z = (u - mean - 0.5) / std::sqrt(variance); // continuity correction.
+    return 0.5 * std::erfc(z / std::sqrt(2.0));
+}
+
+/**
+ * @brief Writes a benchmark set as JSON.
+ * @return false if the file could not be written.
+ */
+inline bool writeBaseline(const char *path, BenchmarkSet const &set)
+{
+    FILE *out = std::fopen(path, "w");
+    if (!out)
+    {
+        return false;
+    }
+    std::fputs("{\n  \"benchmarks\": [\n", out);
+    size_t written = 0;
+    for (auto const &entry : set)
+    {
+        std::fprintf(out, "    {\"name\": \"%s\", \"allocs_per_op\": %.6f, \"ns_per_op\": [", entry.first.c_str(),
+                     entry.second.allocsPerOp);
+        for (size_t i = 0; i < entry.second.nanosPerOp.size(); ++i)
+        {
+            std::fprintf(out, "%s%.4f", i ? ", " : "", entry.second.nanosPerOp[i]);
+        }
+        std::fprintf(out, "]}%s\n", ++written < set.size() ? "," : "");
+    }
+    std::fputs("  ]\n}\n", out);
+    return std::fclose(out) == 0;
+}
+
+/**
+ * A minimal reader for the JSON written by writeBaseline. Unknown keys are skipped.
+ */
+class BaselineReader
+{
+private:
+    std::string _text;
+    size_t _pos = 0;
+
+    void _skipSpaces()
+    {
+        while (_pos < _text.size() && std::isspace((unsigned char) _text[_pos]))
+        {
+            ++_pos;
+        }
+    }
+
+    /**
+     * @return true and consumes c if it is the next non-space character.
+     */
+    bool _accept(char c)
+    {
+        _skipSpaces();
+        if (_pos < _text.size() && _text[_pos] == c)
+        {
+            ++_pos;
+            return true;
+        }
+        return false;
+    }
+
+    void _expect(char c)
+    {
+        if (!_accept(c))
+        {
+            throw std::runtime_error(PARSE_ERROR_MSG);
+        }
+    }
+
+    std::string _string()
+    {
+        _expect('"');
+        size_t end = _text.find('"', _pos);
+        if (end == std::string::npos)
+        {
+            throw std::runtime_error(PARSE_ERROR_MSG);
+        }
+        std::string value = _text.substr(_pos, end - _pos);
+        _pos = end + 1;
+        return value;
+    }
+
+    double _number()
+    {
+        _skipSpaces();
+        const char *begin = _text.c_str() + _pos;
+        char *end = nullptr;
+        double value = std::strtod(begin, &end);
+        if (end == begin)
+        {
+            throw std::runtime_error(PARSE_ERROR_MSG);
+        }
+        _pos += end - begin;
+        return value;
+    }
+
+    /**
+     * @brief Skips any JSON value.
+     */
+    void _skipValue()
+    {
+        _skipSpaces();
+        if (_pos >= _text.size())
+        {
+            throw std::runtime_error(PARSE_ERROR_MSG);
+        }
+        char c = _text[_pos];
+        if (c == '"')
+        {
+            _string();
+        }
+        else if (c == '[' || c == '{')
+        {
+            char close = c == '[' ? ']' : '}';
+            ++_pos;
+            if (_accept(close))
+            {
+                return;
+            }
+            do
+            {
+                if (close == '}')
+                {
+                    _string();
+                    _expect(':');
+                }
+                _skipValue();
+            } while (_accept(','));
+            _expect(close);
+        }
+        else if (std::isalpha((unsigned char) c))
+        {
+            while (_pos < _text.size() && std::isalpha((unsigned char) _text[_pos]))
+            {
+                ++_pos;
+            }
+        }
+        else
+        {
+            _number();
+        }
+    }
+
+    void _benchmark(BenchmarkSet &set)
+    {
+        std::string name;
+        BenchmarkSamples samples;
+        _expect('{');
+        do
+        {
+            std::string key = _string();
+            _expect(':');
+            if (key == "name")
+            {
+                name = _string();
+            }
+            else if (key == "allocs_per_op")
+            {
+                samples.allocsPerOp = _number();
+            }
+            else if (key == "ns_per_op")
+            {
+                _expect('[');
+                if (!_accept(']'))
+                {
+                    do
+                    {
+                        samples.nanosPerOp.push_back(_number());
+                    } while (_accept(','));
+                    _expect(']');
+                }
+            }
+            else
+            {
+                _skipValue();
+            }
+        } while (_accept(','));
+        _expect('}');
+        set[name] = samples;
+    }
+
+public:
+    /**
+     * @brief Reads a baseline file. @throws std::runtime_error if it can not be read or parsed.
+     */
+    BenchmarkSet read(const char *path)
+    {
+        FILE *in = std::fopen(path, "r");
+        if (!in)
+        {
+            throw std::runtime_error(std::string("RegressionGate: can not open ") + path);
+        }
+        char buffer[4096];
+        size_t amount;
+        _text.clear();
+        while ((amount = std::fread(buffer, 1, sizeof(buffer), in)) > 0)
+        {
+            _text.append(buffer, amount);
+        }
+        std::fclose(in);
+        _pos = 0;
+
+        BenchmarkSet set;
+        _expect('{');
+        do
+        {
+            std::string key = _string();
+            _expect(':');
+            if (key != "benchmarks")
+            {
+                _skipValue();
+                continue;
+            }
+            _expect('[');
+            if (!_accept(']'))
+            {
+                do
+                {
+                    _benchmark(set);
+                } while (_accept(','));
+                _expect(']');
+            }
+        } while (_accept(','));
+        _expect('}');
+        return set;
+    }
+};
+
+/**
+ * @brief Compares a run to a baseline and prints a table of the differences.
+ * @param threshold An operation regresses if its median time grew by more than this ratio.
+ * @param alpha The significance level of the Mann-Whitney test.
+ * @param allowNew Whether operations the baseline has no samples of pass. If not, they fail the gate, so a benchmark
+ * can not go ungated because its samples were never recorded.
+ * @param failed If not null, the names of the failed operations are appended to it.
+ * @return The amount of failed operations: regressed ones, and the new ones unless allowed. Allocation count growth is
+ * always a regression.
+ */
+inline size_t compareToBaseline(BenchmarkSet const &current, BenchmarkSet const &baseline, double threshold,
+                                double alpha, bool allowNew = false, std::vector<std::string> *failed = nullptr)
+{
+    size_t regressions = 0;
+    std::printf("\n%-20s %12s %12s %8s %10s %12s  %s\n", "operation", "base ns/op", "curr ns/op", "ratio", "p-value",
+                "allocs/op", "verdict");
+    for (auto const &entry : current)
+    {
+        auto base = baseline.find(entry.first);
+        if (base == baseline.end())
+        {
+            regressions += !allowNew;
+            if (!allowNew && failed)
+            {
+                failed->push_back(entry.first);
+            }
+            std::printf("%-20s %12s %12.2f %8s %10s %12.4f  %s\n", entry.first.c_str(), "-",
+                        median(entry.second.nanosPerOp), "-", "-", entry.second.allocsPerOp,
+                        allowNew ? "new" : "NOT IN BASELINE");
+            continue;
+        }
+        double baseMedian = median(base->second.nanosPerOp), currMedian = median(entry.second.nanosPerOp);
+        double ratio = baseMedian > 0 ? currMedian / baseMedian : 1;
+        double p = mannWhitneyGreater(entry.second.nanosPerOp, base->second.nanosPerOp);
+        bool slower = ratio > threshold && p < alpha;
+        bool allocs = entry.second.allocsPerOp > base->second.allocsPerOp * threshold + 1e-9;
+        const char *verdict = slower ? (allocs ? "REGRESSED (time, allocs)" : "REGRESSED (time)")
+                                     : (allocs ? "REGRESSED (allocs)" : "ok");
+        regressions += slower || allocs;
+        if ((slower || allocs) && failed)
+        {
+            failed->push_back(entry.first);
+        }
+        std::printf("%-20s %12.2f %12.2f %8.3f %10.4f %5.4f->%.4f  %s\n", entry.first.c_str(), baseMedian, currMedian,
+                    ratio, p, base->second.allocsPerOp, entry.second.allocsPerOp, verdict);
+    }
+    for (auto const &entry : baseline)
+    {
+        if (current.find(entry.first) == current.end())
+        {
+            std::printf("%-20s %12.2f %12s %8s %10s %12s  missing\n", entry.first.c_str(),
+                        median(entry.second.nanosPerOp), "-", "-", "-", "-");
+        }
+    }
+    return regressions;
+}
+
+
+#endif //CPP_EXAM_REGRESSIONGATE_HPP
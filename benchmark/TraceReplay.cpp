@@ -0,0 +1,116 @@
+/**
+ * @file TraceReplay.cpp
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ *
+ * @brief Replays a VLVector operation trace against several containers.
+ *
+ * @section DESCRIPTION Reads a trace recorded with VLVECTOR_TRACE (see VLVectorTrace.hpp) and re-executes it against
+ * VLVector<T, N> for several static capacities, against VLVector with the static capacity every vector was recorded
+ * with and against std::vector<T>, reporting the time and the allocations of every replay (see TraceReplay.hpp). The
+ * growth and shrink settings of VLVector are compile time macros, so every setting is a separate build:
+ *     g++ -std=c++17 -O2 -I.. -DINCREASE_FACTOR=2 -DSHRINK_TO_STATIC=false TraceReplay.cpp -o TraceReplay
+ * replay_trace.sh builds and runs the usual settings.
+ * Usage: TraceReplay TRACE_FILE [--repeat R]
+ */
+#define ALLOC_COUNTER_IMPLEMENTATION
+
+#include "AllocCounter.hpp"
+#include "TraceReplay.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#define DEFAULT_REPEAT 5
+
+#define STRINGIFY_IMPL(x) #x
+
+#define STRINGIFY(x) STRINGIFY_IMPL(x)
+
+#define USAGE_MSG "Usage: TraceReplay TRACE_FILE [--repeat R]\n"
+
+/**
+ * @brief Replays the trace repeat times, every vector as the type Layout gives it, and prints the median time.
+ */
+template<class Layout>
+void report(const char *name, Trace const &trace, size_t repeat)
+{
+    std::vector<ReplayResult> runs;
+    for (size_t run = 0; run < repeat; ++run)
+    {
+        ReplayResult total;
+        for (auto const &sub : trace.bySize)
+        {
+            ReplayResult result = replayBytes<Layout>(sub.second, sub.first);
+            total.nanos += result.nanos;
+            total.allocs.allocations += result.allocs.allocations;
+            total.allocs.bytes += result.allocs.bytes;
+        }
+        runs.push_back(total);
+    }
+    std::sort(runs.begin(), runs.end(), [](ReplayResult const &lhs, ReplayResult const &rhs)
+    { return lhs.nanos < rhs.nanos; });
+    ReplayResult const &mid = runs[runs.size() / 2];
+    double ops = (double) std::max<size_t>(1, trace.records);
+    std::printf("%-22s %12.3f %10.2f %12llu %14llu %10.4f\n", name, mid.nanos / 1e6, mid.nanos / ops,
+                (unsigned long long) mid.allocs.allocations, (unsigned long long) mid.allocs.bytes,
+                (double) mid.allocs.allocations / ops);
+}
+
+int main(int argc, char **argv)
+{
+    const char *path = nullptr;
+    size_t repeat = DEFAULT_REPEAT;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!std::strcmp(argv[i], "--repeat") && i + 1 < argc)
+        {
+            repeat = std::max<size_t>(1, std::strtoull(argv[++i], nullptr, 10));
+        }
+        else if (!path && argv[i][0] != '-')
+        {
+            path = argv[i];
+        }
+        else
+        {
+            std::fputs(USAGE_MSG, stderr);
+            return EXIT_FAILURE;
+        }
+    }
+    if (!path)
+    {
+        std::fputs(USAGE_MSG, stderr);
+        return EXIT_FAILURE;
+    }
+
+    Trace trace;
+    try
+    {
+        trace = readTrace(path);
+    }
+    catch (std::runtime_error const &e)
+    {
+        std::fprintf(stderr, "%s: %s\n", path, e.what());
+        return EXIT_FAILURE;
+    }
+    std::printf("%zu operations on %zu vector slots, growth factor %s, shrink to static %s, element sizes",
+                trace.records, trace.slots, STRINGIFY(INCREASE_FACTOR), STRINGIFY(SHRINK_TO_STATIC));
+    for (auto const &sub : trace.bySize)
+    {
+        std::printf(" %zu", sub.first);
+    }
+    std::printf("\n%-22s %12s %10s %12s %14s %10s\n", "container", "total ms", "ns/op", "allocs", "bytes", "allocs/op");
+    report<AsRecorded>("VLVector as recorded", trace, repeat);
+    report<FixedCapacity<4>>("VLVector<T, 4>", trace, repeat);
+    report<FixedCapacity<8>>("VLVector<T, 8>", trace, repeat);
+    report<FixedCapacity<16>>("VLVector<T, 16>", trace, repeat);
+    report<FixedCapacity<32>>("VLVector<T, 32>", trace, repeat);
+    report<FixedCapacity<64>>("VLVector<T, 64>", trace, repeat);
+    report<StdVector>("std::vector<T>", trace, repeat);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,564 @@
+/**
+ * @file TraceReplay.hpp
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ *
+ * @brief Decoding and replaying of VLVector operation traces.
+ *
+ * @section DESCRIPTION Reads a trace recorded with VLVECTOR_TRACE (see VLVectorTrace.hpp) and re-executes it against
+ * a chosen container layout, measuring the time and the allocations of the replay. Element values are not part of the
+ * trace, so every vector is replayed with elements of its recorded size, rounded up to a power of two of at most
+ * MAX_ELEMENT_BYTES bytes. Recorded static capacities are rounded up to a power of two of at most MAX_STATIC_CAPACITY.
+ * Moves are replayed with std::move. Counts allocations with AllocCounter.hpp, so a translation unit of the program
+ * has to define ALLOC_COUNTER_IMPLEMENTATION. TraceReplay.cpp reports the replays of a trace file.
+ */
+#ifndef CPP_EXAM_TRACEREPLAY_HPP
+#define CPP_EXAM_TRACEREPLAY_HPP
+
+#include "AllocCounter.hpp"
+#include "../VLVector.hpp"
+#include "../VLVectorTrace.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#define MAX_ELEMENT_BYTES 256
+
+#define MAX_STATIC_CAPACITY 256
+
+#define UNSIZED_COPIES_VERSION 1
+
+/**
+ * A decoded trace record. Vector ids are replaced by dense slot numbers, reused after destruction.
+ */
+struct TraceRecord
+{
+    VLVTraceOp op;
+    uint32_t slot;
+    uint32_t other; // slot of the copied / moved / assigned-from vector.
+    uint64_t pos;
+    uint64_t amount;
+    uint64_t staticCapacity; // of a created, copied or moved vector.
+};
+
+/**
+ * The records of the vectors of a single replayed element size. Vectors of different element types never copy, move
+ * or assign each other, so every element size is replayed on its own, in its own slots.
+ */
+struct SubTrace
+{
+    std::vector<TraceRecord> records;
+    size_t slots = 0;
+    uint64_t maxInsert = 0;
+};
+
+/**
+ * A decoded trace.
+ */
+struct Trace
+{
+    std::map<size_t, SubTrace> bySize; // by the replayed element size.
+    size_t records = 0;
+    size_t slots = 0;
+};
+
+/**
+ * @return The size of the elements replaying elements of bytes bytes: the next power of two, at most
+ * MAX_ELEMENT_BYTES.
+ */
+inline size_t replayedBytes(uint64_t bytes)
+{
+    size_t replayed = 1;
+    while (replayed < bytes && replayed < MAX_ELEMENT_BYTES)
+    {
+        replayed *= 2;
+    }
+    return replayed;
+}
+
+/**
+ * @brief Reads an LEB128 varint. @throws std::runtime_error on a truncated trace.
+ */
+inline uint64_t getVarint(const unsigned char *&cur, const unsigned char *end)
+{
+    uint64_t value = 0;
+    for (unsigned shift = 0; cur < end && shift < 64; shift += 7)
+    {
+        unsigned char byte = *(cur++);
+        value |= (uint64_t) (byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+        {
+            return value;
+        }
+    }
+    throw std::runtime_error("truncated trace");
+}
+
+/**
+ * A vector alive in the trace being decoded.
+ */
+struct DecodedVector
+{
+    size_t bytes; // replayed element size.
+    uint32_t slot;
+    uint64_t staticCapacity;
+};
+
+/**
+ * @brief Reads and decodes a trace file. Version 1 traces do not record the element size and the static capacity of
+ * copies, which are taken from the copied vectors. Version 2 and older traces record moves as copies and clears, and
+ * are replayed so. @throws std::runtime_error if it is not a valid trace.
+ */
+inline Trace readTrace(const char *path)
+{
+    FILE *in = std::fopen(path, "rb");
+    if (!in)
+    {
+        throw std::runtime_error(std::string("can not open ") + path);
+    }
+    std::vector<unsigned char> bytes;
+    unsigned char buffer[1 << 16];
+    size_t amount;
+    while ((amount = std::fread(buffer, 1, sizeof(buffer), in)) > 0)
+    {
+        bytes.insert(bytes.end(), buffer, buffer + amount);
+    }
+    std::fclose(in);
+    if (bytes.size() < TRACE_MAGIC_LEN + 1 || std::memcmp(bytes.data(), TRACE_MAGIC, TRACE_MAGIC_LEN) ||
+        bytes[TRACE_MAGIC_LEN] < UNSIZED_COPIES_VERSION || bytes[TRACE_MAGIC_LEN] > TRACE_VERSION)
+    {
+        throw std::runtime_error("not a VLVector trace");
+    }
+    bool sizedCopies = bytes[TRACE_MAGIC_LEN] > UNSIZED_COPIES_VERSION;
+
+    Trace trace;
+    std::unordered_map<uint64_t, DecodedVector> vectors;
+    std::map<size_t, std::vector<uint32_t>> freeSlots;
+    const unsigned char *cur = bytes.data() + TRACE_MAGIC_LEN + 1, *end = bytes.data() + bytes.size();
+    while (cur < end)
+    {
+        TraceRecord record = {};
+        unsigned char op = *(cur++);
+        if (op >= TRACE_OPS_AMOUNT)
+        {
+            throw std::runtime_error("unknown trace op");
+        }
+        record.op = (VLVTraceOp) op;
+        uint64_t id = getVarint(cur, end), other = 0, elementBytes = 0;
+        if (op == TRACE_CREATE)
+        {
+            elementBytes = getVarint(cur, end);
+            record.staticCapacity = getVarint(cur, end);
+        }
+        else if (op == TRACE_INSERT || op == TRACE_ERASE)
+        {
+            record.pos = getVarint(cur, end);
+            record.amount = getVarint(cur, end);
+        }
+        else if (op == TRACE_COPY || op == TRACE_ASSIGN || op == TRACE_MOVE || op == TRACE_MOVE_ASSIGN)
+        {
+            other = getVarint(cur, end);
+        }
+        bool copied = op == TRACE_COPY || op == TRACE_MOVE, assigned = op == TRACE_ASSIGN || op == TRACE_MOVE_ASSIGN;
+        if (copied && sizedCopies)
+        {
+            elementBytes = getVarint(cur, end);
+            record.staticCapacity = getVarint(cur, end);
+        }
+
+        auto source = vectors.find(other);
+        if (copied && source == vectors.end())
+        {
+            if (!sizedCopies)
+            {
+                continue; // a copy of a vector created before recording started, whose size is unknown.
+            }
+            record.op = TRACE_CREATE; // its elements are unknown, but the copy itself can be created.
+        }
+        if (op == TRACE_CREATE || copied)
+        {
+            DecodedVector vector;
+            vector.bytes = sizedCopies || op == TRACE_CREATE ? replayedBytes(elementBytes) : source->second.bytes;
+            vector.staticCapacity = sizedCopies || op == TRACE_CREATE ? record.staticCapacity
+                                                                      : source->second.staticCapacity;
+            std::vector<uint32_t> &free = freeSlots[vector.bytes];
+            if (free.empty())
+            {
+                free.push_back((uint32_t) trace.bySize[vector.bytes].slots++);
+                ++trace.slots;
+            }
+            vector.slot = free.back();
+            free.pop_back();
+            vectors[id] = vector;
+            record.staticCapacity = vector.staticCapacity;
+        }
+        auto vector = vectors.find(id);
+        source = vectors.find(other); //the insertion may have rehashed.
+        if (vector == vectors.end() || (assigned && source == vectors.end()))
+        {
+            continue; // a vector created before recording started.
+        }
+        if (((copied && record.op != TRACE_CREATE) || assigned) && source->second.bytes != vector->second.bytes)
+        {
+            continue; // only vectors of the same element type copy or move each other, so the trace is corrupt.
+        }
+        SubTrace &sub = trace.bySize[vector->second.bytes];
+        record.slot = vector->second.slot;
+        record.other = source == vectors.end() ? 0 : source->second.slot;
+        if (op == TRACE_INSERT)
+        {
+            sub.maxInsert = std::max(sub.maxInsert, record.amount);
+        }
+        if (op == TRACE_DESTROY)
+        {
+            freeSlots[vector->second.bytes].push_back(vector->second.slot);
+            vectors.erase(vector);
+        }
+        sub.records.push_back(record);
+        ++trace.records;
+    }
+    return trace;
+}
+
+/**
+ * A replayed element of Bytes bytes, holding the int it was made of in its first bytes.
+ */
+template<size_t Bytes>
+struct ReplayElement
+{
+    unsigned char bytes[Bytes];
+
+    ReplayElement() : bytes()
+    {
+    }
+
+    explicit ReplayElement(int value) : bytes()
+    {
+        std::memcpy(bytes, &value, std::min(Bytes, sizeof(value)));
+    }
+
+    bool operator==(ReplayElement const &rhs) const
+    {
+        return !std::memcmp(bytes, rhs.bytes, Bytes);
+    }
+
+    bool operator<(ReplayElement const &rhs) const
+    {
+        return std::memcmp(bytes, rhs.bytes, Bytes) < 0;
+    }
+};
+
+/**
+ * A replayed vector. Only creation and destruction are virtual: the operations are called on Base, the type the
+ * containers of a replay share, like a program taking VLVectorBase references.
+ */
+template<class Base>
+class ReplaySlot
+{
+public:
+    virtual ~ReplaySlot() = default;
+
+    virtual Base &vec() noexcept = 0;
+};
+
+template<class Container, class Base>
+class SlotOf final : public ReplaySlot<Base>
+{
+private:
+    Container _vec;
+
+public:
+    SlotOf() = default;
+
+    explicit SlotOf(Base const &toCopy) : _vec(toCopy)
+    {
+    }
+
+    explicit SlotOf(Base &&toMove) : _vec(std::move(toMove))
+    {
+    }
+
+    Base &vec() noexcept override
+    {
+        return _vec;
+    }
+};
+
+/**
+ * The way to create a replayed vector in place.
+ */
+template<class Base>
+struct SlotType
+{
+    size_t bytes;
+
+    ReplaySlot<Base> *(*create)(void *where);
+
+    ReplaySlot<Base> *(*copy)(void *where, Base const &toCopy);
+
+    ReplaySlot<Base> *(*move)(void *where, Base &&toMove);
+};
+
+template<class Container, class Base>
+SlotType<Base> slotType()
+{
+    return {sizeof(SlotOf<Container, Base>),
+            [](void *where) -> ReplaySlot<Base> * { return new(where) SlotOf<Container, Base>(); },
+            [](void *where, Base const &toCopy) -> ReplaySlot<Base> *
+            { return new(where) SlotOf<Container, Base>(toCopy); },
+            [](void *where, Base &&toMove) -> ReplaySlot<Base> *
+            { return new(where) SlotOf<Container, Base>(std::move(toMove)); }};
+}
+
+/**
+ * @return The type replaying a vector of E with staticCapacity: a VLVector of the next power of two static capacity,
+ * at most MAX_STATIC_CAPACITY.
+ */
+template<class E, size_t Capacity = 1>
+SlotType<VLVectorBase<E>> recordedType(uint64_t staticCapacity)
+{
+    if constexpr (Capacity < MAX_STATIC_CAPACITY)
+    {
+        if (staticCapacity > Capacity)
+        {
+            return recordedType<E, Capacity * 2>(staticCapacity);
+        }
+    }
+    return slotType<VLVector<E, Capacity>, VLVectorBase<E>>();
+}
+
+/**
+ * Replays every vector as a VLVector of the static capacity it was recorded with.
+ */
+struct AsRecorded
+{
+    template<class E>
+    using Base = VLVectorBase<E>;
+
+    template<class E>
+    static SlotType<Base<E>> type(uint64_t staticCapacity)
+    {
+        return recordedType<E>(staticCapacity);
+    }
+};
+
+/**
+ * Replays every vector as a VLVector of StaticCapacity.
+ */
+template<size_t StaticCapacity>
+struct FixedCapacity
+{
+    template<class E>
+    using Base = VLVectorBase<E>;
+
+    template<class E>
+    static SlotType<Base<E>> type(uint64_t)
+    {
+        return slotType<VLVector<E, StaticCapacity>, Base<E>>();
+    }
+};
+
+/**
+ * Replays every vector as a std::vector.
+ */
+struct StdVector
+{
+    template<class E>
+    using Base = std::vector<E>;
+
+    template<class E>
+    static SlotType<Base<E>> type(uint64_t)
+    {
+        return slotType<Base<E>, Base<E>>();
+    }
+};
+
+/**
+ * The outcome of a replay.
+ */
+struct ReplayResult
+{
+    double nanos = 0;
+    AllocSample allocs;
+};
+
+/**
+ * @brief Re-executes the sub trace of elements E, every vector as the type Layout gives it. Records that do not fit
+ * the replayed state (which can only happen with a partial trace) are skipped.
+ * @param sizes If not null, set to the sizes of the vectors alive at the end of the trace by slot, 0 for empty slots.
+ */
+template<class Layout, class E>
+ReplayResult replay(SubTrace const &trace, std::vector<size_t> *sizes = nullptr)
+{
+    typedef typename Layout::template Base<E> Base;
+    std::vector<size_t> offsets(trace.slots + 1, 0); //every slot is large enough for all of the vectors it holds.
+    for (TraceRecord const &record : trace.records)
+    {
+        if (record.op == TRACE_CREATE || record.op == TRACE_COPY || record.op == TRACE_MOVE)
+        {
+            size_t bytes = Layout::template type<E>(record.staticCapacity).bytes;
+            offsets[record.slot + 1] = std::max(offsets[record.slot + 1], bytes);
+        }
+    }
+    for (size_t slot = 0; slot < trace.slots; ++slot)
+    {
+        size_t aligned = (offsets[slot + 1] + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) *
+                         alignof(std::max_align_t);
+        offsets[slot + 1] = offsets[slot] + aligned;
+    }
+    std::unique_ptr<unsigned char[]> raw(new unsigned char[offsets.back() + 1]);
+    std::vector<ReplaySlot<Base> *> live(trace.slots, nullptr);
+    std::vector<E> values;
+    for (size_t i = 0; i <= trace.maxInsert; ++i)
+    {
+        values.emplace_back((int) i);
+    }
+    int next = 0;
+
+    AllocSample allocsBefore = allocSnapshot();
+    auto timeBefore = std::chrono::steady_clock::now();
+    for (TraceRecord const &record : trace.records)
+    {
+        ReplaySlot<Base> *&slot = live[record.slot];
+        if (!slot && record.op != TRACE_CREATE && record.op != TRACE_COPY && record.op != TRACE_MOVE)
+        {
+            continue;
+        }
+        switch (record.op)
+        {
+            case TRACE_CREATE:
+                slot = Layout::template type<E>(record.staticCapacity).create(raw.get() + offsets[record.slot]);
+                break;
+            case TRACE_COPY:
+                if (live[record.other])
+                {
+                    slot = Layout::template type<E>(record.staticCapacity).copy(raw.get() + offsets[record.slot],
+                                                                               live[record.other]->vec());
+                }
+                break;
+            case TRACE_MOVE:
+                if (live[record.other])
+                {
+                    slot = Layout::template type<E>(record.staticCapacity).move(raw.get() + offsets[record.slot],
+                                                                               std::move(live[record.other]->vec()));
+                }
+                break;
+            case TRACE_ASSIGN:
+                if (live[record.other])
+                {
+                    slot->vec() = live[record.other]->vec();
+                }
+                break;
+            case TRACE_MOVE_ASSIGN:
+                if (live[record.other])
+                {
+                    slot->vec() = std::move(live[record.other]->vec());
+                }
+                break;
+            case TRACE_DESTROY:
+                slot->~ReplaySlot();
+                slot = nullptr;
+                break;
+            case TRACE_PUSH_BACK:
+                slot->vec().push_back(E(next++));
+                break;
+            case TRACE_POP_BACK:
+                if (!slot->vec().empty())
+                {
+                    slot->vec().pop_back();
+                }
+                break;
+            case TRACE_INSERT:
+            {
+                Base &vec = slot->vec();
+                if (record.pos > vec.size())
+                {
+                    break;
+                }
+                if (record.amount == 1)
+                {
+                    vec.insert(vec.cbegin() + record.pos, E(next++));
+                }
+                else
+                {
+                    vec.insert(vec.cbegin() + record.pos, values.data(), values.data() + record.amount);
+                }
+                break;
+            }
+            case TRACE_ERASE:
+            {
+                Base &vec = slot->vec();
+                if (record.pos + record.amount > vec.size())
+                {
+                    break;
+                }
+                if (record.amount == 1)
+                {
+                    vec.erase(vec.cbegin() + record.pos);
+                }
+                else
+                {
+                    vec.erase(vec.cbegin() + record.pos, vec.cbegin() + (record.pos + record.amount));
+                }
+                break;
+            }
+            case TRACE_CLEAR:
+                slot->vec().clear();
+                break;
+            default:
+                break;
+        }
+    }
+    if (sizes)
+    {
+        sizes->clear();
+        for (ReplaySlot<Base> *slot : live)
+        {
+            sizes->push_back(slot ? slot->vec().size() : 0);
+        }
+    }
+    for (ReplaySlot<Base> *slot : live)
+    {
+        if (slot)
+        {
+            slot->~ReplaySlot();
+        }
+    }
+    auto timeAfter = std::chrono::steady_clock::now();
+
+    ReplayResult result;
+    result.nanos = (double) std::chrono::duration_cast<std::chrono::nanoseconds>(timeAfter - timeBefore).count();
+    result.allocs = allocSnapshot() - allocsBefore;
+    return result;
+}
+
+/**
+ * @brief Replays the sub trace of elements of bytes bytes, a power of two of at most MAX_ELEMENT_BYTES.
+ */
+template<class Layout, size_t Bytes = 1>
+ReplayResult replayBytes(SubTrace const &trace, size_t bytes)
+{
+    if constexpr (Bytes < MAX_ELEMENT_BYTES)
+    {
+        if (bytes > Bytes)
+        {
+            return replayBytes<Layout, Bytes * 2>(trace, bytes);
+        }
+    }
+    return replay<Layout, ReplayElement<Bytes>>(trace);
+}
+
+
+#endif //CPP_EXAM_TRACEREPLAY_HPP
@@ -0,0 +1,1123 @@
+/**
+ * @file VLVectorBenchmark.cpp
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ *
+ * @brief Micro benchmarks for VLVector.
+ *
+ * @section DESCRIPTION Runs every VLVector operation for a fixed amount of iterations and reports, per operation, the
+ * wall time, the hardware counters of PerfCounters (when the kernel permits them) and the allocations seen by the
+ * interposed operator new. Build with:
+ *     g++ -std=c++17 -O2 -I.. VLVectorBenchmark.cpp -o VLVectorBenchmark
+ * Usage: VLVectorBenchmark [--ops N] [--filter SUBSTRING] [--only NAME]... [--repeat R] [--json OUT] [--baseline IN]
+ *                          [--threshold RATIO] [--alpha P] [--allow-new] [--confirm C]
+ * --repeat runs every benchmark R times, --json saves the samples and --baseline compares them to a saved run and
+ * exits with a failure if an operation regressed or has no samples in the baseline, which --allow-new lets pass (see
+ * RegressionGate.hpp). An operation failing the comparison is run again in up to C separate processes of this
+ * executable (DEFAULT_CONFIRM if not given), and fails only if it fails in every one of them. --only runs the
+ * operation of exactly that name, and may be repeated. regression_gate.sh wraps all of it.
+ */
+#define ALLOC_COUNTER_IMPLEMENTATION
+
+#include "AllocCounter.hpp"
+#include "PerfCounters.hpp"
+#include "RegressionGate.hpp"
+#include "../VLBitVector.hpp"
+#include "../VLDeque.hpp"
+#include "../VLFlatMap.hpp"
+#include "../VLGapVector.hpp"
+#include "../VLHashMap.hpp"
+#include "../VLJaggedVector.hpp"
+#include "../VLPriorityQueue.hpp"
+#include "../VLSegmentedVector.hpp"
+#include "../VLString.hpp"
+#include "../VLVector.hpp"
+#include "../VLVectorExpr.hpp"
+#include "../VLVectorFilter.hpp"
+#include "../VLVectorHash.hpp"
+#include "../VLVectorSearch.hpp"
+#include "../VLVectorSearchIndex.hpp"
+#include "../VLVectorSetOps.hpp"
+#include "../VLVectorSort.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <numeric>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#define DEFAULT_OPS 2000000
+
+#define DEFAULT_REPEAT 1
+
+#define DEFAULT_CONFIRM 2
+
+#define INLINE_CAPACITY 16
+
+#define SPILLED_SIZE 256
+
+#define SEARCHED_SIZE 4096
+
+#define SORTED_SIZE 4096
+
+#define SHUFFLE_SEED 0x9e3779b9u
+
+#define INDEXED_SIZE (1 << 20)
+
+#define QUEUE_DEPTH 12
+
+#define EDIT_RUN 64
+
+#define TOP_K 10
+
+#define ATTRIBUTES 6
+
+#define MASK_BITS 4096
+
+#define IDENTIFIERS 64
+
+#define IDENTIFIER_CAPACITY 48
+
+#define ADJACENCY_ROWS 4096
+
+#define ADJACENCY_SLOTS 4
+
+#define USAGE_MSG "Usage: VLVectorBenchmark [--ops N] [--filter SUBSTRING] [--only NAME]... [--repeat R]" \
+                  " [--json OUT] [--baseline IN] [--threshold RATIO] [--alpha P] [--allow-new] [--confirm C]\n"
+
+typedef VLVector<int, INLINE_CAPACITY> BenchVector;
+
+typedef VLVector<uint32_t, INLINE_CAPACITY> PostingList;
+
+/**
+ * @brief Keeps the compiler from optimizing away a value that is never read.
+ */
+template<class T>
+inline void escape(T const &value)
+{
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+/**
+ * The measurements of a single benchmark.
+ */
+struct BenchmarkResult
+{
+    std::string name;
+    size_t ops;
+    double nanos;
+    PerfSample counters;
+    AllocSample allocs;
+};
+
+/**
+ * @brief Runs body, which performs ops operations, once and measures it.
+ */
+template<class Body>
+BenchmarkResult measure(PerfCounters &counters, const char *name, size_t ops, Body body)
+{
+    AllocSample allocsBefore = allocSnapshot();
+    auto timeBefore = std::chrono::steady_clock::now();
+    counters.start();
+    body();
+    PerfSample sample = counters.stop();
+    auto timeAfter = std::chrono::steady_clock::now();
+    AllocSample allocsAfter = allocSnapshot();
+    BenchmarkResult result;
+    result.name = name;
+    result.ops = ops;
+    result.nanos = (double) std::chrono::duration_cast<std::chrono::nanoseconds>(timeAfter - timeBefore).count();
+    result.counters = sample;
+    result.allocs = allocsAfter - allocsBefore;
+    return result;
+}
+
+/**
+ * @brief Builds a vector holding 0..size-1.
+ */
+inline BenchVector makeVector(size_t size)
+{
+    BenchVector vec;
+    for (size_t i = 0; i < size; ++i)
+    {
+        vec.push_back((int) i);
+    }
+    return vec;
+}
+
+/**
+ * @brief Builds a vector holding a fixed pseudo random permutation of 0..size-1.
+ */
+inline BenchVector makeShuffled(size_t size)
+{
+    BenchVector vec = makeVector(size);
+    uint32_t state = SHUFFLE_SEED;
+    for (size_t i = size; i > 1; --i)
+    {
+        state = state * 1664525u + 1013904223u;
+        std::swap(vec.data()[i - 1], vec.data()[(state >> 8) % i]);
+    }
+    return vec;
+}
+
+/**
+ * A named benchmark. run performs the given amount of operations.
+ */
+struct Benchmark
+{
+    const char *name;
+
+    void (*run)(size_t ops);
+};
+
+/**
+ * @brief push_back into a vector that never leaves its static storage.
+ */
+static void benchPushBackInline(size_t ops)
+{
+    for (size_t done = 0; done < ops; done += INLINE_CAPACITY)
+    {
+        BenchVector vec;
+        for (int i = 0; i < INLINE_CAPACITY; ++i)
+        {
+            vec.push_back(i);
+        }
+        escape(vec);
+    }
+}
+
+/**
+ * @brief push_back into a vector that spills to the heap.
+ */
+static void benchPushBackSpill(size_t ops)
+{
+    for (size_t done = 0; done < ops; done += SPILLED_SIZE)
+    {
+        BenchVector vec;
+        for (int i = 0; i < SPILLED_SIZE; ++i)
+        {
+            vec.push_back(i);
+        }
+        escape(vec);
+    }
+}
+
+/**
+ * @brief push_back into a segmented vector that spills to the heap, see benchPushBackSpill.
+ */
+static void benchPushBackSegmented(size_t ops)
+{
+    for (size_t done = 0; done < ops; done += SPILLED_SIZE)
+    {
+        VLSegmentedVector<int, INLINE_CAPACITY> vec;
+        for (int i = 0; i < SPILLED_SIZE; ++i)
+        {
+            vec.push_back(i);
+        }
+        escape(vec);
+    }
+}
+
+/**
+ * @brief Single element insert at the front of an inline vector.
+ */
+static void benchInsertFront(size_t ops)
+{
+    for (size_t done = 0; done < ops; done += INLINE_CAPACITY)
+    {
+        BenchVector vec;
+        for (int i = 0; i < INLINE_CAPACITY; ++i)
+        {
+            vec.insert(vec.cbegin(), i);
+        }
+        escape(vec);
+    }
+}
+
+/**
+ * @brief Single element erase from the front of a spilled vector, down to the static storage.
+ */
+static void benchEraseFront(size_t ops)
+{
+    BenchVector full = makeVector(SPILLED_SIZE);
+    for (size_t done = 0; done < ops; done += SPILLED_SIZE)
+    {
+        BenchVector vec(full);
+        while (!vec.empty())
+        {
+            vec.erase(vec.cbegin());
+        }
+        escape(vec);
+    }
+}
+
+/**
+ * @brief pop_back of a spilled vector down to empty.
+ */
+static void benchPopBack(size_t ops)
+{
+    BenchVector full = makeVector(SPILLED_SIZE);
+    for (size_t done = 0; done < ops; done += SPILLED_SIZE)
+    {
+        BenchVector vec(full);
+        while (!vec.empty())
+        {
+            vec.pop_back();
+        }
+        escape(vec);
+    }
+}
+
+/**
+ * @brief Copy construction of an inline vector.
+ */
+static void benchCopyInline(size_t ops)
+{
+    BenchVector source = makeVector(INLINE_CAPACITY);
+    for (size_t done = 0; done < ops; ++done)
+    {
+        BenchVector vec(source);
+        escape(vec);
+    }
+}
+
+/**
+ * @brief Copy construction of a spilled vector.
+ */
+static void benchCopySpilled(size_t ops)
+{
+    BenchVector source = makeVector(SPILLED_SIZE);
+    for (size_t done = 0; done < ops; done += SPILLED_SIZE)
+    {
+        BenchVector vec(source);
+        escape(vec);
+    }
+}
+
+/**
+ * @brief Iteration over an inline vector through its iterators.
+ */
+static void benchIterateInline(size_t ops)
+{
+    BenchVector vec = makeVector(INLINE_CAPACITY);
+    for (size_t done = 0; done < ops; done += INLINE_CAPACITY)
+    {
+        escape(vec);
+        int sum = 0;
+        for (int elem : vec)
+        {
+            sum += elem;
+        }
+        escape(sum);
+    }
+}
+
+/**
+ * @brief Element lookup through std::find over an inline vector.
+ */
+static void benchFindInline(size_t ops)
+{
+    BenchVector vec = makeVector(INLINE_CAPACITY);
+    for (size_t done = 0; done < ops; done += INLINE_CAPACITY)
+    {
+        escape(vec);
+        bool found = std::find(vec.cbegin(), vec.cend(), INLINE_CAPACITY - 1) != vec.cend();
+        escape(found);
+    }
+}
+
+/**
+ * @brief Membership test through the contains kernel over an inline vector.
+ */
+static void benchContainsInline(size_t ops)
+{
+    BenchVector vec = makeVector(INLINE_CAPACITY);
+    for (size_t done = 0; done < ops; done += INLINE_CAPACITY)
+    {
+        escape(vec);
+        bool found = contains(vec, INLINE_CAPACITY - 1);
+        escape(found);
+    }
+}
+
+/**
+ * @brief Element lookup through std::find over a large spilled vector.
+ */
+static void benchStdFindSpilled(size_t ops)
+{
+    BenchVector vec = makeVector(SEARCHED_SIZE);
+    for (size_t done = 0; done < ops; done += SEARCHED_SIZE)
+    {
+        escape(vec);
+        bool found = std::find(vec.data(), vec.data() + vec.size(), SEARCHED_SIZE - 1) != vec.data() + vec.size();
+        escape(found);
+    }
+}
+
+/**
+ * @brief Element lookup through the find kernel over a large spilled vector.
+ */
+static void benchFindSpilled(size_t ops)
+{
+    BenchVector vec = makeVector(SEARCHED_SIZE);
+    for (size_t done = 0; done < ops; done += SEARCHED_SIZE)
+    {
+        escape(vec);
+        bool found = find(vec, SEARCHED_SIZE - 1) != vec.cend();
+        escape(found);
+    }
+}
+
+/**
+ * @brief Equality of two equal inline vectors.
+ */
+static void benchEqualInline(size_t ops)
+{
+    BenchVector lhs = makeVector(INLINE_CAPACITY), rhs = makeVector(INLINE_CAPACITY);
+    for (size_t done = 0; done < ops; done += INLINE_CAPACITY)
+    {
+        escape(lhs);
+        bool equal = lhs == rhs;
+        escape(equal);
+    }
+}
+
+/**
+ * @brief std::hash of an inline vector.
+ */
+static void benchHashInline(size_t ops)
+{
+    BenchVector vec = makeVector(INLINE_CAPACITY);
+    std::hash<BenchVector> hasher;
+    for (size_t done = 0; done < ops; done += INLINE_CAPACITY)
+    {
+        escape(vec);
+        size_t hash = hasher(vec);
+        escape(hash);
+    }
+}
+
+/**
+ * @brief Sorts a copy of a shuffled vector of Size elements, with sort() or, if Std, with std::sort.
+ */
+template<size_t Size, bool Std>
+static void benchSort(size_t ops)
+{
+    BenchVector shuffled = makeShuffled(Size), vec;
+    for (size_t done = 0; done < ops; done += Size)
+    {
+        vec = shuffled;
+        escape(vec);
+        if (Std)
+        {
+            std::sort(vec.data(), vec.data() + vec.size());
+        }
+        else
+        {
+            sort(vec);
+        }
+        escape(vec);
+    }
+}
+
+/**
+ * @brief A fused element-wise expression of three inline vectors into a fourth.
+ */
+static void benchExprInline(size_t ops)
+{
+    BenchVector lhs = makeVector(INLINE_CAPACITY), mid = makeShuffled(INLINE_CAPACITY);
+    BenchVector rhs = makeVector(INLINE_CAPACITY), vec;
+    for (size_t done = 0; done < ops; done += INLINE_CAPACITY)
+    {
+        escape(lhs);
+        vec = lhs * 2 + mid - rhs;
+        escape(vec);
+    }
+}
+
+/**
+ * @brief Filters half of a shuffled array into a vector, with filter_into or, if Branchy, with a push_back loop.
+ */
+template<bool Branchy>
+static void benchFilter(size_t ops)
+{
+    BenchVector shuffled = makeShuffled(SEARCHED_SIZE), vec;
+    const int *src = shuffled.data();
+    for (size_t done = 0; done < ops; done += SEARCHED_SIZE)
+    {
+        vec.clear();
+        escape(shuffled);
+        if (Branchy)
+        {
+            for (size_t i = 0; i < SEARCHED_SIZE; ++i)
+            {
+                if (src[i] < SEARCHED_SIZE / 2)
+                {
+                    vec.push_back(src[i]);
+                }
+            }
+        }
+        else
+        {
+            filter_into(src, SEARCHED_SIZE, vlvfilter::Less<int>(SEARCHED_SIZE / 2), vec);
+        }
+        escape(vec);
+    }
+}
+
+/**
+ * @brief Builds a posting list of about one in step of the ids below SEARCHED_SIZE * 2, picked by a hash so the gaps
+ * are irregular.
+ */
+inline PostingList makePostings(uint32_t step)
+{
+    PostingList list;
+    for (uint32_t id = 0; id < SEARCHED_SIZE * 2; ++id)
+    {
+        if (((id * SHUFFLE_SEED) >> 16) % step == 0)
+        {
+            list.push_back(id);
+        }
+    }
+    return list;
+}
+
+/**
+ * @brief Intersects a posting list of one in 2 ids with one of one in Step ids, with set_intersection or, if Std, with
+ * std::set_intersection. Every element of both lists counts as an operation.
+ */
+template<uint32_t Step, bool Std>
+static void benchIntersect(size_t ops)
+{
+    PostingList lhs = makePostings(2), rhs = makePostings(Step), out;
+    for (size_t done = 0; done < ops; done += lhs.size() + rhs.size())
+    {
+        escape(lhs);
+        if (Std)
+        {
+            out.resize_and_overwrite(rhs.size(), [&](uint32_t *elems, size_t)
+            {
+                return std::set_intersection(lhs.data(), lhs.data() + lhs.size(), rhs.data(), rhs.data() + rhs.size(),
+                                             elems) - elems;
+            });
+        }
+        else
+        {
+            set_intersection(lhs, rhs, out);
+        }
+        escape(out);
+    }
+}
+
+/**
+ * The layouts benchIndex searches.
+ */
+enum class IndexLayout
+{
+    Sorted, Eytzinger, STree
+};
+
+/**
+ * @brief Looks random keys up in INDEXED_SIZE sorted keys, half of them present, with std::lower_bound over the sorted
+ * vector or with a search index of Layout.
+ */
+template<IndexLayout Layout>
+static void benchIndex(size_t ops)
+{
+    BenchVector sorted;
+    sorted.reserve(INDEXED_SIZE);
+    for (int i = 0; i < INDEXED_SIZE; ++i)
+    {
+        sorted.push_back(2 * i);
+    }
+    VLEytzingerIndex<int> eytzinger;
+    VLSTreeIndex<int> stree;
+    if (Layout == IndexLayout::Eytzinger)
+    {
+        eytzinger.rebuild(sorted);
+    }
+    if (Layout == IndexLayout::STree)
+    {
+        stree.rebuild(sorted);
+    }
+    uint32_t state = SHUFFLE_SEED;
+    size_t positions = 0;
+    for (size_t done = 0; done < ops; ++done)
+    {
+        state = state * 1664525u + 1013904223u;
+        int key = (int) ((state >> 8) % (2 * INDEXED_SIZE));
+        if (Layout == IndexLayout::Sorted)
+        {
+            positions += (size_t) (std::lower_bound(sorted.data(), sorted.data() + sorted.size(), key) - sorted.data());
+        }
+        else if (Layout == IndexLayout::Eytzinger)
+        {
+            positions += eytzinger.lower_bound(key);
+        }
+        else
+        {
+            positions += stree.lower_bound(key);
+        }
+    }
+    escape(positions);
+}
+
+/**
+ * @brief A FIFO work queue of QUEUE_DEPTH items, with a VLDeque or with a VLVector that dequeues by erasing its front.
+ * Every operation enqueues one item and dequeues one.
+ */
+template<bool Deque>
+static void benchFifo(size_t ops)
+{
+    typedef std::conditional_t<Deque, VLDeque<int, INLINE_CAPACITY>, BenchVector> Queue;
+    Queue queue;
+    for (int i = 0; i < QUEUE_DEPTH; ++i)
+    {
+        queue.push_back(i);
+    }
+    int dequeued = 0;
+    for (size_t done = 0; done < ops; ++done)
+    {
+        queue.push_back((int) done);
+        dequeued += queue.front();
+        if constexpr (Deque)
+        {
+            queue.pop_front();
+        }
+        else
+        {
+            queue.erase(queue.cbegin());
+        }
+    }
+    escape(dequeued);
+    escape(queue);
+}
+
+/**
+ * @brief Selects the TOP_K largest of SORTED_SIZE shuffled elements, with std::partial_sort_copy or with top_k over a
+ * heap of Arity. Every operation looks at one element.
+ */
+template<size_t Arity, bool Std>
+static void benchTopK(size_t ops)
+{
+    BenchVector shuffled = makeShuffled(SORTED_SIZE);
+    for (size_t done = 0; done < ops; done += SORTED_SIZE)
+    {
+        escape(shuffled);
+        if (Std)
+        {
+            int best[TOP_K];
+            std::partial_sort_copy(shuffled.begin(), shuffled.end(), best, best + TOP_K, std::greater<int>());
+            escape(best);
+        }
+        else
+        {
+            VLVector<int, INLINE_CAPACITY> best = top_k<INLINE_CAPACITY, Arity>(shuffled, TOP_K);
+            escape(best);
+        }
+    }
+}
+
+/**
+ * @brief Builds a map of INLINE_CAPACITY shuffled keys and looks every key up, with a VLFlatMap or a std::map. Every
+ * operation is one insert and one lookup.
+ */
+template<bool Flat>
+static void benchSmallMap(size_t ops)
+{
+    typedef std::conditional_t<Flat, VLFlatMap<int, int, INLINE_CAPACITY>, std::map<int, int>> Map;
+    BenchVector keys = makeShuffled(INLINE_CAPACITY);
+    for (size_t done = 0; done < ops; done += INLINE_CAPACITY)
+    {
+        escape(keys);
+        Map map;
+        for (int key : keys)
+        {
+            map[key] = key;
+        }
+        int found = 0;
+        for (int key : keys)
+        {
+            found += map.find(key) != map.end();
+        }
+        escape(found);
+    }
+}
+
+/**
+ * @brief Builds a map of Size keys and looks every key up, with a VLHashMap or a std::unordered_map. Every operation
+ * is one insert and one lookup.
+ */
+template<size_t Size, bool Std>
+static void benchHashMap(size_t ops)
+{
+    typedef std::conditional_t<Std, std::unordered_map<int, int>, VLHashMap<int, int, INLINE_CAPACITY>> Map;
+    BenchVector keys = makeShuffled(Size);
+    for (size_t done = 0; done < ops; done += Size)
+    {
+        escape(keys);
+        Map map;
+        for (int key : keys)
+        {
+            map[key * 7919] = key;
+        }
+        int found = 0;
+        for (int key : keys)
+        {
+            found += map.find(key * 7919) != map.end();
+        }
+        escape(found);
+    }
+}
+
+/**
+ * @brief Runs of EDIT_RUN inserts at a cursor which advances after every insert and jumps between runs, into
+ * SORTED_SIZE elements, with a VLGapVector or a VLVector.
+ */
+template<bool Gap>
+static void benchCursorInsert(size_t ops)
+{
+    typedef std::conditional_t<Gap, VLGapVector<int, INLINE_CAPACITY>, BenchVector> Edited;
+    BenchVector initial = makeVector(SORTED_SIZE);
+    uint32_t state = SHUFFLE_SEED;
+    for (size_t done = 0; done < ops; done += SORTED_SIZE)
+    {
+        Edited vec(initial.begin(), initial.end());
+        size_t cursor = 0;
+        for (size_t inserted = 0; inserted < SORTED_SIZE; ++inserted)
+        {
+            if (inserted % EDIT_RUN == 0)
+            {
+                state = state * 1664525u + 1013904223u;
+                cursor = (state >> 8) % vec.size();
+            }
+            vec.insert(vec.cbegin() + (ptrdiff_t) cursor++, (int) inserted);
+        }
+        escape(vec);
+    }
+}
+
+/**
+ * @brief Intersects two masks of MASK_BITS bits and counts the bits left, with VLBitVector or with a
+ * std::vector<bool>. Every operation is one bit.
+ */
+template<bool Packed>
+static void benchMaskCount(size_t ops)
+{
+    typedef std::conditional_t<Packed, VLBitVector<MASK_BITS>, std::vector<bool>> Mask;
+    Mask lhs, rhs;
+    uint32_t state = SHUFFLE_SEED;
+    for (size_t bit = 0; bit < MASK_BITS; ++bit)
+    {
+        state = state * 1664525u + 1013904223u;
+        lhs.push_back((state >> 8) & 1);
+        rhs.push_back((state >> 9) & 1);
+    }
+    for (size_t done = 0; done < ops; done += MASK_BITS)
+    {
+        escape(lhs);
+        Mask both = lhs;
+        size_t count = 0;
+        if constexpr (Packed)
+        {
+            both &= rhs;
+            count = both.count();
+        }
+        else
+        {
+            for (size_t bit = 0; bit < MASK_BITS; ++bit)
+            {
+                both[bit] = both[bit] && rhs[bit];
+            }
+            count = (size_t) std::count(both.begin(), both.end(), true);
+        }
+        escape(count);
+    }
+}
+
+/**
+ * @brief Copies IDENTIFIERS identifiers of 20 to 40 characters into strings and hashes them, with a VLString or a
+ * std::string, whose small string buffer is too short for them. Every operation is one identifier.
+ */
+template<bool Std>
+static void benchIdentifiers(size_t ops)
+{
+    typedef std::conditional_t<Std, std::string, VLString<IDENTIFIER_CAPACITY>> String;
+    std::string names[IDENTIFIERS];
+    uint32_t state = SHUFFLE_SEED;
+    for (std::string &name : names)
+    {
+        state = state * 1664525u + 1013904223u;
+        name = "module::component_" + std::string(2 + (state >> 8) % 21, 'x'); //20 to 40 characters.
+    }
+    for (size_t done = 0; done < ops; done += IDENTIFIERS)
+    {
+        size_t hashes = 0;
+        for (std::string const &name : names)
+        {
+            String copy(std::string_view(name.data(), name.size()));
+            escape(copy);
+            hashes += std::hash<String>()(copy);
+        }
+        escape(hashes);
+    }
+}
+
+/**
+ * @brief Finds a needle of 8 characters at the end of a text of SORTED_SIZE characters of the same 4 letter alphabet,
+ * so its first character is everywhere, with a VLString or a std::string. Every operation is one character of the
+ * text.
+ */
+template<bool Std>
+static void benchSubstring(size_t ops)
+{
+    typedef std::conditional_t<Std, std::string, VLString<IDENTIFIER_CAPACITY>> String;
+    String text;
+    uint32_t state = SHUFFLE_SEED;
+    for (size_t idx = 0; idx < SORTED_SIZE; ++idx)
+    {
+        state = state * 1664525u + 1013904223u;
+        text += (char) ('a' + (state >> 8) % 4);
+    }
+    text += "dacbbcad";
+    for (size_t done = 0; done < ops; done += SORTED_SIZE)
+    {
+        escape(text);
+        size_t found = text.find(std::string_view("dacbbcad"));
+        escape(found);
+    }
+}
+
+enum class Adjacency
+{
+    Nested, Hybrid, Csr
+};
+
+/**
+ * @brief Builds the adjacency lists of a graph of ADJACENCY_ROWS vertices from its edges, which are in random order,
+ * and sums the neighbors of every vertex: with a std::vector of VLVector<int, ADJACENCY_SLOTS>, with a
+ * VLHybridJaggedVector of as many slots, or with a VLJaggedVector rebuilt from the edges. The degrees are skewed: most
+ * vertices have a few neighbors, some have many. Every operation is one edge.
+ */
+template<Adjacency Layout>
+static void benchAdjacency(size_t ops)
+{
+    std::vector<uint32_t> sources, targets;
+    uint32_t state = SHUFFLE_SEED;
+    for (size_t vertex = 0; vertex < ADJACENCY_ROWS; ++vertex)
+    {
+        state = state * 1664525u + 1013904223u;
+        size_t degree = (state >> 8) % 8 == 0 ? (state >> 12) % 64 : (state >> 12) % 6;
+        for (size_t edge = 0; edge < degree; ++edge)
+        {
+            sources.push_back((uint32_t) vertex);
+            targets.push_back((state >> 4) % ADJACENCY_ROWS);
+            state = state * 1664525u + 1013904223u;
+        }
+    }
+    for (size_t edge = sources.size(); edge > 1; --edge) //shuffles the edges.
+    {
+        state = state * 1664525u + 1013904223u;
+        size_t other = (state >> 8) % edge;
+        std::swap(sources[edge - 1], sources[other]);
+        std::swap(targets[edge - 1], targets[other]);
+    }
+    for (size_t done = 0; done < ops; done += sources.size())
+    {
+        uint64_t sum = 0;
+        if constexpr (Layout == Adjacency::Nested)
+        {
+            std::vector<VLVector<uint32_t, ADJACENCY_SLOTS>> lists(ADJACENCY_ROWS);
+            for (size_t edge = 0; edge < sources.size(); ++edge)
+            {
+                lists[sources[edge]].push_back(targets[edge]);
+            }
+            for (auto const &list : lists)
+            {
+                sum = std::accumulate(list.begin(), list.end(), sum);
+            }
+        }
+        else if constexpr (Layout == Adjacency::Hybrid)
+        {
+            VLHybridJaggedVector<uint32_t, ADJACENCY_SLOTS> lists(ADJACENCY_ROWS);
+            for (size_t edge = 0; edge < sources.size(); ++edge)
+            {
+                lists.push_back(sources[edge], targets[edge]);
+            }
+            for (size_t vertex = 0; vertex < ADJACENCY_ROWS; ++vertex)
+            {
+                sum = std::accumulate(lists[vertex].begin(), lists[vertex].end(), sum);
+            }
+        }
+        else
+        {
+            VLJaggedVector<uint32_t, INLINE_CAPACITY, uint32_t> lists;
+            lists.rebuild(ADJACENCY_ROWS, sources.begin(), sources.end(), targets.begin());
+            for (size_t vertex = 0; vertex < ADJACENCY_ROWS; ++vertex)
+            {
+                sum = std::accumulate(lists[vertex].begin(), lists[vertex].end(), sum);
+            }
+        }
+        escape(sum);
+    }
+}
+
+static const Benchmark BENCHMARKS[] = {
+        {"push_back/inline", benchPushBackInline},
+        {"push_back/spill",  benchPushBackSpill},
+        {"push_back/segmented", benchPushBackSegmented},
+        {"insert/front",     benchInsertFront},
+        {"erase/front",      benchEraseFront},
+        {"pop_back/spilled", benchPopBack},
+        {"copy/inline",      benchCopyInline},
+        {"copy/spilled",     benchCopySpilled},
+        {"iterate/inline",   benchIterateInline},
+        {"find/inline",      benchFindInline},
+        {"contains/inline",  benchContainsInline},
+        {"std_find/spilled", benchStdFindSpilled},
+        {"find/spilled",     benchFindSpilled},
+        {"equal/inline",     benchEqualInline},
+        {"hash/inline",      benchHashInline},
+        {"std_sort/8",       benchSort<8, true>},
+        {"sort/8",           benchSort<8, false>},
+        {"std_sort/16",      benchSort<INLINE_CAPACITY, true>},
+        {"sort/16",          benchSort<INLINE_CAPACITY, false>},
+        {"std_sort/4096",    benchSort<SORTED_SIZE, true>},
+        {"sort/4096",        benchSort<SORTED_SIZE, false>},
+        {"expr/inline",      benchExprInline},
+        {"push_filter/spilled", benchFilter<true>},
+        {"filter/spilled",   benchFilter<false>},
+        {"std_intersect",    benchIntersect<3, true>},
+        {"intersect/spilled", benchIntersect<3, false>},
+        {"std_intersect/skew", benchIntersect<97, true>},
+        {"intersect/skewed", benchIntersect<97, false>},
+        {"std_lower_bound/1M", benchIndex<IndexLayout::Sorted>},
+        {"eytzinger/1M",     benchIndex<IndexLayout::Eytzinger>},
+        {"stree/1M",         benchIndex<IndexLayout::STree>},
+        {"fifo/vector",      benchFifo<false>},
+        {"fifo/deque",       benchFifo<true>},
+        {"cursor_insert/vector", benchCursorInsert<false>},
+        {"cursor_insert/gap", benchCursorInsert<true>},
+        {"std_top_k/10",     benchTopK<BINARY_HEAP, true>},
+        {"top_k/10",         benchTopK<BINARY_HEAP, false>},
+        {"top_k/10/4-ary",   benchTopK<QUATERNARY_HEAP, false>},
+        {"std_map/16",       benchSmallMap<false>},
+        {"flat_map/16",      benchSmallMap<true>},
+        {"std_unordered/6",  benchHashMap<ATTRIBUTES, true>},
+        {"hash_map/6",       benchHashMap<ATTRIBUTES, false>},
+        {"std_unordered/4096", benchHashMap<SORTED_SIZE, true>},
+        {"hash_map/4096",    benchHashMap<SORTED_SIZE, false>},
+        {"mask_count/vector_bool", benchMaskCount<false>},
+        {"mask_count/bits",  benchMaskCount<true>},
+        {"std_string/identifiers", benchIdentifiers<true>},
+        {"string/identifiers", benchIdentifiers<false>},
+        {"std_string/find",  benchSubstring<true>},
+        {"string/find",      benchSubstring<false>},
+        {"adjacency/nested", benchAdjacency<Adjacency::Nested>},
+        {"adjacency/hybrid", benchAdjacency<Adjacency::Hybrid>},
+        {"adjacency/csr",    benchAdjacency<Adjacency::Csr>},
+};
+
+/**
+ * @brief Prints a result line. Counters the kernel did not allow are printed as "-".
+ */
+static void printResult(BenchmarkResult const &result)
+{
+    double ops = (double) result.ops;
+    std::printf("%-20s %10.2f", result.name.c_str(), result.nanos / ops);
+    for (size_t event = 0; event < PERF_EVENTS_AMOUNT; ++event)
+    {
+        if (result.counters.valid[event])
+        {
+            std::printf(" %14.3f", (double) result.counters.values[event] / ops);
+        }
+        else
+        {
+            std::printf(" %14s", "-");
+        }
+    }
+    std::printf(" %10.4f %12.2f\n", (double) result.allocs.allocations / ops, (double) result.allocs.bytes / ops);
+}
+
+/**
+ * @brief Runs a benchmark repeat times, prints its median run and records the samples into set.
+ */
+static void runBenchmark(PerfCounters &counters, Benchmark const &bench, size_t ops, size_t repeat,
+                         BenchmarkSet &set)
+{
+    std::vector<BenchmarkResult> runs;
+    BenchmarkSamples &samples = set[bench.name];
+    for (size_t run = 0; run < repeat; ++run)
+    {
+        runs.push_back(measure(counters, bench.name, ops, [&bench, ops]()
+        { bench.run(ops); }));
+        samples.nanosPerOp.push_back(runs.back().nanos / (double) ops);
+    }
+    std::sort(runs.begin(), runs.end(), [](BenchmarkResult const &lhs, BenchmarkResult const &rhs)
+    { return lhs.nanos < rhs.nanos; });
+    BenchmarkResult const &mid = runs[runs.size() / 2];
+    samples.allocsPerOp = (double) mid.allocs.allocations / (double) ops;
+    printResult(mid);
+}
+
+/**
+ * @brief Compares the operation name to the baseline again, in up to confirm separate processes of the executable
+ * self, each running only that operation with the same settings.
+ * @return true if it failed in every one of them.
+ */
+static bool confirmFailure(const char *self, std::string const &name, size_t ops, size_t repeat,
+                           const char *baselinePath, double threshold, double alpha, bool allowNew, size_t confirm)
+{
+    for (size_t run = 1; run <= confirm; ++run)
+    {
+        std::printf("\nconfirming %s in a separate process (%zu of %zu)\n", name.c_str(), run, confirm);
+        std::fflush(stdout);
+        char settings[192];
+        std::snprintf(settings, sizeof(settings), " --ops %zu --repeat %zu --threshold %.17g --alpha %.17g%s", ops,
+                      repeat, threshold, alpha, allowNew ? " --allow-new" : "");
+        std::string command = std::string("'") + self + "' --confirm 0 --only '" + name + "' --baseline '" +
+                              baselinePath + "'" + settings;
+        if (std::system(command.c_str()) == 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    size_t ops = DEFAULT_OPS, repeat = DEFAULT_REPEAT, confirm = DEFAULT_CONFIRM;
+    const char *filter = nullptr, *jsonPath = nullptr, *baselinePath = nullptr;
+    std::vector<std::string> only;
+    double threshold = DEFAULT_THRESHOLD, alpha = DEFAULT_ALPHA;
+    bool allowNew = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!std::strcmp(argv[i], "--ops") && i + 1 < argc)
+        {
+            ops = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if (!std::strcmp(argv[i], "--filter") && i + 1 < argc)
+        {
+            filter = argv[++i];
+        }
+        else if (!std::strcmp(argv[i], "--only") && i + 1 < argc)
+        {
+            only.push_back(argv[++i]);
+        }
+        else if (!std::strcmp(argv[i], "--confirm") && i + 1 < argc)
+        {
+            confirm = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if (!std::strcmp(argv[i], "--repeat") && i + 1 < argc)
+        {
+            repeat = std::max<size_t>(1, std::strtoull(argv[++i], nullptr, 10));
+        }
+        else if (!std::strcmp(argv[i], "--json") && i + 1 < argc)
+        {
+            jsonPath = argv[++i];
+        }
+        else if (!std::strcmp(argv[i], "--baseline") && i + 1 < argc)
+        {
+            baselinePath = argv[++i];
+        }
+        else if (!std::strcmp(argv[i], "--threshold") && i + 1 < argc)
+        {
+            threshold = std::strtod(argv[++i], nullptr);
+        }
+        else if (!std::strcmp(argv[i], "--alpha") && i + 1 < argc)
+        {
+            alpha = std::strtod(argv[++i], nullptr);
+        }
+        else if (!std::strcmp(argv[i], "--allow-new"))
+        {
+            allowNew = true;
+        }
+        else
+        {
+            std::fputs(USAGE_MSG, stderr);
+            return EXIT_FAILURE;
+        }
+    }
+    if (!ops)
+    {
+        std::fputs(USAGE_MSG, stderr);
+        return EXIT_FAILURE;
+    }
+
+    PerfCounters counters;
+    if (!counters.available())
+    {
+        std::fputs("hardware counters are not available here, reporting wall time and allocations only.\n", stderr);
+    }
+    std::printf("%-20s %10s", "operation", "ns/op");
+    for (size_t event = 0; event < PERF_EVENTS_AMOUNT; ++event)
+    {
+        std::printf(" %14s", perfEventName(event));
+    }
+    std::printf(" %10s %12s\n", "allocs/op", "bytes/op");
+    BenchmarkSet results;
+    for (Benchmark const &bench : BENCHMARKS)
+    {
+        if ((filter && !std::strstr(bench.name, filter)) ||
+            (!only.empty() && std::find(only.begin(), only.end(), bench.name) == only.end()))
+        {
+            continue;
+        }
+        runBenchmark(counters, bench, ops, repeat, results);
+    }
+
+    if (jsonPath && !writeBaseline(jsonPath, results))
+    {
+        std::fprintf(stderr, "can not write %s\n", jsonPath);
+        return EXIT_FAILURE;
+    }
+    if (baselinePath)
+    {
+        BenchmarkSet baseline;
+        try
+        {
+            baseline = BaselineReader().read(baselinePath);
+        }
+        catch (std::runtime_error const &e)
+        {
+            std::fprintf(stderr, "%s\n", e.what());
+            return EXIT_FAILURE;
+        }
+        for (auto entry = baseline.begin(); (filter || !only.empty()) && entry != baseline.end();)
+        {
+            entry = results.count(entry->first) ? std::next(entry) : baseline.erase(entry); //not selected to run.
+        }
+        std::vector<std::string> failed;
+        compareToBaseline(results, baseline, threshold, alpha, allowNew, &failed);
+        size_t regressions = 0;
+        for (std::string const &name : failed)
+        {
+            regressions += confirmFailure(argv[0], name, ops, repeat, baselinePath, threshold, alpha, allowNew,
+                                          confirm);
+        }
+        if (regressions)
+        {
+            std::printf("\n%zu operation(s) regressed beyond %.2fx (alpha %.4f) in %zu process(es), or are not in the "
+                        "baseline.\n", regressions, threshold, alpha, confirm + 1);
+            return EXIT_FAILURE;
+        }
+        std::printf("\nNo regressions beyond %.2fx (alpha %.4f)", threshold, alpha);
+        if (!failed.empty())
+        {
+            std::printf(", %zu not confirmed in separate processes", failed.size());
+        }
+        std::printf(".\n");
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,30 @@
+#!/bin/sh
+# Builds the VLVector benchmarks and compares a fresh run against the checked-in baseline.
+# Fails (exit status 1) and prints the per-operation diff if any operation regressed or has no samples in the baseline.
+# An operation failing the comparison is re-measured in CONFIRM separate processes and fails only if it fails in all.
+#
+# Usage: regression_gate.sh [--update] [extra VLVectorBenchmark flags, e.g. --threshold 1.25 or --allow-new]
+#   --update  re-records baseline.json on this machine instead of comparing against it.
+# A change adding a benchmark re-records the baseline with it; --allow-new lets operations without samples pass.
+# Environment: CXX (default g++), REPEAT (default 15), OPS (default 200000), BASELINE (default baseline.json),
+#              CONFIRM (default 2).
+set -e
+
+DIR=$(cd "$(dirname "$0")" && pwd)
+CXX=${CXX:-g++}
+REPEAT=${REPEAT:-15}
+OPS=${OPS:-200000}
+CONFIRM=${CONFIRM:-2}
+BASELINE=${BASELINE:-$DIR/baseline.json}
+BIN=${TMPDIR:-/tmp}/VLVectorBenchmark.$$
+
+trap 'rm -f "$BIN"' EXIT
+"$CXX" -std=c++17 -O2 -I"$DIR/.." "$DIR/VLVectorBenchmark.cpp" -o "$BIN"
+
+if [ "$1" = "--update" ]; then
+    shift
+    "$BIN" --ops "$OPS" --repeat "$REPEAT" --json "$BASELINE" "$@"
+    echo "baseline written to $BASELINE"
+else
+    "$BIN" --ops "$OPS" --repeat "$REPEAT" --confirm "$CONFIRM" --baseline "$BASELINE" "$@"
+fi
@@ -0,0 +1,22 @@
+#!/bin/sh
+# Replays a VLVector trace (see VLVectorTrace.hpp) under several growth and shrink settings.
+#
+# Usage: replay_trace.sh TRACE_FILE [--repeat R]
+# Environment: CXX (default g++), GROWTH (default "3/2 2"), SHRINK (default "true false").
+set -e
+
+DIR=$(cd "$(dirname "$0")" && pwd)
+CXX=${CXX:-g++}
+GROWTH=${GROWTH:-"3/2 2"}
+SHRINK=${SHRINK:-"true false"}
+BIN=${TMPDIR:-/tmp}/TraceReplay.$$
+
+trap 'rm -f "$BIN"' EXIT
+for growth in $GROWTH; do
+    for shrink in $SHRINK; do
+        "$CXX" -std=c++17 -O2 -I"$DIR/.." "-DINCREASE_FACTOR=$growth" "-DSHRINK_TO_STATIC=$shrink" \
+            "$DIR/TraceReplay.cpp" -o "$BIN"
+        "$BIN" "$@"
+        echo
+    done
+done
@@ -0,0 +1,122 @@
+/**
+ * @file RegressionGateTest.cpp
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ *
+ * @brief Tests of the statistics and the baseline files of benchmark/RegressionGate.hpp: the one sided Mann-Whitney U
+ * test against p-values worked out by hand, with and without ties, and writeBaseline and BaselineReader round trips,
+ * unknown keys and malformed files.
+ */
+#include "TestCheck.hpp"
+#include "../benchmark/RegressionGate.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#define P_TOLERANCE 1e-6
+
+/**
+ * @brief mannWhitneyGreater of separated, tied, equal, shifted and empty samples.
+ */
+static void testMannWhitney(TestRandom &random)
+{
+    // U = 9 of 9, mean 4.5, variance 5.25.
+    CHECK(std::fabs(mannWhitneyGreater({4, 5, 6}, {1, 2, 3}) - 0.0404278) < P_TOLERANCE);
+    // Four tied 3s: U = 14, mean 8, variance 16 / 12 * (9 - 60 / 56).
+    CHECK(std::fabs(mannWhitneyGreater({3, 3, 4, 5}, {1, 2, 3, 3}) - 0.0453618) < P_TOLERANCE);
+    CHECK(std::fabs(mannWhitneyGreater({1, 2, 3, 3}, {3, 3, 4, 5}) - 0.9772042) < P_TOLERANCE);
+    CHECK(mannWhitneyGreater({2, 2, 2}, {2, 2, 2, 2}) == 1);
+    CHECK(mannWhitneyGreater({}, {1, 2}) == 1 && mannWhitneyGreater({1, 2}, {}) == 1);
+
+    std::vector<double> baseline, same, slower;
+    for (size_t sample = 0; sample < 15; ++sample)
+    {
+        double noise = (double) below(random, 1000) / 10000;
+        baseline.push_back(1 + noise);
+        same.push_back(1 + (double) below(random, 1000) / 10000);
+        slower.push_back(1.5 + noise);
+    }
+    CHECK(mannWhitneyGreater(slower, baseline) < 1e-4);
+    CHECK(mannWhitneyGreater(baseline, slower) > 1 - 1e-4);
+    double p = mannWhitneyGreater(same, baseline);
+    CHECK(p > 1e-3 && p < 1 - 1e-3);
+}
+
+/**
+ * @brief Writes text to path.
+ */
+static void writeFile(std::string const &path, std::string const &text)
+{
+    FILE *out = std::fopen(path.c_str(), "w");
+    CHECK(out != nullptr);
+    if (out)
+    {
+        std::fputs(text.c_str(), out);
+        std::fclose(out);
+    }
+}
+
+/**
+ * @return true if reading path throws std::runtime_error.
+ */
+static bool readThrows(std::string const &path)
+{
+    try
+    {
+        BaselineReader().read(path.c_str());
+    }
+    catch (std::runtime_error const &)
+    {
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief A written benchmark set reads back equal, unknown keys and empty sample lists are read, and malformed or
+ * missing files throw.
+ */
+static void testBaselineFiles(std::string const &path)
+{
+    BenchmarkSet written;
+    written["push_back/inline"].nanosPerOp = {1.25, 1.5, 0.0625};
+    written["push_back/inline"].allocsPerOp = 0.5;
+    written["sort/4096"].nanosPerOp = {9.8125};
+    written["empty"];
+    CHECK(writeBaseline(path.c_str(), written));
+    BenchmarkSet read = BaselineReader().read(path.c_str());
+    CHECK(read.size() == written.size());
+    for (auto const &entry : written)
+    {
+        CHECK(read.count(entry.first) && read[entry.first].nanosPerOp == entry.second.nanosPerOp &&
+              read[entry.first].allocsPerOp == entry.second.allocsPerOp);
+    }
+
+    writeFile(path, "{\"machine\": {\"cpu\": \"x\", \"flags\": [1, 2.5e3, true, null], \"none\": {}},\n"
+                    " \"benchmarks\": [{\"name\": \"a\", \"note\": [], \"ns_per_op\": [2, 3e-1], \"allocs_per_op\": 1},"
+                    " {\"ns_per_op\": [], \"name\": \"b\"}], \"version\": 1}");
+    read = BaselineReader().read(path.c_str());
+    CHECK(read.size() == 2 && read["a"].nanosPerOp == std::vector<double>({2, 0.3}) && read["a"].allocsPerOp == 1);
+    CHECK(read["b"].nanosPerOp.empty() && read["b"].allocsPerOp == 0);
+
+    for (const char *malformed : {"", "{", "[]", "{\"benchmarks\": [{\"name\": \"a\", \"ns_per_op\": [1,]}]}",
+                                  "{\"benchmarks\": [{\"name\": \"a\"}", "{\"benchmarks\": [{\"name: 1}]}",
+                                  "{\"benchmarks\": [{\"name\": \"a\", \"ns_per_op\": [x]}]}"})
+    {
+        writeFile(path, malformed);
+        CHECK(readThrows(path));
+    }
+    std::remove(path.c_str());
+    CHECK(readThrows(path));
+}
+
+int main(int, char **argv)
+{
+    TestRandom random(TEST_SEED);
+    testMannWhitney(random);
+    testBaselineFiles(std::string(argv[0]) + ".json");
+    return testResult("RegressionGateTest");
+}
@@ -0,0 +1,158 @@
+/**
+ * @file TestCheck.hpp
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ *
+ * @brief The checks shared by the VLVector tests.
+ *
+ * @section DESCRIPTION Every test is a program of its own, which checks with CHECK and returns testResult() from main.
+ * A failed check is printed with its place and the test goes on, so one run reports all of the failures. Randomized
+ * tests draw from a TestRandom seeded with TEST_SEED (override it with -DTEST_SEED=N to reproduce another run), and
+ * compare the container to its std equivalent after every operation, with sameElements and the container specific
+ * checks of the test. Their string elements come from makeValue, and their element arguments from randomArgument, which
+ * often aliases an element of the tested container. A ThrowingElement fails the allocations of a container on demand.
+ * run_tests.sh builds and runs them all.
+ */
+#ifndef CPP_EXAM_TESTCHECK_HPP
+#define CPP_EXAM_TESTCHECK_HPP
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <string>
+
+#ifndef TEST_SEED
+#define TEST_SEED 20200807
+#endif
+
+#define RANDOM_OPS 20000
+
+#define STRING_PADDING "-padded-past-the-small-string-buffer"
+
+#define CHECK(...) checkImpl((__VA_ARGS__), #__VA_ARGS__, __FILE__, __LINE__)
+
+typedef std::mt19937_64 TestRandom;
+
+/**
+ * An element whose default construction throws std::bad_alloc while throwing() is set, the way the allocation of an
+ * array of them would fail.
+ */
+struct ThrowingElement
+{
+    int value = 0;
+
+    ThrowingElement()
+    {
+        if (throwing())
+        {
+            throw std::bad_alloc();
+        }
+    }
+
+    ThrowingElement(int value) noexcept: value(value)
+    {
+    }
+
+    bool operator==(ThrowingElement const &rhs) const noexcept
+    {
+        return value == rhs.value;
+    }
+
+    static bool &throwing() noexcept
+    {
+        static bool throwing = false;
+        return throwing;
+    }
+};
+
+/**
+ * @return The amount of failed checks so far.
+ */
+inline int &failedChecks() noexcept
+{
+    static int failed = 0;
+    return failed;
+}
+
+/**
+ * @brief Counts and prints a failed check. Use CHECK.
+ */
+inline bool checkImpl(bool passed, const char *condition, const char *file, int line) noexcept
+{
+    if (!passed && ++failedChecks() <= 20)
+    {
+        std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", file, line, condition);
+    }
+    return passed;
+}
+
+/**
+ * @return A random value in [0, bound).
+ */
+inline size_t below(TestRandom &random, size_t bound)
+{
+    return (size_t) (random() % bound);
+}
+
+/**
+ * @return A value whose copies own heap memory, so a read of a freed element is caught by the sanitizer.
+ */
+inline std::string makeValue(TestRandom &random)
+{
+    return std::to_string(below(random, 1000)) + STRING_PADDING;
+}
+
+/**
+ * @brief Draws the element argument of a random operation: half of the time the element at of the tested container
+ * itself, which the operation must read before it moves or frees any element, otherwise a new value.
+ * @param value Set to the value of the argument, for the std container.
+ * @return The argument, for the tested container.
+ */
+template<class Tested, class Expected>
+inline std::string const &randomArgument(TestRandom &random, Tested const &tested, Expected const &expected, size_t at,
+                                         std::string &value)
+{
+    bool alias = !expected.empty() && below(random, 2);
+    value = alias ? expected[at] : makeValue(random);
+    return alias ? tested[at] : value;
+}
+
+/**
+ * @return true if tested holds the elements of expected, by iteration and by index.
+ */
+template<class Tested, class Expected>
+inline bool sameElements(Tested const &tested, Expected const &expected)
+{
+    if (tested.size() != expected.size() || !std::equal(tested.begin(), tested.end(), expected.begin()))
+    {
+        return false;
+    }
+    for (size_t idx = 0; idx < expected.size(); ++idx)
+    {
+        if (!(tested[idx] == expected[idx]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Prints the outcome of the test.
+ * @return The exit status of the test.
+ */
+inline int testResult(const char *name) noexcept
+{
+    if (failedChecks())
+    {
+        std::printf("%s: %d check(s) failed\n", name, failedChecks());
+        return EXIT_FAILURE;
+    }
+    std::printf("%s: ok\n", name);
+    return EXIT_SUCCESS;
+}
+
+
+#endif //CPP_EXAM_TESTCHECK_HPP
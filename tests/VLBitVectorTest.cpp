@@ -0,0 +1,210 @@
+/**
+ * @file VLBitVectorTest.cpp
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ *
+ * @brief Randomized tests of VLBitVector and VLRankSelect against std::vector<bool>.
+ */
+#include "TestCheck.hpp"
+#include "../VLBitVector.hpp"
+
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#define ROUNDS 300
+
+#define MAX_BITS 3000
+
+#define TEST_STATIC_BITS 128
+
+typedef VLBitVector<TEST_STATIC_BITS> Bits;
+
+/**
+ * @return true if bits holds the bits of expected, counts them alike and keeps the bits past its size clear.
+ */
+static bool same(Bits const &bits, std::vector<bool> const &expected)
+{
+    if (bits.size() != expected.size())
+    {
+        return false;
+    }
+    size_t count = 0;
+    for (size_t idx = 0; idx < expected.size(); ++idx)
+    {
+        if (bits[idx] != expected[idx])
+        {
+            return false;
+        }
+        count += expected[idx];
+    }
+    bool tailClear = !bits.word_count() || !(bits.size() % 64) ||
+                     !(bits.data()[bits.word_count() - 1] >> (bits.size() % 64));
+    return bits.count() == count && bits.any() == (count > 0) && bits.none() == (count == 0) && tailClear;
+}
+
+/**
+ * @brief Pushes size random bits, each set with probability density / 4, to both of the containers.
+ */
+static void randomBits(TestRandom &random, size_t size, size_t density, Bits &bits, std::vector<bool> &expected)
+{
+    for (size_t idx = 0; idx < size; ++idx)
+    {
+        bool value = below(random, 4) < density;
+        bits.push_back(value);
+        expected.push_back(value);
+    }
+}
+
+/**
+ * @brief find_first, find_next, rank and select of the bit vector and of a VLRankSelect built on it, against a scan.
+ */
+static void checkQueries(TestRandom &random, Bits const &bits, std::vector<bool> const &expected)
+{
+    std::vector<size_t> ones;
+    for (size_t idx = 0; idx < expected.size(); ++idx)
+    {
+        if (expected[idx])
+        {
+            ones.push_back(idx);
+        }
+    }
+    CHECK(bits.find_first() == (ones.empty() ? expected.size() : ones.front()));
+    for (size_t idx = 0; idx < expected.size(); idx += 1 + below(random, 7))
+    {
+        size_t next = idx + 1;
+        while (next < expected.size() && !expected[next])
+        {
+            ++next;
+        }
+        CHECK(bits.find_next(idx) == next);
+    }
+    VLRankSelect index(bits);
+    CHECK(index.count() == ones.size());
+    size_t rank = 0;
+    for (size_t idx = 0; idx <= expected.size(); ++idx)
+    {
+        CHECK(bits.rank(idx) == rank && index.rank(idx) == rank);
+        rank += idx < expected.size() && expected[idx];
+    }
+    for (size_t k = 0; k <= ones.size(); ++k)
+    {
+        size_t place = k < ones.size() ? ones[k] : expected.size();
+        CHECK(bits.select(k) == place && index.select(k) == place);
+    }
+}
+
+/**
+ * @brief Random bit vectors of random densities: their queries, a bulk operation with another of a different size,
+ * single bit edits, resizing and filling.
+ */
+static void testRandomBits()
+{
+    TestRandom random(TEST_SEED);
+    for (size_t round = 0; round < ROUNDS; ++round)
+    {
+        Bits bits, other;
+        std::vector<bool> expected, otherExpected;
+        randomBits(random, below(random, MAX_BITS), below(random, 5), bits, expected);
+        randomBits(random, below(random, MAX_BITS), 2, other, otherExpected);
+        CHECK(same(bits, expected));
+        checkQueries(random, bits, expected);
+
+        Bits combined = bits;
+        std::vector<bool> combinedExpected = expected;
+        size_t op = below(random, 4);
+        for (size_t idx = 0; idx < combinedExpected.size(); ++idx)
+        {
+            bool rhs = idx < otherExpected.size() && otherExpected[idx];
+            bool lhs = combinedExpected[idx];
+            combinedExpected[idx] = op == 0 ? lhs && rhs : op == 1 ? lhs || rhs : op == 2 ? lhs != rhs : lhs && !rhs;
+        }
+        if (op == 0)
+        {
+            combined &= other;
+        }
+        else if (op == 1)
+        {
+            combined |= other;
+        }
+        else if (op == 2)
+        {
+            combined ^= other;
+        }
+        else
+        {
+            combined.and_not(other);
+        }
+        CHECK(same(combined, combinedExpected));
+
+        for (size_t edit = 0; edit < 200 && !expected.empty(); ++edit)
+        {
+            size_t idx = below(random, expected.size());
+            switch (below(random, 4))
+            {
+                case 0:
+                    bits.set(idx);
+                    expected[idx] = true;
+                    break;
+                case 1:
+                    bits.reset(idx);
+                    expected[idx] = false;
+                    break;
+                case 2:
+                    bits.flip(idx);
+                    expected[idx] = !expected[idx];
+                    break;
+                default:
+                    bits.pop_back();
+                    expected.pop_back();
+                    break;
+            }
+        }
+        CHECK(same(bits, expected));
+        checkQueries(random, bits, expected);
+
+        size_t newSize = below(random, MAX_BITS);
+        bool value = below(random, 2);
+        bits.resize(newSize, value);
+        expected.resize(newSize, value);
+        CHECK(same(bits, expected));
+        bits.fill(true);
+        expected.assign(expected.size(), true);
+        CHECK(same(bits, expected) && bits == Bits(expected.size(), true) && !(bits != bits));
+    }
+}
+
+/**
+ * @brief Bits within the static capacity do not allocate, test checks its index, and a moved bit vector is empty.
+ */
+static void testEdges()
+{
+    Bits bits;
+    for (size_t idx = 0; idx < TEST_STATIC_BITS; ++idx)
+    {
+        bits.push_back(idx % 3 == 0);
+    }
+    CHECK(bits.capacity() == TEST_STATIC_BITS);
+    bool thrown = false;
+    try
+    {
+        bits.test(TEST_STATIC_BITS);
+    }
+    catch (std::out_of_range const &)
+    {
+        thrown = true;
+    }
+    CHECK(thrown && bits.test(0) && !bits.test(1));
+
+    Bits moved(std::move(bits));
+    CHECK(moved.size() == TEST_STATIC_BITS && bits.empty() && bits.count() == 0);
+    bits.push_back(true);
+    CHECK(bits.size() == 1 && bits.count() == 1);
+}
+
+int main()
+{
+    testRandomBits();
+    testEdges();
+    return testResult("VLBitVectorTest");
+}
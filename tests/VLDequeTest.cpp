@@ -0,0 +1,179 @@
+/**
+ * @file VLDequeTest.cpp
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ *
+ * @brief Randomized tests of VLDeque against std::deque, and of the slack before it shrinks back to static storage.
+ */
+#include "TestCheck.hpp"
+#include "../VLDeque.hpp"
+
+#include <deque>
+#include <string>
+
+/**
+ * @return true if deque holds the elements of expected, by index and by iteration.
+ */
+template<class T, size_t StaticCapacity>
+static bool same(VLDeque<T, StaticCapacity> const &deque, std::deque<T> const &expected)
+{
+    return sameElements(deque, expected) && deque.capacity() >= deque.size() &&
+           !(deque.capacity() & (deque.capacity() - 1));
+}
+
+/**
+ * @brief Random pushes and pops at both ends, biased in turns toward growing and toward shrinking so the ring wraps,
+ * grows and shrinks back to the static storage. The pushed values are often elements of the deque itself.
+ */
+template<size_t StaticCapacity>
+static void testRandomOps()
+{
+    TestRandom random(TEST_SEED + StaticCapacity);
+    VLDeque<std::string, StaticCapacity> deque;
+    std::deque<std::string> expected;
+    for (size_t op = 0; op < RANDOM_OPS; ++op)
+    {
+        bool growing = (op / 500) % 2 == 0;
+        size_t at = expected.empty() ? 0 : below(random, expected.size());
+        std::string value;
+        std::string const &argument = randomArgument(random, deque, expected, at, value);
+        switch (below(random, growing ? 6 : 8))
+        {
+            case 0:
+            case 1:
+                deque.push_back(argument);
+                expected.push_back(value);
+                break;
+            case 2:
+            case 3:
+                deque.push_front(argument);
+                expected.push_front(value);
+                break;
+            case 4:
+            case 6:
+                if (!expected.empty())
+                {
+                    deque.pop_back();
+                    expected.pop_back();
+                }
+                break;
+            default:
+                if (!expected.empty())
+                {
+                    deque.pop_front();
+                    expected.pop_front();
+                }
+                break;
+        }
+        CHECK(same(deque, expected));
+        if (!expected.empty())
+        {
+            CHECK(deque.front() == expected.front() && deque.back() == expected.back());
+            at %= expected.size();
+            CHECK(deque.at(at) == expected.at(at));
+        }
+    }
+    VLDeque<std::string, StaticCapacity> copy(deque);
+    CHECK(same(copy, expected) && copy == deque);
+    deque.clear();
+    CHECK(deque.empty() && deque.capacity() == (VLDeque<std::string, StaticCapacity>::STATIC_CAPACITY));
+}
+
+/**
+ * @brief A copy is sized by the copied elements, not by the capacity the copied deque kept, and a failed allocation
+ * leaves the assigned deque as it was.
+ */
+static void testCopy()
+{
+    VLDeque<int, 8> shrunk;
+    for (int i = 0; i < 64; ++i)
+    {
+        shrunk.push_back(i);
+    }
+    while (shrunk.size() > 20)
+    {
+        shrunk.pop_front();
+    }
+    VLDeque<int, 8> copy(shrunk);
+    CHECK(copy == shrunk && shrunk.capacity() == 64 && copy.capacity() == 32);
+    VLDeque<int, 8> slack;
+    for (int i = 0; i < 9; ++i)
+    {
+        slack.push_back(i);
+    }
+    while (slack.size() > 5)
+    {
+        slack.pop_front();
+    }
+    VLDeque<int, 8> fitting(slack);
+    CHECK(fitting == slack && slack.capacity() == 16 && fitting.capacity() == 8);
+    copy = slack;
+    CHECK(copy == slack && copy.capacity() == (SHRINK_TO_STATIC ? 8 : 32));
+
+    VLDeque<ThrowingElement, 8> small, large;
+    for (int i = 0; i < 20; ++i)
+    {
+        small.push_back(i);
+    }
+    for (int i = 0; i < 100; ++i)
+    {
+        large.push_back(-i);
+    }
+    VLDeque<ThrowingElement, 8> before(small);
+    bool thrown = false;
+    ThrowingElement::throwing() = true;
+    try
+    {
+        small = large;
+    }
+    catch (std::bad_alloc const &)
+    {
+        thrown = true;
+    }
+    ThrowingElement::throwing() = false;
+    CHECK(thrown && small == before && small.capacity() == 32);
+    small = large;
+    CHECK(small == large && small.capacity() == 128);
+}
+
+/**
+ * @brief A queue whose size goes back and forth across the static capacity stays in its dynamic array, and only
+ * returns to the static storage once it fills a DEQUE_SHRINK_RATIO-th of it.
+ */
+static void testShrinkHysteresis()
+{
+    VLDeque<int, 8> deque;
+    for (int i = 0; i < 9; ++i)
+    {
+        deque.push_back(i);
+    }
+    CHECK(deque.capacity() == 16);
+    for (int i = 0; i < 100; ++i)
+    {
+        deque.pop_front();
+        CHECK(deque.capacity() == 16);
+        deque.push_back(i);
+        CHECK(deque.capacity() == 16);
+    }
+    while (deque.size() > 16 / DEQUE_SHRINK_RATIO + 1)
+    {
+        deque.pop_back();
+        CHECK(deque.capacity() == 16);
+    }
+    deque.pop_back();
+    CHECK(deque.capacity() == 8 && deque.size() == 16 / DEQUE_SHRINK_RATIO);
+    for (size_t idx = 0; idx < deque.size(); ++idx)
+    {
+        CHECK(deque[idx] == 91 + (int) idx);
+    }
+}
+
+int main()
+{
+    testRandomOps<1>();
+    testRandomOps<4>();
+    testRandomOps<16>();
+    testShrinkHysteresis();
+    testCopy();
+    return testResult("VLDequeTest");
+}
@@ -0,0 +1,191 @@
+/**
+ * @file VLFlatMapTest.cpp
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ *
+ * @brief Randomized tests of VLFlatMap against std::map and of VLFlatSet against std::set, in the default order, which
+ * searches arithmetic keys by SIMD, and in others.
+ */
+#include "TestCheck.hpp"
+#include "../VLFlatMap.hpp"
+
+#include <functional>
+#include <iterator>
+#include <map>
+#include <set>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Keys of type K drawn from a range of about range values.
+ */
+template<class K>
+static K makeKey(TestRandom &random, size_t range)
+{
+    if constexpr (std::is_same<K, std::string>::value)
+    {
+        return "key-" + std::to_string(below(random, range));
+    }
+    else
+    {
+        return (K) below(random, range) - (K) (range / 4);
+    }
+}
+
+/**
+ * @return true if map holds the entries of expected, in order.
+ */
+template<class K, class V, size_t StaticCapacity, class Compare>
+static bool same(VLFlatMap<K, V, StaticCapacity, Compare> const &map, std::map<K, V, Compare> const &expected)
+{
+    if (map.size() != expected.size())
+    {
+        return false;
+    }
+    auto entry = expected.begin();
+    for (auto iter = map.begin(); iter != map.end(); ++iter, ++entry)
+    {
+        if (iter.key() != entry->first || iter->second != entry->second)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Random inserts, assignments, lookups, erases and batch inserts, with keys from a range which grows in turns
+ * so the map crosses both its static capacity and the size up to which its keys are scanned rather than searched.
+ */
+template<class K, class Compare>
+static void testMap()
+{
+    TestRandom random(TEST_SEED);
+    VLFlatMap<K, int, 8, Compare> map;
+    std::map<K, int, Compare> expected;
+    for (size_t op = 0; op < RANDOM_OPS; ++op)
+    {
+        size_t range = (op / 2000) % 2 ? 40 : 400;
+        K key = makeKey<K>(random, range);
+        int value = (int) below(random, 1000);
+        switch (below(random, 8))
+        {
+            case 0:
+            {
+                auto inserted = map.insert(key, value);
+                auto stdInserted = expected.insert({key, value});
+                CHECK(inserted.second == stdInserted.second && inserted.first.value() == stdInserted.first->second);
+                break;
+            }
+            case 1:
+                CHECK(map.insert_or_assign(key, value).second == expected.insert_or_assign(key, value).second);
+                break;
+            case 2:
+                map[key] += value;
+                expected[key] += value;
+                break;
+            case 3:
+                CHECK(map.erase(key) == expected.erase(key));
+                break;
+            case 4:
+                if (!expected.empty())
+                {
+                    size_t idx = below(random, expected.size());
+                    auto next = map.erase(typename VLFlatMap<K, int, 8, Compare>::const_iterator(&map, idx));
+                    expected.erase(std::next(expected.begin(), (ptrdiff_t) idx));
+                    CHECK(next.index() == idx);
+                }
+                break;
+            case 5:
+            {
+                std::vector<std::pair<K, int>> batch(below(random, 20));
+                for (auto &entry : batch)
+                {
+                    entry = {makeKey<K>(random, range), (int) below(random, 1000)};
+                }
+                map.insert_range(batch.begin(), batch.end());
+                expected.insert(batch.begin(), batch.end());
+                break;
+            }
+            default:
+            {
+                auto found = map.find(key);
+                auto stdFound = expected.find(key);
+                CHECK((found == map.end()) == (stdFound == expected.end()));
+                CHECK(found == map.end() || found.value() == stdFound->second);
+                CHECK(map.contains(key) == (stdFound != expected.end()) && map.count(key) == expected.count(key));
+                auto bound = map.lower_bound(key);
+                CHECK(bound.index() == (size_t) std::distance(expected.begin(), expected.lower_bound(key)));
+                if (stdFound != expected.end())
+                {
+                    CHECK(map.at(key) == stdFound->second);
+                }
+                if (!below(random, 256))
+                {
+                    map.clear();
+                    expected.clear();
+                }
+                break;
+            }
+        }
+        CHECK(same(map, expected));
+    }
+    VLFlatMap<K, int, 8, Compare> copy(map);
+    CHECK(copy == map);
+}
+
+/**
+ * @brief Random inserts, erases, lookups and batch inserts of a VLFlatSet.
+ */
+template<class K, class Compare>
+static void testSet()
+{
+    TestRandom random(TEST_SEED);
+    VLFlatSet<K, 8, Compare> set;
+    std::set<K, Compare> expected;
+    for (size_t op = 0; op < RANDOM_OPS; ++op)
+    {
+        size_t range = (op / 2000) % 2 ? 40 : 400;
+        K key = makeKey<K>(random, range);
+        switch (below(random, 5))
+        {
+            case 0:
+                CHECK(set.insert(key).second == expected.insert(key).second);
+                break;
+            case 1:
+                CHECK(set.erase(key) == expected.erase(key));
+                break;
+            case 2:
+            {
+                std::vector<K> batch(below(random, 20));
+                for (K &element : batch)
+                {
+                    element = makeKey<K>(random, range);
+                }
+                set.insert_range(batch.begin(), batch.end());
+                expected.insert(batch.begin(), batch.end());
+                break;
+            }
+            default:
+                CHECK(set.contains(key) == (expected.count(key) > 0) && set.count(key) == expected.count(key));
+                CHECK((size_t) (set.lower_bound(key) - set.begin()) ==
+                      (size_t) std::distance(expected.begin(), expected.lower_bound(key)));
+                break;
+        }
+        CHECK(set.size() == expected.size() && std::equal(set.begin(), set.end(), expected.begin()));
+    }
+}
+
+int main()
+{
+    testMap<int, std::less<int>>();
+    testMap<double, std::less<double>>();
+    testMap<int, std::greater<int>>();
+    testMap<std::string, std::less<std::string>>();
+    testSet<int, std::less<int>>();
+    testSet<unsigned char, std::less<unsigned char>>();
+    testSet<std::string, std::greater<std::string>>();
+    return testResult("VLFlatMapTest");
+}
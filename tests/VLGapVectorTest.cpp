@@ -0,0 +1,172 @@
+/**
+ * @file VLGapVectorTest.cpp
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ *
+ * @brief Randomized tests of VLGapVector against std::vector, with edits both at a moving cursor and anywhere.
+ */
+#include "TestCheck.hpp"
+#include "../VLGapVector.hpp"
+
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/**
+ * @return true if vec holds the elements of expected, by index and by iteration. Does not close the gap.
+ */
+template<class T, size_t StaticCapacity>
+static bool same(VLGapVector<T, StaticCapacity> const &vec, std::vector<T> const &expected)
+{
+    return sameElements(vec, expected) && vec.capacity() >= vec.size() && vec.gap() <= vec.size();
+}
+
+/**
+ * @brief Random edits, half of them at a cursor which moves by small steps like the one of an editor and half of them
+ * anywhere. The inserted values are often elements of the vector itself.
+ */
+template<size_t StaticCapacity>
+static void testRandomOps()
+{
+    TestRandom random(TEST_SEED + StaticCapacity);
+    VLGapVector<std::string, StaticCapacity> vec;
+    std::vector<std::string> expected;
+    size_t cursor = 0;
+    for (size_t op = 0; op < RANDOM_OPS; ++op)
+    {
+        if (below(random, 2))
+        {
+            cursor = below(random, expected.size() + 1);
+        }
+        else
+        {
+            cursor = std::min(expected.size(), cursor + below(random, 3) - std::min<size_t>(cursor, 1));
+        }
+        size_t source = expected.empty() ? 0 : below(random, expected.size());
+        std::string value;
+        std::string const &argument = randomArgument(random, vec, expected, source, value);
+        switch (below(random, 8))
+        {
+            case 0:
+            case 1:
+                CHECK(*vec.insert(vec.cbegin() + cursor, argument) == value);
+                expected.insert(expected.begin() + cursor, value);
+                ++cursor;
+                break;
+            case 2:
+            {
+                std::vector<std::string> values(below(random, 5), value);
+                vec.insert(vec.cbegin() + cursor, values.begin(), values.end());
+                expected.insert(expected.begin() + cursor, values.begin(), values.end());
+                break;
+            }
+            case 3:
+                vec.push_back(argument);
+                expected.push_back(value);
+                break;
+            case 4:
+                if (cursor < expected.size())
+                {
+                    vec.erase(vec.cbegin() + cursor);
+                    expected.erase(expected.begin() + cursor);
+                }
+                break;
+            case 5:
+            {
+                size_t last = cursor + below(random, expected.size() - cursor + 1);
+                size_t first = below(random, cursor + 1);
+                vec.erase(vec.cbegin() + first, vec.cbegin() + last);
+                expected.erase(expected.begin() + first, expected.begin() + last);
+                cursor = first;
+                break;
+            }
+            case 6:
+                if (!expected.empty())
+                {
+                    vec.pop_back();
+                    expected.pop_back();
+                }
+                break;
+            default:
+                if (!below(random, 8))
+                {
+                    CHECK(std::equal(vec.data(), vec.data() + vec.size(), expected.begin()));
+                    CHECK(vec.gap() == vec.size());
+                }
+                else if (!below(random, 32))
+                {
+                    vec.clear();
+                    expected.clear();
+                    CHECK(vec.capacity() == StaticCapacity);
+                }
+                break;
+        }
+        cursor = std::min(cursor, expected.size());
+        CHECK(same(vec, expected));
+    }
+    VLGapVector<std::string, StaticCapacity> copy(vec);
+    CHECK(same(copy, expected) && copy == vec);
+}
+
+/**
+ * @brief A range insert from an istream_iterator, which can be read only once, lands in place and past the capacity.
+ */
+static void testSinglePassInsert()
+{
+    const int values[] = {1, 2, 3};
+    VLGapVector<int, 4> vec(values, values + 3);
+    std::istringstream input("10 11 12 13 14 15");
+    auto inserted = vec.insert(vec.cbegin() + 1, std::istream_iterator<int>(input), std::istream_iterator<int>());
+    CHECK(inserted == vec.begin() + 1 && vec.gap() == 7);
+    CHECK(sameElements(vec, std::vector<int>({1, 10, 11, 12, 13, 14, 15, 2, 3})));
+}
+
+/**
+ * @brief A copy is sized by the copied elements, and a failed allocation leaves the assigned vector as it was.
+ */
+static void testCopy()
+{
+    VLGapVector<ThrowingElement, 4> small, large;
+    for (int i = 0; i < 20; ++i)
+    {
+        large.push_back(i);
+    }
+    large.erase(large.cbegin() + 2, large.cend());
+    VLGapVector<ThrowingElement, 4> copy(large);
+    CHECK(copy == large && copy.capacity() == 4);
+    for (int i = 0; i < 30; ++i)
+    {
+        large.insert(large.cbegin() + 1, -i);
+    }
+    for (int i = 0; i < 10; ++i)
+    {
+        small.push_back(i);
+    }
+    VLGapVector<ThrowingElement, 4> before(small);
+    size_t capacity = small.capacity();
+    bool thrown = false;
+    ThrowingElement::throwing() = true;
+    try
+    {
+        small = large;
+    }
+    catch (std::bad_alloc const &)
+    {
+        thrown = true;
+    }
+    ThrowingElement::throwing() = false;
+    CHECK(thrown && small == before && small.capacity() == capacity);
+    small = large;
+    CHECK(small == large && small.capacity() == large.size() && small.gap() == small.size());
+}
+
+int main()
+{
+    testRandomOps<1>();
+    testRandomOps<4>();
+    testRandomOps<16>();
+    testSinglePassInsert();
+    testCopy();
+    return testResult("VLGapVectorTest");
+}
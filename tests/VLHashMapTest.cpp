@@ -0,0 +1,221 @@
+/**
+ * @file VLHashMapTest.cpp
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ *
+ * @brief Randomized tests of VLHashMap against std::unordered_map and of VLHashSet against std::unordered_set,
+ * through the linear and the hashed layouts, growth, tombstones and in place rehashing.
+ */
+#include "TestCheck.hpp"
+#include "../VLHashMap.hpp"
+
+#include <iterator>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#define HASH_RANDOM_OPS (2 * RANDOM_OPS)
+
+/**
+ * A hash which maps keys to few values, so that most probes pass full groups and compare keys.
+ */
+struct CollidingHash
+{
+    size_t operator()(int key) const noexcept
+    {
+        return (size_t) (key % 5);
+    }
+};
+
+/**
+ * @return true if map holds the entries of expected, by lookup and by iteration.
+ */
+template<class Map, class Expected>
+static bool same(Map const &map, Expected const &expected)
+{
+    if (map.size() != expected.size() || (size_t) std::distance(map.begin(), map.end()) != expected.size())
+    {
+        return false;
+    }
+    for (auto const &entry : map)
+    {
+        auto found = expected.find(entry.first);
+        if (found == expected.end() || found->second != entry.second)
+        {
+            return false;
+        }
+    }
+    return map.capacity() >= map.size() && !(map.capacity() & (map.capacity() - 1));
+}
+
+/**
+ * @brief Random inserts, assignments, lookups and erases. The key range changes in turns, so the map grows, then keeps
+ * about the same size while erasing and inserting, which fills it with tombstones until it rehashes in place.
+ */
+template<class Hash>
+static void testMap()
+{
+    TestRandom random(TEST_SEED);
+    VLHashMap<int, int, 16, Hash> map;
+    std::unordered_map<int, int> expected;
+    for (size_t op = 0; op < HASH_RANDOM_OPS; ++op)
+    {
+        size_t phase = (op / 5000) % 4;
+        int range = phase == 0 ? 12 : phase == 1 ? 3000 : 400;
+        int key = (int) below(random, (size_t) range) - range / 3;
+        int value = (int) below(random, 1000);
+        switch (below(random, phase == 3 ? 6 : 4))
+        {
+            case 0:
+            {
+                auto inserted = map.insert(key, value);
+                auto stdInserted = expected.insert({key, value});
+                CHECK(inserted.second == stdInserted.second && inserted.first->second == stdInserted.first->second);
+                break;
+            }
+            case 1:
+                CHECK(map.insert_or_assign(key, value).second == expected.insert_or_assign(key, value).second);
+                break;
+            case 2:
+                map[key] += value;
+                expected[key] += value;
+                break;
+            default:
+                CHECK(map.erase(key) == expected.erase(key));
+                break;
+        }
+        int probe = (int) below(random, (size_t) range) - range / 3;
+        auto found = expected.find(probe);
+        CHECK(map.contains(probe) == (found != expected.end()) && map.count(probe) == expected.count(probe));
+        CHECK(found == expected.end() || map.at(probe) == found->second);
+        if (!below(random, 64))
+        {
+            CHECK(same(map, expected));
+        }
+        if (!below(random, 20000))
+        {
+            map.clear();
+            expected.clear();
+        }
+    }
+    CHECK(same(map, expected));
+    VLHashMap<int, int, 16, Hash> copy(map);
+    CHECK(same(copy, expected) && copy == map);
+}
+
+/**
+ * @brief A map whose size stays the same while its keys change grows at most once, when its tombstones first reach
+ * the maximal load, and rehashes in place from then on.
+ */
+static void testSteadyChurn()
+{
+    VLHashMap<int, int, 16> map;
+    for (int key = 0; key < 100; ++key)
+    {
+        map.insert(key, key);
+    }
+    size_t capacity = map.capacity();
+    for (int key = 100; key < 20000; ++key)
+    {
+        CHECK(map.erase(key - 100) == 1);
+        map.insert(key, key);
+        CHECK(map.size() == 100 && map.capacity() <= 2 * capacity);
+    }
+    for (int key = 19900; key < 20000; ++key)
+    {
+        CHECK(map.at(key) == key);
+    }
+}
+
+/**
+ * @brief A failed allocation while growing or copying leaves the map as it was, and leaks nothing.
+ */
+static void testFailedAllocation()
+{
+    VLHashMap<int, ThrowingElement, 16> map, large;
+    for (int key = 0; key < 10; ++key)
+    {
+        map.insert(key, key);
+    }
+    for (int key = 0; key < 1000; ++key)
+    {
+        large.insert(key, -key);
+    }
+    size_t capacity = map.capacity();
+    int thrown = 0;
+    int key = 10;
+    ThrowingElement::throwing() = true;
+    try
+    {
+        for (; key < 1000; ++key)
+        {
+            map.insert(key, key);
+        }
+    }
+    catch (std::bad_alloc const &)
+    {
+        ++thrown;
+    }
+    ThrowingElement::throwing() = false;
+    CHECK(map.size() == (size_t) key && map.find(key) == map.end() && map.at(0) == 0);
+    VLHashMap<int, ThrowingElement, 16> before(map);
+    ThrowingElement::throwing() = true;
+    try
+    {
+        map = large;
+    }
+    catch (std::bad_alloc const &)
+    {
+        ++thrown;
+    }
+    ThrowingElement::throwing() = false;
+    CHECK(thrown == 2 && map == before && map.capacity() == capacity);
+    map = large;
+    CHECK(map == large);
+}
+
+/**
+ * @brief Random inserts, lookups and erases of string keys.
+ */
+static void testSet()
+{
+    TestRandom random(TEST_SEED);
+    VLHashSet<std::string, 16> set;
+    std::unordered_set<std::string> expected;
+    for (size_t op = 0; op < HASH_RANDOM_OPS; ++op)
+    {
+        size_t range = (op / 5000) % 2 ? 50 : 2000;
+        std::string key = "key-" + std::to_string(below(random, range));
+        switch (below(random, 3))
+        {
+            case 0:
+                CHECK(set.insert(key).second == expected.insert(key).second);
+                break;
+            case 1:
+                CHECK(set.erase(key) == expected.erase(key));
+                break;
+            default:
+                CHECK(set.contains(key) == (expected.count(key) > 0));
+                break;
+        }
+        CHECK(set.size() == expected.size());
+    }
+    size_t seen = 0;
+    for (std::string const &key : set)
+    {
+        CHECK(expected.count(key) == 1);
+        ++seen;
+    }
+    CHECK(seen == expected.size());
+}
+
+int main()
+{
+    testMap<std::hash<int>>();
+    testMap<CollidingHash>();
+    testSteadyChurn();
+    testFailedAllocation();
+    testSet();
+    return testResult("VLHashMapTest");
+}
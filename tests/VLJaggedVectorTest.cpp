@@ -0,0 +1,220 @@
+/**
+ * @file VLJaggedVectorTest.cpp
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ *
+ * @brief Randomized tests of VLHybridJaggedVector and VLJaggedVector against a std::vector of std::vectors.
+ */
+#include "TestCheck.hpp"
+#include "../VLJaggedVector.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#define ROUNDS 300
+
+#define EDITS_PER_ROUND 400
+
+typedef std::vector<std::vector<int>> Rows;
+
+/**
+ * @return true if jagged holds the rows of expected.
+ */
+template<class Jagged>
+static bool same(Jagged const &jagged, Rows const &expected)
+{
+    if (jagged.size() != expected.size())
+    {
+        return false;
+    }
+    size_t valueCount = 0;
+    for (size_t row = 0; row < expected.size(); ++row)
+    {
+        auto values = jagged[row];
+        if (jagged.row_size(row) != expected[row].size() ||
+            !std::equal(values.begin(), values.end(), expected[row].begin(), expected[row].end()))
+        {
+            return false;
+        }
+        valueCount += expected[row].size();
+    }
+    return jagged.value_count() == valueCount;
+}
+
+/**
+ * @brief Random row edits of a hybrid jagged vector, some pushing values of the vector itself, then copies,
+ * compaction and conversion to a VLJaggedVector.
+ */
+static void testHybrid()
+{
+    TestRandom random(TEST_SEED);
+    for (size_t round = 0; round < ROUNDS; ++round)
+    {
+        VLHybridJaggedVector<int, 3, 4> jagged;
+        Rows expected;
+        for (size_t edit = 0; edit < EDITS_PER_ROUND; ++edit)
+        {
+            size_t row = expected.empty() ? 0 : below(random, expected.size());
+            switch (below(random, 9))
+            {
+                case 0:
+                    CHECK(jagged.push_row() == expected.size());
+                    expected.emplace_back();
+                    break;
+                case 1:
+                case 2:
+                case 3:
+                case 4:
+                    if (!expected.empty())
+                    {
+                        if (!expected[row].empty() && !below(random, 4))
+                        {
+                            size_t idx = below(random, expected[row].size());
+                            expected[row].push_back(expected[row][idx]);
+                            jagged.push_back(row, jagged[row][idx]);
+                        }
+                        else
+                        {
+                            int value = (int) below(random, 100);
+                            expected[row].push_back(value);
+                            jagged.push_back(row, value);
+                        }
+                    }
+                    break;
+                case 5:
+                    if (!expected.empty() && !expected[row].empty())
+                    {
+                        jagged.pop_back(row);
+                        expected[row].pop_back();
+                    }
+                    break;
+                case 6:
+                    if (!below(random, 10))
+                    {
+                        size_t rows = below(random, 30);
+                        jagged.resize(rows);
+                        expected.resize(rows);
+                    }
+                    break;
+                case 7:
+                    if (!below(random, 10))
+                    {
+                        jagged.compact();
+                        CHECK(jagged.garbage() == 0);
+                    }
+                    break;
+                default:
+                    if (!expected.empty() && !below(random, 5))
+                    {
+                        jagged.clear_row(row);
+                        expected[row].clear();
+                    }
+                    break;
+            }
+            CHECK(same(jagged, expected));
+        }
+
+        VLHybridJaggedVector<int, 3, 4> copy(jagged);
+        CHECK(same(copy, expected) && copy.garbage() == 0);
+        VLHybridJaggedVector<int, 3, 4> assigned;
+        assigned.push_row();
+        assigned.push_back(0, 1);
+        assigned = jagged;
+        assigned.reserve(100, 500);
+        CHECK(same(assigned, expected));
+
+        jagged.compact();
+        CHECK(same(jagged, expected));
+        size_t spilled = 0;
+        for (auto const &values : expected)
+        {
+            spilled += values.size() > 3 ? values.size() : 0;
+        }
+        CHECK(jagged.overflow_size() == spilled);
+
+        VLJaggedVector<int, 4> converted(jagged);
+        CHECK(same(converted, expected));
+        jagged.clear();
+        CHECK(jagged.empty() && jagged.value_count() == 0);
+    }
+}
+
+/**
+ * @brief VLJaggedVectors built row by row, value by value and from pairs of a row and a value, with both offset types.
+ */
+static void testCompressed()
+{
+    TestRandom random(TEST_SEED);
+    for (size_t round = 0; round < ROUNDS; ++round)
+    {
+        Rows expected(below(random, 30));
+        for (auto &values : expected)
+        {
+            values.resize(below(random, 12));
+            for (int &value : values)
+            {
+                value = (int) below(random, 1000);
+            }
+        }
+
+        VLJaggedVector<int, 4, uint32_t> byRow;
+        for (auto const &values : expected)
+        {
+            byRow.push_row(values.begin(), values.end());
+        }
+        CHECK(same(byRow, expected));
+
+        VLJaggedVector<int> byValue;
+        for (auto const &values : expected)
+        {
+            byValue.push_row();
+            for (int value : values)
+            {
+                byValue.push_back(value);
+            }
+        }
+        CHECK(same(byValue, expected));
+        VLJaggedVector<int> copy(byValue);
+        CHECK(copy == byValue);
+        Rows shorter(expected);
+        if (!expected.empty())
+        {
+            copy.pop_row();
+            shorter.pop_back();
+            CHECK(same(copy, shorter) && copy != byValue);
+        }
+        VLJaggedVector<int> moved(std::move(copy));
+        CHECK(same(moved, shorter) && copy.empty() && copy.value_count() == 0);
+        copy.push_row();
+        copy.push_back(5);
+        CHECK(copy.size() == 1 && copy.row_size(0) == 1);
+
+        size_t rows = 1 + below(random, 20);
+        Rows scattered(rows);
+        std::vector<size_t> rowOf;
+        std::vector<int> values;
+        for (size_t pair = below(random, 200); pair-- > 0;)
+        {
+            size_t row = below(random, rows);
+            int value = (int) below(random, 1000);
+            rowOf.push_back(row);
+            values.push_back(value);
+            scattered[row].push_back(value);
+        }
+        VLJaggedVector<int, 4, uint32_t> rebuilt;
+        rebuilt.push_row();
+        rebuilt.push_back(7);
+        rebuilt.rebuild(rows, rowOf.begin(), rowOf.end(), values.begin());
+        CHECK(same(rebuilt, scattered));
+        CHECK(rebuilt.offsets().size() == rows + 1 && rebuilt.values().size() == values.size());
+    }
+}
+
+int main()
+{
+    testHybrid();
+    testCompressed();
+    return testResult("VLJaggedVectorTest");
+}
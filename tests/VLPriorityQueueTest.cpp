@@ -0,0 +1,146 @@
+/**
+ * @file VLPriorityQueueTest.cpp
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ *
+ * @brief Randomized tests of VLPriorityQueue against std::priority_queue, and of top_k against std::partial_sort.
+ */
+#include "TestCheck.hpp"
+#include "../VLPriorityQueue.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <queue>
+#include <sstream>
+#include <vector>
+
+/**
+ * @return true if every element of the heap of queue is no better than its parent, by comp.
+ */
+template<class T, size_t StaticCapacity, class Compare, size_t Arity>
+static bool heapOrdered(VLPriorityQueue<T, StaticCapacity, Compare, Arity> const &queue, Compare comp)
+{
+    auto const &heap = queue.container();
+    for (size_t idx = 1; idx < heap.size(); ++idx)
+    {
+        if (comp(heap[(idx - 1) / Arity], heap[idx]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Random pushes, pops, top replacements and rebuilds, the queue being compared to a std::priority_queue of
+ * the same order after every operation.
+ */
+template<size_t Arity, class Compare>
+static void testRandomOps()
+{
+    TestRandom random(TEST_SEED + Arity);
+    VLPriorityQueue<int, 8, Compare, Arity> queue;
+    std::priority_queue<int, std::vector<int>, Compare> expected;
+    for (size_t op = 0; op < RANDOM_OPS; ++op)
+    {
+        int value = (int) below(random, 500);
+        bool growing = (op / 1000) % 2 == 0;
+        switch (below(random, growing ? 3 : 5))
+        {
+            case 0:
+            case 1:
+                queue.push(value);
+                expected.push(value);
+                break;
+            case 2:
+                if (!expected.empty())
+                {
+                    queue.replace_top(value);
+                    expected.pop();
+                    expected.push(value);
+                }
+                break;
+            default:
+                if (!expected.empty())
+                {
+                    queue.pop();
+                    expected.pop();
+                }
+                break;
+        }
+        if (!below(random, 1000))
+        {
+            std::vector<int> values(below(random, 40));
+            for (int &element : values)
+            {
+                element = (int) below(random, 500);
+            }
+            queue.assign(values.begin(), values.end());
+            expected = std::priority_queue<int, std::vector<int>, Compare>(values.begin(), values.end());
+        }
+        CHECK(queue.size() == expected.size() && heapOrdered(queue, Compare()));
+        CHECK(expected.empty() || queue.top() == expected.top());
+    }
+    std::vector<int> values(300);
+    for (int &element : values)
+    {
+        element = (int) below(random, 100);
+    }
+    VLPriorityQueue<int, 8, Compare, Arity> built(values.begin(), values.end());
+    std::sort(values.begin(), values.end(), Compare());
+    for (size_t idx = values.size(); idx-- > 0; built.pop())
+    {
+        CHECK(built.top() == values[idx]);
+    }
+    CHECK(built.empty());
+}
+
+/**
+ * @brief top_k returns the k best elements best first, like a partial_sort by the reversed order, for k below, at
+ * and above the static capacity and the size of the range, from forward and from single pass iterators.
+ */
+template<size_t Arity>
+static void testTopK()
+{
+    TestRandom random(TEST_SEED + Arity);
+    for (size_t round = 0; round < 300; ++round)
+    {
+        VLVector<int, 16> values;
+        size_t size = below(random, 60);
+        for (size_t idx = 0; idx < size; ++idx)
+        {
+            values.push_back((int) below(random, 50));
+        }
+        size_t k = below(random, 70);
+        std::vector<int> expected(values.begin(), values.end());
+        size_t kept = std::min(k, size);
+        std::partial_sort(expected.begin(), expected.begin() + kept, expected.end(), std::greater<int>());
+        expected.resize(kept);
+
+        VLVector<int, 8> best = top_k<8, Arity>(values, k);
+        CHECK(best.size() == kept && std::equal(best.begin(), best.end(), expected.begin()));
+        std::stringstream input;
+        for (int value : values)
+        {
+            input << value << ' ';
+        }
+        best = top_k<8, Arity>(std::istream_iterator<int>(input), std::istream_iterator<int>(), k);
+        CHECK(best.size() == kept && std::equal(best.begin(), best.end(), expected.begin()));
+
+        std::vector<int> smallest(values.begin(), values.end());
+        std::partial_sort(smallest.begin(), smallest.begin() + kept, smallest.end());
+        VLVector<int, 8> worst = top_k<8, Arity>(values.begin(), values.end(), k, std::greater<int>());
+        CHECK(worst.size() == kept && std::equal(worst.begin(), worst.end(), smallest.begin()));
+    }
+}
+
+int main()
+{
+    testRandomOps<BINARY_HEAP, std::less<int>>();
+    testRandomOps<QUATERNARY_HEAP, std::less<int>>();
+    testRandomOps<3, std::greater<int>>();
+    testTopK<BINARY_HEAP>();
+    testTopK<QUATERNARY_HEAP>();
+    return testResult("VLPriorityQueueTest");
+}
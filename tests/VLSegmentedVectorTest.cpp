@@ -0,0 +1,123 @@
+/**
+ * @file VLSegmentedVectorTest.cpp
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ *
+ * @brief Randomized tests of VLSegmentedVector against std::vector, of the stability of its elements, and of the
+ * spare segment it keeps.
+ */
+#include "TestCheck.hpp"
+#include "../VLSegmentedVector.hpp"
+
+#include <string>
+#include <vector>
+
+/**
+ * @return true if vec holds the elements of expected, by index, by iteration and segment by segment, at addresses.
+ */
+template<class T, size_t StaticCapacity>
+static bool same(VLSegmentedVector<T, StaticCapacity> const &vec, std::vector<T> const &expected,
+                 std::vector<const T *> const &addresses)
+{
+    if (!sameElements(vec, expected))
+    {
+        return false;
+    }
+    size_t idx = 0;
+    bool equal = true;
+    for_each_segmented(vec, [&](T const &elem)
+    {
+        equal = equal && elem == expected[idx] && &elem == &vec[idx] && &elem == addresses[idx];
+        ++idx;
+    });
+    return equal && idx == expected.size() && vec.capacity() >= vec.size();
+}
+
+/**
+ * @brief Random pushes and pops, biased in turns toward growing and toward shrinking. The address of every element
+ * is kept when it is pushed, and must not change while the element is in the vector.
+ */
+template<size_t StaticCapacity>
+static void testRandomOps()
+{
+    TestRandom random(TEST_SEED + StaticCapacity);
+    VLSegmentedVector<std::string, StaticCapacity> vec;
+    std::vector<std::string> expected;
+    std::vector<const std::string *> addresses;
+    for (size_t op = 0; op < RANDOM_OPS; ++op)
+    {
+        bool growing = (op / 1000) % 2 == 0;
+        size_t at = expected.empty() ? 0 : below(random, expected.size());
+        std::string value;
+        std::string const &argument = randomArgument(random, vec, expected, at, value);
+        size_t choice = below(random, 8);
+        if (choice < (growing ? 6u : 3u))
+        {
+            vec.push_back(argument);
+            expected.push_back(value);
+            addresses.push_back(&vec.back());
+        }
+        else if (choice < 7 && !expected.empty())
+        {
+            vec.pop_back();
+            expected.pop_back();
+            addresses.pop_back();
+        }
+        else if (choice == 7 && !below(random, 64))
+        {
+            vec.clear();
+            expected.clear();
+            addresses.clear();
+            CHECK(vec.capacity() == StaticCapacity);
+        }
+        CHECK(same(vec, expected, addresses));
+    }
+    VLSegmentedVector<std::string, StaticCapacity> copy(vec);
+    CHECK(copy == vec && copy.size() == expected.size());
+}
+
+/**
+ * @brief A size going back and forth across the start of a segment keeps the segment, and a segment is freed once
+ * the one before it is empty too.
+ */
+static void testSpareSegment()
+{
+    VLSegmentedVector<int, 4> vec;
+    for (int i = 0; i < 5; ++i)
+    {
+        vec.push_back(i);
+    }
+    CHECK(vec.capacity() == 8);
+    for (int i = 0; i < 10; ++i)
+    {
+        vec.pop_back();
+        CHECK(vec.capacity() == 8);
+        vec.push_back(i);
+    }
+    for (int i = 5; i < 9; ++i)
+    {
+        vec.push_back(i);
+    }
+    CHECK(vec.capacity() == 16 && vec.segment_count() == 3);
+    while (vec.size() > 5)
+    {
+        vec.pop_back();
+        CHECK(vec.capacity() == 16);
+    }
+    vec.pop_back();
+    CHECK(vec.capacity() == 8 && vec.segment_count() == 1);
+    while (!vec.empty())
+    {
+        vec.pop_back();
+    }
+    CHECK(vec.capacity() == 4);
+}
+
+int main()
+{
+    testRandomOps<1>();
+    testRandomOps<4>();
+    testRandomOps<16>();
+    testSpareSegment();
+    return testResult("VLSegmentedVectorTest");
+}
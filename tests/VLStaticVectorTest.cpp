@@ -0,0 +1,180 @@
+/**
+ * @file VLStaticVectorTest.cpp
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ *
+ * @brief Randomized tests of VLStaticVector against std::vector, under every overflow policy, and of its range insert
+ * from single pass iterators.
+ */
+#include "TestCheck.hpp"
+#include "../VLStaticVector.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#define STATIC_TEST_CAPACITY 24
+
+/**
+ * @brief Random operations, which often would exceed the capacity. Overflowing operations must leave the vector
+ * unchanged, either by throwing or by being refused.
+ */
+template<VLOverflow Overflow>
+static void testRandomOps()
+{
+    TestRandom random(TEST_SEED);
+    VLStaticVector<int, STATIC_TEST_CAPACITY, Overflow> vec;
+    std::vector<int> expected;
+    for (size_t op = 0; op < RANDOM_OPS; ++op)
+    {
+        int value = (int) below(random, 1000);
+        size_t at = below(random, expected.size() + 1);
+        bool fits = expected.size() < STATIC_TEST_CAPACITY;
+        bool refused = false;
+        try
+        {
+            switch (below(random, 8))
+            {
+                case 0:
+                case 1:
+                    refused = !vec.push_back(value);
+                    if (fits)
+                    {
+                        expected.push_back(value);
+                    }
+                    break;
+                case 2:
+                    refused = vec.insert(vec.cbegin() + at, value) == vec.end();
+                    if (fits)
+                    {
+                        expected.insert(expected.begin() + at, value);
+                    }
+                    break;
+                case 3:
+                {
+                    std::vector<int> values(below(random, 6), value);
+                    fits = expected.size() + values.size() <= STATIC_TEST_CAPACITY;
+                    auto inserted = vec.insert(vec.cbegin() + at, values.begin(), values.end());
+                    refused = !fits && inserted == vec.end();
+                    if (fits)
+                    {
+                        expected.insert(expected.begin() + at, values.begin(), values.end());
+                    }
+                    break;
+                }
+                case 4:
+                {
+                    size_t newSize = below(random, STATIC_TEST_CAPACITY + 4);
+                    fits = newSize <= STATIC_TEST_CAPACITY;
+                    refused = !vec.resize(newSize, value);
+                    if (fits)
+                    {
+                        expected.resize(newSize, value);
+                    }
+                    break;
+                }
+                case 5:
+                    if (!expected.empty())
+                    {
+                        size_t last = at + below(random, expected.size() - at + 1);
+                        vec.erase(vec.cbegin() + at, vec.cbegin() + last);
+                        expected.erase(expected.begin() + at, expected.begin() + last);
+                    }
+                    fits = true;
+                    break;
+                case 6:
+                    if (!expected.empty())
+                    {
+                        vec.pop_back();
+                        expected.pop_back();
+                    }
+                    fits = true;
+                    break;
+                default:
+                    CHECK(vec.try_push_back(value) == fits);
+                    if (fits)
+                    {
+                        expected.push_back(value);
+                    }
+                    fits = true;
+                    break;
+            }
+        }
+        catch (std::length_error const &)
+        {
+            CHECK(Overflow == VLOverflow::Throw && !fits);
+            refused = true;
+        }
+        CHECK(refused == !fits);
+        CHECK(sameElements(vec, expected));
+        CHECK(vec.full() == (expected.size() == STATIC_TEST_CAPACITY));
+    }
+}
+
+/**
+ * @brief A range insert from an istream_iterator, which can be read only once, lands in place, and one which
+ * overflows leaves the vector unchanged.
+ */
+static void testSinglePassInsert()
+{
+    VLStaticVector<int, 8, VLOverflow::Refuse> vec;
+    vec.push_back(1);
+    vec.push_back(5);
+    std::istringstream input("2 3 4");
+    auto inserted = vec.insert(vec.cbegin() + 1, std::istream_iterator<int>(input), std::istream_iterator<int>());
+    CHECK(inserted == vec.begin() + 1);
+    std::vector<int> expected = {1, 2, 3, 4, 5};
+    CHECK(sameElements(vec, expected));
+
+    std::istringstream tooMany("6 7 8 9");
+    CHECK(vec.insert(vec.cbegin(), std::istream_iterator<int>(tooMany), std::istream_iterator<int>()) == vec.end());
+    CHECK(sameElements(vec, expected));
+
+    VLStaticVector<int, 8> throwing(expected.begin(), expected.end());
+    std::istringstream alsoTooMany("6 7 8 9");
+    bool thrown = false;
+    try
+    {
+        throwing.insert(throwing.cbegin(), std::istream_iterator<int>(alsoTooMany), std::istream_iterator<int>());
+    }
+    catch (std::length_error const &)
+    {
+        thrown = true;
+    }
+    CHECK(thrown && sameElements(throwing, expected));
+}
+
+/**
+ * @brief The comparisons agree with those of std::vector.
+ */
+static void testComparisons()
+{
+    TestRandom random(TEST_SEED);
+    for (size_t i = 0; i < 2000; ++i)
+    {
+        std::vector<int> lhs(below(random, 5)), rhs(below(random, 5));
+        for (int &value : lhs)
+        {
+            value = (int) below(random, 3);
+        }
+        for (int &value : rhs)
+        {
+            value = (int) below(random, 3);
+        }
+        VLStaticVector<int, 8> left(lhs.begin(), lhs.end()), right(rhs.begin(), rhs.end());
+        CHECK((left == right) == (lhs == rhs) && (left != right) == (lhs != rhs));
+        CHECK((left < right) == (lhs < rhs) && (left <= right) == (lhs <= rhs));
+        CHECK((left > right) == (lhs > rhs) && (left >= right) == (lhs >= rhs));
+    }
+}
+
+int main()
+{
+    testRandomOps<VLOverflow::Throw>();
+    testRandomOps<VLOverflow::Refuse>();
+    testSinglePassInsert();
+    testComparisons();
+    return testResult("VLStaticVectorTest");
+}
@@ -0,0 +1,218 @@
+/**
+ * @file VLStringTest.cpp
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ *
+ * @brief Randomized tests of VLString against std::string: edits, searches, comparisons and hashing.
+ */
+#include "TestCheck.hpp"
+#include "../VLString.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <unordered_set>
+#include <utility>
+
+#define ROUNDS 2000
+
+#define EDITS_PER_ROUND 40
+
+#define TEXT_LENGTH 10000
+
+/**
+ * The characters of the random strings: few, so that searches often find partial matches.
+ */
+#define ALPHABET "abc"
+
+/**
+ * @return A random string of length characters of ALPHABET.
+ */
+static std::string randomText(TestRandom &random, size_t length)
+{
+    std::string text(length, ' ');
+    for (char &ch : text)
+    {
+        ch = ALPHABET[below(random, sizeof(ALPHABET) - 1)];
+    }
+    return text;
+}
+
+/**
+ * @return true if str holds the characters of expected, followed by its terminator.
+ */
+template<size_t StaticCapacity>
+static bool same(VLString<StaticCapacity> const &str, std::string const &expected)
+{
+    return std::string_view(str) == expected && str.size() == expected.size() && str.c_str()[str.size()] == '\0' &&
+           str.capacity() >= str.size();
+}
+
+/**
+ * @brief Random edits, some appending characters of the string itself, each followed by searches for random needles
+ * from random places.
+ */
+static void testRandomEdits()
+{
+    TestRandom random(TEST_SEED);
+    for (size_t round = 0; round < ROUNDS; ++round)
+    {
+        VLString<8> str;
+        std::string expected;
+        for (size_t edit = 0; edit < EDITS_PER_ROUND; ++edit)
+        {
+            switch (below(random, 7))
+            {
+                case 0:
+                {
+                    char ch = ALPHABET[below(random, sizeof(ALPHABET) - 1)];
+                    str.push_back(ch);
+                    expected.push_back(ch);
+                    break;
+                }
+                case 1:
+                {
+                    std::string text = randomText(random, below(random, 30));
+                    str += text;
+                    expected += text;
+                    break;
+                }
+                case 2:
+                    if (!expected.empty())
+                    {
+                        str.pop_back();
+                        expected.pop_back();
+                    }
+                    break;
+                case 3:
+                {
+                    size_t newSize = below(random, 50);
+                    char ch = ALPHABET[below(random, sizeof(ALPHABET) - 1)];
+                    str.resize(newSize, ch);
+                    expected.resize(newSize, ch);
+                    break;
+                }
+                case 4:
+                    if (!expected.empty())
+                    {
+                        size_t pos = below(random, expected.size());
+                        size_t count = below(random, expected.size() - pos + 1);
+                        str.append(str.data() + pos, count);
+                        expected.append(expected, pos, count);
+                    }
+                    break;
+                case 5:
+                {
+                    size_t maxSize = below(random, 60);
+                    str.resize_and_overwrite(maxSize, [](char *chars, size_t size)
+                    {
+                        std::fill(chars, chars + size / 2, 'q');
+                        return size / 2;
+                    });
+                    expected.assign(maxSize / 2, 'q');
+                    break;
+                }
+                default:
+                    if (!below(random, 8))
+                    {
+                        str.clear();
+                        expected.clear();
+                    }
+                    break;
+            }
+            CHECK(same(str, expected));
+        }
+        for (size_t query = 0; query < 20; ++query)
+        {
+            std::string needle = randomText(random, below(random, 5));
+            size_t pos = below(random, expected.size() + 3);
+            char ch = "abcd"[below(random, 4)];
+            CHECK(str.find(needle, pos) == expected.find(needle, pos) && str.find(ch, pos) == expected.find(ch, pos));
+            CHECK(str.contains(needle) == (expected.find(needle) != std::string::npos));
+            CHECK(str.starts_with(needle) == (expected.compare(0, needle.size(), needle) == 0));
+            bool endsWith = expected.size() >= needle.size() &&
+                            expected.compare(expected.size() - needle.size(), needle.size(), needle) == 0;
+            CHECK(str.ends_with(needle) == endsWith);
+        }
+    }
+}
+
+/**
+ * @brief Searches of a long text, which go through the unrolled SIMD loop.
+ */
+static void testLongFind()
+{
+    TestRandom random(TEST_SEED);
+    std::string text = randomText(random, TEXT_LENGTH);
+    VLString<48> str(text);
+    for (size_t query = 0; query < 2000; ++query)
+    {
+        std::string needle = randomText(random, 1 + below(random, 12));
+        size_t pos = below(random, text.size());
+        CHECK(str.find(needle, pos) == text.find(needle, pos));
+    }
+    CHECK(str.find(text) == 0 && str.find(text + "a") == VLString<48>::npos);
+}
+
+/**
+ * @brief The comparisons of strings of different static capacities agree with those of std::string, including for
+ * characters past CHAR_MAX, and equal strings hash equally.
+ */
+static void testComparisons()
+{
+    TestRandom random(TEST_SEED);
+    for (size_t round = 0; round < 2000; ++round)
+    {
+        std::string lhs = randomText(random, below(random, 6)), rhs = randomText(random, below(random, 6));
+        if (!below(random, 4))
+        {
+            lhs += '\xE9';
+        }
+        VLString<4> left(lhs);
+        VLString<16> right(rhs);
+        CHECK((left == right) == (lhs == rhs) && (left != right) == (lhs != rhs));
+        CHECK((left < right) == (lhs < rhs) && (left <= right) == (lhs <= rhs));
+        CHECK((left > right) == (lhs > rhs) && (left >= right) == (lhs >= rhs));
+        CHECK(left == std::string_view(lhs) && std::string_view(rhs) == right);
+        CHECK(std::hash<VLString<4>>()(left) == std::hash<VLString<16>>()(VLString<16>(lhs)));
+    }
+    std::unordered_set<VLString<48>> set;
+    set.insert("abc");
+    CHECK(set.count("abc") == 1 && set.count("abd") == 0);
+}
+
+/**
+ * @brief at checks its index, and a moved string is left empty and terminated.
+ */
+static void testEdges()
+{
+    VLString<> str(5, 'k');
+    CHECK(str == "kkkkk" && str.at(4) == 'k');
+    bool thrown = false;
+    try
+    {
+        str.at(5);
+    }
+    catch (std::out_of_range const &)
+    {
+        thrown = true;
+    }
+    CHECK(thrown);
+
+    VLString<4> longer("longer than the static capacity");
+    VLString<4> moved(std::move(longer));
+    CHECK(moved == "longer than the static capacity" && same(longer, ""));
+    longer = std::move(moved);
+    CHECK(longer == "longer than the static capacity" && same(moved, ""));
+    moved += "x";
+    CHECK(same(moved, "x"));
+}
+
+int main()
+{
+    testRandomEdits();
+    testLongFind();
+    testComparisons();
+    testEdges();
+    return testResult("VLStringTest");
+}
@@ -0,0 +1,182 @@
+/**
+ * @file VLVectorCompareTest.cpp
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ *
+ * @brief Randomized tests of ==, != and the lexicographic orderings of VLVectors against std::vector, for elements
+ * compared by memcmp, by the SIMD mismatch kernel (floating ones with NaNs and signed zeros too), by unsigned byte
+ * memcmp ordering and element by element, between vectors of different static capacities, and of a vector with itself.
+ */
+#include "TestCheck.hpp"
+#include "../VLVector.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#define ROUNDS 2000
+
+#define MAX_SIZE 40
+
+#define VALUE_RANGE 4
+
+/**
+ * An element with operator== and operator< only, which the orderings synthesize operator<=> from.
+ */
+struct LessOnly
+{
+    int value;
+
+    bool operator==(LessOnly const &other) const
+    {
+        return value == other.value;
+    }
+
+    bool operator!=(LessOnly const &other) const
+    {
+        return value != other.value;
+    }
+
+    bool operator<(LessOnly const &other) const
+    {
+        return value < other.value;
+    }
+};
+
+/**
+ * @return A random element of a small range, so that vectors often share long prefixes. Floating elements are NaN or
+ * a zero of either sign some of the time if withNan.
+ */
+template<class T>
+static T randomValue(TestRandom &random, bool withNan)
+{
+    int value = (int) below(random, VALUE_RANGE) - (std::is_signed<T>::value ? VALUE_RANGE / 2 : 0);
+    if constexpr (std::is_floating_point<T>::value)
+    {
+        switch (withNan ? below(random, 8) : VALUE_RANGE)
+        {
+            case 0:
+                return std::numeric_limits<T>::quiet_NaN();
+            case 1:
+                return (T) -0.0;
+            default:
+                return (T) value;
+        }
+    }
+    else if constexpr (std::is_same<T, std::string>::value)
+    {
+        return std::string(below(random, 3), (char) ('a' + value));
+    }
+    else if constexpr (std::is_same<T, LessOnly>::value)
+    {
+        return LessOnly{value};
+    }
+    else
+    {
+        return (T) value;
+    }
+}
+
+/**
+ * @return The elements of lhs, mostly changed a little: truncated, extended or with one element replaced, so that the
+ * vectors differ late or not at all.
+ */
+template<class T>
+static std::vector<T> nearby(TestRandom &random, std::vector<T> lhs, bool withNan)
+{
+    switch (below(random, 5))
+    {
+        case 0:
+            lhs.resize(below(random, lhs.size() + 1));
+            break;
+        case 1:
+            lhs.push_back(randomValue<T>(random, withNan));
+            break;
+        case 2:
+            if (!lhs.empty())
+            {
+                lhs[below(random, lhs.size())] = randomValue<T>(random, withNan);
+            }
+            break;
+        case 3:
+            lhs.clear();
+            for (size_t idx = below(random, MAX_SIZE); idx-- > 0;)
+            {
+                lhs.push_back(randomValue<T>(random, withNan));
+            }
+            break;
+        default:
+            break;
+    }
+    return lhs;
+}
+
+/**
+ * @brief Compares lhs and rhs as VLVectors and as std::vectors by every operator.
+ */
+template<class T, size_t LhsCapacity, size_t RhsCapacity>
+static void compare(VLVector<T, LhsCapacity> const &lhs, VLVector<T, RhsCapacity> const &rhs,
+                    std::vector<T> const &expectedLhs, std::vector<T> const &expectedRhs)
+{
+    CHECK((lhs == rhs) == (expectedLhs == expectedRhs));
+    CHECK((lhs != rhs) == (expectedLhs != expectedRhs));
+    CHECK((lhs < rhs) == (expectedLhs < expectedRhs));
+    CHECK((lhs > rhs) == (expectedLhs > expectedRhs));
+    CHECK((lhs <= rhs) == (expectedLhs <= expectedRhs));
+    CHECK((lhs >= rhs) == (expectedLhs >= expectedRhs));
+#ifdef VLV_THREE_WAY_COMPARISON
+    CHECK(std::partial_ordering(lhs <=> rhs) == std::partial_ordering(expectedLhs <=> expectedRhs));
+#endif
+}
+
+/**
+ * @brief Compares random nearby vectors of the given static capacities, and every vector with itself.
+ */
+template<class T, size_t LhsCapacity, size_t RhsCapacity>
+static void testCompare(TestRandom &random)
+{
+    for (size_t round = 0; round < ROUNDS; ++round)
+    {
+        bool withNan = below(random, 2);
+        std::vector<T> expectedLhs;
+        for (size_t idx = below(random, MAX_SIZE); idx-- > 0;)
+        {
+            expectedLhs.push_back(randomValue<T>(random, withNan));
+        }
+        std::vector<T> expectedRhs = nearby(random, expectedLhs, withNan);
+        VLVector<T, LhsCapacity> lhs(expectedLhs.begin(), expectedLhs.end());
+        VLVector<T, RhsCapacity> rhs(expectedRhs.begin(), expectedRhs.end());
+        compare(lhs, rhs, expectedLhs, expectedRhs);
+        compare(rhs, lhs, expectedRhs, expectedLhs);
+        compare(lhs, lhs, expectedLhs, expectedLhs);
+    }
+}
+
+/**
+ * @brief testCompare with equal static capacities, and with the vectors in static and dynamic storages.
+ */
+template<class T>
+static void testElement(TestRandom &random)
+{
+    testCompare<T, 16, 16>(random);
+    testCompare<T, 4, 16>(random);
+    testCompare<T, 1, MAX_SIZE>(random);
+}
+
+int main()
+{
+    TestRandom random(TEST_SEED);
+    testElement<uint8_t>(random);
+    testElement<int8_t>(random);
+    testElement<uint16_t>(random);
+    testElement<int32_t>(random);
+    testElement<uint64_t>(random);
+    testElement<float>(random);
+    testElement<double>(random);
+    testElement<std::string>(random);
+    testElement<LessOnly>(random);
+    return testResult("VLVectorCompareTest");
+}
@@ -0,0 +1,226 @@
+/**
+ * @file VLVectorExprTest.cpp
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ *
+ * @brief Randomized tests of the lazy element-wise expressions of VLVectorExpr.hpp against loops over std::vectors:
+ * scalars on either side and of other types than the elements, assignments to an operand of the expression, and the
+ * storage an assigned vector keeps.
+ */
+#include "TestCheck.hpp"
+#include "../VLVectorExpr.hpp"
+
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#define ROUNDS 40
+
+#define MAX_SIZE 100
+
+#define CAPACITY 16
+
+/**
+ * @return A VLVector and a std::vector of the same random values, small enough that no expression overflows, and not
+ * zero, so that they may be divided by.
+ */
+template<class T>
+static void randomVectors(TestRandom &random, size_t size, VLVector<T, CAPACITY> &vec, std::vector<T> &expected)
+{
+    vec.clear();
+    expected.clear();
+    for (size_t idx = 0; idx < size; ++idx)
+    {
+        T value = (T) ((int) below(random, 100) - 50);
+        value = value ? value : (T) 1;
+        vec.push_back(value);
+        expected.push_back(value);
+    }
+}
+
+/**
+ * @return true if vec holds the values of expected, converted to T.
+ */
+template<class T, size_t StaticCapacity, class U>
+static bool holds(VLVector<T, StaticCapacity> const &vec, std::vector<U> const &expected)
+{
+    if (vec.size() != expected.size())
+    {
+        return false;
+    }
+    for (size_t idx = 0; idx < expected.size(); ++idx)
+    {
+        if (vec[idx] != (T) expected[idx])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Expressions of vectors, scalars of the element type and of double, and negation, against the same
+ * arithmetic on every element, computed in the common type and converted once.
+ */
+template<class T>
+static void testExpressions(TestRandom &random)
+{
+    for (size_t round = 0; round < ROUNDS; ++round)
+    {
+        size_t size = below(random, MAX_SIZE);
+        VLVector<T, CAPACITY> a, b, c, result;
+        std::vector<T> ea, eb, ec;
+        randomVectors(random, size, a, ea);
+        randomVectors(random, size, b, eb);
+        randomVectors(random, size, c, ec);
+
+        std::vector<decltype(T() * 2 + T() - T())> fused;
+        std::vector<double> halves, quotients, mixed;
+        std::vector<decltype(-T())> negated;
+        for (size_t idx = 0; idx < size; ++idx)
+        {
+            fused.push_back(ea[idx] * 2 + eb[idx] - ec[idx]);
+            halves.push_back(ea[idx] * 0.5);
+            quotients.push_back(ea[idx] / 2.5);
+            mixed.push_back(10 - ea[idx] / (double) eb[idx]);
+            negated.push_back(-ea[idx]);
+        }
+
+        result = a * 2 + b - c;
+        CHECK(holds(result, fused));
+        result = a * 0.5;
+        CHECK(holds(result, halves));
+        result = a / 2.5;
+        CHECK(holds(result, quotients));
+        result = 10 - a / (b * 1.0);
+        CHECK(holds(result, mixed));
+        result = -a;
+        CHECK(holds(result, negated));
+
+        VLVector<T, CAPACITY> constructed = a * 0.5;
+        CHECK(holds(constructed, halves));
+
+        VLVector<T, CAPACITY> longer(a);
+        longer.push_back((T) 1);
+        bool threw = false;
+        try
+        {
+            result = a + longer;
+        }
+        catch (std::invalid_argument const &)
+        {
+            threw = true;
+        }
+        CHECK(threw);
+    }
+}
+
+/**
+ * @brief An integral vector times or divided by a floating point scalar is computed in floating point, not by the
+ * scalar truncated to the element type.
+ */
+static void testIntegralByFloatingScalar()
+{
+    const int values[] = {2, 4, 5, 10, 11};
+    VLVector<int, 4> vec(std::begin(values), std::end(values));
+    VLVector<int, 4> result = vec * 0.5;
+    CHECK(holds(result, std::vector<int>{1, 2, 2, 5, 5}));
+    result = vec / 2.5;
+    CHECK(holds(result, std::vector<int>{0, 1, 2, 4, 4}));
+    result = 1.5 * vec + 0.5;
+    CHECK(holds(result, std::vector<int>{3, 6, 8, 15, 17}));
+    vec *= 0.5;
+    CHECK(holds(vec, std::vector<int>{1, 2, 2, 5, 5}));
+
+    const uint8_t byteValues[] = {200, 100, 10};
+    VLVector<uint8_t, 4> bytes(std::begin(byteValues), std::end(byteValues));
+    VLVector<uint8_t, 4> sums = bytes + bytes / 2;
+    CHECK(holds(sums, std::vector<int>{300 % 256, 150, 15}));
+}
+
+/**
+ * @brief A vector assigned an expression it is an operand of, directly and by the compound assignments.
+ */
+static void testAliasing(TestRandom &random)
+{
+    for (size_t round = 0; round < ROUNDS; ++round)
+    {
+        size_t size = below(random, MAX_SIZE);
+        VLVector<int, CAPACITY> a, b;
+        std::vector<int> ea, eb;
+        randomVectors(random, size, a, ea);
+        randomVectors(random, size, b, eb);
+
+        a = a * 2 + a;
+        for (int &elem : ea)
+        {
+            elem = elem * 2 + elem;
+        }
+        CHECK(holds(a, ea));
+
+        a += a;
+        a -= b;
+        a *= 3;
+        a /= b;
+        for (size_t idx = 0; idx < size; ++idx)
+        {
+            ea[idx] = (ea[idx] + ea[idx] - eb[idx]) * 3 / eb[idx];
+        }
+        CHECK(holds(a, ea));
+
+        b = a - b * b;
+        for (size_t idx = 0; idx < size; ++idx)
+        {
+            eb[idx] = ea[idx] - eb[idx] * eb[idx];
+        }
+        CHECK(holds(b, eb));
+    }
+}
+
+/**
+ * @brief An assigned vector writes into its static storage, or into the dynamic storage it has if it is large enough,
+ * and only allocates when it is too small.
+ */
+static void testStorageReuse()
+{
+    VLVector<int, CAPACITY> source, inlineDst, heapDst;
+    for (int value = 0; value < (int) CAPACITY; ++value)
+    {
+        source.push_back(value);
+        inlineDst.push_back(0);
+    }
+    const int *inlineData = inlineDst.data();
+    inlineDst = source * 2;
+    CHECK(inlineDst.data() == inlineData);
+    CHECK(inlineDst.capacity() == CAPACITY);
+    CHECK(inlineDst[CAPACITY - 1] == 2 * (CAPACITY - 1));
+
+    heapDst.reserve(4 * CAPACITY);
+    const int *heapData = heapDst.data();
+    heapDst = source + 1;
+    CHECK(heapDst.data() == heapData);
+    heapDst = source * 3;
+    CHECK(heapDst.data() == heapData);
+    CHECK(heapDst.size() == CAPACITY && heapDst[1] == 3);
+
+    source.push_back(CAPACITY);
+    inlineDst = source - 1;
+    CHECK(inlineDst.size() == CAPACITY + 1 && inlineDst.capacity() > CAPACITY);
+    CHECK(inlineDst[CAPACITY] == CAPACITY - 1);
+}
+
+int main()
+{
+    TestRandom random(TEST_SEED);
+    testExpressions<int8_t>(random);
+    testExpressions<int>(random);
+    testExpressions<int64_t>(random);
+    testExpressions<float>(random);
+    testExpressions<double>(random);
+    testIntegralByFloatingScalar();
+    testAliasing(random);
+    testStorageReuse();
+    return testResult("VLVectorExprTest");
+}
@@ -0,0 +1,116 @@
+/**
+ * @file VLVectorFilterTest.cpp
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ *
+ * @brief Randomized tests of filter_into and retain against std::copy_if, with every predicate of vlvfilter and with
+ * a lambda, for every element size the compaction kernels handle.
+ */
+#include "TestCheck.hpp"
+#include "../VLVectorFilter.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+#define ROUNDS 60
+
+#define MAX_SIZE 2000
+
+/**
+ * The amount of values the random elements are drawn from, so that the predicates keep anything from none to all.
+ */
+#define VALUE_RANGE 64
+
+/**
+ * @return One of VALUE_RANGE values of T, half of them negative if T is signed.
+ */
+template<class T>
+static T randomValue(TestRandom &random)
+{
+    return (T) ((int) below(random, VALUE_RANGE) - (std::is_signed<T>::value ? VALUE_RANGE / 2 : 0));
+}
+
+/**
+ * @brief Filters src by pred into an empty vector which has room for all of it, into one which has not and thus goes
+ * through chunks, after a few elements already in it, and in place by retain.
+ */
+template<class T, class Pred>
+static void checkFilter(TestRandom &random, std::vector<T> const &src, Pred pred)
+{
+    std::vector<T> expected;
+    std::copy_if(src.begin(), src.end(), std::back_inserter(expected), pred);
+
+    VLVector<T, 16> roomy;
+    roomy.reserve(src.size());
+    CHECK(filter_into(src.data(), src.size(), pred, roomy) == expected.size());
+    CHECK(std::equal(roomy.begin(), roomy.end(), expected.begin(), expected.end()));
+
+    VLVector<T, 16> appended;
+    std::vector<T> appendedExpected;
+    for (size_t idx = below(random, 5); idx-- > 0;)
+    {
+        appended.push_back((T) idx);
+        appendedExpected.push_back((T) idx);
+    }
+    appendedExpected.insert(appendedExpected.end(), expected.begin(), expected.end());
+    CHECK(filter_into(src.data(), src.size(), pred, appended) == expected.size());
+    CHECK(std::equal(appended.begin(), appended.end(), appendedExpected.begin(), appendedExpected.end()));
+
+    VLVector<T, 16> retained(src.begin(), src.end());
+    CHECK(retain(retained, pred) == src.size() - expected.size());
+    CHECK(std::equal(retained.begin(), retained.end(), expected.begin(), expected.end()));
+}
+
+/**
+ * @brief Random arrays of T, of sizes around the SIMD widths and FILTER_CHUNK, through each predicate.
+ */
+template<class T>
+static void testType(TestRandom &random)
+{
+    for (size_t round = 0; round < ROUNDS; ++round)
+    {
+        size_t size = below(random, 2) ? below(random, 3 * FILTER_CHUNK) : below(random, MAX_SIZE);
+        std::vector<T> src(size);
+        for (T &value : src)
+        {
+            value = randomValue<T>(random);
+        }
+        T value = randomValue<T>(random);
+        T other = randomValue<T>(random);
+        checkFilter(random, src, vlvfilter::Less<T>(value));
+        checkFilter(random, src, vlvfilter::LessEqual<T>(value));
+        checkFilter(random, src, vlvfilter::Greater<T>(value));
+        checkFilter(random, src, vlvfilter::GreaterEqual<T>(value));
+        checkFilter(random, src, vlvfilter::Equal<T>(value));
+        checkFilter(random, src, vlvfilter::NotEqual<T>(value));
+        checkFilter(random, src, vlvfilter::Between<T>(std::min(value, other), std::max(value, other)));
+        if constexpr (std::is_integral<T>::value)
+        {
+            checkFilter(random, src, vlvfilter::AnyBits<T>(value));
+            checkFilter(random, src, vlvfilter::AllBits<T>(value));
+        }
+        checkFilter(random, src, [value](T x)
+        {
+            return (int) x % 3 == (int) value % 3;
+        });
+    }
+}
+
+int main()
+{
+    TestRandom random(TEST_SEED);
+    testType<int8_t>(random);
+    testType<uint8_t>(random);
+    testType<int16_t>(random);
+    testType<uint16_t>(random);
+    testType<int32_t>(random);
+    testType<uint32_t>(random);
+    testType<int64_t>(random);
+    testType<uint64_t>(random);
+    testType<float>(random);
+    testType<double>(random);
+    return testResult("VLVectorFilterTest");
+}
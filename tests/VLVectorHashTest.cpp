@@ -0,0 +1,92 @@
+/**
+ * @file VLVectorHashTest.cpp
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ *
+ * @brief Tests of VLVectorHash.hpp: CRC32C against its check value, and hashes of equal vectors.
+ */
+#include "TestCheck.hpp"
+#include "../VLVectorHash.hpp"
+
+#include <cstring>
+#include <string>
+
+#define CRC32C_CHECK_INPUT "123456789"
+
+#define CRC32C_CHECK_VALUE 0xE3069283u
+
+/**
+ * @brief The CRC32C check value, by the dispatched, the software and the hardware paths, whole and piecewise.
+ */
+static void testCrc32c()
+{
+    const char *input = CRC32C_CHECK_INPUT;
+    size_t len = std::strlen(input);
+    const unsigned char *bytes = reinterpret_cast<const unsigned char *>(input);
+    CHECK(vlvhash::crc32c(input, len) == CRC32C_CHECK_VALUE);
+    CHECK(~vlvhash::crc32cSoftware(~0u, bytes, len) == CRC32C_CHECK_VALUE);
+#ifdef VLV_SIMD_X86
+    if (__builtin_cpu_supports("sse4.2"))
+    {
+        CHECK(~vlvhash::crc32cHardware(~0u, bytes, len) == CRC32C_CHECK_VALUE);
+    }
+#endif
+    for (size_t split = 0; split <= len; ++split)
+    {
+        CHECK(vlvhash::crc32c(input + split, len - split, vlvhash::crc32c(input, split)) == CRC32C_CHECK_VALUE);
+    }
+    CHECK(vlvhash::crc32c(input, 0) == 0);
+
+    VLVector<char, 4> vec(input, input + len);
+    CHECK(crc32c(vec) == CRC32C_CHECK_VALUE);
+
+    TestRandom random(TEST_SEED);
+    VLVector<unsigned char, 16> data;
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        data.push_back((unsigned char) random());
+        uint32_t software = ~vlvhash::crc32cSoftware(~0u, data.data(), data.size());
+        CHECK(crc32c(data) == software);
+    }
+}
+
+/**
+ * @brief Equal vectors hash equally, whatever their static capacities, through the VLVector and the VLVectorBase
+ * specializations.
+ */
+static void testHash()
+{
+    TestRandom random(TEST_SEED);
+    VLVector<int, 4> small;
+    VLVector<int, 64> large;
+    std::hash<VLVector<int, 4>> smallHash;
+    std::hash<VLVector<int, 64>> largeHash;
+    std::hash<VLVectorBase<int>> baseHash;
+    for (size_t i = 0; i < 200; ++i)
+    {
+        int value = (int) below(random, 1000);
+        small.push_back(value);
+        large.push_back(value);
+        VLVectorBase<int> const &base = small;
+        CHECK(smallHash(small) == largeHash(large));
+        CHECK(baseHash(base) == smallHash(small));
+        CHECK(baseHash(large) == largeHash(large));
+    }
+    large.back() ^= 1;
+    CHECK(smallHash(small) != largeHash(large));
+
+    VLVector<std::string, 2> strings, same;
+    for (size_t i = 0; i < 20; ++i)
+    {
+        strings.push_back(std::to_string(below(random, 100)));
+        same.push_back(strings.back());
+        CHECK(std::hash<VLVector<std::string, 2>>()(strings) == std::hash<VLVectorBase<std::string>>()(same));
+    }
+}
+
+int main()
+{
+    testCrc32c();
+    testHash();
+    return testResult("VLVectorHashTest");
+}
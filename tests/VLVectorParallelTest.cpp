@@ -0,0 +1,275 @@
+/**
+ * @file VLVectorParallelTest.cpp
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ *
+ * @brief Randomized tests of the parallel algorithms of VLVectorParallel.hpp against their sequential std equivalents,
+ * at sizes below and above PARALLEL_MIN_SIZE. Run without VLVECTOR_THREADS, the test runs itself again with every
+ * amount of threads of THREAD_COUNTS, since the pool reads it once.
+ */
+#include "TestCheck.hpp"
+#include "../VLVectorParallel.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#define ROUNDS 3
+
+#define SMALL_SIZE 1000
+
+#define THREAD_COUNTS {1, 2, 3, 8}
+
+#define FAILING_ELEM 12345
+
+/**
+ * @return The sizes every algorithm is tested at: empty, sequential, in the static storage, and a few parallel ones.
+ */
+static std::vector<size_t> testSizes(TestRandom &random)
+{
+    std::vector<size_t> sizes = {0, 1, 7, below(random, SMALL_SIZE), PARALLEL_MIN_SIZE - 1, PARALLEL_MIN_SIZE};
+    for (size_t round = 0; round < ROUNDS; ++round)
+    {
+        sizes.push_back(PARALLEL_MIN_SIZE + below(random, PARALLEL_MIN_SIZE));
+    }
+    return sizes;
+}
+
+/**
+ * @return A VLVector and a std::vector of the same size random values below bound.
+ */
+template<class T, size_t StaticCapacity>
+static void randomVectors(TestRandom &random, size_t size, uint64_t bound, VLVector<T, StaticCapacity> &vec,
+                          std::vector<T> &expected)
+{
+    vec.clear();
+    expected.clear();
+    for (size_t idx = 0; idx < size; ++idx)
+    {
+        T value = (T) below(random, bound);
+        vec.push_back(value);
+        expected.push_back(value);
+    }
+}
+
+/**
+ * @brief parallel_for_each and both parallel_transforms, and the exception of an element and of a size mismatch.
+ */
+static void testForEachAndTransform(TestRandom &random)
+{
+    for (size_t size : testSizes(random))
+    {
+        VLVector<uint32_t, 16> vec;
+        std::vector<uint32_t> expected;
+        randomVectors(random, size, 1000000, vec, expected);
+
+        parallel_for_each(vec, [](uint32_t &elem) { elem = elem * 3 + 1; });
+        std::for_each(expected.begin(), expected.end(), [](uint32_t &elem) { elem = elem * 3 + 1; });
+        CHECK(std::equal(vec.begin(), vec.end(), expected.begin(), expected.end()));
+
+        parallel_transform(vec, [](uint32_t elem) { return elem ^ 0x5a5a5a5au; });
+        std::transform(expected.begin(), expected.end(), expected.begin(), [](uint32_t elem)
+        {
+            return elem ^ 0x5a5a5a5au;
+        });
+        CHECK(std::equal(vec.begin(), vec.end(), expected.begin(), expected.end()));
+
+        VLVector<double, 4> dst;
+        dst.resize(size);
+        std::vector<double> dstExpected(size);
+        parallel_transform(vec, dst, [](uint32_t elem) { return elem / 2.0; });
+        std::transform(expected.begin(), expected.end(), dstExpected.begin(), [](uint32_t elem) { return elem / 2.0; });
+        CHECK(std::equal(dst.begin(), dst.end(), dstExpected.begin(), dstExpected.end()));
+
+        bool threw = false;
+        dst.push_back(0.0);
+        try
+        {
+            parallel_transform(vec, dst, [](uint32_t elem) { return (double) elem; });
+        }
+        catch (std::invalid_argument const &)
+        {
+            threw = true;
+        }
+        CHECK(threw);
+
+        if (size > FAILING_ELEM)
+        {
+            vec[FAILING_ELEM] = FAILING_ELEM;
+            threw = false;
+            try
+            {
+                parallel_for_each(vec, [](uint32_t &elem)
+                {
+                    if (elem == FAILING_ELEM)
+                    {
+                        throw std::runtime_error("element");
+                    }
+                });
+            }
+            catch (std::runtime_error const &)
+            {
+                threw = true;
+            }
+            CHECK(threw);
+        }
+    }
+}
+
+/**
+ * @brief Both parallel_reduces: a sum to a wider Result, a product, and a count whose op takes a Result on its left
+ * only, which is joined by a separate combine.
+ */
+static void testReduce(TestRandom &random)
+{
+    for (size_t size : testSizes(random))
+    {
+        VLVector<int, 8> vec;
+        std::vector<int> expected;
+        randomVectors(random, size, 1000000, vec, expected);
+
+        CHECK(parallel_reduce(vec, (long long) 7) == std::accumulate(expected.begin(), expected.end(), 7LL));
+
+        VLVector<uint64_t, 8> wide(vec.begin(), vec.end());
+        CHECK(parallel_reduce(wide, (uint64_t) 3, std::multiplies<>()) ==
+              std::accumulate(wide.begin(), wide.end(), (uint64_t) 3, std::multiplies<>()));
+
+        auto countOdd = [](size_t count, int elem) { return count + (size_t) (elem % 2); };
+        CHECK(parallel_reduce(vec, (size_t) 5, countOdd, std::plus<>()) ==
+              std::accumulate(expected.begin(), expected.end(), (size_t) 5, countOdd));
+    }
+}
+
+/**
+ * @brief parallel_inclusive_scan against std::partial_sum, by a sum which wraps around and by a max.
+ */
+static void testInclusiveScan(TestRandom &random)
+{
+    for (size_t size : testSizes(random))
+    {
+        VLVector<uint64_t, 32> vec;
+        std::vector<uint64_t> expected;
+        randomVectors(random, size, ~(uint64_t) 0, vec, expected);
+        VLVector<uint64_t, 32> maxVec(vec);
+        std::vector<uint64_t> maxExpected(expected);
+
+        parallel_inclusive_scan(vec);
+        std::partial_sum(expected.begin(), expected.end(), expected.begin());
+        CHECK(std::equal(vec.begin(), vec.end(), expected.begin(), expected.end()));
+
+        auto max = [](uint64_t lhs, uint64_t rhs) { return std::max(lhs, rhs); };
+        parallel_inclusive_scan(maxVec, max);
+        std::partial_sum(maxExpected.begin(), maxExpected.end(), maxExpected.begin(), max);
+        CHECK(std::equal(maxVec.begin(), maxVec.end(), maxExpected.begin(), maxExpected.end()));
+    }
+}
+
+/**
+ * @brief parallel_sort of integral, floating point and string elements, in ascending order (radix sorted chunks for
+ * arithmetic elements) and by a comparison, against std::sort.
+ */
+static void testSort(TestRandom &random)
+{
+    for (size_t size : testSizes(random))
+    {
+        VLVector<int32_t, 16> ints;
+        std::vector<int32_t> intsExpected;
+        randomVectors(random, size, ~(uint32_t) 0, ints, intsExpected);
+        VLVector<int32_t, 16> descending(ints);
+
+        parallel_sort(ints);
+        std::sort(intsExpected.begin(), intsExpected.end());
+        CHECK(std::equal(ints.begin(), ints.end(), intsExpected.begin(), intsExpected.end()));
+
+        parallel_sort(descending, std::greater<>());
+        std::reverse(intsExpected.begin(), intsExpected.end());
+        CHECK(std::equal(descending.begin(), descending.end(), intsExpected.begin(), intsExpected.end()));
+
+        VLVector<double, 4> doubles;
+        std::vector<double> doublesExpected;
+        for (size_t idx = 0; idx < size; ++idx)
+        {
+            double value = ((double) below(random, 1 << 20) - (1 << 19)) / 16;
+            doubles.push_back(value);
+            doublesExpected.push_back(value);
+        }
+        parallel_sort(doubles);
+        std::sort(doublesExpected.begin(), doublesExpected.end());
+        CHECK(std::equal(doubles.begin(), doubles.end(), doublesExpected.begin(), doublesExpected.end()));
+
+        if (size <= PARALLEL_MIN_SIZE)
+        {
+            VLVector<std::string, 4> strings;
+            std::vector<std::string> stringsExpected;
+            for (size_t idx = 0; idx < size; ++idx)
+            {
+                std::string value = std::to_string(below(random, 100000));
+                strings.push_back(value);
+                stringsExpected.push_back(value);
+            }
+            parallel_sort(strings);
+            std::sort(stringsExpected.begin(), stringsExpected.end());
+            CHECK(std::equal(strings.begin(), strings.end(), stringsExpected.begin(), stringsExpected.end()));
+        }
+    }
+}
+
+/**
+ * @brief Tasks submitted to pools of every size all run, also when they submit and wait for tasks of their own.
+ */
+static void testPool()
+{
+    for (size_t threads : THREAD_COUNTS)
+    {
+        VLThreadPool pool(threads);
+        CHECK(pool.threads() == threads);
+        std::atomic<size_t> done(0);
+        for (size_t task = 0; task < SMALL_SIZE; ++task)
+        {
+            pool.submit([&done] { done.fetch_add(1); });
+        }
+        while (done.load() < SMALL_SIZE)
+        {
+            pool.runOne();
+        }
+        CHECK(done.load() == SMALL_SIZE);
+    }
+    VLVector<int> inner;
+    inner.resize(PARALLEL_MIN_SIZE, 1);
+    VLVector<VLVector<int>, 4> nested;
+    nested.resize(8, inner);
+    vlvparallel::forChunks(nested.size(), nested.size(), [&nested](size_t chunk, size_t, size_t)
+    {
+        parallel_transform(nested[chunk], [](int elem) { return elem + 1; });
+    });
+    for (VLVector<int> const &vec : nested)
+    {
+        CHECK(parallel_reduce(vec, 0) == 2 * PARALLEL_MIN_SIZE);
+    }
+}
+
+int main(int, char **argv)
+{
+    if (!std::getenv(THREADS_ENV_VAR))
+    {
+        for (size_t threads : THREAD_COUNTS)
+        {
+            std::string command = THREADS_ENV_VAR "=" + std::to_string(threads) + " '" + argv[0] + "'";
+            CHECK(std::system(command.c_str()) == 0);
+        }
+        return testResult("VLVectorParallelTest");
+    }
+    TestRandom random(TEST_SEED);
+    testPool();
+    testForEachAndTransform(random);
+    testReduce(random);
+    testInclusiveScan(random);
+    testSort(random);
+    std::string name = std::string("VLVectorParallelTest (") + std::getenv(THREADS_ENV_VAR) + " threads)";
+    return testResult(name.c_str());
+}
@@ -0,0 +1,130 @@
+/**
+ * @file VLVectorSearchIndexTest.cpp
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ *
+ * @brief Randomized tests of VLEytzingerIndex and VLSTreeIndex against std::lower_bound, over sorted vectors with
+ * repeated keys and with the largest key, before and after updates.
+ */
+#include "TestCheck.hpp"
+#include "../VLVectorSearchIndex.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <set>
+#include <vector>
+
+#define ROUNDS 60
+
+#define MAX_SIZE 5000
+
+#define QUERIES 500
+
+/**
+ * @return A random key of T out of about range values, or now and then the largest or the smallest T.
+ */
+template<class T>
+static T randomKey(TestRandom &random, size_t range)
+{
+    typedef std::numeric_limits<T> Limits;
+    switch (below(random, 64))
+    {
+        case 0:
+            return Limits::has_infinity ? Limits::infinity() : Limits::max();
+        case 1:
+            return Limits::has_infinity ? -Limits::infinity() : Limits::lowest();
+        default:
+            return (T) ((double) below(random, range) - (std::is_signed<T>::value ? (double) (range / 2) : 0.0));
+    }
+}
+
+/**
+ * @brief lower_bound and contains of both indexes, for keys in and around the range of sorted.
+ */
+template<class T>
+static void checkQueries(TestRandom &random, VLVector<T, 16> const &sorted, VLEytzingerIndex<T> const &eytzinger,
+                         VLSTreeIndex<T> const &stree, size_t range)
+{
+    CHECK(eytzinger.size() == sorted.size() && stree.size() == sorted.size());
+    for (size_t query = 0; query < QUERIES; ++query)
+    {
+        T key = below(random, 2) && !sorted.empty() ? sorted[below(random, sorted.size())] : randomKey<T>(random, range);
+        size_t expected = (size_t) (std::lower_bound(sorted.begin(), sorted.end(), key) - sorted.begin());
+        bool found = expected < sorted.size() && sorted[expected] == key;
+        CHECK(eytzinger.lower_bound(key) == expected && eytzinger.contains(key) == found);
+        CHECK(stree.lower_bound(key) == expected && stree.contains(key) == found);
+    }
+}
+
+/**
+ * @brief Indexes random sorted vectors of T, of sizes which fill a whole tree or not, then changes a run of their keys
+ * keeping them sorted, and changes their size.
+ */
+template<class T>
+static void testType(TestRandom &random)
+{
+    for (size_t round = 0; round < ROUNDS; ++round)
+    {
+        size_t size = below(random, 2) ? below(random, 200) : below(random, MAX_SIZE);
+        size_t range = 1 + size * (below(random, 2) ? 1 : 8);
+        if (std::numeric_limits<T>::digits < 16)
+        {
+            range = std::min<size_t>(range, 100);
+        }
+        std::vector<T> keys(size);
+        for (T &key : keys)
+        {
+            key = randomKey<T>(random, range);
+        }
+        std::sort(keys.begin(), keys.end());
+        VLVector<T, 16> sorted(keys.begin(), keys.end());
+        VLEytzingerIndex<T> eytzinger(sorted);
+        VLSTreeIndex<T> stree(sorted);
+        checkQueries(random, sorted, eytzinger, stree, range);
+
+        if (size > 1)
+        {
+            size_t first = below(random, size - 1), last = first + 1 + below(random, size - first - 1);
+            for (size_t position = first; position < last; ++position)
+            {
+                sorted[position] = sorted[first];
+            }
+            eytzinger.update(sorted, first, last);
+            stree.update(sorted, first, last);
+            checkQueries(random, sorted, eytzinger, stree, range);
+        }
+
+        sorted.push_back(std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity()
+                                                               : std::numeric_limits<T>::max());
+        eytzinger.update(sorted, 0, 0);
+        stree.update(sorted, 0, 0);
+        checkQueries(random, sorted, eytzinger, stree, range);
+    }
+}
+
+/**
+ * @brief Default constructed indexes are empty.
+ */
+static void testEmpty()
+{
+    VLEytzingerIndex<int> eytzinger;
+    VLSTreeIndex<int> stree;
+    CHECK(eytzinger.size() == 0 && eytzinger.lower_bound(5) == 0 && !eytzinger.contains(5));
+    CHECK(stree.size() == 0 && stree.lower_bound(5) == 0 && !stree.contains(5));
+}
+
+int main()
+{
+    TestRandom random(TEST_SEED);
+    testType<int8_t>(random);
+    testType<uint16_t>(random);
+    testType<int32_t>(random);
+    testType<uint32_t>(random);
+    testType<int64_t>(random);
+    testType<uint64_t>(random);
+    testType<float>(random);
+    testType<double>(random);
+    testEmpty();
+    return testResult("VLVectorSearchIndexTest");
+}
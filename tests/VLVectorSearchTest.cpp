@@ -0,0 +1,212 @@
+/**
+ * @file VLVectorSearchTest.cpp
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ *
+ * @brief Randomized tests of the search and reduction functions of VLVectorSearch.hpp against their std equivalents, at
+ * every element width, at every size up to past the static storage and a few AVX2 windows, so that the unrolled static
+ * storage loops, their slid back windows and the tails of the kernels are all reached. Floating vectors also hold a NaN
+ * at their front, middle, end or a random place. run_tests.sh runs it at every SIMD level.
+ */
+#include "TestCheck.hpp"
+#include "../VLVectorSearch.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#define ROUNDS 4
+
+#define VALUE_RANGE 8
+
+/**
+ * The places a NaN is put at.
+ */
+enum class NanAt
+{
+    None,
+    Front,
+    Middle,
+    End,
+    Anywhere
+};
+
+/**
+ * @return true if the values are equal, or both NaN.
+ */
+template<class T>
+static bool same(T lhs, T rhs)
+{
+    if constexpr (std::is_floating_point<T>::value)
+    {
+        if (std::isnan(lhs) || std::isnan(rhs))
+        {
+            return std::isnan(lhs) && std::isnan(rhs);
+        }
+    }
+    return lhs == rhs;
+}
+
+/**
+ * @return A random value of a small range, so that values repeat. Signed values are negative too, and floating values
+ * include -0.
+ */
+template<class T>
+static T randomValue(TestRandom &random)
+{
+    T value = (T) below(random, VALUE_RANGE);
+    if constexpr (std::is_signed<T>::value)
+    {
+        value = (T) (value - (T) (VALUE_RANGE / 2));
+    }
+    if constexpr (std::is_floating_point<T>::value)
+    {
+        value = value ? value : (below(random, 2) ? (T) -0.0 : (T) 0.0);
+    }
+    return value;
+}
+
+/**
+ * @brief Every search of a vector of the given size against std: find and contains of every value of the range and of
+ * one outside it, count, find_if_eq against a second vector, min_element, max_element, minmax and sum. If distinct, the
+ * vector holds a shuffle of 0 to size - 1 instead of repeating values, so each extreme is in one lane only.
+ */
+template<class T, size_t StaticCapacity>
+static void testSize(TestRandom &random, size_t size, NanAt nanAt, bool distinct)
+{
+    VLVector<T, StaticCapacity> vec, other;
+    std::vector<T> expected, otherExpected;
+    for (size_t idx = 0; idx < size; ++idx)
+    {
+        expected.push_back(distinct ? (T) idx : randomValue<T>(random));
+    }
+    std::shuffle(expected.begin(), expected.end(), random);
+    for (size_t idx = 0; idx < size; ++idx)
+    {
+        T otherValue = below(random, 4) ? randomValue<T>(random) : expected[idx];
+        vec.push_back(expected[idx]);
+        other.push_back(otherValue);
+        otherExpected.push_back(otherValue);
+    }
+    if constexpr (std::is_floating_point<T>::value)
+    {
+        if (size && nanAt != NanAt::None)
+        {
+            size_t at = nanAt == NanAt::Front ? 0 : nanAt == NanAt::Middle ? size / 2 :
+                        nanAt == NanAt::End ? size - 1 : below(random, size);
+            vec[at] = expected[at] = std::numeric_limits<T>::quiet_NaN();
+        }
+    }
+    VLVector<T, StaticCapacity> const &constVec = vec;
+
+    for (int value = -VALUE_RANGE; value <= VALUE_RANGE; ++value)
+    {
+        T needle = (T) value;
+        size_t at = (size_t) (std::find(expected.begin(), expected.end(), needle) - expected.begin());
+        CHECK((size_t) (find(vec, needle) - vec.begin()) == at);
+        CHECK((size_t) (find(constVec, needle) - constVec.cbegin()) == at);
+        CHECK(contains(vec, needle) == (at != size));
+        CHECK(count(vec, needle) == (size_t) std::count(expected.begin(), expected.end(), needle));
+    }
+
+    for (size_t shorter = 0; shorter < 2; ++shorter)
+    {
+        size_t common = size - (shorter && size ? 1 : 0);
+        size_t at = 0;
+        while (at < common && !(expected[at] == otherExpected[at]))
+        {
+            ++at;
+        }
+        VLVector<T, StaticCapacity> rhs(other.begin(), other.begin() + common);
+        size_t found = (size_t) (find_if_eq(constVec, rhs) - constVec.cbegin());
+        CHECK(found == (at == common ? size : at));
+    }
+
+    size_t minAt = (size_t) (std::min_element(expected.begin(), expected.end()) - expected.begin());
+    size_t maxAt = (size_t) (std::max_element(expected.begin(), expected.end()) - expected.begin());
+    CHECK((size_t) (min_element(vec) - vec.cbegin()) == minAt);
+    CHECK((size_t) (max_element(vec) - vec.cbegin()) == maxAt);
+    if (size)
+    {
+        std::pair<T, T> extremes = minmax(vec);
+        CHECK(same(extremes.first, expected[minAt]) && same(extremes.second, expected[maxAt]));
+    }
+    else
+    {
+        bool threw = false;
+        try
+        {
+            minmax(vec);
+        }
+        catch (std::out_of_range const &)
+        {
+            threw = true;
+        }
+        CHECK(threw);
+    }
+
+    vlvsimd::SumType<T> total = 0;
+    for (T elem : expected)
+    {
+        total += elem;
+    }
+    CHECK(same(sum(vec), total));
+}
+
+/**
+ * @brief Every size up to past StaticCapacity and past a few AVX2 windows, with and without NaNs.
+ */
+template<class T, size_t StaticCapacity>
+static void testSizes(TestRandom &random)
+{
+    constexpr size_t lanes = AVX2_BYTES / sizeof(T);
+    size_t maxSize = std::max(StaticCapacity, 3 * lanes) + lanes + 1;
+    for (size_t round = 0; round < ROUNDS; ++round)
+    {
+        for (size_t size = 0; size <= maxSize; ++size)
+        {
+            for (NanAt nanAt : {NanAt::None, NanAt::Front, NanAt::Middle, NanAt::End, NanAt::Anywhere})
+            {
+                testSize<T, StaticCapacity>(random, size, nanAt, round % 2);
+                if (!std::is_floating_point<T>::value)
+                {
+                    break;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief testSizes with static storages smaller than an SSE2 window, of one window, of several windows, and one too
+ * large to be unrolled.
+ */
+template<class T>
+static void testElement(TestRandom &random)
+{
+    testSizes<T, 3>(random);
+    testSizes<T, SSE2_BYTES / sizeof(T)>(random);
+    testSizes<T, 3 * SSE2_BYTES / sizeof(T) + 1>(random);
+    testSizes<T, INLINE_UNROLL_BYTES / sizeof(T)>(random);
+    testSizes<T, INLINE_UNROLL_BYTES / sizeof(T) + 1>(random);
+}
+
+int main()
+{
+    TestRandom random(TEST_SEED);
+    testElement<int8_t>(random);
+    testElement<uint8_t>(random);
+    testElement<int16_t>(random);
+    testElement<uint16_t>(random);
+    testElement<int32_t>(random);
+    testElement<uint32_t>(random);
+    testElement<int64_t>(random);
+    testElement<uint64_t>(random);
+    testElement<float>(random);
+    testElement<double>(random);
+    return testResult("VLVectorSearchTest");
+}
@@ -0,0 +1,134 @@
+/**
+ * @file VLVectorSetOpsTest.cpp
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ *
+ * @brief Randomized tests of set_intersection, set_union, set_difference and merge of sorted VLVectors against their
+ * std equivalents, with inputs of similar sizes, which merge or compare blocks, and of skewed ones, which gallop.
+ */
+#include "TestCheck.hpp"
+#include "../VLVectorSetOps.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <set>
+#include <vector>
+
+#define ROUNDS 300
+
+#define MAX_SIZE 1500
+
+/**
+ * An element ordered by its key only, so that merge shows which of equal elements comes first.
+ */
+struct Keyed
+{
+    int key;
+    int tag;
+
+    bool operator<(Keyed const &rhs) const noexcept
+    {
+        return key < rhs.key;
+    }
+
+    bool operator==(Keyed const &rhs) const noexcept
+    {
+        return key == rhs.key && tag == rhs.tag;
+    }
+};
+
+/**
+ * @return A sorted set of up to size random values out of range, as a VLVector.
+ */
+template<class T>
+static VLVector<T, 16> randomSet(TestRandom &random, size_t size, size_t range)
+{
+    std::set<T> values;
+    for (size_t idx = 0; idx < size; ++idx)
+    {
+        values.insert((T) below(random, range) - (T) (range / 4));
+    }
+    return VLVector<T, 16>(values.begin(), values.end());
+}
+
+/**
+ * @brief All of the operations on random sets of T, into an output which holds some earlier content, in its static
+ * storage or not.
+ */
+template<class T>
+static void testType(TestRandom &random)
+{
+    for (size_t round = 0; round < ROUNDS; ++round)
+    {
+        size_t lhsSize = below(random, MAX_SIZE);
+        size_t rhsSize = below(random, 4) ? below(random, MAX_SIZE) : below(random, 1 + lhsSize / GALLOP_RATIO);
+        if (below(random, 2))
+        {
+            std::swap(lhsSize, rhsSize);
+        }
+        size_t range = 1 + (lhsSize + rhsSize) * (1 + below(random, 4));
+        VLVector<T, 16> lhs = randomSet<T>(random, lhsSize, range), rhs = randomSet<T>(random, rhsSize, range);
+        VLVector<T, 16> out;
+        out.resize(below(random, 40), (T) 7);
+        std::vector<T> expected;
+
+        CHECK(set_intersection(lhs, rhs, out) == out.size());
+        std::set_intersection(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::back_inserter(expected));
+        CHECK(std::equal(out.begin(), out.end(), expected.begin(), expected.end()));
+
+        expected.clear();
+        CHECK(set_union(lhs, rhs, out) == out.size());
+        std::set_union(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::back_inserter(expected));
+        CHECK(std::equal(out.begin(), out.end(), expected.begin(), expected.end()));
+
+        expected.clear();
+        CHECK(set_difference(lhs, rhs, out) == out.size());
+        std::set_difference(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::back_inserter(expected));
+        CHECK(std::equal(out.begin(), out.end(), expected.begin(), expected.end()));
+
+        expected.clear();
+        merge(lhs, rhs, out);
+        std::merge(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::back_inserter(expected));
+        CHECK(std::equal(out.begin(), out.end(), expected.begin(), expected.end()));
+    }
+}
+
+/**
+ * @brief merge keeps repeated elements, and puts the ones of lhs first of equal elements.
+ */
+static void testMergeOrder(TestRandom &random)
+{
+    for (size_t round = 0; round < ROUNDS; ++round)
+    {
+        VLVector<Keyed, 8> lhs, rhs, out;
+        int lhsSize = (int) below(random, 100), rhsSize = (int) below(random, 100);
+        for (int tag = 0; tag < lhsSize; ++tag)
+        {
+            lhs.push_back(Keyed{(int) below(random, 20), tag});
+        }
+        for (int tag = 0; tag < rhsSize; ++tag)
+        {
+            rhs.push_back(Keyed{(int) below(random, 20), -1 - tag});
+        }
+        std::stable_sort(lhs.begin(), lhs.end());
+        std::stable_sort(rhs.begin(), rhs.end());
+        std::vector<Keyed> expected;
+        merge(lhs, rhs, out);
+        std::merge(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::back_inserter(expected));
+        CHECK(std::equal(out.begin(), out.end(), expected.begin(), expected.end()));
+    }
+}
+
+int main()
+{
+    TestRandom random(TEST_SEED);
+    testType<int16_t>(random);
+    testType<int32_t>(random);
+    testType<uint32_t>(random);
+    testType<int64_t>(random);
+    testType<uint64_t>(random);
+    testType<double>(random);
+    testMergeOrder(random);
+    return testResult("VLVectorSetOpsTest");
+}
@@ -0,0 +1,153 @@
+/**
+ * @file VLVectorSortTest.cpp
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ *
+ * @brief Randomized tests of sort and stable_sort of VLVectors against std::sort and std::stable_sort, at sizes which
+ * go to each of the sorting networks, insertion sort, radix sort and the std sorts.
+ */
+#include "TestCheck.hpp"
+#include "../VLVectorSort.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#define ROUNDS 40
+
+#define MAX_SIZE 3000
+
+/**
+ * @return A random value of T, of up to bits random bits, so that small ranges repeat values. Floating point values
+ * include both zeros and both infinities.
+ */
+template<class T>
+static T randomValue(TestRandom &random, size_t bits)
+{
+    if constexpr (std::is_floating_point<T>::value)
+    {
+        double range = (double) ((size_t) 1 << std::min<size_t>(bits, 24));
+        switch (below(random, 16))
+        {
+            case 0:
+                return (T) -0.0;
+            case 1:
+                return (T) 0.0;
+            case 2:
+                return std::numeric_limits<T>::infinity();
+            case 3:
+                return -std::numeric_limits<T>::infinity();
+            default:
+                return (T) (((double) below(random, (size_t) range) - range / 2) / 8);
+        }
+    }
+    else
+    {
+        uint64_t value = random() & (bits >= 64 ? ~(uint64_t) 0 : ((uint64_t) 1 << bits) - 1);
+        T result;
+        std::memcpy(&result, &value, sizeof(T));
+        return result;
+    }
+}
+
+/**
+ * @return true if vec holds the bits of expected: a stable sort keeps the order of -0 and +0.
+ */
+template<class T, size_t StaticCapacity>
+static bool sameBits(VLVector<T, StaticCapacity> const &vec, std::vector<T> const &expected)
+{
+    return vec.size() == expected.size() &&
+           (expected.empty() || !std::memcmp(vec.data(), expected.data(), expected.size() * sizeof(T)));
+}
+
+/**
+ * @brief Sorts random vectors of size up to maxSize, with a few or many random bits, by all of the sorts. A vector
+ * within a StaticCapacity of at most NETWORK_MAX_SIZE goes to a network, a dynamic one to insertion sort, radix sort
+ * (in its spare capacity, which is reserved half of the time, or in a buffer of its own) or a std sort.
+ */
+template<class T, size_t StaticCapacity>
+static void testSorts(TestRandom &random, size_t maxSize)
+{
+    for (size_t round = 0; round < ROUNDS; ++round)
+    {
+        size_t size = below(random, maxSize + 1);
+        size_t bits = below(random, 2) ? 4 : sizeof(T) * 8;
+        VLVector<T, StaticCapacity> vec;
+        if (below(random, 2))
+        {
+            vec.reserve(2 * size);
+        }
+        std::vector<T> expected;
+        for (size_t idx = 0; idx < size; ++idx)
+        {
+            T value = randomValue<T>(random, bits);
+            vec.push_back(value);
+            expected.push_back(value);
+        }
+        VLVector<T, StaticCapacity> stable(vec), descending(vec);
+        std::vector<T> stableExpected(expected), descendingExpected(expected);
+
+        sort(vec);
+        std::sort(expected.begin(), expected.end());
+        CHECK(std::equal(vec.begin(), vec.end(), expected.begin(), expected.end()));
+
+        stable_sort(stable);
+        std::stable_sort(stableExpected.begin(), stableExpected.end());
+        CHECK(sameBits(stable, stableExpected));
+
+        stable_sort(descending, std::greater<T>());
+        std::stable_sort(descendingExpected.begin(), descendingExpected.end(), std::greater<T>());
+        CHECK(sameBits(descending, descendingExpected));
+        sort(descending, std::greater<T>());
+        CHECK(std::is_sorted(descending.begin(), descending.end(), std::greater<T>()));
+    }
+}
+
+/**
+ * @brief Elements sorted by a key which many of them share keep their order under stable_sort.
+ */
+static void testStableByKey(TestRandom &random)
+{
+    for (size_t round = 0; round < ROUNDS; ++round)
+    {
+        VLVector<int, 8> vec;
+        std::vector<int> expected;
+        for (size_t idx = below(random, MAX_SIZE); idx-- > 0;)
+        {
+            int value = (int) below(random, 100000);
+            vec.push_back(value);
+            expected.push_back(value);
+        }
+        auto byKey = [](int lhs, int rhs)
+        {
+            return lhs % 10 < rhs % 10;
+        };
+        stable_sort(vec, byKey);
+        std::stable_sort(expected.begin(), expected.end(), byKey);
+        CHECK(std::equal(vec.begin(), vec.end(), expected.begin(), expected.end()));
+    }
+}
+
+int main()
+{
+    TestRandom random(TEST_SEED);
+    testSorts<int8_t, NETWORK_MAX_SIZE>(random, 2 * NETWORK_MAX_SIZE);
+    testSorts<int32_t, NETWORK_MAX_SIZE>(random, 2 * NETWORK_MAX_SIZE);
+    testSorts<double, NETWORK_MAX_SIZE>(random, 2 * NETWORK_MAX_SIZE);
+    testSorts<int8_t, 4>(random, MAX_SIZE);
+    testSorts<uint8_t, 4>(random, MAX_SIZE);
+    testSorts<int16_t, 4>(random, MAX_SIZE);
+    testSorts<uint16_t, 4>(random, MAX_SIZE);
+    testSorts<int32_t, 4>(random, MAX_SIZE);
+    testSorts<uint32_t, 4>(random, MAX_SIZE);
+    testSorts<int64_t, 4>(random, MAX_SIZE);
+    testSorts<uint64_t, 4>(random, MAX_SIZE);
+    testSorts<float, 4>(random, MAX_SIZE);
+    testSorts<double, 4>(random, MAX_SIZE);
+    testStableByKey(random);
+    return testResult("VLVectorSortTest");
+}
@@ -0,0 +1,235 @@
+/**
+ * @file VLVectorTest.cpp
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ *
+ * @brief Randomized tests of VLVector against std::vector.
+ */
+#include "TestCheck.hpp"
+#include "../VLVector.hpp"
+
+#include <iterator>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if __has_include(<version>)
+
+#include <version>
+
+#endif
+
+#ifdef __cpp_lib_concepts
+
+#include <ranges>
+
+#endif
+
+// The element copies and moves of std algorithms take their memmove paths on pointers only, so a change of the
+// iterators to a class must fail here rather than silently lose them.
+static_assert(std::is_pointer<VLVector<int>::iterator>::value && std::is_pointer<VLVector<int>::const_iterator>::value,
+              "VLVector iterators must be pointers");
+#ifdef __cpp_lib_concepts
+static_assert(std::contiguous_iterator<VLVector<int>::iterator> &&
+              std::contiguous_iterator<VLVector<int>::const_iterator>, "VLVector iterators must be contiguous");
+static_assert(std::ranges::contiguous_range<VLVector<int>> && std::ranges::sized_range<VLVector<int>> &&
+              std::ranges::contiguous_range<VLVector<int> const> && std::ranges::sized_range<VLVector<int> const>,
+              "VLVector must be a sized contiguous range");
+static_assert(std::ranges::contiguous_range<VLVectorBase<int>> && std::ranges::sized_range<VLVectorBase<int>>,
+              "VLVectorBase must be a sized contiguous range");
+#endif
+// Moving the static storage of a wider VLVector may allocate.
+static_assert(!std::is_nothrow_constructible<VLVector<int, 16>, VLVectorBase<int> &&>::value,
+              "a move from another static capacity may throw");
+static_assert(std::is_nothrow_move_constructible<VLVector<int, 16>>::value, "a move within a capacity must not throw");
+
+/**
+ * @return true if vec holds the elements of expected.
+ */
+template<class T>
+static bool same(VLVectorBase<T> const &vec, std::vector<T> const &expected)
+{
+    return sameElements(vec, expected) && vec.capacity() >= vec.size();
+}
+
+/**
+ * @brief Random operations, the element arguments often being elements of the vector itself, which growth and
+ * shifting must not invalidate before they are read.
+ */
+template<size_t StaticCapacity>
+static void testRandomOps()
+{
+    TestRandom random(TEST_SEED + StaticCapacity);
+    VLVector<std::string, StaticCapacity> vec;
+    std::vector<std::string> expected;
+    for (size_t op = 0; op < RANDOM_OPS; ++op)
+    {
+        size_t at = expected.empty() ? 0 : below(random, expected.size());
+        std::string value;
+        std::string const &argument = randomArgument(random, vec, expected, at, value);
+        switch (below(random, 8))
+        {
+            case 0:
+            case 1:
+                vec.push_back(argument);
+                expected.push_back(value);
+                break;
+            case 2:
+            {
+                size_t pos = below(random, expected.size() + 1);
+                CHECK(*vec.insert(vec.cbegin() + pos, argument) == value);
+                expected.insert(expected.begin() + pos, value);
+                break;
+            }
+            case 3:
+            {
+                size_t newSize = below(random, 3 * StaticCapacity + 2);
+                vec.resize(newSize, argument);
+                expected.resize(newSize, value);
+                break;
+            }
+            case 4:
+                if (!expected.empty())
+                {
+                    vec.pop_back();
+                    expected.pop_back();
+                }
+                break;
+            case 5:
+                if (!expected.empty())
+                {
+                    vec.erase(vec.cbegin() + at);
+                    expected.erase(expected.begin() + at);
+                }
+                break;
+            case 6:
+            {
+                size_t last = at + below(random, expected.size() - at + 1);
+                vec.erase(vec.cbegin() + at, vec.cbegin() + last);
+                expected.erase(expected.begin() + at, expected.begin() + last);
+                break;
+            }
+            default:
+                if (!below(random, 16))
+                {
+                    vec.clear();
+                    expected.clear();
+                    CHECK(vec.capacity() == StaticCapacity);
+                }
+                break;
+        }
+        CHECK(same(vec, expected));
+    }
+}
+
+/**
+ * @brief resize, push_back and insert with an element of the vector as the value, when the vector has to grow.
+ */
+static void testSelfReferencesOnGrowth()
+{
+    for (size_t size = 1; size < 40; ++size)
+    {
+        VLVector<std::string, 4> vec;
+        for (size_t i = 0; i < size; ++i)
+        {
+            vec.push_back(std::to_string(i) + STRING_PADDING);
+        }
+        std::string first = vec.front(), last = vec.back();
+
+        VLVector<std::string, 4> resized(vec);
+        resized.resize(resized.capacity() + 1, resized[0]);
+        CHECK(resized.back() == first);
+
+        VLVector<std::string, 4> pushed(vec);
+        pushed.resize(pushed.capacity(), last);
+        pushed.push_back(pushed[0]);
+        CHECK(pushed.back() == first);
+
+        VLVector<std::string, 4> inserted(vec);
+        inserted.resize(inserted.capacity(), last);
+        inserted.insert(inserted.cbegin(), inserted.back());
+        CHECK(inserted.front() == last);
+    }
+}
+
+/**
+ * @return A VLVector of size strings.
+ */
+template<size_t StaticCapacity>
+static VLVector<std::string, StaticCapacity> makeVector(size_t size)
+{
+    VLVector<std::string, StaticCapacity> vec;
+    for (size_t i = 0; i < size; ++i)
+    {
+        vec.push_back(std::to_string(i) + STRING_PADDING);
+    }
+    return vec;
+}
+
+/**
+ * @brief Copies and moves between VLVectors of the same and of other static capacities, in static and in dynamic
+ * storage. A copy is sized by the copied elements, not by the capacity of the copied vector, and a move takes over a
+ * dynamic array and leaves the moved vector empty.
+ */
+static void testCopyAndMove()
+{
+    for (size_t size = 0; size < 20; ++size)
+    {
+        VLVector<std::string, 4> source = makeVector<4>(size);
+        std::vector<std::string> expected(source.begin(), source.end());
+
+        VLVector<std::string, 4> grown = makeVector<4>(64);
+        grown.resize(size);
+        VLVector<std::string, 4> copy(grown);
+        CHECK(same(copy, expected));
+        CHECK(copy.capacity() == std::max<size_t>(size, 4));
+
+        VLVector<std::string, 4> assigned = makeVector<4>(10);
+        size_t capacity = assigned.capacity();
+        assigned = source;
+        CHECK(same(assigned, expected));
+        CHECK(assigned.capacity() == (size <= 4 ? 4 : std::max(size, capacity)));
+
+        VLVector<std::string, 8> other;
+        other = source;
+        CHECK(same(other, expected));
+
+        const std::string *elements = source.data();
+        VLVector<std::string, 4> moved(std::move(source));
+        CHECK(same(moved, expected));
+        CHECK(source.empty() && source.capacity() == 4);
+        CHECK((moved.data() == elements) == (size > 4));
+
+        VLVector<std::string, 4> moveAssigned = makeVector<4>(7);
+        moveAssigned = std::move(moved);
+        CHECK(same(moveAssigned, expected));
+        CHECK(moved.empty() && moved.capacity() == 4);
+
+        VLVector<std::string, 16> crossMoved;
+        crossMoved = std::move(moveAssigned);
+        CHECK(same(crossMoved, expected));
+        CHECK(moveAssigned.empty() && moveAssigned.capacity() == 4);
+        VLVectorBase<std::string> &self = crossMoved;
+        crossMoved = std::move(self);
+        CHECK(same(crossMoved, expected));
+
+        VLVector<std::string, 64> wide(expected.begin(), expected.end());
+        VLVector<std::string, 16> narrowed(std::move(static_cast<VLVectorBase<std::string> &>(wide)));
+        CHECK(same(narrowed, expected));
+        CHECK(wide.empty() && narrowed.capacity() == std::max<size_t>(size, 16));
+
+        moveAssigned.push_back(STRING_PADDING);
+        CHECK(moveAssigned.size() == 1);
+    }
+}
+
+int main()
+{
+    testRandomOps<1>();
+    testRandomOps<4>();
+    testRandomOps<16>();
+    testSelfReferencesOnGrowth();
+    testCopyAndMove();
+    return testResult("VLVectorTest");
+}
@@ -0,0 +1,188 @@
+/**
+ * @file VLVectorTraceTest.cpp
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ *
+ * @brief Round trip tests of the operation traces of VLVectorTrace.hpp: a scripted sequence of calls is recorded,
+ * decoded by benchmark/TraceReplay.hpp record by record, and replayed as VLVectors and as std::vectors, which must end
+ * up with the sizes the recorded vectors had. Older trace versions must still decode.
+ */
+#define VLVECTOR_TRACE
+#define ALLOC_COUNTER_IMPLEMENTATION
+
+#include "TestCheck.hpp"
+#include "../benchmark/TraceReplay.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * A decoded record as expected: the op, the slot of its vector, the slot of the copied / moved / assigned-from vector,
+ * the position and the amount of an insert or an erase and the static capacity of a new vector.
+ */
+struct Expected
+{
+    VLVTraceOp op;
+    uint32_t slot;
+    uint32_t other;
+    uint64_t pos;
+    uint64_t amount;
+    uint64_t staticCapacity;
+};
+
+/**
+ * @return true if the decoded records are the expected ones.
+ */
+static bool decodedAs(SubTrace const &sub, std::vector<Expected> const &expected)
+{
+    if (sub.records.size() != expected.size())
+    {
+        return false;
+    }
+    for (size_t idx = 0; idx < expected.size(); ++idx)
+    {
+        TraceRecord const &record = sub.records[idx];
+        Expected const &want = expected[idx];
+        if (record.op != want.op || record.slot != want.slot || record.other != want.other || record.pos != want.pos ||
+            record.amount != want.amount || record.staticCapacity != want.staticCapacity)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @return true if replaying sub as every layout ends with vectors of the expected sizes, by slot.
+ */
+template<size_t Bytes>
+static bool replaysTo(SubTrace const &sub, std::vector<size_t> const &expected)
+{
+    std::vector<size_t> sizes;
+    bool same = true;
+    replay<AsRecorded, ReplayElement<Bytes>>(sub, &sizes);
+    same = same && sizes == expected;
+    replay<FixedCapacity<4>, ReplayElement<Bytes>>(sub, &sizes);
+    same = same && sizes == expected;
+    replay<StdVector, ReplayElement<Bytes>>(sub, &sizes);
+    return same && sizes == expected;
+}
+
+/**
+ * @brief Records copies, moves, assignments and the size changing calls of vectors of two element types, and checks
+ * the decoded trace and its replays.
+ */
+static void testRoundTrip(std::string const &path)
+{
+    CHECK(VLVectorTrace::open(path.c_str()));
+    const int values[] = {7, 8, 9};
+    VLVector<int, 4> a;
+    for (int value = 0; value < 6; ++value)
+    {
+        a.push_back(value);
+    }
+    VLVector<int, 4> b(a);
+    b.insert(b.begin() + 1, values, values + 3);
+    b.erase(b.begin(), b.begin() + 2);
+    VLVector<int, 4> c(std::move(b));
+    VLVector<int, 16> d;
+    d = std::move(c);
+    c = a;
+    c.pop_back();
+    {
+        VLVector<int, 4> copy(a);
+        copy.clear();
+    }
+    VLVector<int, 8> e(std::move(static_cast<VLVectorBase<int> &>(d)));
+    VLVector<double, 2> f;
+    f.push_back(1.5);
+    VLVectorTrace::close();
+    CHECK(a.size() == 6 && b.empty() && c.size() == 5 && d.empty() && e.size() == 7 && f.size() == 1);
+
+    Trace trace = readTrace(path.c_str());
+    CHECK(trace.bySize.size() == 2 && trace.slots == 6 && trace.records == 21);
+    CHECK(decodedAs(trace.bySize[sizeof(int)], {{TRACE_CREATE, 0, 0, 0, 0, 4},
+                                                {TRACE_PUSH_BACK, 0, 0, 0, 0, 0},
+                                                {TRACE_PUSH_BACK, 0, 0, 0, 0, 0},
+                                                {TRACE_PUSH_BACK, 0, 0, 0, 0, 0},
+                                                {TRACE_PUSH_BACK, 0, 0, 0, 0, 0},
+                                                {TRACE_PUSH_BACK, 0, 0, 0, 0, 0},
+                                                {TRACE_PUSH_BACK, 0, 0, 0, 0, 0},
+                                                {TRACE_COPY, 1, 0, 0, 0, 4},
+                                                {TRACE_INSERT, 1, 0, 1, 3, 0},
+                                                {TRACE_ERASE, 1, 0, 0, 2, 0},
+                                                {TRACE_MOVE, 2, 1, 0, 0, 4},
+                                                {TRACE_CREATE, 3, 0, 0, 0, 16},
+                                                {TRACE_MOVE_ASSIGN, 3, 2, 0, 0, 0},
+                                                {TRACE_ASSIGN, 2, 0, 0, 0, 0},
+                                                {TRACE_POP_BACK, 2, 0, 0, 0, 0},
+                                                {TRACE_COPY, 4, 0, 0, 0, 4},
+                                                {TRACE_CLEAR, 4, 0, 0, 0, 0},
+                                                {TRACE_DESTROY, 4, 0, 0, 0, 0},
+                                                {TRACE_MOVE, 4, 3, 0, 0, 8}}));
+    CHECK(decodedAs(trace.bySize[sizeof(double)], {{TRACE_CREATE, 0, 0, 0, 0, 2},
+                                                   {TRACE_PUSH_BACK, 0, 0, 0, 0, 0}}));
+    CHECK(replaysTo<sizeof(int)>(trace.bySize[sizeof(int)], {a.size(), b.size(), c.size(), d.size(), e.size()}));
+    CHECK(replaysTo<sizeof(double)>(trace.bySize[sizeof(double)], {f.size()}));
+}
+
+/**
+ * @brief Writes bytes to path.
+ */
+static void writeFile(std::string const &path, std::string const &bytes)
+{
+    FILE *out = std::fopen(path.c_str(), "wb");
+    CHECK(out != nullptr);
+    if (out)
+    {
+        std::fwrite(bytes.data(), 1, bytes.size(), out);
+        std::fclose(out);
+    }
+}
+
+/**
+ * @brief A version 2 trace, which records a move as a copy and a clear, still decodes and replays so, and a trace of
+ * an unknown version does not.
+ */
+static void testOldVersions(std::string const &path)
+{
+    const char version2[] = {'V', 'L', 'V', 'T', 2,
+                             TRACE_CREATE, 1, 4, 4,
+                             TRACE_PUSH_BACK, 1,
+                             TRACE_PUSH_BACK, 1,
+                             TRACE_COPY, 2, 1, 4, 4,
+                             TRACE_CLEAR, 1};
+    writeFile(path, std::string(version2, sizeof(version2)));
+    Trace trace = readTrace(path.c_str());
+    CHECK(decodedAs(trace.bySize[4], {{TRACE_CREATE, 0, 0, 0, 0, 4},
+                                      {TRACE_PUSH_BACK, 0, 0, 0, 0, 0},
+                                      {TRACE_PUSH_BACK, 0, 0, 0, 0, 0},
+                                      {TRACE_COPY, 1, 0, 0, 0, 4},
+                                      {TRACE_CLEAR, 0, 0, 0, 0, 0}}));
+    CHECK(replaysTo<4>(trace.bySize[4], {0, 2}));
+
+    writeFile(path, std::string("VLVT") + (char) (TRACE_VERSION + 1));
+    bool threw = false;
+    try
+    {
+        readTrace(path.c_str());
+    }
+    catch (std::runtime_error const &)
+    {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+int main(int, char **argv)
+{
+    std::string path = std::string(argv[0]) + ".trace";
+    testRoundTrip(path);
+    testOldVersions(path);
+    std::remove(path.c_str());
+    return testResult("VLVectorTraceTest");
+}
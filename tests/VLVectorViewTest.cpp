@@ -0,0 +1,62 @@
+/**
+ * @file VLVectorViewTest.cpp
+ * @author  Guy Lev <thehatguy>
+ * @version 1.0
+ *
+ * @brief Tests of the VLVector views, and of their conversion to std::span under C++20.
+ */
+#include "TestCheck.hpp"
+#include "../VLVectorView.hpp"
+
+#include <numeric>
+
+/**
+ * @return The sum of a view, a function which accepts a VLVector of any static capacity.
+ */
+static int total(VLSpan<const int> view)
+{
+    return std::accumulate(view.begin(), view.end(), 0);
+}
+
+/**
+ * @brief Views of a VLVector see its elements, in its static and in its dynamic storage.
+ */
+static void testSpan()
+{
+    VLVector<int, 4> vec;
+    for (int i = 1; i <= 10; ++i)
+    {
+        vec.push_back(i);
+        CHECK(total(vec) == i * (i + 1) / 2);
+        CHECK(as_span(vec).data() == vec.data());
+    }
+    VLSpan<const int> middle = slice(vec, 2, 5);
+    CHECK(middle.size() == 5 && middle.front() == 3 && middle.back() == 7);
+    as_span(vec)[0] = 100;
+    CHECK(vec[0] == 100);
+}
+
+/**
+ * @brief A VLSpan converts to std::span whenever the standard library has one.
+ */
+static void testStdSpan()
+{
+#if __cplusplus >= 202002L && __has_include(<span>)
+#ifdef VLV_STD_SPAN
+    VLVector<int, 4> vec;
+    vec.push_back(1);
+    vec.push_back(2);
+    std::span<const int> span = VLSpan<const int>(vec);
+    CHECK(span.data() == vec.data() && span.size() == vec.size());
+#else
+    CHECK(!"VLV_STD_SPAN is not defined though <span> is available");
+#endif
+#endif
+}
+
+int main()
+{
+    testSpan();
+    testStdSpan();
+    return testResult("VLVectorViewTest");
+}
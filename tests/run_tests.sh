@@ -0,0 +1,38 @@
+#!/bin/sh
+# Builds and runs every tests/*Test.cpp, as C++17 and as C++20, with the address and undefined behavior sanitizers,
+# once with the widest SIMD level of the CPU and once capped to every lower one (see VLVECTOR_SIMD in VLVectorSimd.hpp).
+# Fails (exit status 1) if any test does not build cleanly or fails.
+#
+# Usage: run_tests.sh [test name substring]
+# Environment: CXX (default g++), STANDARDS (default "c++17 c++20"), SIMD_LEVELS (default "scalar sse2 avx2"),
+#              CXXFLAGS (default "-O1 -g -fsanitize=address,undefined").
+set -e
+
+DIR=$(cd "$(dirname "$0")" && pwd)
+CXX=${CXX:-g++}
+STANDARDS=${STANDARDS:-"c++17 c++20"}
+SIMD_LEVELS=${SIMD_LEVELS:-"scalar sse2 avx2"}
+CXXFLAGS=${CXXFLAGS:-"-O1 -g -fsanitize=address,undefined"}
+BIN=${TMPDIR:-/tmp}/VLVectorTest.$$
+FAILED=0
+
+trap 'rm -f "$BIN"' EXIT
+for test in "$DIR"/*Test.cpp; do
+    case "$(basename "$test")" in
+        *"$1"*) ;;
+        *) continue ;;
+    esac
+    for standard in $STANDARDS; do
+        # shellcheck disable=SC2086
+        if ! "$CXX" -std="$standard" $CXXFLAGS -Wall -Wextra -Werror -I"$DIR/.." "$test" -o "$BIN"; then
+            echo "$(basename "$test") ($standard): build failed"
+            FAILED=1
+            continue
+        fi
+        "$BIN" || FAILED=1
+        for level in $SIMD_LEVELS; do
+            VLVECTOR_SIMD=$level "$BIN" > /dev/null || { echo "  with VLVECTOR_SIMD=$level"; FAILED=1; }
+        done
+    done
+done
+exit $FAILED